@@ -0,0 +1,48 @@
+/*
+ * $Id: vec_memchr.c,v 1.0 2026-10-17 18:21:09 clib2devs Exp $
+*/
+
+#ifndef _VEC_STRING_H
+#include "vec_string.h"
+#endif /* _VEC_STRING_H */
+
+void *
+vec_memchr(const void *ptr, int val, size_t len) {
+#ifdef __ALTIVEC__
+    const unsigned char *m = ptr;
+    const unsigned char *end = m + len;
+    unsigned char c = val;
+    __vec_uchar cv;
+
+    if (len < VEC_MIN_LENGTH)
+        return __swar_memchr(ptr, val, len);
+
+    /* Bytes up to the first block boundary, ... */
+    for (; !VEC_ALIGNED(m); m++) {
+        if ((*m) == c)
+            return (void *) m;
+    }
+
+    /* ...then all complete blocks... */
+    cv = __vec_splat_byte(c);
+
+    for (; end - m >= 16; m += 16) {
+        if (vec_any_eq(vec_ld(0, m), cv)) {
+            while ((*m) != c)
+                m++;
+
+            return (void *) m;
+        }
+    }
+
+    /* ...and whatever is left. */
+    for (; m < end; m++) {
+        if ((*m) == c)
+            return (void *) m;
+    }
+
+    return NULL;
+#else
+    return __swar_memchr(ptr, val, len);
+#endif /* __ALTIVEC__ */
+}
@@ -0,0 +1,49 @@
+/*
+ * $Id: vec_memrchr.c,v 1.0 2026-10-17 18:23:51 clib2devs Exp $
+*/
+
+#ifndef _VEC_STRING_H
+#include "vec_string.h"
+#endif /* _VEC_STRING_H */
+
+void *
+vec_memrchr(const void *ptr, int val, size_t len) {
+#ifdef __ALTIVEC__
+    const unsigned char *start = ptr;
+    const unsigned char *m = start + len;
+    unsigned char c = val;
+    __vec_uchar cv;
+
+    if (len < VEC_MIN_LENGTH)
+        return __swar_memrchr(ptr, val, len);
+
+    /* This works just like vec_memchr(), only backwards: first the bytes
+       which follow the last block boundary... */
+    while (!VEC_ALIGNED(m)) {
+        if ((*--m) == c)
+            return (void *) m;
+    }
+
+    /* ...then all complete blocks... */
+    cv = __vec_splat_byte(c);
+
+    for (; m - start >= 16; m -= 16) {
+        if (vec_any_eq(vec_ld(-16, m), cv)) {
+            while ((*--m) != c)
+                ;
+
+            return (void *) m;
+        }
+    }
+
+    /* ...and whatever is left in front of them. */
+    while (m > start) {
+        if ((*--m) == c)
+            return (void *) m;
+    }
+
+    return NULL;
+#else
+    return __swar_memrchr(ptr, val, len);
+#endif /* __ALTIVEC__ */
+}
@@ -0,0 +1,47 @@
+/*
+ * $Id: vec_strchr.c,v 1.0 2026-10-17 18:16:45 clib2devs Exp $
+*/
+
+#ifndef _VEC_STRING_H
+#include "vec_string.h"
+#endif /* _VEC_STRING_H */
+
+char *
+vec_strchr(const char *s, int c) {
+#ifdef __ALTIVEC__
+    const unsigned char *blk = VEC_BLOCK(s);
+    const unsigned char *q = (const unsigned char *) s;
+    unsigned char ch = c;
+    __vec_uchar zero = vec_splat_u8(0);
+    __vec_uchar cv;
+    __vec_uchar hits;
+    __vec_uchar v;
+
+    if (ch == '\0')
+        return (char *) s + vec_strlen(s);
+
+    cv = __vec_splat_byte(ch);
+
+    /* Look for both the character and the end of the string; neither
+       must be found in front of the string. */
+    v = vec_ld(0, blk);
+    hits = vec_or((__vec_uchar) vec_cmpeq(v, zero), (__vec_uchar) vec_cmpeq(v, cv));
+    hits = vec_andc(hits, __vec_head_mask(s));
+
+    if (vec_all_eq(hits, zero)) {
+        do {
+            blk += 16;
+            v = vec_ld(0, blk);
+        } while (!vec_any_eq(v, zero) && !vec_any_eq(v, cv));
+
+        q = blk;
+    }
+
+    while ((*q) != '\0' && (*q) != ch)
+        q++;
+
+    return (*q) == ch ? (char *) q : NULL;
+#else
+    return __swar_strchr(s, c);
+#endif /* __ALTIVEC__ */
+}
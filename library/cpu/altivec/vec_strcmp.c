@@ -0,0 +1,68 @@
+/*
+ * $Id: vec_strcmp.c,v 1.0 2026-10-17 18:27:33 clib2devs Exp $
+*/
+
+#ifndef _VEC_STRING_H
+#include "vec_string.h"
+#endif /* _VEC_STRING_H */
+
+int
+vec_strcmp(const char *s1, const char *s2) {
+#ifdef __ALTIVEC__
+    const unsigned char *l = (const unsigned char *) s1;
+    const unsigned char *r = (const unsigned char *) s2;
+    __vec_uchar zero = vec_splat_u8(0);
+
+    /* Compare byte by byte until the first string is aligned. */
+    for (; !VEC_ALIGNED(l); l++, r++) {
+        if ((*l) != (*r) || (*l) == '\0')
+            return (*l) - (*r);
+    }
+
+    if (VEC_ALIGNED(r)) {
+        for (;;) {
+            __vec_uchar a = vec_ld(0, l);
+
+            if (vec_any_eq(a, zero) || vec_any_ne(a, vec_ld(0, r)))
+                break;
+
+            l += 16;
+            r += 16;
+        }
+    } else {
+        /* The second string is put together from two neighbouring blocks.
+           The next block is only loaded if the string does not end in the
+           current one, since it might not even be there. */
+        const unsigned char *rb = VEC_BLOCK(r);
+        __vec_uchar perm = vec_lvsl(0, r);
+        __vec_uchar skip = __vec_head_mask(r);
+        __vec_uchar prev = vec_ld(0, rb);
+
+        for (;;) {
+            __vec_uchar a = vec_ld(0, l);
+            __vec_uchar next;
+
+            if (vec_any_eq(a, zero) || vec_any_eq(vec_or(prev, skip), zero))
+                break;
+
+            next = vec_ld(16, rb);
+            if (vec_any_ne(a, vec_perm(prev, next, perm)))
+                break;
+
+            prev = next;
+            rb += 16;
+            l += 16;
+            r += 16;
+        }
+    }
+
+    /* The difference, or the end of either string, is within the
+       next 16 bytes. */
+    for (; (*l) == (*r) && (*l) != '\0'; l++, r++)
+        ;
+
+    return (*l) - (*r);
+#else
+    return __swar_strcmp(s1, s2);
+#endif /* __ALTIVEC__ */
+}
@@ -0,0 +1,93 @@
+/*
+ * $Id: vec_string.h,v 1.0 2026-10-17 18:10:37 clib2devs Exp $
+*/
+
+#ifndef _VEC_STRING_H
+#define _VEC_STRING_H
+
+/****************************************************************************/
+
+/* AltiVec string and memory kernels written in C. Each of them is built with
+   the vector unit if the compiler targets it (-maltivec) and falls back to the
+   portable word-at-a-time versions otherwise. The library only calls them on
+   CPUs with AltiVec, but the fallback lets the very same sources be compiled
+   and checked on any host (see test_programs/string/altivec).
+
+   The vector versions only ever load whole, aligned 16 byte blocks which hold
+   at least one byte that the caller allowed us to look at. Such a block never
+   crosses a page boundary. */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+
+#ifndef _STRING_SWAR_H
+#include "string_swar.h"
+#endif /* _STRING_SWAR_H */
+
+#ifdef __ALTIVEC__
+#include <altivec.h>
+#endif /* __ALTIVEC__ */
+
+/****************************************************************************/
+
+/* Below this many bytes the word-at-a-time versions are faster. */
+#define VEC_MIN_LENGTH 32
+
+#define VEC_BLOCK(p)   ((const unsigned char *) ((uintptr_t) (p) & ~(uintptr_t) 15))
+#define VEC_ALIGNED(p) ((((uintptr_t) (p)) & 15) == 0)
+
+/****************************************************************************/
+
+#ifdef __ALTIVEC__
+
+typedef __vector unsigned char __vec_uchar;
+typedef __vector signed int    __vec_int;
+
+/* All those bytes of the block which precede 'p' are 0xff, the others are
+   zero. Or'ed to a block, this hides the bytes in front of a string. */
+static __inline__ __vec_uchar
+__vec_head_mask(const void *p) {
+    return vec_perm((__vec_uchar) vec_splat_s8(-1), vec_splat_u8(0), vec_lvsr(0, (const unsigned char *) p));
+}
+
+static __inline__ __vec_uchar
+__vec_splat_byte(int c) {
+    union {
+        __vec_uchar v;
+        unsigned char b[16];
+    } u;
+
+    u.b[0] = c;
+
+    return vec_splat(u.v, 0);
+}
+
+static __inline__ __vec_int
+__vec_splat_int(int c) {
+    union {
+        __vec_int v;
+        int i[4];
+    } u;
+
+    u.i[0] = c;
+
+    return vec_splat(u.v, 0);
+}
+
+#endif /* __ALTIVEC__ */
+
+/****************************************************************************/
+
+extern size_t   vec_strlen(const char *s);
+extern char    *vec_strchr(const char *s, int c);
+extern char    *vec_strrchr(const char *s, int c);
+extern void    *vec_memchr(const void *ptr, int val, size_t len);
+extern void    *vec_memrchr(const void *ptr, int val, size_t len);
+extern int      vec_strcmp(const char *s1, const char *s2);
+extern int      vec_strncmp(const char *s1, const char *s2, size_t n);
+extern size_t   vec_wcslen(const wchar_t *s);
+extern wchar_t *vec_wmemchr(const wchar_t *ptr, wchar_t val, size_t len);
+extern wchar_t *vec_wmemset(wchar_t *ptr, wchar_t val, size_t len);
+
+#endif /* _VEC_STRING_H */
@@ -0,0 +1,37 @@
+/*
+ * $Id: vec_strlen.c,v 1.0 2026-10-17 18:14:02 clib2devs Exp $
+*/
+
+#ifndef _VEC_STRING_H
+#include "vec_string.h"
+#endif /* _VEC_STRING_H */
+
+size_t
+vec_strlen(const char *s) {
+#ifdef __ALTIVEC__
+    const unsigned char *blk = VEC_BLOCK(s);
+    const unsigned char *q = (const unsigned char *) s;
+    __vec_uchar zero = vec_splat_u8(0);
+    __vec_uchar v;
+
+    /* The bytes in front of the string must not be taken for its end. */
+    v = vec_or(vec_ld(0, blk), __vec_head_mask(s));
+
+    if (!vec_any_eq(v, zero)) {
+        do {
+            blk += 16;
+            v = vec_ld(0, blk);
+        } while (!vec_any_eq(v, zero));
+
+        q = blk;
+    }
+
+    /* The terminating NUL is somewhere in this block. */
+    while ((*q) != '\0')
+        q++;
+
+    return q - (const unsigned char *) s;
+#else
+    return __swar_strlen(s);
+#endif /* __ALTIVEC__ */
+}
@@ -0,0 +1,69 @@
+/*
+ * $Id: vec_strncmp.c,v 1.0 2026-10-17 18:31:12 clib2devs Exp $
+*/
+
+#ifndef _VEC_STRING_H
+#include "vec_string.h"
+#endif /* _VEC_STRING_H */
+
+int
+vec_strncmp(const char *s1, const char *s2, size_t n) {
+#ifdef __ALTIVEC__
+    const unsigned char *l = (const unsigned char *) s1;
+    const unsigned char *r = (const unsigned char *) s2;
+    __vec_uchar zero = vec_splat_u8(0);
+
+    if (n < VEC_MIN_LENGTH)
+        return __swar_strncmp(s1, s2, n);
+
+    /* This works just like vec_strcmp(), but never looks at more than
+       'n' characters. */
+    for (; !VEC_ALIGNED(l); l++, r++, n--) {
+        if ((*l) != (*r) || (*l) == '\0')
+            return (*l) - (*r);
+    }
+
+    if (VEC_ALIGNED(r)) {
+        for (; n >= 16; n -= 16) {
+            __vec_uchar a = vec_ld(0, l);
+
+            if (vec_any_eq(a, zero) || vec_any_ne(a, vec_ld(0, r)))
+                break;
+
+            l += 16;
+            r += 16;
+        }
+    } else {
+        const unsigned char *rb = VEC_BLOCK(r);
+        __vec_uchar perm = vec_lvsl(0, r);
+        __vec_uchar skip = __vec_head_mask(r);
+        __vec_uchar prev = vec_ld(0, rb);
+
+        for (; n >= 16; n -= 16) {
+            __vec_uchar a = vec_ld(0, l);
+            __vec_uchar next;
+
+            if (vec_any_eq(a, zero) || vec_any_eq(vec_or(prev, skip), zero))
+                break;
+
+            next = vec_ld(16, rb);
+            if (vec_any_ne(a, vec_perm(prev, next, perm)))
+                break;
+
+            prev = next;
+            rb += 16;
+            l += 16;
+            r += 16;
+        }
+    }
+
+    for (; n > 0; l++, r++, n--) {
+        if ((*l) != (*r) || (*l) == '\0')
+            return (*l) - (*r);
+    }
+
+    return 0;
+#else
+    return __swar_strncmp(s1, s2, n);
+#endif /* __ALTIVEC__ */
+}
@@ -0,0 +1,14 @@
+/*
+ * $Id: vec_strrchr.c,v 1.0 2026-10-17 18:18:20 clib2devs Exp $
+*/
+
+#ifndef _VEC_STRING_H
+#include "vec_string.h"
+#endif /* _VEC_STRING_H */
+
+char *
+vec_strrchr(const char *s, int c) {
+    /* The terminating NUL is part of the string, which is why it is
+       searched along with the other characters. */
+    return vec_memrchr(s, c, vec_strlen(s) + 1);
+}
@@ -0,0 +1,37 @@
+/*
+ * $Id: vec_wcslen.c,v 1.0 2026-10-17 18:34:48 clib2devs Exp $
+*/
+
+#ifndef _VEC_STRING_H
+#include "vec_string.h"
+#endif /* _VEC_STRING_H */
+
+size_t
+vec_wcslen(const wchar_t *s) {
+    const wchar_t *q = s;
+
+#ifdef __ALTIVEC__
+    /* A block holds four characters, provided that they are aligned. */
+    if ((((uintptr_t) s) & (sizeof(wchar_t) - 1)) == 0) {
+        const unsigned char *blk = VEC_BLOCK(s);
+        __vec_int zero = vec_splat_s32(0);
+        __vec_int v;
+
+        v = vec_or(vec_ld(0, (const int *) blk), (__vec_int) __vec_head_mask(s));
+
+        if (!vec_any_eq(v, zero)) {
+            do {
+                blk += 16;
+                v = vec_ld(0, (const int *) blk);
+            } while (!vec_any_eq(v, zero));
+
+            q = (const wchar_t *) blk;
+        }
+    }
+#endif /* __ALTIVEC__ */
+
+    while ((*q) != L'\0')
+        q++;
+
+    return q - s;
+}
@@ -0,0 +1,39 @@
+/*
+ * $Id: vec_wmemchr.c,v 1.0 2026-10-17 18:37:26 clib2devs Exp $
+*/
+
+#ifndef _VEC_STRING_H
+#include "vec_string.h"
+#endif /* _VEC_STRING_H */
+
+wchar_t *
+vec_wmemchr(const wchar_t *ptr, wchar_t val, size_t len) {
+    const wchar_t *end = ptr + len;
+
+#ifdef __ALTIVEC__
+    if (len >= VEC_MIN_LENGTH / sizeof(wchar_t) && (((uintptr_t) ptr) & (sizeof(wchar_t) - 1)) == 0) {
+        __vec_int cv = __vec_splat_int(val);
+
+        for (; !VEC_ALIGNED(ptr); ptr++) {
+            if ((*ptr) == val)
+                return (wchar_t *) ptr;
+        }
+
+        for (; end - ptr >= 4; ptr += 4) {
+            if (vec_any_eq(vec_ld(0, (const int *) ptr), cv)) {
+                while ((*ptr) != val)
+                    ptr++;
+
+                return (wchar_t *) ptr;
+            }
+        }
+    }
+#endif /* __ALTIVEC__ */
+
+    for (; ptr < end; ptr++) {
+        if ((*ptr) == val)
+            return (wchar_t *) ptr;
+    }
+
+    return NULL;
+}
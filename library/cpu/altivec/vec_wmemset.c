@@ -0,0 +1,37 @@
+/*
+ * $Id: vec_wmemset.c,v 1.0 2026-10-17 18:40:03 clib2devs Exp $
+*/
+
+#ifndef _VEC_STRING_H
+#include "vec_string.h"
+#endif /* _VEC_STRING_H */
+
+wchar_t *
+vec_wmemset(wchar_t *ptr, wchar_t val, size_t len) {
+    wchar_t *p = ptr;
+    wchar_t *end = ptr + len;
+
+#ifdef __ALTIVEC__
+    if (len >= VEC_MIN_LENGTH / sizeof(wchar_t) && (((uintptr_t) ptr) & (sizeof(wchar_t) - 1)) == 0) {
+        __vec_int v = __vec_splat_int(val);
+
+        for (; !VEC_ALIGNED(p); p++)
+            (*p) = val;
+
+        for (; end - p >= 8; p += 8) {
+            vec_st(v, 0, (int *) p);
+            vec_st(v, 16, (int *) p);
+        }
+
+        if (end - p >= 4) {
+            vec_st(v, 0, (int *) p);
+            p += 4;
+        }
+    }
+#endif /* __ALTIVEC__ */
+
+    for (; p < end; p++)
+        (*p) = val;
+
+    return ptr;
+}
@@ -1,5 +1,5 @@
 /*
- * $Id: fcntl_fcntl.c,v 1.20 2006-11-16 14:39:23 clib2devs Exp $
+ * $Id: fcntl_fcntl.c,v 1.21 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _FCNTL_HEADERS_H
@@ -136,8 +136,9 @@ fcntl(int file_descriptor, int cmd, ... /* int arg */) {
                 goto out;
             }
 
-            /* If this is a file, make sure that we don't hit a zero file handle. */
-            if (FLAG_IS_CLEAR(fd->fd_Flags, FDF_IS_SOCKET) && fd->fd_File == ZERO) {
+            /* If this is a file, make sure that we don't hit a zero file handle.
+               Pipes within the program have none. */
+            if (FLAG_IS_CLEAR(fd->fd_Flags, FDF_IS_SOCKET) && FLAG_IS_CLEAR(fd->fd_Flags, FDF_IS_RING_PIPE) && fd->fd_File == ZERO) {
                 __set_errno(EBADF);
                 goto out;
             }
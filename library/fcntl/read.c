@@ -1,5 +1,5 @@
 /*
- * $Id: fcntl_read.c,v 1.10 2006-01-08 12:04:22 clib2devs Exp $
+ * $Id: fcntl_read.c,v 1.11 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _FCNTL_HEADERS_H
@@ -73,6 +73,8 @@ read(int file_descriptor, void *buffer, size_t num_bytes) {
 
     result = num_bytes_read;
 
+    __COUNT_CALL(__CLIB2_CALL_READ, num_bytes_read);
+
 out:
     __fd_unlock(fd);
     __stdio_unlock();
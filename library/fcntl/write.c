@@ -1,5 +1,5 @@
 /*
- * $Id: fcntl_write.c,v 1.10 2006-01-08 12:04:22 clib2devs Exp $
+ * $Id: fcntl_write.c,v 1.11 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _FCNTL_HEADERS_H
@@ -73,6 +73,8 @@ write(int file_descriptor, const void *buffer, size_t num_bytes) {
 
     result = num_bytes_written;
 
+    __COUNT_CALL(__CLIB2_CALL_WRITE, num_bytes_written);
+
 out:
 
     __fd_unlock(fd);
@@ -106,6 +106,17 @@ extern int __get_default_file(int file_descriptor, long *file_ptr);
 
 /****************************************************************************/
 
+/*
+ * For as long as the program has only one thread, the library does not
+ * lock its streams, file descriptors or memory allocator. Locking is
+ * switched on for good by pthread_create(), popen(), spawnv() and
+ * setitimer(). If your program starts a process of its own which calls
+ * into the library, too, call this function before you start it.
+ */
+extern void __enable_locking(void);
+
+/****************************************************************************/
+
 /*
  * If your program is intended to be launched by the Internet superserver
  * (inetd) to run as a daemon, receiving and sending data through a network
@@ -181,6 +192,14 @@ extern char *__stdio_window_specification;
  */
 extern BOOL __disable_dos_requesters;
 
+/*
+ * If set to TRUE, pipe() and pipe2() will open a file through the "PIPE:"
+ * handler, as they used to, instead of passing the data through a buffer
+ * in memory. This is slower, but the file handle __get_default_file()
+ * returns for either end can then be handed to another program.
+ */
+extern BOOL __use_dos_pipes;
+
 /*
  * If set to TRUE, your program will disconnect itself from the shell it was
  * launched from and keep running in the background. This service is unavailable
@@ -495,7 +514,8 @@ struct _clib2
 	uint32 cpufamily;
     uint32 hasAltivec;
 
-	/* Memalign memory list */
+	/* No longer used: memalign() memory now comes from the allocator itself.
+	   The fields stay, so that the layout of this structure is unchanged. */
     void           *__memalign_pool;
     struct AVLNode *__memalign_tree;
 
@@ -141,7 +141,14 @@ typedef struct pthread_mutexattr pthread_mutexattr_t;
 
 struct pthread_mutex {
     int kind;
-    struct SignalSemaphore semaphore;
+    union {
+        struct SignalSemaphore semaphore;   /* No longer used, keeps the size of pthread_mutex_t */
+        struct {
+            volatile int state;             /* 0 = unlocked, 1 = locked, 2 = locked with waiters */
+            struct Task *owner;
+            int count;                      /* Recursion depth of the owner */
+        } lock;
+    } u;
     int incond;
 };
 
@@ -153,9 +160,9 @@ typedef struct pthread_mutex pthread_mutex_t;
 #define NULL_SEMAPHOREREQUEST {NULL_MINNODE, 0}
 #define NULL_SEMAPHORE {NULL_NODE, 0, NULL_MINLIST, NULL_SEMAPHOREREQUEST, 0, 0}
 
-#define PTHREAD_MUTEX_INITIALIZER {PTHREAD_MUTEX_NORMAL, NULL_SEMAPHORE}
-#define PTHREAD_RECURSIVE_MUTEX_INITIALIZER {PTHREAD_MUTEX_RECURSIVE, NULL_SEMAPHORE}
-#define PTHREAD_ERRORCHECK_MUTEX_INITIALIZER {PTHREAD_MUTEX_ERRORCHECK, NULL_SEMAPHORE}
+#define PTHREAD_MUTEX_INITIALIZER {PTHREAD_MUTEX_NORMAL, {NULL_SEMAPHORE}}
+#define PTHREAD_RECURSIVE_MUTEX_INITIALIZER {PTHREAD_MUTEX_RECURSIVE, {NULL_SEMAPHORE}}
+#define PTHREAD_ERRORCHECK_MUTEX_INITIALIZER {PTHREAD_MUTEX_ERRORCHECK, {NULL_SEMAPHORE}}
 
 //
 // Condition variables
@@ -169,13 +176,19 @@ typedef struct pthread_condattr pthread_condattr_t;
 
 struct pthread_cond {
     int pad1;
-    struct SignalSemaphore semaphore;
-    struct MinList waiters;
+    union {
+        struct SignalSemaphore semaphore;   /* No longer used, keeps the size of pthread_cond_t */
+        struct {
+            volatile int sequence;          /* Bumped by every signal or broadcast */
+            volatile int waiting;           /* Number of threads inside pthread_cond_wait() */
+        } wait;
+    } u;
+    struct MinList waiters;                 /* No longer used */
 };
 
 typedef struct pthread_cond pthread_cond_t;
 
-#define PTHREAD_COND_INITIALIZER {0, NULL_SEMAPHORE, NULL_MINLIST}
+#define PTHREAD_COND_INITIALIZER {0, {NULL_SEMAPHORE}, NULL_MINLIST}
 
 //
 // Barriers
@@ -266,6 +279,7 @@ int pthread_setcancelstate(int state, int *oldstate);
 int pthread_setcanceltype(int type, int *oldtype);
 void pthread_testcancel(void);
 int pthread_once(pthread_once_t *once_control, void (*init_routine)(void));
+int pthread_getcpuclockid(pthread_t thread, clockid_t *clock_id);
 
 #define pthread_sigmask(blocktype, mask_ptr, unused1) sigprocmask(blocktype, mask_ptr, unused1);
 
@@ -20,7 +20,9 @@ enum file_action_t
 	file_action_close,
 	file_action_set_blocking,
 	file_action_set_async,
-	file_action_examine
+	file_action_examine,
+	file_action_pread,		/* Read from fam_Offset, don't move the file position */
+	file_action_pwrite		/* Write to fam_Offset, don't move the file position */
 };
 
 /****************************************************************************/
@@ -32,7 +34,7 @@ struct file_action_message
 	char *					fam_Data;		/* Where to read/write the data */
 	int						fam_Size;		/* How much data to write */
 
-    int64_t				    fam_Offset;		/* The seek offset */
+    int64_t				    fam_Offset;		/* The seek offset, or where to read/write */
 	int						fam_Mode;		/* The seek mode */
 
 	int						fam_Arg;		/* Action parameters, e.g. whether or not
@@ -120,6 +122,8 @@ struct _fd
 #define FDF_PATH_ONLY   	(1UL<<16)	/* Allowed operation on file are only statistics one */
 #define FDF_STDIN_AS_SOCKET	(1UL<<17)	/* STDIN is used in a socket stream */
 #define FDF_STDIN_READ_MARK	(1UL<<18)	/* STDIN was marked as first read */
+#define FDF_IS_RING_PIPE	(1UL<<19)	/* This is an in-process pipe or socket
+										   pair, with no file handle behind it */
 
 /****************************************************************************/
 
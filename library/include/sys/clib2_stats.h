@@ -0,0 +1,67 @@
+/*
+ * $Id: clib2_stats.h,v 1.0 2026-10-17 12:00:00 clib2devs Exp $
+*/
+
+#ifndef _SYS_CLIB2_STATS_H
+#define _SYS_CLIB2_STATS_H
+
+#ifndef _STDINT_H
+#include <stdint.h>
+#endif /* _STDINT_H */
+
+#include <features.h>
+
+__BEGIN_DECLS
+
+/* The locks inside the library whose use is counted. */
+enum __clib2_lock_site
+{
+	__CLIB2_LOCK_MEMORY,			/* Memory allocator (__memory_lock) */
+	__CLIB2_LOCK_STDIO,				/* File tables (__stdio_lock) */
+	__CLIB2_LOCK_FD,				/* File descriptors (__fd_lock) */
+	__CLIB2_LOCK_IOB,				/* Buffered files (flockfile) */
+	__CLIB2_LOCK_LOCALE,			/* Locale data (__locale_lock) */
+	__CLIB2_LOCK_PTHREAD_MUTEX,		/* pthread mutexes */
+
+	__CLIB2_NUM_LOCK_SITES
+};
+
+/* The library functions whose calls and bytes are counted. */
+enum __clib2_call_site
+{
+	__CLIB2_CALL_READ,				/* read(), bytes read */
+	__CLIB2_CALL_WRITE,				/* write(), bytes written */
+	__CLIB2_CALL_MALLOC,			/* malloc(), bytes requested */
+	__CLIB2_CALL_FREE,				/* free(), usable size of the memory released */
+
+	__CLIB2_NUM_CALL_SITES
+};
+
+struct __clib2_lock_stats
+{
+	uint64_t ls_Acquisitions;		/* How often the lock was obtained */
+	uint64_t ls_Contended;			/* How often somebody else had it first */
+	uint64_t ls_WaitTotal;			/* Nanoseconds spent waiting for it */
+	uint64_t ls_WaitMax;			/* Longest single wait, in nanoseconds */
+};
+
+struct __clib2_call_stats
+{
+	uint64_t cs_Calls;
+	uint64_t cs_Bytes;
+};
+
+struct __clib2_stats
+{
+	struct __clib2_lock_stats	s_Locks[__CLIB2_NUM_LOCK_SITES];
+	struct __clib2_call_stats	s_Calls[__CLIB2_NUM_CALL_SITES];
+};
+
+/* Only a library built with STATS=yes counts anything. Otherwise these
+   fail with errno set to ENOSYS. */
+extern int __clib2_stats_snapshot(struct __clib2_stats *stats);
+extern int __clib2_stats_reset(void);
+
+__END_DECLS
+
+#endif /* _SYS_CLIB2_STATS_H */
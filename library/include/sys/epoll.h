@@ -0,0 +1,60 @@
+/*
+ * $Id: epoll.h,v 1.0 2026-10-17 12:00:00 clib2devs Exp $
+*/
+
+#ifndef _SYS_EPOLL_H
+#define _SYS_EPOLL_H
+
+#ifndef _STDINT_H
+#include <stdint.h>
+#endif /* _STDINT_H */
+
+#include <features.h>
+
+__BEGIN_DECLS
+
+/* Flags for epoll_create1(). */
+#define EPOLL_CLOEXEC   02000000        /* Accepted, but has no effect.  */
+
+/* Operations for epoll_ctl(). */
+#define EPOLL_CTL_ADD   1               /* Add a file descriptor to the interest list.  */
+#define EPOLL_CTL_DEL   2               /* Remove a file descriptor from the interest list.  */
+#define EPOLL_CTL_MOD   3               /* Change the events a file descriptor is watched for.  */
+
+/* Event types; these have the same values as the poll() events. */
+#define EPOLLIN         0x001           /* There is data to read.  */
+#define EPOLLPRI        0x002           /* There is urgent data to read.  */
+#define EPOLLOUT        0x004           /* Writing now will not block.  */
+#define EPOLLERR        0x008           /* Error condition.  */
+#define EPOLLHUP        0x010           /* Hung up.  */
+#define EPOLLRDNORM     0x040           /* Normal data may be read.  */
+#define EPOLLRDBAND     0x080           /* Priority data may be read.  */
+#define EPOLLWRNORM     0x100           /* Writing now will not block.  */
+#define EPOLLWRBAND     0x200           /* Priority data may be written.  */
+
+/* Input flags for epoll_ctl(). */
+#define EPOLLONESHOT    (1U << 30)      /* Report only once, until EPOLL_CTL_MOD.  */
+#define EPOLLET         (1U << 31)      /* Report only when the descriptor becomes ready.  */
+
+typedef union epoll_data
+{
+        void *ptr;
+        int fd;
+        uint32_t u32;
+        uint64_t u64;
+} epoll_data_t;
+
+struct epoll_event
+{
+        uint32_t events;        /* Epoll events.  */
+        epoll_data_t data;      /* User data variable.  */
+};
+
+extern int epoll_create(int size);
+extern int epoll_create1(int flags);
+extern int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event);
+extern int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout);
+
+__END_DECLS
+
+#endif /* _SYS_EPOLL_H */
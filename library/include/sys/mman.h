@@ -26,6 +26,12 @@ __BEGIN_DECLS
 #define MAP_TYPE        0x0f            /* Mask for type of mapping */
 #define MAP_FIXED       0x10            /* Interpret addr exactly */
 #define MAP_ANONYMOUS   0x20            /* don't use a file */
+#define MAP_ANON        MAP_ANONYMOUS
+
+/* Flags for `msync'.  */
+#define MS_ASYNC        0x1             /* Sync memory asynchronously */
+#define MS_INVALIDATE   0x2             /* Invalidate the caches */
+#define MS_SYNC         0x4             /* Synchronous memory sync */
 
 extern void *mmap(void *addr, size_t len, int prot, int flags, int fd, off_t offset);
 extern int munmap(void *map, size_t length);
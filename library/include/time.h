@@ -24,8 +24,8 @@ __BEGIN_DECLS
 
 #define CLOCK_REALTIME (clockid_t)0
 #define CLOCK_MONOTONIC (clockid_t)1
-#define CLOCK_PROCESS_CPUTIME_ID (clockid_t)2 /* Not used in clock_ functions yet */
-#define CLOCK_THREAD_CPUTIME_ID (clockid_t)3  /* Not used in clock_ functions yet */
+#define CLOCK_PROCESS_CPUTIME_ID (clockid_t)2
+#define CLOCK_THREAD_CPUTIME_ID (clockid_t)3
 
 #define _CLOCK_T_ unsigned long long /* clock() */
 #define _TIME_T_ long                /* time() */
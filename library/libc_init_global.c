@@ -26,6 +26,10 @@
 #include "stdlib_constructor.h"
 #endif /* _STDLIB_CONSTRUCTOR_H */
 
+#ifndef _STRING_HEADERS_H
+#include "string_headers.h"
+#endif /* _STRING_HEADERS_H */
+
 #include <proto/elf.h>
 #include <fenv.h>
 
@@ -131,22 +135,6 @@ reent_init() {
         /* Get the current task pointer */
         __global_clib2->self = (struct Process *) FindTask(0);
 
-        /* Init memalign list */
-        __global_clib2->__memalign_pool = AllocSysObjectTags(ASOT_ITEMPOOL,
-                                                             ASO_NoTrack, FALSE,
-                                                             ASO_MemoryOvr, MEMF_PRIVATE,
-                                                             ASOITEM_MFlags, MEMF_PRIVATE,
-                                                             ASOITEM_ItemSize, sizeof(struct MemalignEntry),
-                                                             ASOITEM_BatchSize, 408,
-                                                             ASOITEM_GCPolicy, ITEMGC_AFTERCOUNT,
-                                                             ASOITEM_GCParameter, 1000,
-                                                             TAG_DONE);
-        if (!__global_clib2->__memalign_pool) {
-            goto out;
-        }
-        /* Set memalign tree to NULL */
-        __global_clib2->__memalign_tree = NULL;
-
         /* Check is SYSV library is available in the system */
         __global_clib2->haveShm = FALSE;
         __SysVBase = OpenLibrary("sysvipc.library", 53);
@@ -186,6 +174,9 @@ reent_init() {
         __global_clib2->hasAltivec = 0;
 #endif
 
+        /* Now that we know the CPU, choose the string functions to use */
+        __select_string_functions();
+
         /*
          * Next: Get Elf handle associated with the currently running process.
          * ElfBase is opened in crtbegin.c that is called before the
@@ -215,12 +206,6 @@ out:
             FreeVec(__global_clib2->wide_status);
             __global_clib2->wide_status = NULL;
         }
-        /* Free memalign pool object */
-        if (__global_clib2->__memalign_pool) {
-            FreeSysObject(ASOT_ITEMPOOL, __global_clib2->__memalign_pool);
-            __global_clib2->__memalign_pool = NULL;
-        }
-
         /* Remove timer tasks */
         if (__global_clib2->tmr_real_task != NULL) {
             struct Hook h = {{NULL, NULL}, (HOOKFUNC) hook_function, NULL, NULL};
@@ -270,11 +255,6 @@ reent_exit() {
 
     /* Free global clib structure */
     if (__global_clib2) {
-        /* Free memalign stuff */
-        if (&__global_clib2->__memalign_pool) {
-            FreeSysObject(ASOT_ITEMPOOL, __global_clib2->__memalign_pool);
-        }
-
         if (__ISysVIPC != NULL) {
             DropInterface((struct Interface *) __ISysVIPC);
             __ISysVIPC = NULL;
@@ -322,18 +302,26 @@ void enableAltivec(void) {
         __global_clib2->hasAltivec = 1;
     else
         __global_clib2->hasAltivec = 0;
+
+    __select_string_functions();
 }
 
 void disableAltivec(void) {
     __global_clib2->hasAltivec = 0;
+
+    __select_string_functions();
 }
 
 void enableOptimizedFunctions(void) {
     __global_clib2->optimizedCPUFunctions = 1;
+
+    __select_string_functions();
 };
 
 void disableOptimizedFunctions(void) {
     __global_clib2->optimizedCPUFunctions = 0;
+
+    __select_string_functions();
 };
 
 int *__mb_cur_max(void) {
@@ -1,5 +1,5 @@
 /*
- * $Id: locale_init_exit.c,v 1.15 2006-01-08 12:04:23 clib2devs Exp $
+ * $Id: locale_init_exit.c,v 1.17 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _LOCALE_HEADERS_H
@@ -10,6 +10,10 @@
 #include "stdlib_constructor.h"
 #endif /* _STDLIB_CONSTRUCTOR_H */
 
+#ifndef _TIME_HEADERS_H
+#include "time_headers.h"
+#endif /* _TIME_HEADERS_H */
+
 #include <proto/diskfont.h>
 
 struct Library *NOCOMMON __LocaleBase;
@@ -71,6 +75,9 @@ void __locale_exit(void)
 		{
 			CloseLocale(__default_locale);
 			__default_locale = NULL;
+
+			/* The clock has to pick up the time zone again. */
+			__invalidate_clock();
 		}
 		if (__ILocale != NULL)
 		{
@@ -137,6 +144,9 @@ int __locale_init(void)
 		DECLARE_LOCALEBASE();
 
 		__default_locale = OpenLocale(NULL);
+
+		/* The clock has to pick up the time zone again. */
+		__invalidate_clock();
 	}
 
 	if (__default_locale != NULL)
@@ -154,8 +164,28 @@ static struct SignalSemaphore * locale_lock;
 
 void __locale_lock(void)
 {
+#if defined(CLIB2_STATS)
+	uint64 start;
+
+	if (locale_lock != NULL)
+	{
+		if (AttemptSemaphore(locale_lock))
+		{
+			__stats_count_lock(__CLIB2_LOCK_LOCALE, FALSE, 0);
+		}
+		else
+		{
+			start = rdtsc();
+
+			ObtainSemaphore(locale_lock);
+
+			__stats_count_lock(__CLIB2_LOCK_LOCALE, TRUE, rdtsc() - start);
+		}
+	}
+#else
 	if (locale_lock != NULL)
 		ObtainSemaphore(locale_lock);
+#endif /* CLIB2_STATS */
 }
 
 void __locale_unlock(void)
@@ -1,5 +1,5 @@
 /*
- * $Id: resource_getrusage.c,v 1.0 2021-01-19 16:35:27 clib2devs Exp $
+ * $Id: resource_getrusage.c,v 1.1 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _TIME_HEADERS_H
@@ -28,9 +28,8 @@ getrusage(int who, struct rusage *rusage) {
     SHOWVALUE(who);
     SHOWPOINTER(rusage);
 
-    long clock[2];
+    struct timespec used;
     int status = 0;
-    struct TimerIFace *ITimer = __ITimer;
 
     if (__global_clib2 == NULL) {
         __set_errno(EINVAL);
@@ -39,19 +38,16 @@ getrusage(int who, struct rusage *rusage) {
     }
 
     switch (who) {
-        case RUSAGE_SELF: {
-                GetSysTime((struct TimeVal *) clock);
-                clock[0] -= __global_clib2->clock.Seconds;
-                clock[1] -= __global_clib2->clock.Microseconds;
-                if (clock[1] < 0) {
-                    clock[1] += 1000000;
-                    clock[0]--;
-                }
+        case RUSAGE_SELF:
+        case RUSAGE_THREAD:
+            /* A task whose own CPU time is not counted gets that of the
+               whole program. */
+            if (who == RUSAGE_SELF || !__get_cpu_time(CLOCK_THREAD_CPUTIME_ID, &used))
+                __get_cpu_time(CLOCK_PROCESS_CPUTIME_ID, &used);
 
-                memcpy(rusage, &__global_clib2->ru, sizeof(struct rusage));
-                rusage->ru_utime.tv_sec = clock[0];
-                rusage->ru_utime.tv_usec = clock[1];
-            }
+            memcpy(rusage, &__global_clib2->ru, sizeof(struct rusage));
+            rusage->ru_utime.tv_sec = used.tv_sec;
+            rusage->ru_utime.tv_usec = used.tv_nsec / 1000;
             break;
 
         case RUSAGE_CHILDREN:
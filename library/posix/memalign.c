@@ -1,37 +1,18 @@
 /*
- * $Id: malloc_memalign.c,v 1.0 2021-01-10 10:52:18 clib2devs Exp $
+ * $Id: malloc_memalign.c,v 1.1 2026-10-17 10:52:18 clib2devs Exp $
 */
 
 #ifndef _STDLIB_HEADERS_H
 #include "stdlib_headers.h"
 #endif /* _STDLIB_HEADERS_H */
 
-#ifndef _STDIO_HEADERS_H
-#include "stdio_headers.h"
-#endif /* _STDIO_HEADERS_H */
+#ifndef _STDLIB_MEMORY_H
+#include "stdlib_memory.h"
+#endif /* _STDLIB_MEMORY_H */
 
 #include <stdint.h>
 #include <malloc.h>
 
-int32
-MemalignAVLNodeComp(struct AVLNode *avlnode1, struct AVLNode *avlnode2)
-{
-    struct MemalignEntry *e1, *e2;
-
-    e1 = (struct MemalignEntry *)avlnode1;
-    e2 = (struct MemalignEntry *)avlnode2;
-
-    return (int32)((uint32)e1->me_Exact - (uint32)e2->me_Exact);
-}
-
-int32
-MemalignAVLKeyComp(struct AVLNode *avlnode1, AVLKey key2)
-{
-    struct MemalignEntry *e1 = (struct MemalignEntry *)avlnode1;
-
-    return (int32)((uint32)e1->me_Exact - (uint32)key2);
-}
-
 static inline BOOL
 isPowerOfTwo(size_t alignment)
 {
@@ -54,37 +35,17 @@ memalign(size_t alignment, size_t size)
         goto out;
     }
 
-    if (__global_clib2->__memalign_pool == NULL) {
-        __set_errno(ENOSYS);
-        goto out;
-    }
-    //size = ((size + alignment - 1) / alignment) * alignment;
+    /* The allocator tags the chunk itself, so free() can tell aligned
+     * pointers apart without any further bookkeeping. */
+    __memory_lock();
 
-    result = AllocVecTags(size, AVT_Type, MEMF_SHARED, AVT_Alignment, alignment, TAG_END);
-    if (result == NULL) {
-        __set_errno(ENOMEM);
-        goto out;
-    }
+    if (__wof_allocator != NULL)
+        result = wof_alloc_aligned(__wof_allocator, alignment, size);
 
-    struct MemalignEntry *l = ItemPoolAlloc(__global_clib2->__memalign_pool);
-    if (l == NULL)
-    {
-        FreeVec(result);
-        __set_errno(ENOMEM);
-        result = NULL;
-        goto out;
-    }
-    /* Set MemalignEntry node stuff */
-    l->me_Exact = result;
+    __memory_unlock();
 
-    if (NULL != AVL_AddNode(&__global_clib2->__memalign_tree, &l->me_AvlNode, MemalignAVLNodeComp))
-    {
-        FreeVec(result);
-        ItemPoolFree(__global_clib2->__memalign_pool, l);
+    if (result == NULL)
         __set_errno(ENOMEM);
-        result = NULL;
-        goto out;
-    }
 
 out:
     RETURN(result);
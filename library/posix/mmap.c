@@ -1,18 +1,289 @@
 /*
- * $Id: mman_mmap.c,v 1.0 2021-01-18 20:17:27 clib2devs Exp $
+ * $Id: mman_mmap.c,v 1.2 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _UNISTD_HEADERS_H
 #include "unistd_headers.h"
 #endif /* _UNISTD_HEADERS_H */
 
+#ifndef _POSIX_HEADERS_H
+#include "posix_headers.h"
+#endif /* _POSIX_HEADERS_H */
+
+#ifndef _STDLIB_CONSTRUCTOR_H
+#include "stdlib_constructor.h"
+#endif /* _STDLIB_CONSTRUCTOR_H */
+
 #include <sys/mman.h>
 
-void *
-mmap(void *addr, size_t len, int prot, int flags, int fd, off_t offset)
+/* AmigaOS does not let us catch page faults in user code, so a mapping cannot
+ * be filled on first access. Instead the data is read straight into page
+ * aligned memory in large windows, without clearing it first, and only the
+ * part beyond the end of the file is zeroed.
+ *
+ * Shared, writable mappings keep a copy of the data as it was read from the
+ * file. msync() and munmap() compare every page against that copy and write
+ * back only the pages which differ.
+ */
+
+#define MMAP_READ_WINDOW (1024 * 1024)
+
+/* Mappings which are still alive, sorted by address. */
+static struct MinList mmap_list;
+static struct SignalSemaphore *mmap_semaphore;
+
+size_t __mmap_page_size = 4096;
+
+void __mmap_lock(void) {
+    if (mmap_semaphore != NULL)
+        ObtainSemaphore(mmap_semaphore);
+}
+
+void __mmap_unlock(void) {
+    if (mmap_semaphore != NULL)
+        ReleaseSemaphore(mmap_semaphore);
+}
+
+struct MappedRegion *
+__mmap_find_region(const void *address) {
+    struct MappedRegion *mr;
+    const UBYTE *p = address;
+
+    for (mr = (struct MappedRegion *) mmap_list.mlh_Head;
+         mr->mr_Node.mln_Succ != NULL;
+         mr = (struct MappedRegion *) mr->mr_Node.mln_Succ) {
+        if (p < mr->mr_Address)
+            break;
+
+        if (p < mr->mr_Address + mr->mr_Length)
+            return mr;
+    }
+
+    return NULL;
+}
+
+/* Read or write mapped data at the given file position. If no private file
+   handle could be opened, e.g. because the file is locked exclusively, the
+   descriptor's own handle is used and its file position is restored. */
+static LONG
+region_io(struct MappedRegion *mr, BOOL write, off_t position, UBYTE *data, size_t size) {
+    struct fd *fd = NULL;
+    int64_t saved_position = -1;
+    LONG result = -1;
+    BPTR file;
+
+    if (mr->mr_File != ZERO) {
+        file = mr->mr_File;
+    } else {
+        fd = __get_file_descriptor(mr->mr_Descriptor);
+        if (fd == NULL) {
+            __set_errno(EBADF);
+            goto out;
+        }
+
+        __fd_lock(fd);
+
+        file = __resolve_fd_file(fd);
+        saved_position = GetFilePosition(file);
+    }
+
+    if (ChangeFilePosition(file, position, OFFSET_BEGINNING) == CHANGE_FILE_ERROR) {
+        __set_errno(__translate_io_error_to_errno(IoErr()));
+        goto out;
+    }
+
+    if (write)
+        result = Write(file, data, size);
+    else
+        result = Read(file, data, size);
+
+    if (result < 0)
+        __set_errno(__translate_io_error_to_errno(IoErr()));
+
+out:
+
+    if (fd != NULL) {
+        if (saved_position >= 0)
+            ChangeFilePosition(file, saved_position, OFFSET_BEGINNING);
+
+        __fd_unlock(fd);
+    }
+
+    return result;
+}
+
+/* Write back the modified pages in the range [first_page..last_page]. The caller must hold the mmap lock. */
+int
+__mmap_write_back(struct MappedRegion *mr, size_t first_page, size_t last_page) {
+    size_t page_size = __mmap_page_size;
+    int result = OK;
+    size_t i;
+
+    if (mr->mr_Descriptor < 0 || !(mr->mr_Flags & MAP_SHARED) || !(mr->mr_Prot & PROT_WRITE))
+        return OK;
+
+    for (i = first_page; i <= last_page; i++) {
+        size_t start = i * page_size;
+        size_t size;
+
+        if (!mr->mr_Pages[i].mp_Mapped || start >= mr->mr_FileLength)
+            continue;
+
+        /* Never grow the file; the tail of the last page is not backed by it */
+        size = mr->mr_FileLength - start;
+        if (size > page_size)
+            size = page_size;
+
+        if (memcmp(mr->mr_Address + start, mr->mr_Shadow + start, size) == 0)
+            continue;
+
+        SHOWVALUE(i);
+
+        if (region_io(mr, TRUE, mr->mr_Offset + start, mr->mr_Address + start, size) != (LONG) size) {
+            result = ERROR;
+            continue;
+        }
+
+        memcpy(mr->mr_Shadow + start, mr->mr_Address + start, size);
+    }
+
+    return result;
+}
+
+static void
+free_region(struct MappedRegion *mr) {
+    Remove((struct Node *) mr);
+
+    if (mr->mr_File != ZERO)
+        Close(mr->mr_File);
+
+    FreeVec(mr->mr_Address);
+    FreeVec(mr->mr_Shadow);
+    FreeVec(mr->mr_Pages);
+    FreeVec(mr);
+}
+
+/* Drop the pages in the range [first_page..last_page] after writing them back. The
+   region goes away once no page is left. The caller must hold the mmap lock. */
+void
+__mmap_release_pages(struct MappedRegion *mr, size_t first_page, size_t last_page) {
+    size_t i;
+
+    __mmap_write_back(mr, first_page, last_page);
+
+    for (i = first_page; i <= last_page; i++) {
+        if (mr->mr_Pages[i].mp_Mapped) {
+            mr->mr_Pages[i].mp_Mapped = FALSE;
+            mr->mr_PagesMapped--;
+        }
+    }
+
+    if (mr->mr_PagesMapped == 0)
+        free_region(mr);
+}
+
+CLIB_CONSTRUCTOR(mmap_init)
 {
-    (void) (prot);
-    (void) (flags);
+    BOOL success = FALSE;
+    ULONG page_size = 0;
+
+    ENTER();
+
+    NewList((struct List *) &mmap_list);
+
+    GetCPUInfoTags(GCIT_ExecPageSize, (ULONG) &page_size, TAG_DONE);
+    if (page_size >= sizeof(ULONG) && (page_size & (page_size - 1)) == 0)
+        __mmap_page_size = page_size;
+
+    mmap_semaphore = __create_semaphore();
+    if (mmap_semaphore == NULL)
+        goto out;
+
+    success = TRUE;
+
+out:
+
+    SHOWVALUE(success);
+    LEAVE();
+
+    if (success)
+        CONSTRUCTOR_SUCCEED();
+    else
+        CONSTRUCTOR_FAIL();
+}
+
+CLIB_DESTRUCTOR(mmap_exit)
+{
+    ENTER();
+
+    /* Mappings which were never unmapped still get their changes written back */
+    if (mmap_list.mlh_Head != NULL) {
+        while (NOT IsMinListEmpty(&mmap_list)) {
+            struct MappedRegion *mr = (struct MappedRegion *) mmap_list.mlh_Head;
+
+            __mmap_release_pages(mr, 0, mr->mr_NumPages - 1);
+        }
+    }
+
+    __delete_semaphore(mmap_semaphore);
+    mmap_semaphore = NULL;
+
+    LEAVE();
+}
+
+/* Try to open a file handle of our own, so that neither the file position of
+   the descriptor nor closing it later have any effect on the mapping. */
+static int
+open_mapped_file(struct MappedRegion *mr, int fd, int prot, int flags) {
+    struct fd *fde;
+    int result = ERROR;
+    BPTR lock;
+
+    fde = __get_file_descriptor(fd);
+    if (fde == NULL) {
+        __set_errno(EBADF);
+        goto out;
+    }
+
+    if (FLAG_IS_SET(fde->fd_Flags, FDF_IS_SOCKET) || FLAG_IS_SET(fde->fd_Flags, FDF_IS_DIRECTORY)) {
+        __set_errno(ENODEV);
+        goto out;
+    }
+
+    if (FLAG_IS_CLEAR(fde->fd_Flags, FDF_READ) ||
+        ((flags & MAP_SHARED) && (prot & PROT_WRITE) && FLAG_IS_CLEAR(fde->fd_Flags, FDF_WRITE))) {
+        __set_errno(EACCES);
+        goto out;
+    }
+
+    __fd_lock(fde);
+
+    lock = DupLockFromFH(__resolve_fd_file(fde));
+    if (lock != ZERO) {
+        mr->mr_File = OpenFromLock(lock);
+        if (mr->mr_File == ZERO)
+            UnLock(lock);
+    }
+
+    __fd_unlock(fde);
+
+    mr->mr_Descriptor = fd;
+
+    result = OK;
+
+out:
+
+    return result;
+}
+
+void *
+mmap(void *addr, size_t len, int prot, int flags, int fd, off_t offset) {
+    struct MappedRegion *mr = NULL;
+    struct MappedRegion *next;
+    void *result = MAP_FAILED;
+    size_t page_size = __mmap_page_size;
+    size_t num_pages;
+    size_t i;
 
     ENTER();
 
@@ -23,56 +294,122 @@ mmap(void *addr, size_t len, int prot, int flags, int fd, off_t offset)
     SHOWVALUE(fd);
     SHOWVALUE(offset);
 
-    if (fd > 0)
-    {
-        if (addr != NULL)
-        {
-            if ((addr = calloc(1, len)))
-            {
-                lseek(fd, offset, SEEK_SET);
-                read(fd, addr, len);
-            }
+    /* The address is only a hint, which we are free to ignore */
+    (void) (addr);
 
-            if (!addr)
-            {
-                __set_errno(ENOMEM);
-                RETURN(NULL);
-                return NULL;
-            }
+    if (len == 0 || offset < 0 || (offset & (page_size - 1)) != 0 || len > (size_t) -page_size) {
+        __set_errno(EINVAL);
+        goto out;
+    }
 
-            RETURN(addr);
-            return addr;
-        }
-        else
-        {
-            void *data = calloc(1, len);
-            if (data != NULL)
-            {
-                lseek(fd, offset, SEEK_SET);
-                read(fd, data, len);
-            }
+    if ((flags & MAP_TYPE) != MAP_SHARED && (flags & MAP_TYPE) != MAP_PRIVATE) {
+        __set_errno(EINVAL);
+        goto out;
+    }
+
+    if (flags & MAP_FIXED) {
+        __set_errno(ENOTSUP);
+        goto out;
+    }
 
-            if (!data)
-            {
+    num_pages = (len + page_size - 1) / page_size;
+
+    mr = AllocVecTags(sizeof(*mr), AVT_Type, MEMF_SHARED, AVT_ClearWithValue, 0, TAG_DONE);
+    if (mr == NULL) {
+        __set_errno(ENOMEM);
+        goto out;
+    }
+
+    mr->mr_Descriptor = -1;
+    mr->mr_Length = num_pages * page_size;
+    mr->mr_Offset = offset;
+    mr->mr_Prot = prot;
+    mr->mr_Flags = flags;
+    mr->mr_NumPages = num_pages;
+    mr->mr_PagesMapped = num_pages;
+
+    mr->mr_Pages = AllocVecTags(num_pages * sizeof(struct MappedPage), AVT_Type, MEMF_SHARED, AVT_ClearWithValue, 0, TAG_DONE);
+    mr->mr_Address = AllocVecTags(mr->mr_Length, AVT_Type, MEMF_SHARED, AVT_Alignment, page_size, TAG_DONE);
+    if (mr->mr_Pages == NULL || mr->mr_Address == NULL) {
+        __set_errno(ENOMEM);
+        goto out;
+    }
+
+    for (i = 0; i < num_pages; i++)
+        mr->mr_Pages[i].mp_Mapped = TRUE;
+
+    if (flags & MAP_ANONYMOUS) {
+        memset(mr->mr_Address, 0, mr->mr_Length);
+    } else {
+        BOOL track = (flags & MAP_SHARED) && (prot & PROT_WRITE);
+        size_t filled = 0;
+
+        if (open_mapped_file(mr, fd, prot, flags) != OK)
+            goto out;
+
+        if (track) {
+            mr->mr_Shadow = AllocVecTags(len, AVT_Type, MEMF_SHARED, TAG_DONE);
+            if (mr->mr_Shadow == NULL) {
                 __set_errno(ENOMEM);
-                RETURN(NULL);
-                return NULL;
+                goto out;
             }
-            RETURN(data);
-            return data;
-        }
-    }
-    else
-    {
-        if ((addr = calloc(1, len))) {
-            RETURN(addr);
-            return addr;
         }
-        else
-        {
-            __set_errno(ENOMEM);
-            RETURN(NULL);
-            return NULL;
+
+        /* Read in large windows and copy each one while it is still in the cache */
+        while (filled < len) {
+            size_t window = len - filled;
+            LONG num_read;
+
+            if (window > MMAP_READ_WINDOW)
+                window = MMAP_READ_WINDOW;
+
+            num_read = region_io(mr, FALSE, offset + filled, mr->mr_Address + filled, window);
+            if (num_read < 0)
+                goto out;
+
+            if (track)
+                memcpy(mr->mr_Shadow + filled, mr->mr_Address + filled, num_read);
+
+            filled += num_read;
+
+            if ((size_t) num_read < window)
+                break;
         }
+
+        mr->mr_FileLength = filled;
+
+        /* Whatever lies beyond the end of the file reads as zero */
+        memset(mr->mr_Address + filled, 0, mr->mr_Length - filled);
     }
-}
\ No newline at end of file
+
+    __mmap_lock();
+
+    for (next = (struct MappedRegion *) mmap_list.mlh_Head;
+         next->mr_Node.mln_Succ != NULL;
+         next = (struct MappedRegion *) next->mr_Node.mln_Succ) {
+        if (next->mr_Address > mr->mr_Address)
+            break;
+    }
+
+    Insert((struct List *) &mmap_list, (struct Node *) mr, (struct Node *) next->mr_Node.mln_Pred);
+
+    __mmap_unlock();
+
+    result = mr->mr_Address;
+    mr = NULL;
+
+out:
+
+    if (mr != NULL) {
+        if (mr->mr_File != ZERO)
+            Close(mr->mr_File);
+
+        FreeVec(mr->mr_Address);
+        FreeVec(mr->mr_Shadow);
+        FreeVec(mr->mr_Pages);
+        FreeVec(mr);
+    }
+
+    RETURN(result);
+    return result;
+}
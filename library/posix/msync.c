@@ -1,18 +1,67 @@
 /*
- * $Id: mman_mmap.c,v 1.0 2021-01-18 20:17:27 clib2devs Exp $
+ * $Id: mman_msync.c,v 1.1 2026-10-17 14:02:11 clib2devs Exp $
 */
 
 #ifndef _UNISTD_HEADERS_H
 #include "unistd_headers.h"
 #endif /* _UNISTD_HEADERS_H */
 
+#ifndef _POSIX_HEADERS_H
+#include "posix_headers.h"
+#endif /* _POSIX_HEADERS_H */
+
 #include <sys/mman.h>
 
-int msync(void *addr, size_t len, int flags) {
-    /* Nothing for now.. */
-    (void)(addr);
-    (void)(len);
-    (void)(flags);
+int
+msync(void *addr, size_t len, int flags) {
+    struct MappedRegion *mr;
+    size_t page_size = __mmap_page_size;
+    size_t first_page, last_page;
+    size_t start;
+    int result = ERROR;
+
+    ENTER();
+
+    SHOWPOINTER(addr);
+    SHOWVALUE(len);
+    SHOWVALUE(flags);
+
+    if (((size_t) addr & (page_size - 1)) != 0 ||
+        (flags & ~(MS_ASYNC | MS_SYNC | MS_INVALIDATE)) != 0 ||
+        (flags & (MS_ASYNC | MS_SYNC)) == (MS_ASYNC | MS_SYNC)) {
+        __set_errno(EINVAL);
+        goto out;
+    }
+
+    if (len == 0) {
+        result = OK;
+        goto out;
+    }
+
+    __mmap_lock();
+
+    mr = __mmap_find_region(addr);
+    if (mr == NULL) {
+        __mmap_unlock();
+
+        __set_errno(ENOMEM);
+        goto out;
+    }
+
+    start = (UBYTE *) addr - mr->mr_Address;
+    if (len > mr->mr_Length - start)
+        len = mr->mr_Length - start;
+
+    first_page = start / page_size;
+    last_page = (start + len - 1) / page_size;
+
+    /* MS_ASYNC is handled just like MS_SYNC; only the modified pages are written */
+    result = __mmap_write_back(mr, first_page, last_page);
+
+    __mmap_unlock();
+
+out:
 
-    return 0;
-}
\ No newline at end of file
+    RETURN(result);
+    return result;
+}
@@ -1,25 +1,57 @@
 /*
- * $Id: mman_munmap.c,v 1.0 2021-01-18 20:17:27 clib2devs Exp $
+ * $Id: mman_munmap.c,v 1.1 2026-10-17 14:02:11 clib2devs Exp $
 */
 
 #ifndef _UNISTD_HEADERS_H
 #include "unistd_headers.h"
 #endif /* _UNISTD_HEADERS_H */
 
+#ifndef _POSIX_HEADERS_H
+#include "posix_headers.h"
+#endif /* _POSIX_HEADERS_H */
+
 #include <sys/mman.h>
 
 int
 munmap(void *map, size_t length) {
-    (void) (length);
+    struct MappedRegion *mr;
+    size_t page_size = __mmap_page_size;
+    size_t first_page, last_page;
+    size_t start;
+    int result = ERROR;
 
     ENTER();
 
     SHOWPOINTER(map);
     SHOWVALUE(length);
 
-    if (map != NULL)
-        free(map);
+    if (length == 0 || ((size_t) map & (page_size - 1)) != 0) {
+        __set_errno(EINVAL);
+        goto out;
+    }
+
+    __mmap_lock();
+
+    /* Unmapping memory which is not mapped is not an error */
+    mr = __mmap_find_region(map);
+    if (mr != NULL) {
+        start = (UBYTE *) map - mr->mr_Address;
+
+        if (length > mr->mr_Length - start)
+            length = mr->mr_Length - start;
+
+        first_page = start / page_size;
+        last_page = (start + length - 1) / page_size;
+
+        __mmap_release_pages(mr, first_page, last_page);
+    }
+
+    __mmap_unlock();
+
+    result = OK;
+
+out:
 
-    RETURN(0);
-    return 0;
-}
\ No newline at end of file
+    RETURN(result);
+    return result;
+}
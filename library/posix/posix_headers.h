@@ -17,4 +17,34 @@
 
 extern void __convert_info_to_statvfs(struct InfoData * id,struct statvfs * f);
 
+/* A file or anonymous mapping created by mmap(). Memory is allocated page
+   aligned and whole pages at a time; mr_Pages holds one entry per page. */
+struct MappedPage {
+    BOOL mp_Mapped;     /* Page has not been released by munmap() yet */
+};
+
+struct MappedRegion {
+    struct MinNode mr_Node;
+    UBYTE *mr_Address;
+    size_t mr_Length;       /* Page rounded length of the mapping */
+    size_t mr_FileLength;   /* Number of bytes which are backed by the file */
+    off_t mr_Offset;        /* File offset the mapping starts at */
+    int mr_Prot;
+    int mr_Flags;
+    BPTR mr_File;           /* Private file handle, if one could be opened */
+    int mr_Descriptor;      /* Descriptor to fall back on, -1 for anonymous mappings */
+    size_t mr_NumPages;
+    size_t mr_PagesMapped;
+    struct MappedPage *mr_Pages;
+    UBYTE *mr_Shadow;       /* Shared writable mappings: the file data as last read/written */
+};
+
+extern size_t __mmap_page_size;
+
+extern void __mmap_lock(void);
+extern void __mmap_unlock(void);
+extern struct MappedRegion *__mmap_find_region(const void *address);
+extern int __mmap_write_back(struct MappedRegion *mr, size_t first_page, size_t last_page);
+extern void __mmap_release_pages(struct MappedRegion *mr, size_t first_page, size_t last_page);
+
 #endif /* _MOUNT_HEADERS_H */
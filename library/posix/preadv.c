@@ -0,0 +1,104 @@
+/*
+ * $Id: uio_preadv.c,v 1.0 2026-10-17 20:14:07 clib2devs Exp $
+*/
+
+#ifndef _UIO_HEADERS_H
+#include "uio_headers.h"
+#endif /* _UIO_HEADERS_H */
+
+ssize_t
+preadv(int file_descriptor, const struct iovec *iov, int vec_count, off_t offset) {
+    ssize_t result = EOF;
+    struct file_action_message msg;
+    ssize_t total_num_bytes_read;
+    ssize_t num_bytes_read;
+    struct fd *fd = NULL;
+    int i;
+
+    ENTER();
+
+    SHOWVALUE(file_descriptor);
+    SHOWPOINTER(iov);
+    SHOWVALUE(vec_count);
+    SHOWVALUE(offset);
+
+    if (iov == NULL) {
+        __set_errno(EFAULT);
+        goto out;
+    }
+
+    if (vec_count < 1 || vec_count > MAX_IOVEC || offset < 0) {
+        __set_errno(EINVAL);
+        goto out;
+    }
+
+    /* Check for overflow. An expensive test, but better to do it here than in the read loop. */
+    for (i = 0, total_num_bytes_read = 0; i < vec_count; i++) {
+        total_num_bytes_read += iov[i].iov_len;
+        if (total_num_bytes_read < 0) /* Rollover. */
+        {
+            __set_errno(EINVAL);
+            goto out;
+        }
+    }
+
+    /* Holding on to the descriptor lock for the whole vector keeps
+       other readers and writers from getting in between. */
+    __stdio_lock();
+
+    fd = __get_file_descriptor(file_descriptor);
+    if (fd != NULL)
+        __fd_lock(fd);
+
+    __stdio_unlock();
+
+    if (fd == NULL) {
+        __set_errno(EBADF);
+        goto out;
+    }
+
+    if (FLAG_IS_CLEAR(fd->fd_Flags, FDF_READ)) {
+        SHOWMSG("this descriptor is not read-enabled");
+
+        __set_errno(EBADF);
+        goto out;
+    }
+
+    total_num_bytes_read = 0;
+
+    for (i = 0; i < vec_count; i++) {
+        __check_abort();
+
+        if (iov[i].iov_len > 0) {
+            msg.fam_Action = file_action_pread;
+            msg.fam_Data = (char *) iov[i].iov_base;
+            msg.fam_Size = iov[i].iov_len;
+            msg.fam_Offset = offset + total_num_bytes_read;
+
+            num_bytes_read = (*fd->fd_Action)(fd, &msg);
+            if (num_bytes_read == EOF) {
+                /* Whatever was read so far still counts. */
+                if (total_num_bytes_read > 0)
+                    break;
+
+                __set_errno(msg.fam_Error);
+                goto out;
+            }
+
+            total_num_bytes_read += num_bytes_read;
+
+            /* A short read means that the end of the file was reached. */
+            if ((size_t) num_bytes_read < iov[i].iov_len)
+                break;
+        }
+    }
+
+    result = total_num_bytes_read;
+
+out:
+
+    __fd_unlock(fd);
+
+    RETURN(result);
+    return (result);
+}
@@ -1,18 +1,22 @@
 /*
- * $Id: uio_readv.c,v 1.6 2006-01-08 12:04:27 clib2devs Exp $
+ * $Id: uio_readv.c,v 1.7 2026-10-17 20:41:52 clib2devs Exp $
 */
 
 #ifndef _UIO_HEADERS_H
 #include "uio_headers.h"
 #endif /* _UIO_HEADERS_H */
 
+#ifndef _SOCKET_HEADERS_H
+#include "socket_headers.h"
+#endif /* _SOCKET_HEADERS_H */
+
 ssize_t
 readv(int file_descriptor, const struct iovec *iov, int vec_count) {
     ssize_t result = EOF;
     struct file_action_message msg;
     ssize_t total_num_bytes_read;
-    ssize_t part_num_bytes_read;
     ssize_t num_bytes_read;
+    char buffer[UIO_GATHER_BUFFER_SIZE];
     struct fd *fd = NULL;
     int i;
 
@@ -22,8 +26,6 @@ readv(int file_descriptor, const struct iovec *iov, int vec_count) {
     SHOWPOINTER(iov);
     SHOWVALUE(vec_count);
 
-    __stdio_lock();
-
     if (iov == NULL) {
         __set_errno(EFAULT);
         goto out;
@@ -44,50 +46,112 @@ readv(int file_descriptor, const struct iovec *iov, int vec_count) {
         }
     }
 
+    /* Only this one descriptor needs to be locked, not all of them. */
+    __stdio_lock();
+
     fd = __get_file_descriptor(file_descriptor);
+    if (fd != NULL && FLAG_IS_CLEAR(fd->fd_Flags, FDF_IS_SOCKET))
+        __fd_lock(fd);
+
+    __stdio_unlock();
+
     if (fd == NULL) {
         __set_errno(EBADF);
         goto out;
     }
 
-    __fd_lock(fd);
+    /* The TCP/IP stack fills the whole vector at once, just like recvmsg() does. */
+    if (FLAG_IS_SET(fd->fd_Flags, FDF_IS_SOCKET)) {
+        struct msghdr mh;
+
+        assert(__SocketBase != NULL);
+
+        memset(&mh, 0, sizeof(mh));
+        mh.msg_iov = (struct iovec *) iov;
+        mh.msg_iovlen = vec_count;
+
+        result = __recvmsg(fd->fd_Socket, &mh, 0);
+
+        fd = NULL;
+        goto out;
+    }
+
+    if (FLAG_IS_CLEAR(fd->fd_Flags, FDF_READ)) {
+        SHOWMSG("this descriptor is not read-enabled");
+
+        __set_errno(EBADF);
+        goto out;
+    }
 
     total_num_bytes_read = 0;
-    part_num_bytes_read = 0;
 
     i = 0;
 
-    while (i < vec_count) /* XXX: Should this loop be locked? */
-    {
+    while (i < vec_count) {
+        int first = i;
+        int last;
+
         __check_abort();
 
-        if (iov[i].iov_len > 0) {
-            msg.fam_Action = file_action_read;
-            msg.fam_Data = (char *) iov[i].iov_base + part_num_bytes_read;
-            msg.fam_Size = iov[i].iov_len - part_num_bytes_read;
+        /* Read straight into each buffer, unless there are several small
+           ones in a row. These are filled from one read into a buffer on
+           the stack. */
+        for (last = i, msg.fam_Size = 0; last < vec_count; last++) {
+            if (iov[last].iov_len > UIO_GATHER_MAX_LENGTH ||
+                msg.fam_Size + iov[last].iov_len > sizeof(buffer))
+                break;
 
-            num_bytes_read = (*fd->fd_Action)(fd, &msg);
-            if (num_bytes_read == EOF) {
-                __set_errno(msg.fam_Error);
-                goto out;
-            }
+            msg.fam_Size += iov[last].iov_len;
+        }
+
+        if (last - i > 1) {
+            msg.fam_Data = buffer;
+        } else {
+            msg.fam_Data = (char *) iov[i].iov_base;
+            msg.fam_Size = iov[i].iov_len;
+
+            last = i + 1;
+        }
+
+        i = last;
 
-            /* End of file reached? */
-            if (num_bytes_read == 0)
+        if (msg.fam_Size == 0)
+            continue;
+
+        msg.fam_Action = file_action_read;
+
+        num_bytes_read = (*fd->fd_Action)(fd, &msg);
+        if (num_bytes_read == EOF) {
+            /* Whatever was read so far still counts. */
+            if (total_num_bytes_read > 0)
                 break;
 
-            total_num_bytes_read += num_bytes_read;
+            __set_errno(msg.fam_Error);
+            goto out;
+        }
+
+        if (msg.fam_Data == buffer) {
+            const char *b = buffer;
+            ssize_t left = num_bytes_read;
+
+            for (; first < last && left > 0; first++) {
+                size_t n = iov[first].iov_len;
 
-            part_num_bytes_read += num_bytes_read;
-            if ((size_t) part_num_bytes_read < iov[i].iov_len) {
-                /* Avoid busy-waiting for more data here? */
-                continue;
+                if ((ssize_t) n > left)
+                    n = left;
+
+                memcpy(iov[first].iov_base, b, n);
+                b += n;
+                left -= n;
             }
         }
 
-        part_num_bytes_read = 0;
+        total_num_bytes_read += num_bytes_read;
 
-        i++;
+        /* Don't wait for more data than there is right now; for a file
+           this means that its end has been reached. */
+        if (num_bytes_read < msg.fam_Size)
+            break;
     }
 
     result = total_num_bytes_read;
@@ -95,7 +159,6 @@ readv(int file_descriptor, const struct iovec *iov, int vec_count) {
 out:
 
     __fd_unlock(fd);
-    __stdio_unlock();
 
     RETURN(result);
     return (result);
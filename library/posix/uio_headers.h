@@ -25,4 +25,11 @@
 
 /****************************************************************************/
 
+/* readv() and writev() gather runs of iovecs no longer than this into one
+   buffer of this size on the stack, and transfer them in one go. */
+#define UIO_GATHER_MAX_LENGTH	128
+#define UIO_GATHER_BUFFER_SIZE	1024
+
+/****************************************************************************/
+
 #endif /* _UIO_HEADERS_H */
@@ -1,17 +1,22 @@
 /*
- * $Id: uio_writev.c,v 1.5 2006-01-08 12:04:27 clib2devs Exp $
+ * $Id: uio_writev.c,v 1.6 2026-10-17 20:41:52 clib2devs Exp $
 */
 
 #ifndef _UIO_HEADERS_H
 #include "uio_headers.h"
 #endif /* _UIO_HEADERS_H */
 
+#ifndef _SOCKET_HEADERS_H
+#include "socket_headers.h"
+#endif /* _SOCKET_HEADERS_H */
+
 ssize_t
 writev(int file_descriptor, const struct iovec *iov, int vec_count) {
     ssize_t result = EOF;
     struct file_action_message msg;
     ssize_t total_num_bytes_written;
-    char *buffer = NULL;
+    ssize_t num_bytes_written;
+    char buffer[UIO_GATHER_BUFFER_SIZE];
     struct fd *fd = NULL;
     int i;
 
@@ -21,8 +26,6 @@ writev(int file_descriptor, const struct iovec *iov, int vec_count) {
     SHOWPOINTER(iov);
     SHOWVALUE(vec_count);
 
-    __stdio_lock();
-
     if (iov == NULL) {
         __set_errno(EFAULT);
         goto out;
@@ -44,57 +47,105 @@ writev(int file_descriptor, const struct iovec *iov, int vec_count) {
         }
     }
 
+    /* Only this one descriptor needs to be locked, not all of them. */
+    __stdio_lock();
+
     fd = __get_file_descriptor(file_descriptor);
+    if (fd != NULL && FLAG_IS_CLEAR(fd->fd_Flags, FDF_IS_SOCKET))
+        __fd_lock(fd);
+
+    __stdio_unlock();
+
     if (fd == NULL) {
         __set_errno(EBADF);
         goto out;
     }
 
-    __fd_lock(fd);
+    /* The TCP/IP stack takes the whole vector at once, just like sendmsg() does. */
+    if (FLAG_IS_SET(fd->fd_Flags, FDF_IS_SOCKET)) {
+        struct msghdr mh;
+
+        assert(__SocketBase != NULL);
+
+        memset(&mh, 0, sizeof(mh));
+        mh.msg_iov = (struct iovec *) iov;
+        mh.msg_iovlen = vec_count;
+
+        result = __sendmsg(fd->fd_Socket, &mh, 0);
+
+        fd = NULL;
+        goto out;
+    }
+
+    if (FLAG_IS_CLEAR(fd->fd_Flags, FDF_WRITE)) {
+        SHOWMSG("file descriptor is not write-enabled");
+
+        __set_errno(EBADF);
+        goto out;
+    }
 
-    buffer = malloc(total_num_bytes_written);
-    if (buffer != NULL) {
-        char *b = buffer;
+    total_num_bytes_written = 0;
 
-        for (i = 0; i < vec_count; i++) {
-            memcpy(b, iov[i].iov_base, iov[i].iov_len);
-            b += iov[i].iov_len;
+    i = 0;
+
+    while (i < vec_count) {
+        int last;
+
+        __check_abort();
+
+        /* Hand each buffer over as it is, unless there are several small
+           ones in a row. These are gathered on the stack first, so that
+           it takes just one write for all of them. */
+        for (last = i, msg.fam_Size = 0; last < vec_count; last++) {
+            if (iov[last].iov_len > UIO_GATHER_MAX_LENGTH ||
+                msg.fam_Size + iov[last].iov_len > sizeof(buffer))
+                break;
+
+            msg.fam_Size += iov[last].iov_len;
+        }
+
+        if (last - i > 1) {
+            char *b = buffer;
+
+            for (; i < last; i++) {
+                memcpy(b, iov[i].iov_base, iov[i].iov_len);
+                b += iov[i].iov_len;
+            }
+
+            msg.fam_Data = buffer;
+        } else {
+            msg.fam_Data = (char *) iov[i].iov_base;
+            msg.fam_Size = iov[i].iov_len;
+
+            i++;
         }
 
+        if (msg.fam_Size == 0)
+            continue;
+
         msg.fam_Action = file_action_write;
-        msg.fam_Data = buffer;
-        msg.fam_Size = total_num_bytes_written;
 
-        if ((*fd->fd_Action)(fd, &msg) == EOF) {
+        num_bytes_written = (*fd->fd_Action)(fd, &msg);
+        if (num_bytes_written == EOF) {
+            /* Whatever was written so far still counts. */
+            if (total_num_bytes_written > 0)
+                break;
+
             __set_errno(msg.fam_Error);
             goto out;
         }
-    } else {
-        for (i = 0; i < vec_count; i++) {
-            __check_abort();
-
-            if (iov[i].iov_len > 0) {
-                msg.fam_Action = file_action_write;
-                msg.fam_Data = (char *) iov[i].iov_base;
-                msg.fam_Size = iov[i].iov_len;
-
-                if ((*fd->fd_Action)(fd, &msg) == EOF) {
-                    __set_errno(msg.fam_Error);
-                    goto out;
-                }
-            }
-        }
+
+        total_num_bytes_written += num_bytes_written;
+
+        if (num_bytes_written < msg.fam_Size)
+            break;
     }
 
     result = total_num_bytes_written;
 
 out:
 
-    if (buffer != NULL)
-        free(buffer);
-
     __fd_unlock(fd);
-    __stdio_unlock();
 
     RETURN(result);
     return (result);
@@ -7,23 +7,55 @@
 #include <proto/exec.h>
 #include <stddef.h>
 
+/*
+ * Every thread of the program records its arcs in the same tables. An arc
+ * which is already known only needs its count incremented, which is done
+ * atomically. A new arc gets a fresh entry, which is filled in first and
+ * then put at the front of its chain with a compare-and-swap; if another
+ * thread changed the chain in the meantime, the chain is searched again.
+ * Nobody ever waits for anybody else, and no arc is dropped because some
+ * other thread happened to be in here, too.
+ */
 
 void __mcount(uint32 frompc, uint32 selfpc);
 
+static void
+alloc_thread_histograms(struct gmonparam *p)
+{
+	uint16 *kcount;
+	int i;
+
+	for (i = 0; i < GMON_MAX_THREADS; i++)
+	{
+		if (p->threads[i].task == NULL || p->threads[i].kcount != NULL)
+			continue;
+
+		kcount = AllocVecTags(p->kcountsize, AVT_Type, MEMF_SHARED, AVT_ClearWithValue, 0, TAG_DONE);
+		if (kcount == NULL)
+			break;
+
+		if (!__sync_bool_compare_and_swap(&p->threads[i].kcount, NULL, kcount))
+			FreeVec(kcount);
+	}
+}
+
 void
 __mcount(uint32 frompc, uint32 selfpc)
 {
-	uint16 *frompcindex;
-	struct tostruct *top, *prevtop;
+	volatile uint16 *frompcindex;
+	struct tostruct *top;
+	uint16 head;
 	struct gmonparam *p;
 
-	int32 toindex;
+	int32 toindex, newindex = 0;
 
 	p = &_gmonparam;
 
 	if (p->state != kGmonProfOn) return;
 
-	p->state = kGmonProfBusy;
+	/* The interrupt found a task which has no histogram of its own yet */
+	if (p->newthreads && __sync_bool_compare_and_swap(&p->newthreads, 1, 0))
+		alloc_thread_histograms(p);
 
 	/*
 	 * Check if the PC is inside our text segment.
@@ -31,7 +63,7 @@ __mcount(uint32 frompc, uint32 selfpc)
 	 */
 	frompc -= p->lowpc;
 	selfpc -= p->lowpc;
-	if (frompc > p->textsize) goto done;
+	if (frompc > p->textsize) return;
 
 #if (HASHFRACTION & (HASHFRACTION-1)) == 0
 	if (p->hashfraction == HASHFRACTION)
@@ -46,63 +78,42 @@ __mcount(uint32 frompc, uint32 selfpc)
 			sizeof(*p->froms)))];
 	}
 
-	toindex = *frompcindex;
-
-	if (toindex == 0)
+	for (;;)
 	{
-		/* first time down this arc */
-		toindex = ++p->tos[0].link;
-		if (toindex >= p->tolimit)
-			/* Ouch! Overflow */
-			goto overflow;
-
-		*frompcindex = (uint16)toindex;
-		top = &p->tos[toindex];
-		top->selfpc = selfpc;
-		top->count = 1;
-		top->link = 0;
-		goto done;
-	}
+		head = *frompcindex;
 
-	top = &p->tos[toindex];
-	if (top->selfpc == selfpc)
-	{
-		/* arc at front of chain */
-		top->count++;
-		goto done;
-	}
+		for (toindex = head; toindex != 0; toindex = top->link)
+		{
+			top = &p->tos[toindex];
+			if (top->selfpc == selfpc)
+			{
+				__sync_fetch_and_add(&top->count, 1);
+				return;
+			}
+		}
 
-	for (;;)
-	{
-		if (top->link == 0)
+		/* first time down this arc */
+		if (newindex == 0)
 		{
-			toindex = ++p->tos[0].link;
-			if (toindex >= p->tolimit)
+			newindex = __sync_add_and_fetch(&p->tonext, 1);
+			if (newindex >= p->tolimit)
+				/* Ouch! Overflow */
 				goto overflow;
 
-			top = &p->tos[toindex];
+			top = &p->tos[newindex];
 			top->selfpc = selfpc;
 			top->count = 1;
-			top->link = *frompcindex;
-			*frompcindex = (uint16)toindex;
-			goto done;
 		}
-		prevtop = top;
-		top = &p->tos[top->link];
-		if (top->selfpc == selfpc)
-		{
-			top->count++;
-			toindex = prevtop->link;
-			prevtop->link = top->link;
-			top->link = *frompcindex;
-			*frompcindex = (uint16)toindex;
-			goto done;
-		}
-	}
 
-done:
-	p->state = kGmonProfOn;
-	return;
+		p->tos[newindex].link = head;
+
+		__sync_synchronize();
+
+		if (__sync_bool_compare_and_swap(frompcindex, head, (uint16)newindex))
+			return;
+
+		/* Somebody else came through here, maybe down the same arc */
+	}
 
 overflow:
 	p->state = kGmonProfError;
@@ -1,5 +1,5 @@
 /*
- * $Id: profile_gmn.c,v 1.0 2021-01-18 12:04:26 clib2devs Exp $
+ * $Id: profile_gmn.c,v 1.1 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #include <exec/exec.h>
@@ -105,6 +105,7 @@ void monstartup(uint32 low_pc, uint32 high_pc)
 	p->froms = (uint16 *)cp;
 
 	p->tos[0].link = 0;
+	p->tonext = 0;
 
 	/* Verify granularity for sampling */
 	if (p->kcountsize < p->textsize)
@@ -137,7 +138,11 @@ void moncontrol(int mode)
 	}
 }
 
-void moncleanup(void)
+/*
+ * Write a gmon.out file with the given PC histogram and, if requested,
+ * the call graph arcs which all threads recorded together.
+ */
+static void write_gmon(const char *name, uint16 *kcount, BOOL arcs)
 {
 	BPTR fd;
 	int fromindex;
@@ -151,17 +156,10 @@ void moncleanup(void)
 	FILE *log;
 #endif
 
-	moncontrol(0);
-
-	if (p->state == kGmonProfError)
-	{
-		fprintf(stderr, "WARNING: Overflow during profiling\n");
-	}
-
-	fd = Open("gmon.out", MODE_NEWFILE);
+	fd = Open(name, MODE_NEWFILE);
 	if (!fd)
 	{
-		fprintf(stderr, "ERROR: could not open gmon.out\n");
+		fprintf(stderr, "ERROR: could not open %s\n", name);
 		return;
 	}
 
@@ -174,7 +172,13 @@ void moncleanup(void)
 	hdr->profrate = 100; //FIXME:!!
 
 	Write(fd, hdr, sizeof(*hdr));
-	Write(fd, p->kcount, p->kcountsize);
+	Write(fd, kcount, p->kcountsize);
+
+	if (!arcs)
+	{
+		Close(fd);
+		return;
+	}
 
 	endfrom = p->fromssize / sizeof(*p->froms);
 
@@ -213,6 +217,55 @@ void moncleanup(void)
 	Close(fd);
 }
 
+void moncleanup(void)
+{
+	struct gmonparam *p = &_gmonparam;
+	struct gmonthread *gt;
+	char name[20];
+	FILE *threads_file = NULL;
+	int i;
+
+	moncontrol(0);
+
+	if (p->state == kGmonProfError)
+	{
+		fprintf(stderr, "WARNING: Overflow during profiling\n");
+	}
+
+	/* All threads together, with the call graph */
+	write_gmon("gmon.out", p->kcount, TRUE);
+
+	/*
+	 * Then a flat profile for each thread on its own, in gmon.out.1 and
+	 * so on. gmon.threads tells which thread is which.
+	 */
+	for (i = 0; i < GMON_MAX_THREADS; i++)
+	{
+		gt = &p->threads[i];
+		if (gt->kcount == NULL)
+			continue;
+
+		if (threads_file == NULL)
+		{
+			threads_file = fopen("gmon.threads", "w");
+			if (threads_file == NULL)
+				fprintf(stderr, "ERROR: could not open gmon.threads\n");
+		}
+
+		snprintf(name, sizeof(name), "gmon.out.%d", i + 1);
+		write_gmon(name, gt->kcount, FALSE);
+
+		if (threads_file != NULL)
+			fprintf(threads_file, "%s %s\n", name, gt->name);
+
+		FreeVec(gt->kcount);
+		gt->kcount = NULL;
+	}
+
+	if (threads_file != NULL)
+		fclose(threads_file);
+}
+
 void mongetpcs(uint32 *lowpc, uint32 *highpc)
 {
 	struct Library *ElfBase = NULL;
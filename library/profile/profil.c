@@ -1,4 +1,4 @@
-/* $Id$ profile_profil.c,v 1.0 2021-01-21 10:08:32 clib2devs Exp $
+/* $Id$ profile_profil.c,v 1.1 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #include <proto/exec.h>
@@ -7,6 +7,8 @@
 #include <resources/performancemonitor.h>
 #include <unistd.h>
 
+#include "profile_gmon.h"
+
 static struct Interrupt CounterInt;
 static struct PerformanceMonitorIFace *IPM;
 
@@ -18,10 +20,12 @@ static struct IntData
 	uint32 Offset;
 	uint32 Scale;
 	uint32 CounterStart;
+	struct gmonparam *Gmon;	/* Also keeps histograms per thread */
 } ProfileData;
 
 uint32 GetCounterStart(void);
 uint32 CounterIntFn(struct ExceptionContext *, struct ExecBase *, struct IntData *);
+void CountThreadSample(struct gmonparam *, struct Task *, uint32);
 
 uint32
 GetCounterStart(void)
@@ -41,6 +45,46 @@ GetCounterStart(void)
 	return 0x80000000 - count;
 }
 
+/* Count a sample for the task which was interrupted. A task which has not
+   been seen before is given an entry; __mcount() allocates the histogram
+   for it, which cannot be done here. */
+void
+CountThreadSample(struct gmonparam *p, struct Task *task, uint32 index)
+{
+	struct gmonthread *gt;
+	const char *name;
+	uint32 slot = ((uint32)task >> 4) % GMON_MAX_THREADS;
+	int i, j;
+
+	for (i = 0; i < GMON_MAX_THREADS; i++)
+	{
+		gt = &p->threads[slot];
+
+		if (gt->task == task)
+		{
+			if (gt->kcount != NULL)
+				gt->kcount[index]++;
+
+			return;
+		}
+
+		if (gt->task == NULL)
+		{
+			name = task->tc_Node.ln_Name;
+			for (j = 0; name != NULL && name[j] != '\0' && j < GMON_NAME_LEN - 1; j++)
+				gt->name[j] = name[j];
+
+			gt->name[j] = '\0';
+			gt->task = task;
+
+			p->newthreads = 1;
+			return;
+		}
+
+		slot = (slot + 1) % GMON_MAX_THREADS;
+	}
+}
+
 uint32
 CounterIntFn(struct ExceptionContext *ctx, struct ExecBase *ExecBase, struct IntData *profileData)
 {
@@ -48,15 +92,17 @@ CounterIntFn(struct ExceptionContext *ctx, struct ExecBase *ExecBase, struct Int
 	uint32 sia = (uint32)sampledAddress;
 
 	/* Silence compiler */
-	(void)ExecBase;
 	(void)ctx;
 
 	sia = ((sia - profileData->Offset) * profileData->Scale) >> 16;
 
-	if (sia <= (profileData->BufferSize >> 1))
+	if (sia < (profileData->BufferSize >> 1))
 	{
 		//if (ProfileData->Buffer[sia] != 0xffff)
 		profileData->Buffer[sia]++;
+
+		if (profileData->Gmon != NULL)
+			CountThreadSample(profileData->Gmon, ExecBase->ThisTask, sia);
 	}
 
 	IPM->CounterControl(1, profileData->CounterStart, PMCI_Transition);
@@ -111,6 +157,7 @@ profil(unsigned short *buffer, size_t bufSize, size_t offset, unsigned int scale
 	ProfileData.Offset = offset;
 	ProfileData.Scale = scale;
 	ProfileData.CounterStart = GetCounterStart();
+	ProfileData.Gmon = (buffer == _gmonparam.kcount) ? &_gmonparam : NULL;
 
 	/* Set interrupt vector */
 	CounterInt.is_Code = (void (*)(void))CounterIntFn;
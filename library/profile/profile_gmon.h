@@ -46,6 +46,17 @@ struct rawarc
 #define ROUNDDOWN(x,y) (((x)/(y))*(y))
 #define ROUNDUP(x,y)   ((((x)+(y)-1)/(y))*(y))
 
+/* PC histogram of one task, filled in by the performance monitor interrupt */
+#define GMON_MAX_THREADS	32
+#define GMON_NAME_LEN		32
+
+struct gmonthread
+{
+	struct Task *		task;
+	uint16 *			kcount;
+	char				name[GMON_NAME_LEN];
+};
+
 struct gmonparam
 {
 	int 				state;
@@ -61,6 +72,9 @@ struct gmonparam
 	uint32				textsize;
 	uint32				hashfraction;
 	uint8 *				memory;
+	int32				tonext;		/* Last tos entry handed out */
+	struct gmonthread	threads[GMON_MAX_THREADS];
+	int					newthreads;	/* Some threads still need a histogram */
 };
 
 extern struct gmonparam _gmonparam;
@@ -68,7 +82,6 @@ extern struct gmonparam _gmonparam;
 enum 
 {
 	kGmonProfOn 		= 0,
-	kGmonProfBusy 		= 1,
 	kGmonProfError		= 2,
 	kGmonProfOff		= 3
 };
@@ -34,6 +34,10 @@
 #include "unistd_headers.h"
 #endif /* _UNISTD_HEADERS_H */
 
+#ifndef _LOCALE_HEADERS_H
+#include "locale_headers.h"
+#endif /* _LOCALE_HEADERS_H */
+
 #include "common.h"
 #include "pthread.h"
 
@@ -60,6 +64,25 @@ ThreadInfo *GetThreadInfo(pthread_t thread) {
 pthread_t GetThreadId(struct Task *task) {
     pthread_t i;
 
+    // Threads are started with their ThreadInfo as entry data, so a thread can be
+    // identified without scanning the table. Anything else is not one of ours.
+    if (task != NULL) {
+        ThreadInfo *inf;
+
+        if (task == threads[0].task)
+            return 0;
+
+        if (task->tc_Node.ln_Type != NT_PROCESS)
+            return PTHREAD_THREADS_MAX;
+
+        inf = (ThreadInfo *) ((struct Process *) task)->pr_EntryData;
+        if (inf >= &threads[PTHREAD_FIRST_THREAD_ID] && inf < &threads[PTHREAD_THREADS_MAX] &&
+            ((ULONG) inf - (ULONG) threads) % sizeof(ThreadInfo) == 0 && inf->task == task)
+            return inf - threads;
+
+        return PTHREAD_THREADS_MAX;
+    }
+
     // 0 is main task, First thread id will be 1 so that it is different than default value of pthread_t
     for (i = PTHREAD_FIRST_THREAD_ID; i < PTHREAD_THREADS_MAX; i++) {
         if (threads[i].task == task)
@@ -113,4 +136,156 @@ CloseTimerDevice(struct IORequest *io) {
     mp = io->io_Message.mn_ReplyPort;
     if (mp->mp_SigBit != SIGB_TIMER_FALLBACK)
         FreeSignal(mp->mp_SigBit);
+}
+
+// Returns the timer of the calling thread, opening it on first use. Tasks which
+// are not known to us have to make do with the temporary one passed in.
+ThreadTimer *
+ObtainThreadTimer(ThreadTimer *local) {
+    struct Task *task = FindTask(NULL);
+    ThreadInfo *inf;
+    ThreadTimer *timer;
+
+    inf = GetThreadInfo(GetThreadId(task));
+    if (inf != NULL && inf->task == task) {
+        timer = &inf->timer;
+        timer->cached = TRUE;
+    } else {
+        timer = local;
+        memset(timer, 0, sizeof(*timer));
+    }
+
+    if (!timer->open) {
+        if (!OpenTimerDevice((struct IORequest *) &timer->request, &timer->port, task)) {
+            CloseTimerDevice((struct IORequest *) &timer->request);
+            return NULL;
+        }
+
+        timer->open = TRUE;
+    }
+
+    return timer;
+}
+
+void
+ReleaseThreadTimer(ThreadTimer *timer) {
+    StopThreadTimer(timer);
+
+    if (!timer->cached)
+        CloseThreadTimer(timer);
+}
+
+void
+CloseThreadTimer(ThreadTimer *timer) {
+    if (timer->open) {
+        StopThreadTimer(timer);
+        CloseTimerDevice((struct IORequest *) &timer->request);
+        timer->open = FALSE;
+    }
+}
+
+// Start the timer so that it fires at the given time. Absolute times are in
+// UTC, like gettimeofday(), while the system time is local time counted from
+// 1978; converting the deadline once is much cheaper than asking for the
+// current UTC time. Returns ETIMEDOUT if the deadline has already passed.
+int
+StartThreadTimer(ThreadTimer *timer, const struct timespec *time, BOOL relative) {
+    struct TimerIFace *ITimer = __ITimer;
+    struct TimeVal *delay = &timer->request.Time;
+
+    TIMESPEC_TO_TIMEVAL(delay, time);
+
+    if (!relative) {
+        struct TimeVal now;
+        LONG offset = UNIX_TIME_OFFSET;
+
+        if (__default_locale != NULL)
+            offset += 60 * __default_locale->loc_GMTOffset;
+
+        if ((LONG) delay->Seconds < offset)
+            return ETIMEDOUT;
+
+        delay->Seconds -= offset;
+
+        // CmpTime() is negative if the first time is the later one
+        GetSysTime(&now);
+        if (CmpTime(delay, &now) >= 0)
+            return ETIMEDOUT;
+
+        SubTime(delay, &now);
+    }
+
+    if (!timerisset(delay))
+        return ETIMEDOUT;
+
+    // a reply from an earlier request may still have left its signal behind
+    SetSignal(0, THREAD_TIMER_MASK(timer));
+
+    timer->request.Request.io_Command = TR_ADDREQUEST;
+    timer->request.Request.io_Flags = 0;
+    SendIO((struct IORequest *) &timer->request);
+    timer->pending = TRUE;
+
+    return 0;
+}
+
+// Abort the timer if it is still running and take its reply off the port.
+void
+StopThreadTimer(ThreadTimer *timer) {
+    if (timer->pending) {
+        if (!CheckIO((struct IORequest *) &timer->request))
+            AbortIO((struct IORequest *) &timer->request);
+
+        WaitIO((struct IORequest *) &timer->request);
+        timer->pending = FALSE;
+    }
+}
+
+// Returns a cleared signal bit to wait on. Threads allocate theirs only once and
+// keep it until they exit.
+BYTE
+ObtainWaitSignal(void) {
+    struct Task *task = FindTask(NULL);
+    ThreadInfo *inf;
+    BYTE signal;
+
+    inf = GetThreadInfo(GetThreadId(task));
+    if (inf != NULL && inf->task == task && inf->waitsig != 0) {
+        signal = inf->waitsig;
+        SetSignal(0, 1UL << signal);
+        return signal;
+    }
+
+    signal = AllocSignal(-1);
+    if (signal == -1) {
+        signal = SIGB_COND_FALLBACK;
+        SetSignal(SIGF_COND_FALLBACK, 0);
+    } else if (inf != NULL && inf->task == task) {
+        inf->waitsig = signal;
+    }
+
+    return signal;
+}
+
+void
+ReleaseWaitSignal(BYTE signal) {
+    struct Task *task = FindTask(NULL);
+    ThreadInfo *inf;
+
+    if (signal == SIGB_COND_FALLBACK)
+        return;
+
+    inf = GetThreadInfo(GetThreadId(task));
+    if (inf != NULL && inf->task == task && inf->waitsig == signal)
+        return;
+
+    FreeSignal(signal);
+}
+
+void
+FreeWaitSignal(ThreadInfo *inf) {
+    if (inf->waitsig != 0) {
+        FreeSignal(inf->waitsig);
+        inf->waitsig = 0;
+    }
 }
\ No newline at end of file
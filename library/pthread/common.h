@@ -56,7 +56,9 @@ enum threadState
 typedef struct {
     struct MinNode node;
     struct Task *task;
+    volatile int *addr;
     UBYTE sigbit;
+    volatile BOOL woken;
 } CondWaiter;
 
 typedef struct {
@@ -70,6 +72,16 @@ typedef struct {
     void *arg;
 } CleanupHandler;
 
+// A timer.device request which is kept open by a thread for all of its timed
+// waits, instead of opening the device again for every single one of them.
+typedef struct {
+    struct MsgPort port;
+    struct TimeRequest request;
+    BOOL open;
+    BOOL pending;
+    BOOL cached;
+} ThreadTimer;
+
 typedef struct {
     void *(*start)(void *);
     void *arg;
@@ -86,6 +98,8 @@ typedef struct {
     int canceled;
     int detached;
     char name[NAMELEN];
+    ThreadTimer timer;
+    BYTE waitsig;
 } ThreadInfo;
 
 extern struct SignalSemaphore thread_sem;
@@ -99,6 +113,16 @@ ThreadInfo *GetThreadInfo(pthread_t thread);
 pthread_t GetThreadId(struct Task *task);
 BOOL OpenTimerDevice(struct IORequest *io, struct MsgPort *mp, struct Task *task);
 void CloseTimerDevice(struct IORequest *io);
+ThreadTimer *ObtainThreadTimer(ThreadTimer *local);
+void ReleaseThreadTimer(ThreadTimer *timer);
+void CloseThreadTimer(ThreadTimer *timer);
+int StartThreadTimer(ThreadTimer *timer, const struct timespec *time, BOOL relative);
+void StopThreadTimer(ThreadTimer *timer);
+BYTE ObtainWaitSignal(void);
+void ReleaseWaitSignal(BYTE signal);
+void FreeWaitSignal(ThreadInfo *inf);
+
+#define THREAD_TIMER_MASK(timer) (1UL << (timer)->port.mp_SigBit)
 
 // Private functions
 void _pthread_clear_threadinfo(ThreadInfo *inf);
@@ -106,5 +130,10 @@ int _pthread_mutex_init(pthread_mutex_t *mutex, const pthread_mutexattr_t *attr,
 int _pthread_obtain_sema_timed(struct SignalSemaphore *sema, const struct timespec *abstime, int shared);
 int _pthread_cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *abstime, BOOL relative);
 int _pthread_cond_broadcast(pthread_cond_t *cond, BOOL onlyfirst);
+int _pthread_mutex_lock_slow(pthread_mutex_t *mutex, const struct timespec *abstime);
+void _pthread_mutex_unlock_slow(pthread_mutex_t *mutex);
+void _pthread_futex_init(void);
+int _pthread_futex_wait(volatile int *addr, int value, const struct timespec *abstime, BOOL relative, BOOL cancellable);
+void _pthread_futex_wake(volatile int *addr, int count);
 
 #endif
\ No newline at end of file
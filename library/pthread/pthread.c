@@ -47,6 +47,20 @@ struct SignalSemaphore thread_sem;
 TLSKey tlskeys[PTHREAD_KEYS_MAX];
 struct SignalSemaphore tls_sem;
 
+// Threads waiting on a futex word are queued in one of these buckets, picked by
+// the address of the word, so that mutexes and condition variables need no wait
+// queue of their own and keep the size they had before.
+#define FUTEX_BUCKETS 64
+
+typedef struct {
+    struct SignalSemaphore sema;
+    struct MinList queue;
+} FutexBucket;
+
+static FutexBucket futex_buckets[FUTEX_BUCKETS];
+
+#define FUTEX_BUCKET(addr) (&futex_buckets[((ULONG) (addr) >> 2) & (FUTEX_BUCKETS - 1)])
+
 //
 // Private common functions
 //
@@ -60,56 +74,192 @@ _pthread_mutex_init(pthread_mutex_t *mutex, const pthread_mutexattr_t *attr, BOO
         mutex->kind = attr->kind;
     else if (!staticinit)
         mutex->kind = PTHREAD_MUTEX_DEFAULT;
-    InitSemaphore(&mutex->semaphore);
     mutex->incond = 0;
+    mutex->u.lock.state = 0;
+    mutex->u.lock.owner = NULL;
+    mutex->u.lock.count = 0;
 
     return 0;
 }
 
+// Contended part of the mutex, after the algorithm in Ulrich Drepper's
+// "Futexes Are Tricky": once a thread has to wait, the state is set to 2 so
+// that the owner knows it has to wake somebody up on unlock.
 int
-_pthread_obtain_sema_timed(struct SignalSemaphore *sema, const struct timespec *abstime, int shared) {
-    struct MsgPort msgport;
-    struct SemaphoreMessage msg;
-    struct TimeRequest timerio;
-    struct Task *task;
-    struct Message *m1, *m2;
+_pthread_mutex_lock_slow(pthread_mutex_t *mutex, const struct timespec *abstime) {
+    int state;
+#if defined(CLIB2_STATS)
+    uint64 start = rdtsc();
+#endif
+
+    state = __sync_lock_test_and_set(&mutex->u.lock.state, 2);
+    while (state != 0) {
+        if (_pthread_futex_wait(&mutex->u.lock.state, 2, abstime, FALSE, FALSE) == ETIMEDOUT)
+            return ETIMEDOUT;
 
-    task = FindTask(NULL);
+        state = __sync_lock_test_and_set(&mutex->u.lock.state, 2);
+    }
 
-    if (!OpenTimerDevice((struct IORequest *) &timerio, &msgport, task)) {
-        CloseTimerDevice((struct IORequest *) &timerio);
-        return EINVAL;
+#if defined(CLIB2_STATS)
+    __stats_count_lock(__CLIB2_LOCK_PTHREAD_MUTEX, TRUE, rdtsc() - start);
+#endif
+
+    return 0;
+}
+
+void
+_pthread_mutex_unlock_slow(pthread_mutex_t *mutex) {
+    __sync_lock_release(&mutex->u.lock.state);
+
+    _pthread_futex_wake(&mutex->u.lock.state, 1);
+}
+
+void
+_pthread_futex_init(void) {
+    int i;
+
+    for (i = 0; i < FUTEX_BUCKETS; i++) {
+        InitSemaphore(&futex_buckets[i].sema);
+        NewMinList(&futex_buckets[i].queue);
     }
+}
 
-    timerio.Request.io_Command = TR_ADDREQUEST;
-    timerio.Request.io_Flags = 0;
-    TIMESPEC_TO_TIMEVAL(&timerio.Time, abstime);
-    //if (!relative)
-    {
-        struct TimeVal starttime;
-        // absolute time has to be converted to relative
-        // GetSysTime can't be used due to the timezone offset in abstime
-        gettimeofday((struct timeval *)&starttime, NULL);
-        timersub(&timerio.Time, &starttime, &timerio.Time);
-        if (!timerisset(&timerio.Time)) {
-            CloseTimerDevice((struct IORequest *) &timerio);
-            return ETIMEDOUT;
+// Emulation of the futex wait operation: sleep until woken up, unless *addr no
+// longer holds the expected value. The check and the queueing are done while
+// holding the bucket semaphore, which _pthread_futex_wake() obtains as well, so
+// no wakeup can get lost in between.
+int
+_pthread_futex_wait(volatile int *addr, int value, const struct timespec *abstime, BOOL relative, BOOL cancellable) {
+    FutexBucket *bucket = FUTEX_BUCKET(addr);
+    CondWaiter waiter;
+    ULONG sigs = 0;
+    ULONG received;
+    ThreadTimer local, *timer = NULL;
+    int result = 0;
+
+    waiter.task = FindTask(NULL);
+    waiter.addr = addr;
+    waiter.woken = FALSE;
+
+    if (cancellable)
+        sigs |= SIGBREAKF_CTRL_C;
+
+    if (abstime) {
+        timer = ObtainThreadTimer(&local);
+        if (timer == NULL)
+            return EINVAL;
+
+        result = StartThreadTimer(timer, abstime, relative);
+        if (result != 0) {
+            ReleaseThreadTimer(timer);
+            return result;
         }
+
+        sigs |= THREAD_TIMER_MASK(timer);
+    }
+
+    waiter.sigbit = ObtainWaitSignal();
+    sigs |= 1 << waiter.sigbit;
+
+    ObtainSemaphore(&bucket->sema);
+
+    if (*addr != value) {
+        ReleaseSemaphore(&bucket->sema);
+        goto out;
+    }
+
+    AddTail((struct List *) &bucket->queue, (struct Node *) &waiter);
+    ReleaseSemaphore(&bucket->sema);
+
+    // the fallback signal may be shared, so only trust the woken flag
+    do {
+        received = Wait(sigs);
+    } while (!waiter.woken && !(received & (sigs & ~(1 << waiter.sigbit))));
+
+    ObtainSemaphore(&bucket->sema);
+    if (!waiter.woken)
+        Remove((struct Node *) &waiter);
+    ReleaseSemaphore(&bucket->sema);
+
+    if (!waiter.woken) {
+        if (timer != NULL && (received & THREAD_TIMER_MASK(timer)))
+            result = ETIMEDOUT;
+        else if (received & SIGBREAKF_CTRL_C)
+            result = EINTR;
+    }
+
+out:
+
+    ReleaseWaitSignal(waiter.sigbit);
+
+    if (timer != NULL)
+        ReleaseThreadTimer(timer);
+
+    return result;
+}
+
+// Wake up to count threads waiting on addr; the bucket may hold waiters for other words, too.
+void
+_pthread_futex_wake(volatile int *addr, int count) {
+    FutexBucket *bucket = FUTEX_BUCKET(addr);
+    CondWaiter *waiter, *next;
+
+    ObtainSemaphore(&bucket->sema);
+
+    for (waiter = (CondWaiter *) bucket->queue.mlh_Head;
+         count > 0 && (next = (CondWaiter *) waiter->node.mln_Succ) != NULL;
+         waiter = next) {
+        if (waiter->addr != addr)
+            continue;
+
+        Remove((struct Node *) waiter);
+        waiter->woken = TRUE;
+        Signal(waiter->task, 1 << waiter->sigbit);
+        count--;
     }
-    SendIO((struct IORequest *) &timerio);
 
+    ReleaseSemaphore(&bucket->sema);
+}
+
+int
+_pthread_obtain_sema_timed(struct SignalSemaphore *sema, const struct timespec *abstime, int shared) {
+    struct SemaphoreMessage msg;
+    ThreadTimer local, *timer;
+    struct Message *m;
+    BOOL obtained = FALSE;
+    int result;
+
+    timer = ObtainThreadTimer(&local);
+    if (timer == NULL)
+        return EINVAL;
+
+    result = StartThreadTimer(timer, abstime, FALSE);
+    if (result != 0) {
+        ReleaseThreadTimer(timer);
+        return result;
+    }
+
+    // the semaphore request is replied to the timer's port as well
     msg.ssm_Message.mn_Node.ln_Type = NT_MESSAGE;
     msg.ssm_Message.mn_Node.ln_Name = (char *) shared;
-    msg.ssm_Message.mn_ReplyPort = &msgport;
+    msg.ssm_Message.mn_ReplyPort = &timer->port;
     Procure(sema, &msg);
 
-    WaitPort(&msgport);
-    m1 = GetMsg(&msgport);
-    m2 = GetMsg(&msgport);
-    if (m1 == &timerio.Request.io_Message || m2 == &timerio.Request.io_Message)
-        Vacate(sema, &msg);
+    // the port is reused, so wait until the semaphore request came back
+    while (!obtained) {
+        WaitPort(&timer->port);
 
-    CloseTimerDevice((struct IORequest *) &timerio);
+        while ((m = GetMsg(&timer->port)) != NULL) {
+            if (m == &timer->request.Request.io_Message) {
+                timer->pending = FALSE;
+                Vacate(sema, &msg);
+            } else {
+                obtained = TRUE;
+            }
+        }
+    }
+
+    ReleaseThreadTimer(timer);
 
     if (msg.ssm_Semaphore == NULL)
         return ETIMEDOUT;
@@ -123,115 +273,49 @@ _pthread_clear_threadinfo(ThreadInfo *inf) {
     inf->status = THREAD_STATE_IDLE;
 }
 
+// Condition variables are a sequence counter on top of the futex emulation.
+// A waiter samples the counter before it drops the mutex and sleeps only as long
+// as nobody has bumped it since, so no signal sent in the meantime can get lost.
 int
 _pthread_cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *abstime, BOOL relative) {
-    CondWaiter waiter;
-    BYTE signal;
-    ULONG sigs = SIGBREAKF_CTRL_C;
-    struct MsgPort timermp;
-    struct TimeRequest timerio;
-    struct Task *task;
+    int sequence;
+    int result;
 
     if (cond == NULL || mutex == NULL)
         return EINVAL;
 
-    // initialize static conditions
-    if (SemaphoreIsInvalid(&cond->semaphore))
-        pthread_cond_init(cond, NULL);
-
-    task = FindTask(NULL);
-
-    if (abstime) {
-        // open timer.device
-        if (!OpenTimerDevice((struct IORequest *) &timerio, &timermp, task)) {
-            CloseTimerDevice((struct IORequest *) &timerio);
-            return EINVAL;
-        }
-
-        // prepare the device command and send it
-        timerio.Request.io_Command = TR_ADDREQUEST;
-        timerio.Request.io_Flags = 0;
-        TIMESPEC_TO_TIMEVAL(&timerio.Time, abstime);
-        if (!relative) {
-            struct TimeVal starttime;
-            // absolute time has to be converted to relative
-            // GetSysTime can't be used due to the timezone offset in abstime
-            gettimeofday((struct timeval *)&starttime, NULL);
-            timersub(&timerio.Time, &starttime, &timerio.Time);
-            if (!timerisset(&timerio.Time)) {
-                CloseTimerDevice((struct IORequest *) &timerio);
-                return ETIMEDOUT;
-            }
-        }
-        sigs |= (1 << timermp.mp_SigBit);
-        SendIO((struct IORequest *) &timerio);
-    }
-
-    // prepare a waiter node
-    waiter.task = task;
-    signal = AllocSignal(-1);
-    if (signal == -1) {
-        signal = SIGB_COND_FALLBACK;
-        SetSignal(SIGF_COND_FALLBACK, 0);
-    }
-    waiter.sigbit = signal;
-    sigs |= 1 << waiter.sigbit;
-
-    // add it to the end of the list
-    ObtainSemaphore(&cond->semaphore);
-    AddTail((struct List *) &cond->waiters, (struct Node *) &waiter);
-    ReleaseSemaphore(&cond->semaphore);
+    __sync_fetch_and_add(&cond->u.wait.waiting, 1);
+    sequence = cond->u.wait.sequence;
 
     // wait for the condition to be signalled or the timeout
     mutex->incond++;
     pthread_mutex_unlock(mutex);
-    sigs = Wait(sigs);
+    result = _pthread_futex_wait(&cond->u.wait.sequence, sequence, abstime, relative, TRUE);
     pthread_mutex_lock(mutex);
     mutex->incond--;
 
-    // remove the node from the list
-    ObtainSemaphore(&cond->semaphore);
-    Remove((struct Node *) &waiter);
-    ReleaseSemaphore(&cond->semaphore);
-
-    if (waiter.sigbit != SIGB_COND_FALLBACK)
-        FreeSignal(waiter.sigbit);
-
-    if (abstime) {
-        // clean up the TimeRequest
-        CloseTimerDevice((struct IORequest *) &timerio);
+    __sync_fetch_and_sub(&cond->u.wait.waiting, 1);
 
-        // did we timeout?
-        if (sigs & (1 << timermp.mp_SigBit))
-            return ETIMEDOUT;
-        else if (sigs & SIGBREAKF_CTRL_C)
-            pthread_testcancel();
-    } else {
-        if (sigs & SIGBREAKF_CTRL_C)
-            pthread_testcancel();
+    if (result == EINTR) {
+        pthread_testcancel();
+        result = 0;
     }
 
-    return 0;
+    return result;
 }
 
 int
 _pthread_cond_broadcast(pthread_cond_t *cond, BOOL onlyfirst) {
-    CondWaiter *waiter;
-
     if (cond == NULL)
         return EINVAL;
 
-    // initialize static conditions
-    if (SemaphoreIsInvalid(&cond->semaphore))
-        pthread_cond_init(cond, NULL);
+    // nobody is waiting, nothing to do
+    if (cond->u.wait.waiting == 0)
+        return 0;
 
-    // signal the waiting threads
-    ObtainSemaphore(&cond->semaphore);
-    ForeachNode(&cond->waiters, waiter) {
-        Signal(waiter->task, 1 << waiter->sigbit);
-        if (onlyfirst) break;
-    }
-    ReleaseSemaphore(&cond->semaphore);
+    __sync_fetch_and_add(&cond->u.wait.sequence, 1);
+
+    _pthread_futex_wake(&cond->u.wait.sequence, onlyfirst ? 1 : INT_MAX);
 
     return 0;
 }
@@ -246,6 +330,7 @@ int __pthread_init_func(void) {
     memset(&threads, 0, sizeof(threads));
     InitSemaphore(&thread_sem);
     InitSemaphore(&tls_sem);
+    _pthread_futex_init();
 
     // reserve ID 0 for the main thread
     ThreadInfo *inf = &threads[0];
@@ -266,6 +351,9 @@ void __pthread_exit_func(void) {
     pthread_t i;
     ThreadInfo *inf;
 
+    CloseThreadTimer(&threads[0].timer);
+    FreeWaitSignal(&threads[0]);
+
     // if we don't do this we can easily end up with unloaded code being executed
     for (i = PTHREAD_FIRST_THREAD_ID; i < PTHREAD_THREADS_MAX; i++) {
         inf = &threads[i];
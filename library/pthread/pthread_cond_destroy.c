@@ -42,19 +42,9 @@ pthread_cond_destroy(pthread_cond_t *cond) {
     if (cond == NULL)
         return EINVAL;
 
-    // probably a statically allocated condition
-    if (SemaphoreIsInvalid(&cond->semaphore))
-        return 0;
-
-    if (AttemptSemaphore(&cond->semaphore) == FALSE)
-        return EBUSY;
-
-    if (!IsMinListEmpty(&cond->waiters)) {
-        ReleaseSemaphore(&cond->semaphore);
+    if (cond->u.wait.waiting != 0)
         return EBUSY;
-    }
 
-    ReleaseSemaphore(&cond->semaphore);
     memset(cond, 0, sizeof(pthread_cond_t));
 
     return 0;
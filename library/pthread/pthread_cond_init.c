@@ -43,8 +43,8 @@ pthread_cond_init(pthread_cond_t *cond, const pthread_condattr_t *attr) {
     if (cond == NULL)
         return EINVAL;
 
-    InitSemaphore(&cond->semaphore);
-    NewMinList(&cond->waiters);
+    cond->u.wait.sequence = 0;
+    cond->u.wait.waiting = 0;
 
     return 0;
 }
\ No newline at end of file
@@ -46,6 +46,17 @@ StarterFunc() {
     struct Process *startedTask = (struct Process *) FindTask(NULL);
     ThreadInfo *inf = (ThreadInfo *)startedTask->pr_EntryData;
 
+    // the parent only learns our address once CreateNewProc() returns, but
+    // GetThreadId() needs it right away
+    inf->task = (struct Task *) startedTask;
+
+    // count the CPU time this thread uses
+    __start_cpu_clock();
+
+    // small allocations are served from a cache of our own, which
+    // __thread_cache_exit() hands back below
+    __thread_cache_init();
+
     // custom stack requires special handling
     if (inf->attr.stackaddr != NULL && inf->attr.stacksize > 0) {
         stack.stk_Lower = inf->attr.stackaddr;
@@ -80,9 +91,17 @@ StarterFunc() {
     }
     ReleaseSemaphore(&tls_sem);
 
+    // hand the chunks cached by this thread back to the allocator
+    __thread_cache_exit();
+
+    CloseThreadTimer(&inf->timer);
+    FreeWaitSignal(inf);
+
     if (stackSwapped)
         StackSwap(&stack);
 
+    __stop_cpu_clock();
+
     if (!inf->detached) {
         // tell the parent thread that we are done
         Forbid();
@@ -109,6 +128,9 @@ pthread_create(pthread_t *thread, const pthread_attr_t *attr, void *(*start)(voi
     if (thread == NULL || start == NULL)
         return EINVAL;
 
+    // from now on the library has to lock its streams and memory
+    __enable_locking();
+
     // grab an empty thread slot
     ObtainSemaphore(&thread_sem);
     threadnew = GetThreadId(NULL);
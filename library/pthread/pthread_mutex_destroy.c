@@ -42,19 +42,9 @@ pthread_mutex_destroy(pthread_mutex_t *mutex) {
     if (mutex == NULL)
         return EINVAL;
 
-    // probably a statically allocated mutex
-    if (SemaphoreIsInvalid(&mutex->semaphore))
-        return 0;
-
-    if (/*mutex->incond ||*/ AttemptSemaphore(&mutex->semaphore) == FALSE)
-        return EBUSY;
-
-    if (mutex->incond) {
-        ReleaseSemaphore(&mutex->semaphore);
+    if (mutex->u.lock.state != 0 || mutex->incond)
         return EBUSY;
-    }
 
-    ReleaseSemaphore(&mutex->semaphore);
     memset(mutex, 0, sizeof(pthread_mutex_t));
 
     return 0;
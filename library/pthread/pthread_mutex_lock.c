@@ -39,30 +39,32 @@
 
 int
 pthread_mutex_lock(pthread_mutex_t *mutex) {
-    struct SignalSemaphore *sem;
+    struct Task *task;
 
     if (mutex == NULL)
         return EINVAL;
 
-    sem = &mutex->semaphore;
+    task = FindTask(NULL);
 
-    // initialize static mutexes
-    if (SemaphoreIsInvalid(sem))
-        _pthread_mutex_init(mutex, NULL, TRUE);
+    if (mutex->u.lock.owner == task) {
+        if (mutex->kind == PTHREAD_MUTEX_RECURSIVE) {
+            mutex->u.lock.count++;
+            return 0;
+        }
 
-    // normal mutexes would simply deadlock here
-    if (mutex->kind == PTHREAD_MUTEX_ERRORCHECK && SemaphoreIsMine(sem))
-        return EDEADLK;
+        // normal mutexes would simply deadlock here
+        if (mutex->kind == PTHREAD_MUTEX_ERRORCHECK)
+            return EDEADLK;
+    }
 
-    ObtainSemaphore(sem);
+    // uncontended case: a single compare-and-swap, no semaphore involved
+    if (__sync_bool_compare_and_swap(&mutex->u.lock.state, 0, 1))
+        __COUNT_LOCK(__CLIB2_LOCK_PTHREAD_MUTEX);
+    else
+        _pthread_mutex_lock_slow(mutex, NULL);
 
-#if 0 // let's just deadlock here, to be compatible with normal mutexes on other platforms
-    if (mutex->kind == PTHREAD_MUTEX_NORMAL && sem->ss_NestCount > 1) {
-        // should have blocked - fix this
-        ReleaseSemaphore(sem);
-        return EDEADLK;
-    }
-#endif
+    mutex->u.lock.owner = task;
+    mutex->u.lock.count = 1;
 
     return 0;
 }
\ No newline at end of file
@@ -54,9 +54,17 @@ pthread_mutex_timedlock(pthread_mutex_t *mutex, const struct timespec *abstime)
         // pthread_mutex_trylock returns EBUSY when a deadlock would occur
         if (result != EBUSY)
             return result;
-        else if (mutex->kind != PTHREAD_MUTEX_RECURSIVE && SemaphoreIsMine(&mutex->semaphore))
+        else if (mutex->kind != PTHREAD_MUTEX_RECURSIVE && mutex->u.lock.owner == FindTask(NULL))
             return EDEADLK;
+    } else {
+        return 0;
     }
 
-    return _pthread_obtain_sema_timed(&mutex->semaphore, abstime, SM_EXCLUSIVE);
+    result = _pthread_mutex_lock_slow(mutex, abstime);
+    if (result == 0) {
+        mutex->u.lock.owner = FindTask(NULL);
+        mutex->u.lock.count = 1;
+    }
+
+    return result;
 }
\ No newline at end of file
@@ -39,19 +39,26 @@
 
 int
 pthread_mutex_trylock(pthread_mutex_t *mutex) {
-    ULONG ret;
+    struct Task *task;
 
     if (mutex == NULL)
         return EINVAL;
 
-    // initialize static mutexes
-    if (SemaphoreIsInvalid(&mutex->semaphore))
-        _pthread_mutex_init(mutex, NULL, TRUE);
+    task = FindTask(NULL);
 
-    if (mutex->kind != PTHREAD_MUTEX_RECURSIVE && SemaphoreIsMine(&mutex->semaphore))
+    if (mutex->u.lock.owner == task) {
+        if (mutex->kind != PTHREAD_MUTEX_RECURSIVE)
+            return EBUSY;
+
+        mutex->u.lock.count++;
+        return 0;
+    }
+
+    if (!__sync_bool_compare_and_swap(&mutex->u.lock.state, 0, 1))
         return EBUSY;
 
-    ret = AttemptSemaphore(&mutex->semaphore);
+    mutex->u.lock.owner = task;
+    mutex->u.lock.count = 1;
 
-    return (ret == TRUE) ? 0 : EBUSY;
+    return 0;
 }
\ No newline at end of file
@@ -42,14 +42,18 @@ pthread_mutex_unlock(pthread_mutex_t *mutex) {
     if (mutex == NULL)
         return EINVAL;
 
-    // initialize static mutexes
-    if (SemaphoreIsInvalid(&mutex->semaphore))
-        _pthread_mutex_init(mutex, NULL, TRUE);
-
-    if (mutex->kind != PTHREAD_MUTEX_NORMAL && !SemaphoreIsMine(&mutex->semaphore))
+    if (mutex->kind != PTHREAD_MUTEX_NORMAL && mutex->u.lock.owner != FindTask(NULL))
         return EPERM;
 
-    ReleaseSemaphore(&mutex->semaphore);
+    if (mutex->kind == PTHREAD_MUTEX_RECURSIVE && --mutex->u.lock.count > 0)
+        return 0;
+
+    mutex->u.lock.owner = NULL;
+    mutex->u.lock.count = 0;
+
+    // anything but 1 means that somebody is waiting for us
+    if (__sync_fetch_and_sub(&mutex->u.lock.state, 1) != 1)
+        _pthread_mutex_unlock_slow(mutex);
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+/*
+ * $Id: socket_epoll_create.c,v 1.0 2026-10-17 12:00:00 clib2devs Exp $
+*/
+
+#ifndef _SOCKET_HEADERS_H
+#include "socket_headers.h"
+#endif /* _SOCKET_HEADERS_H */
+
+int
+epoll_create1(int flags) {
+    struct SignalSemaphore *lock = NULL;
+    struct epoll_instance *ep = NULL;
+    int result = ERROR;
+    struct fd *fd;
+    int fd_slot_number;
+
+    ENTER();
+
+    SHOWVALUE(flags);
+
+    /* There is no exec() which the descriptor could be inherited by. */
+    if ((flags & ~EPOLL_CLOEXEC) != 0) {
+        __set_errno(EINVAL);
+        goto out;
+    }
+
+    ep = malloc(sizeof(*ep));
+    if (ep == NULL) {
+        __set_errno(ENOMEM);
+        goto out;
+    }
+
+    memset(ep, 0, sizeof(*ep));
+
+    ep->ep_MaxSocket = -1;
+
+    ep->ep_Lock = __create_semaphore();
+    if (ep->ep_Lock == NULL) {
+        __set_errno(ENOMEM);
+        goto out;
+    }
+
+    __stdio_lock();
+
+    fd_slot_number = __find_vacant_fd_entry();
+    if (fd_slot_number < 0) {
+        if (__grow_fd_table(0) < 0) {
+            SHOWMSG("couldn't find a vacant fd slot and no memory to create one");
+
+            __stdio_unlock();
+            goto out;
+        }
+
+        fd_slot_number = __find_vacant_fd_entry();
+        assert(fd_slot_number >= 0);
+    }
+
+    lock = __create_semaphore();
+    if (lock == NULL) {
+        __stdio_unlock();
+
+        __set_errno(ENOMEM);
+        goto out;
+    }
+
+    fd = __fd[fd_slot_number];
+
+    /* There is no file or socket behind this descriptor, just the
+       instance. */
+    __initialize_fd(fd, __epoll_hook_entry, ZERO, FDF_IN_USE, lock);
+
+    fd->fd_Aux = ep;
+
+    __stdio_unlock();
+
+    lock = NULL;
+    ep = NULL;
+
+    result = fd_slot_number;
+
+out:
+
+    if (ep != NULL) {
+        __delete_semaphore(ep->ep_Lock);
+        free(ep);
+    }
+
+    __delete_semaphore(lock);
+
+    RETURN(result);
+    return (result);
+}
+
+/****************************************************************************/
+
+int
+epoll_create(int size) {
+    int result;
+
+    ENTER();
+
+    SHOWVALUE(size);
+
+    /* The size is only a hint, but it still has to make sense. */
+    if (size <= 0) {
+        __set_errno(EINVAL);
+        result = ERROR;
+    } else {
+        result = epoll_create1(0);
+    }
+
+    RETURN(result);
+    return (result);
+}
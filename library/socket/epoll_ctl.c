@@ -0,0 +1,394 @@
+/*
+ * $Id: socket_epoll_ctl.c,v 1.2 2026-10-17 12:00:00 clib2devs Exp $
+*/
+
+#ifndef _SOCKET_HEADERS_H
+#include "socket_headers.h"
+#endif /* _SOCKET_HEADERS_H */
+
+#define SET_BIT(bits, n) ((bits)[(n) >> 5] |= (1UL << ((n) & 31)))
+#define CLEAR_BIT(bits, n) ((bits)[(n) >> 5] &= ~(1UL << ((n) & 31)))
+
+/****************************************************************************/
+
+/* Make room in a table which maps numbers to item indexes; unused entries
+   are set to -1. */
+static int
+grow_index(int **table_ptr, int *size_ptr, int size) {
+    int *table;
+    int i;
+
+    if (size < 2 * (*size_ptr))
+        size = 2 * (*size_ptr);
+
+    if (size < 32)
+        size = 32;
+
+    table = realloc((*table_ptr), sizeof(*table) * size);
+    if (table == NULL) {
+        __set_errno(ENOMEM);
+        return (ERROR);
+    }
+
+    for (i = (*size_ptr); i < size; i++)
+        table[i] = -1;
+
+    (*table_ptr) = table;
+    (*size_ptr) = size;
+
+    return (OK);
+}
+
+/****************************************************************************/
+
+/* Make room for a socket number in the descriptor sets. */
+static int
+grow_socket_bits(struct epoll_instance *ep, int socket_number) {
+    unsigned long *bits;
+    int num_longs;
+    int i;
+
+    num_longs = (socket_number + 32) / 32;
+    if (num_longs < 2 * ep->ep_NumLongs)
+        num_longs = 2 * ep->ep_NumLongs;
+
+    if (grow_index(&ep->ep_ItemBySocket, &ep->ep_NumSockets, 32 * num_longs) < 0)
+        return (ERROR);
+
+    bits = malloc(3 * num_longs * sizeof(*bits));
+    if (bits == NULL) {
+        __set_errno(ENOMEM);
+        return (ERROR);
+    }
+
+    memset(bits, 0, 3 * num_longs * sizeof(*bits));
+
+    if (ep->ep_SocketBits != NULL) {
+        for (i = 0; i < 3; i++)
+            memcpy(&bits[i * num_longs], &ep->ep_SocketBits[i * ep->ep_NumLongs], ep->ep_NumLongs * sizeof(*bits));
+
+        free(ep->ep_SocketBits);
+    }
+
+    ep->ep_SocketBits = bits;
+    ep->ep_NumLongs = num_longs;
+
+    return (OK);
+}
+
+/****************************************************************************/
+
+/* Take a descriptor off the list of those with edge-triggered events
+   pending. Has to be called with the instance locked. */
+void
+__remove_epoll_edge(struct epoll_instance *ep, int descriptor) {
+    int i;
+
+    for (i = 0; i < ep->ep_NumEdges; i++) {
+        if (ep->ep_Edges[i] == descriptor) {
+            ep->ep_Edges[i] = ep->ep_Edges[--ep->ep_NumEdges];
+            break;
+        }
+    }
+}
+
+/****************************************************************************/
+
+/* Bring the descriptor sets up to date with what an item is waiting for.
+   Has to be called with the instance locked. */
+void
+__update_epoll_item(struct epoll_instance *ep, struct epoll_item *ei) {
+    unsigned long *read_bits, *write_bits, *except_bits;
+    uint32_t events;
+    int s;
+
+    s = ei->ei_Socket;
+    if (s < 0)
+        return;
+
+    assert(s < 32 * ep->ep_NumLongs);
+
+    read_bits = &ep->ep_SocketBits[0];
+    write_bits = &ep->ep_SocketBits[ep->ep_NumLongs];
+    except_bits = &ep->ep_SocketBits[2 * ep->ep_NumLongs];
+
+    /* Edge-triggered events which were reported already are not waited
+       for again until they have gone away. */
+    if (ei->ei_Disabled)
+        events = 0;
+    else
+        events = ei->ei_Events & ~ei->ei_Reported;
+
+    if (FLAG_IS_SET(events, EPOLLIN))
+        SET_BIT(read_bits, s);
+    else
+        CLEAR_BIT(read_bits, s);
+
+    if (FLAG_IS_SET(events, EPOLLOUT))
+        SET_BIT(write_bits, s);
+    else
+        CLEAR_BIT(write_bits, s);
+
+    if (FLAG_IS_SET(events, EPOLLPRI))
+        SET_BIT(except_bits, s);
+    else
+        CLEAR_BIT(except_bits, s);
+}
+
+/****************************************************************************/
+
+/* Check if the descriptor an item refers to was closed, and possibly
+   reused for something else, since it was added. Only a descriptor which
+   ends up with the same file or socket number is not noticed. */
+BOOL
+__epoll_item_is_stale(const struct epoll_item *ei, const struct fd *fd) {
+    if (fd == NULL)
+        return (TRUE);
+
+    return ((BOOL) (ei->ei_FdFlags != (fd->fd_Flags & EPOLL_FD_FLAGS) || ei->ei_FdFile != fd->fd_DefaultFile));
+}
+
+/****************************************************************************/
+
+/* Take a descriptor off the interest list. Has to be called with the
+   instance locked. */
+void
+__remove_epoll_item(struct epoll_instance *ep, int descriptor) {
+    struct epoll_item *ei;
+    int index;
+    int s;
+
+    SHOWVALUE(descriptor);
+
+    assert(descriptor >= 0 && descriptor < ep->ep_NumFds);
+
+    index = ep->ep_ItemByFd[descriptor];
+    assert(index >= 0 && index < ep->ep_NumItems);
+
+    ei = &ep->ep_Items[index];
+
+    if (ei->ei_Reported != 0)
+        __remove_epoll_edge(ep, descriptor);
+
+    if (ei->ei_Socket >= 0) {
+        ei->ei_Disabled = TRUE;
+        __update_epoll_item(ep, ei);
+
+        ep->ep_ItemBySocket[ei->ei_Socket] = -1;
+    } else {
+        ep->ep_NumFiles--;
+    }
+
+    ep->ep_ItemByFd[descriptor] = -1;
+
+    /* The last item takes the place of this one. */
+    ep->ep_NumItems--;
+
+    if (index != ep->ep_NumItems) {
+        (*ei) = ep->ep_Items[ep->ep_NumItems];
+
+        ep->ep_ItemByFd[ei->ei_Descriptor] = index;
+
+        if (ei->ei_Socket >= 0)
+            ep->ep_ItemBySocket[ei->ei_Socket] = index;
+    }
+
+    /* WaitSelect() does not need to look at more sockets than are
+       on the list. */
+    for (s = ep->ep_MaxSocket; s >= 0 && ep->ep_ItemBySocket[s] < 0; s--)
+        continue;
+
+    ep->ep_MaxSocket = s;
+}
+
+/****************************************************************************/
+
+static int
+add_item(struct epoll_instance *ep, int descriptor, struct fd *fd, uint32_t events, epoll_data_t data) {
+    struct epoll_item *ei;
+    int socket_number;
+    int *edges;
+
+    socket_number = FLAG_IS_SET(fd->fd_Flags, FDF_IS_SOCKET) ? fd->fd_Socket : -1;
+
+    if (descriptor >= ep->ep_NumFds && grow_index(&ep->ep_ItemByFd, &ep->ep_NumFds, descriptor + 1) < 0)
+        return (ERROR);
+
+    if (socket_number >= 32 * ep->ep_NumLongs && grow_socket_bits(ep, socket_number) < 0)
+        return (ERROR);
+
+    if (ep->ep_NumItems == ep->ep_MaxItems) {
+        int max_items = (ep->ep_MaxItems > 0) ? 2 * ep->ep_MaxItems : 16;
+
+        ei = realloc(ep->ep_Items, sizeof(*ei) * max_items);
+        if (ei == NULL) {
+            __set_errno(ENOMEM);
+            return (ERROR);
+        }
+
+        ep->ep_Items = ei;
+
+        /* Every item could end up on the edge list. */
+        edges = realloc(ep->ep_Edges, sizeof(*edges) * max_items);
+        if (edges == NULL) {
+            __set_errno(ENOMEM);
+            return (ERROR);
+        }
+
+        ep->ep_Edges = edges;
+
+        ep->ep_MaxItems = max_items;
+    }
+
+    ei = &ep->ep_Items[ep->ep_NumItems];
+
+    memset(ei, 0, sizeof(*ei));
+
+    ei->ei_Descriptor = descriptor;
+    ei->ei_FdFlags = fd->fd_Flags & EPOLL_FD_FLAGS;
+    ei->ei_FdFile = fd->fd_DefaultFile;
+    ei->ei_Socket = socket_number;
+    ei->ei_Events = events;
+    ei->ei_Data = data;
+
+    ep->ep_ItemByFd[descriptor] = ep->ep_NumItems;
+
+    if (socket_number >= 0) {
+        ep->ep_ItemBySocket[socket_number] = ep->ep_NumItems;
+
+        if (ep->ep_MaxSocket < socket_number)
+            ep->ep_MaxSocket = socket_number;
+
+        __update_epoll_item(ep, ei);
+    } else {
+        ep->ep_NumFiles++;
+    }
+
+    ep->ep_NumItems++;
+
+    return (OK);
+}
+
+/****************************************************************************/
+
+int
+epoll_ctl(int epfd, int op, int fd, struct epoll_event *event) {
+    struct epoll_instance *ep = NULL;
+    struct epoll_item *ei = NULL;
+    struct fd *target;
+    uint32_t events = 0;
+    int result = ERROR;
+    int index;
+
+    ENTER();
+
+    SHOWVALUE(epfd);
+    SHOWVALUE(op);
+    SHOWVALUE(fd);
+    SHOWPOINTER(event);
+
+    if (op != EPOLL_CTL_ADD && op != EPOLL_CTL_MOD && op != EPOLL_CTL_DEL) {
+        __set_errno(EINVAL);
+        goto out;
+    }
+
+    if (op != EPOLL_CTL_DEL) {
+        if (event == NULL) {
+            __set_errno(EFAULT);
+            goto out;
+        }
+
+        /* The poll() events have the same values. */
+        if ((event->events & (EPOLLIN | EPOLLRDNORM)) != 0)
+            events |= EPOLLIN;
+
+        if ((event->events & (EPOLLOUT | EPOLLWRNORM)) != 0)
+            events |= EPOLLOUT;
+
+        events |= event->events & (EPOLLPRI | EPOLLET | EPOLLONESHOT);
+    }
+
+    ep = __obtain_epoll_instance(epfd);
+    if (ep == NULL)
+        goto out;
+
+    target = __get_file_descriptor(fd);
+    if (target == NULL) {
+        __set_errno(EBADF);
+        goto out;
+    }
+
+    /* Instances cannot be put on each other's interest lists. */
+    if (target->fd_Action == __epoll_hook_entry) {
+        __set_errno((fd == epfd) ? EINVAL : EPERM);
+        goto out;
+    }
+
+    __obtain_semaphore(ep->ep_Lock);
+
+    index = (fd < ep->ep_NumFds) ? ep->ep_ItemByFd[fd] : -1;
+    if (index >= 0)
+        ei = &ep->ep_Items[index];
+
+    /* The descriptor may have been closed and reused since it was added. */
+    if (ei != NULL && __epoll_item_is_stale(ei, target)) {
+        SHOWMSG("dropping stale item");
+
+        __remove_epoll_item(ep, fd);
+        ei = NULL;
+    }
+
+    switch (op) {
+        case EPOLL_CTL_ADD:
+
+            if (ei != NULL) {
+                __set_errno(EEXIST);
+                break;
+            }
+
+            result = add_item(ep, fd, target, events, event->data);
+            break;
+
+        case EPOLL_CTL_MOD:
+
+            if (ei == NULL) {
+                __set_errno(ENOENT);
+                break;
+            }
+
+            if (ei->ei_Reported != 0)
+                __remove_epoll_edge(ep, fd);
+
+            ei->ei_Events = events;
+            ei->ei_Data = event->data;
+            ei->ei_Reported = 0;
+            ei->ei_Disabled = FALSE;
+
+            __update_epoll_item(ep, ei);
+
+            result = OK;
+            break;
+
+        case EPOLL_CTL_DEL:
+
+            if (ei == NULL) {
+                __set_errno(ENOENT);
+                break;
+            }
+
+            __remove_epoll_item(ep, fd);
+
+            result = OK;
+            break;
+    }
+
+    __release_semaphore(ep->ep_Lock);
+
+out:
+
+    if (ep != NULL)
+        __release_epoll_instance(ep);
+
+    RETURN(result);
+    return (result);
+}
@@ -0,0 +1,198 @@
+/*
+ * $Id: socket_epoll_hook_entry.c,v 1.0 2026-10-17 12:00:00 clib2devs Exp $
+*/
+
+#ifndef _SOCKET_HEADERS_H
+#include "socket_headers.h"
+#endif /* _SOCKET_HEADERS_H */
+
+static void
+delete_epoll_instance(struct epoll_instance *ep) {
+    if (ep == NULL)
+        return;
+
+    free(ep->ep_Items);
+    free(ep->ep_ItemByFd);
+    free(ep->ep_ItemBySocket);
+    free(ep->ep_SocketBits);
+    free(ep->ep_Edges);
+
+    __delete_semaphore(ep->ep_Lock);
+
+    free(ep);
+}
+
+/****************************************************************************/
+
+/* Look up the instance attached to an epoll descriptor, and make sure that
+   it stays around until __release_epoll_instance() is called. */
+struct epoll_instance *
+__obtain_epoll_instance(int epfd) {
+    struct epoll_instance *result = NULL;
+    struct epoll_instance *ep;
+    struct fd *fd;
+
+    ENTER();
+
+    SHOWVALUE(epfd);
+
+    fd = __get_file_descriptor(epfd);
+    if (fd == NULL) {
+        __set_errno(EBADF);
+        goto out;
+    }
+
+    if (fd->fd_Action != __epoll_hook_entry) {
+        __set_errno(EINVAL);
+        goto out;
+    }
+
+    __fd_lock(fd);
+
+    ep = fd->fd_Aux;
+    if (ep != NULL) {
+        Forbid();
+
+        ep->ep_Users++;
+
+        Permit();
+
+        result = ep;
+    }
+
+    __fd_unlock(fd);
+
+    if (result == NULL)
+        __set_errno(EBADF);
+
+out:
+
+    RETURN(result);
+    return (result);
+}
+
+/****************************************************************************/
+
+void
+__release_epoll_instance(struct epoll_instance *ep) {
+    BOOL last_user;
+
+    ENTER();
+
+    SHOWPOINTER(ep);
+
+    assert(ep != NULL && ep->ep_Users > 0);
+
+    Forbid();
+
+    ep->ep_Users--;
+
+    last_user = (BOOL) (ep->ep_Users == 0 && ep->ep_Closed);
+
+    Permit();
+
+    /* The descriptor was closed in the meantime. */
+    if (last_user)
+        delete_epoll_instance(ep);
+
+    LEAVE();
+}
+
+/****************************************************************************/
+
+int64_t
+__epoll_hook_entry(struct fd *fd, struct file_action_message *fam) {
+    struct ExamineData *fib;
+    BOOL is_aliased;
+    int result;
+
+    assert(fam != NULL && fd != NULL);
+
+    /* Careful: file_action_close has to monkey with the file descriptor
+                table and therefore needs to obtain the stdio lock before
+                it locks this particular descriptor entry. */
+    if (fam->fam_Action == file_action_close)
+        __stdio_lock();
+
+    __fd_lock(fd);
+
+    switch (fam->fam_Action) {
+        case file_action_close:
+            SHOWMSG("file_action_close");
+            result = OK;
+
+            /* If this is an alias, just remove it. */
+            is_aliased = __fd_is_aliased(fd);
+            if (is_aliased) {
+                __remove_fd_alias(fd);
+            } else {
+                struct epoll_instance *ep = fd->fd_Aux;
+                BOOL in_use;
+
+                /* A thread may still be waiting on the instance; then it
+                   is the one to free it. Forbid() rather than the instance
+                   lock, so that we never wait for it while holding the
+                   stdio lock. */
+                Forbid();
+
+                ep->ep_Closed = TRUE;
+                in_use = (BOOL) (ep->ep_Users > 0);
+
+                Permit();
+
+                if (NOT in_use)
+                    delete_epoll_instance(ep);
+
+                fd->fd_Aux = NULL;
+            }
+
+            __fd_unlock(fd);
+
+            /* Free the lock semaphore now. */
+            if (NOT is_aliased)
+                __delete_semaphore(fd->fd_Lock);
+
+            /* And that's the last for this file descriptor. */
+            memset(fd, 0, sizeof(*fd));
+            fd = NULL;
+            break;
+
+        case file_action_seek:
+        case file_action_pread:
+        case file_action_pwrite:
+            SHOWMSG("file_action_seek/file_action_pread/file_action_pwrite");
+            result = ERROR;
+            fam->fam_Error = ESPIPE;
+            break;
+
+        case file_action_read:
+        case file_action_write:
+            SHOWMSG("file_action_read/file_action_write");
+            result = ERROR;
+            fam->fam_Error = EINVAL;
+            break;
+
+        case file_action_examine:
+            SHOWMSG("file_action_examine");
+            fib = fam->fam_FileInfo;
+            memset(fib, 0, sizeof(*fib));
+            fib->Type = ST_PIPEFILE;
+            DateStamp(&fib->Date);
+            result = OK;
+            break;
+
+        default:
+            SHOWVALUE(fam->fam_Action);
+            result = ERROR;
+            fam->fam_Error = EBADF;
+            break;
+    }
+
+    __fd_unlock(fd);
+
+    if (fam->fam_Action == file_action_close)
+        __stdio_unlock();
+
+    RETURN(result);
+    return (result);
+}
@@ -0,0 +1,664 @@
+/*
+ * $Id: socket_epoll_wait.c,v 1.2 2026-10-17 12:00:00 clib2devs Exp $
+*/
+
+#ifndef _SOCKET_HEADERS_H
+#include "socket_headers.h"
+#endif /* _SOCKET_HEADERS_H */
+
+#ifndef _UNISTD_HEADERS_H
+#include "unistd_headers.h"
+#endif /* _UNISTD_HEADERS_H */
+
+/* As long as the interest list holds only sockets, the descriptor sets kept
+ * by epoll_ctl() are copied and handed to WaitSelect(), and only the words
+ * with bits set in them are looked at when it returns. Once there are files
+ * on the list, everything goes through __poll_descriptors() instead, which
+ * knows how to wait for them.
+ *
+ * Roadshow can tell when a socket's state changes (SO_EVENTMASK), but it
+ * signals only one task per library base, for all sockets at once, which
+ * does not fit several instances and threads. Edge-triggered events are
+ * therefore emulated: once reported, an event is no longer waited for
+ * until it has been seen to go away. Each call checks without waiting
+ * whether it is still there. Input also counts as gone if a read found
+ * nothing to read since, and so does room to write if a write found none;
+ * this is what a program written for edge triggering does before it waits
+ * again. More input than there was when the event was reported is a new
+ * edge, too.
+ */
+
+/* The events which can actually be waited for. */
+#define WAITABLE_EVENTS (EPOLLIN | EPOLLOUT | EPOLLPRI)
+
+/* Up to this many descriptors or sockets are handled without allocating
+   memory. */
+#define NUM_LOCAL_POLLFDS 32
+#define NUM_LOCAL_LONGS ((FD_SETSIZE + 31) / 32)
+
+#define BIT_IS_SET(bits, n) (((bits)[(n) >> 5] & (1UL << ((n) & 31))) != 0)
+
+/****************************************************************************/
+
+static void
+get_uptime(struct timeval *tv) {
+    struct TimerIFace *ITimer = __ITimer;
+
+    GetUpTime((struct TimeVal *) tv);
+}
+
+/****************************************************************************/
+
+/* Figures out how much time is left until the deadline; returns FALSE if
+   there is none. */
+static BOOL
+get_time_left(const struct timeval *deadline, struct timeval *time_left) {
+    struct timeval now;
+
+    get_uptime(&now);
+
+    if (now.tv_sec > deadline->tv_sec || (now.tv_sec == deadline->tv_sec && now.tv_usec >= deadline->tv_usec)) {
+        time_left->tv_sec = time_left->tv_usec = 0;
+        return (FALSE);
+    }
+
+    time_left->tv_sec = deadline->tv_sec - now.tv_sec;
+    time_left->tv_usec = deadline->tv_usec - now.tv_usec;
+
+    if (time_left->tv_usec < 0) {
+        time_left->tv_sec--;
+        time_left->tv_usec += 1000000;
+    }
+
+    return (TRUE);
+}
+
+/****************************************************************************/
+
+/* Hand an event to the caller. Has to be called with the instance locked. */
+static void
+report_event(struct epoll_instance *ep, struct epoll_item *ei, uint32_t revents, struct epoll_event *event) {
+    uint32_t edges;
+
+    SHOWVALUE(ei->ei_Descriptor);
+    SHOWVALUE(revents);
+
+    event->events = revents;
+    event->data = ei->ei_Data;
+
+    if (FLAG_IS_SET(ei->ei_Events, EPOLLET)) {
+        edges = revents & ei->ei_Events & WAITABLE_EVENTS;
+
+        if (ei->ei_Reported == 0 && edges != 0)
+            ep->ep_Edges[ep->ep_NumEdges++] = ei->ei_Descriptor;
+
+        /* What the descriptor looks like now is noted once the events
+           have been handed out. */
+        if ((edges & ~ei->ei_Reported) != 0)
+            ei->ei_EdgeStateValid = FALSE;
+
+        ei->ei_Reported |= edges;
+    }
+
+    if (FLAG_IS_SET(ei->ei_Events, EPOLLONESHOT))
+        ei->ei_Disabled = TRUE;
+
+    __update_epoll_item(ep, ei);
+}
+
+/****************************************************************************/
+
+/* Find the item for a descriptor; NULL if there is none. Has to be called
+   with the instance locked. */
+static struct epoll_item *
+find_item(struct epoll_instance *ep, int descriptor) {
+    int index;
+
+    if (descriptor < 0 || descriptor >= ep->ep_NumFds)
+        return (NULL);
+
+    index = ep->ep_ItemByFd[descriptor];
+    if (index < 0)
+        return (NULL);
+
+    return (&ep->ep_Items[index]);
+}
+
+/****************************************************************************/
+
+/* Find out how much input is waiting on a descriptor, and how often reads
+   and writes would have blocked. Looking up the descriptor needs the stdio
+   lock, so the instance must not be locked. */
+static void
+get_edge_state(int descriptor, BOOL want_read_count, struct epoll_edge_state *es) {
+    struct fd *fd;
+    int saved_errno;
+    int count = -1;
+
+    saved_errno = __get_errno();
+
+    memset(es, 0, sizeof(*es));
+
+    fd = __get_file_descriptor(descriptor);
+    if (fd != NULL) {
+        if (want_read_count) {
+            if (FLAG_IS_SET(fd->fd_Flags, FDF_IS_RING_PIPE)) {
+                if (__ring_pipe_ioctl(fd, FIONREAD, (char *) &count) < 0)
+                    count = -1;
+            } else if (FLAG_IS_SET(fd->fd_Flags, FDF_IS_SOCKET)) {
+                if (__IoctlSocket(fd->fd_Socket, FIONREAD, (char *) &count) < 0)
+                    count = -1;
+            }
+        }
+
+        /* The counters are shared by all aliases. */
+        if (fd->fd_Original != NULL)
+            fd = fd->fd_Original;
+
+        es->es_NumEmptyReads = fd->fd_NumEmptyReads;
+        es->es_NumFullWrites = fd->fd_NumFullWrites;
+    }
+
+    es->es_ReadCount = count;
+
+    __set_errno(saved_errno);
+}
+
+/****************************************************************************/
+
+/* Look at the descriptors with edge-triggered events reported. Right after
+   the events were handed out, this only notes what the descriptors look
+   like. Otherwise, it checks without waiting which events went away, so
+   that they are waited for again. */
+static int
+check_edges(struct epoll_instance *ep, BOOL just_reported) {
+    struct pollfd local_fds[NUM_LOCAL_POLLFDS];
+    struct epoll_edge_state local_states[NUM_LOCAL_POLLFDS];
+    struct pollfd *fds = local_fds;
+    struct epoll_edge_state *states = local_states;
+    struct timeval no_wait = {0, 0};
+    struct epoll_edge_state *old;
+    struct epoll_item *ei;
+    uint32_t gone;
+    int result = ERROR;
+    int num_fds = 0;
+    int i;
+
+    __obtain_semaphore(ep->ep_Lock);
+
+    if (ep->ep_NumEdges > NUM_LOCAL_POLLFDS) {
+        fds = malloc((sizeof(*fds) + sizeof(*states)) * ep->ep_NumEdges);
+        if (fds == NULL) {
+            __release_semaphore(ep->ep_Lock);
+
+            __set_errno(ENOMEM);
+            goto out;
+        }
+
+        states = (struct epoll_edge_state *) &fds[ep->ep_NumEdges];
+    }
+
+    for (i = 0; i < ep->ep_NumEdges; i++) {
+        ei = find_item(ep, ep->ep_Edges[i]);
+        assert(ei != NULL);
+
+        if (just_reported && ei->ei_EdgeStateValid)
+            continue;
+
+        fds[num_fds].fd = ei->ei_Descriptor;
+        fds[num_fds].events = ei->ei_Reported;
+        fds[num_fds].revents = 0;
+        num_fds++;
+    }
+
+    __release_semaphore(ep->ep_Lock);
+
+    if (num_fds == 0) {
+        result = OK;
+        goto out;
+    }
+
+    if (NOT just_reported && __poll_descriptors(fds, num_fds, &no_wait, NULL) < 0)
+        goto out;
+
+    for (i = 0; i < num_fds; i++)
+        get_edge_state(fds[i].fd, FLAG_IS_SET(fds[i].events, EPOLLIN), &states[i]);
+
+    __obtain_semaphore(ep->ep_Lock);
+
+    for (i = 0; i < num_fds; i++) {
+        /* The list may have changed in the meantime. */
+        ei = find_item(ep, fds[i].fd);
+        if (ei == NULL || ei->ei_Reported == 0)
+            continue;
+
+        if (just_reported) {
+            ei->ei_EdgeState = states[i];
+            ei->ei_EdgeStateValid = TRUE;
+            continue;
+        }
+
+        /* Closed descriptors drop off the list. */
+        if (FLAG_IS_SET(fds[i].revents, POLLNVAL)) {
+            __remove_epoll_item(ep, fds[i].fd);
+            continue;
+        }
+
+        /* Events which are no longer there are waited for again. Note
+           that the end of the input stays readable, and is not reported
+           again. */
+        gone = ei->ei_Reported & ~fds[i].revents;
+
+        if (ei->ei_EdgeStateValid) {
+            old = &ei->ei_EdgeState;
+
+            /* So is input after a read found nothing left, or if there
+               is more of it than before; */
+            if (states[i].es_NumEmptyReads != old->es_NumEmptyReads ||
+                (old->es_ReadCount >= 0 && states[i].es_ReadCount > old->es_ReadCount))
+                gone |= EPOLLIN;
+
+            /* and room to write after a write found none. */
+            if (states[i].es_NumFullWrites != old->es_NumFullWrites)
+                gone |= EPOLLOUT;
+        }
+
+        /* Input which is still there, less of it if some was read, is
+           what the next check compares with. */
+        ei->ei_EdgeState = states[i];
+        ei->ei_EdgeStateValid = TRUE;
+
+        gone &= ei->ei_Reported;
+        if (gone == 0)
+            continue;
+
+        ei->ei_Reported &= ~gone;
+        if (ei->ei_Reported == 0)
+            __remove_epoll_edge(ep, ei->ei_Descriptor);
+
+        __update_epoll_item(ep, ei);
+    }
+
+    __release_semaphore(ep->ep_Lock);
+
+    result = OK;
+
+out:
+
+    if (fds != local_fds)
+        free(fds);
+
+    return (result);
+}
+
+/****************************************************************************/
+
+/* WaitSelect() complained about a socket; take the items whose descriptors
+   were closed off the list. Returns how many there were. */
+static int
+drop_closed_items(struct epoll_instance *ep) {
+    struct epoll_item *ei;
+    struct fd **fds = NULL;
+    int *descriptors = NULL;
+    int num_dropped = 0;
+    int num_items;
+    int i;
+
+    __obtain_semaphore(ep->ep_Lock);
+
+    num_items = ep->ep_NumItems;
+
+    descriptors = malloc(sizeof(*descriptors) * (num_items + 1));
+    fds = malloc(sizeof(*fds) * (num_items + 1));
+
+    if (descriptors == NULL || fds == NULL) {
+        __release_semaphore(ep->ep_Lock);
+        goto out;
+    }
+
+    for (i = 0; i < num_items; i++)
+        descriptors[i] = ep->ep_Items[i].ei_Descriptor;
+
+    __release_semaphore(ep->ep_Lock);
+
+    /* Looking up the descriptors needs the stdio lock. */
+    for (i = 0; i < num_items; i++)
+        fds[i] = __get_file_descriptor(descriptors[i]);
+
+    __obtain_semaphore(ep->ep_Lock);
+
+    for (i = 0; i < num_items; i++) {
+        ei = find_item(ep, descriptors[i]);
+        if (ei != NULL && __epoll_item_is_stale(ei, fds[i])) {
+            SHOWVALUE(descriptors[i]);
+
+            __remove_epoll_item(ep, descriptors[i]);
+            num_dropped++;
+        }
+    }
+
+    __release_semaphore(ep->ep_Lock);
+
+out:
+
+    free(descriptors);
+    free(fds);
+
+    return (num_dropped);
+}
+
+/****************************************************************************/
+
+/* There are files on the list: let __poll_descriptors() deal with
+   everything. */
+static int
+wait_for_descriptors(struct epoll_instance *ep, struct epoll_event *events, int maxevents, const struct timeval *timeout) {
+    struct pollfd local_fds[NUM_LOCAL_POLLFDS];
+    struct pollfd *fds = local_fds;
+    struct epoll_item *ei;
+    uint32_t wanted;
+    int num_events = 0;
+    int result = ERROR;
+    int num_fds = 0;
+    int i;
+
+    __obtain_semaphore(ep->ep_Lock);
+
+    if (ep->ep_NumItems > NUM_LOCAL_POLLFDS) {
+        fds = malloc(sizeof(*fds) * ep->ep_NumItems);
+        if (fds == NULL) {
+            __release_semaphore(ep->ep_Lock);
+
+            __set_errno(ENOMEM);
+            goto out;
+        }
+    }
+
+    for (i = 0; i < ep->ep_NumItems; i++) {
+        ei = &ep->ep_Items[i];
+
+        if (ei->ei_Disabled)
+            continue;
+
+        wanted = ei->ei_Events & ~ei->ei_Reported & WAITABLE_EVENTS;
+        if (wanted == 0)
+            continue;
+
+        fds[num_fds].fd = ei->ei_Descriptor;
+        fds[num_fds].events = wanted;
+        num_fds++;
+    }
+
+    __release_semaphore(ep->ep_Lock);
+
+    if (__poll_descriptors(fds, num_fds, timeout, NULL) < 0)
+        goto out;
+
+    __obtain_semaphore(ep->ep_Lock);
+
+    for (i = 0; i < num_fds && num_events < maxevents; i++) {
+        if (fds[i].revents == 0)
+            continue;
+
+        ei = find_item(ep, fds[i].fd);
+        if (ei == NULL || ei->ei_Disabled)
+            continue;
+
+        if (FLAG_IS_SET(fds[i].revents, POLLNVAL)) {
+            __remove_epoll_item(ep, fds[i].fd);
+            continue;
+        }
+
+        wanted = ei->ei_Events & ~ei->ei_Reported & WAITABLE_EVENTS;
+        if ((fds[i].revents & wanted) == 0)
+            continue;
+
+        report_event(ep, ei, fds[i].revents & wanted, &events[num_events++]);
+    }
+
+    __release_semaphore(ep->ep_Lock);
+
+    result = num_events;
+
+out:
+
+    if (fds != local_fds)
+        free(fds);
+
+    return (result);
+}
+
+/****************************************************************************/
+
+/* Only sockets on the list: wait for them directly. */
+static int
+wait_for_sockets(struct epoll_instance *ep, struct epoll_event *events, int maxevents, struct timeval *timeout) {
+    unsigned long local_bits[3 * NUM_LOCAL_LONGS];
+    unsigned long *bits = local_bits;
+    unsigned long *read_bits = NULL, *write_bits = NULL, *except_bits = NULL;
+    struct epoll_item *ei;
+    ULONG break_mask;
+    uint32_t revents;
+    unsigned long word;
+    int num_events = 0;
+    int result = ERROR;
+    int num_longs = 0;
+    int max_socket;
+    int first, w, i;
+    int index;
+    int n, s;
+
+    __obtain_semaphore(ep->ep_Lock);
+
+    max_socket = ep->ep_MaxSocket;
+
+    if (max_socket >= 0) {
+        num_longs = (max_socket + 32) / 32;
+
+        if (num_longs > NUM_LOCAL_LONGS) {
+            bits = malloc(3 * num_longs * sizeof(*bits));
+            if (bits == NULL) {
+                __release_semaphore(ep->ep_Lock);
+
+                __set_errno(ENOMEM);
+                goto out;
+            }
+        }
+
+        read_bits = &bits[0];
+        write_bits = &bits[num_longs];
+        except_bits = &bits[2 * num_longs];
+
+        memcpy(read_bits, &ep->ep_SocketBits[0], num_longs * sizeof(*bits));
+        memcpy(write_bits, &ep->ep_SocketBits[ep->ep_NumLongs], num_longs * sizeof(*bits));
+        memcpy(except_bits, &ep->ep_SocketBits[2 * ep->ep_NumLongs], num_longs * sizeof(*bits));
+    }
+
+    __release_semaphore(ep->ep_Lock);
+
+    /* Signals to stop on; we want to stop when a break signal arrives. */
+    break_mask = 0;
+
+    if (__check_abort_enabled)
+        break_mask |= __break_signal_mask;
+
+    n = __WaitSelect(max_socket + 1, (fd_set *) read_bits, (fd_set *) write_bits, (fd_set *) except_bits, (struct TimeVal *) timeout, &break_mask);
+
+    /* Stop if a break signal arrives. */
+    if ((n < 0 && __get_errno() == EINTR) || FLAG_IS_SET(break_mask, __break_signal_mask)) {
+        SetSignal(__break_signal_mask, __break_signal_mask);
+        __check_abort();
+    }
+
+    if (n <= 0) {
+        result = n;
+        goto out;
+    }
+
+    __obtain_semaphore(ep->ep_Lock);
+
+    /* Pick up where the last call left off, so that busy sockets with low
+       numbers cannot starve the others. The word the search starts in is
+       looked at twice: first above, and at the end below that socket. */
+    first = (ep->ep_NextScan < 32 * num_longs) ? ep->ep_NextScan : 0;
+
+    for (i = 0; i <= num_longs && num_events < maxevents; i++) {
+        w = ((first >> 5) + i) % num_longs;
+
+        word = read_bits[w] | write_bits[w] | except_bits[w];
+
+        if (i == 0)
+            word &= ~0UL << (first & 31);
+        else if (i == num_longs)
+            word &= ~(~0UL << (first & 31));
+
+        for (s = 32 * w; word != 0 && num_events < maxevents; s++, word >>= 1) {
+            if ((word & 1) == 0)
+                continue;
+
+            index = (s < ep->ep_NumSockets) ? ep->ep_ItemBySocket[s] : -1;
+            if (index < 0)
+                continue;
+
+            ei = &ep->ep_Items[index];
+            if (ei->ei_Disabled)
+                continue;
+
+            revents = 0;
+
+            if (BIT_IS_SET(read_bits, s))
+                revents |= EPOLLIN;
+
+            if (BIT_IS_SET(write_bits, s))
+                revents |= EPOLLOUT;
+
+            if (BIT_IS_SET(except_bits, s))
+                revents |= EPOLLPRI;
+
+            /* epoll_ctl() may have changed the item in the meantime. */
+            revents &= ei->ei_Events & ~ei->ei_Reported;
+            if (revents == 0)
+                continue;
+
+            report_event(ep, ei, revents, &events[num_events++]);
+
+            ep->ep_NextScan = s + 1;
+        }
+    }
+
+    __release_semaphore(ep->ep_Lock);
+
+    result = num_events;
+
+out:
+
+    if (bits != local_bits)
+        free(bits);
+
+    return (result);
+}
+
+/****************************************************************************/
+
+int
+epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout) {
+    struct epoll_instance *ep = NULL;
+    struct timeval deadline;
+    struct timeval wait_time;
+    struct timeval *wait_time_ptr = NULL;
+    BOOL have_files;
+    int result = ERROR;
+
+    ENTER();
+
+    SHOWVALUE(epfd);
+    SHOWPOINTER(events);
+    SHOWVALUE(maxevents);
+    SHOWVALUE(timeout);
+
+    assert(__SocketBase != NULL);
+
+    __check_abort();
+
+    if (maxevents <= 0) {
+        __set_errno(EINVAL);
+        goto out;
+    }
+
+    if (events == NULL) {
+        __set_errno(EFAULT);
+        goto out;
+    }
+
+    ep = __obtain_epoll_instance(epfd);
+    if (ep == NULL)
+        goto out;
+
+    /* A negative timeout means waiting indefinitely, zero means not
+       waiting at all, and anything else is in milliseconds. */
+    if (timeout >= 0) {
+        get_uptime(&deadline);
+
+        deadline.tv_sec += timeout / 1000;
+        deadline.tv_usec += (timeout % 1000) * 1000;
+
+        if (deadline.tv_usec >= 1000000) {
+            deadline.tv_sec++;
+            deadline.tv_usec -= 1000000;
+        }
+
+        wait_time.tv_sec = timeout / 1000;
+        wait_time.tv_usec = (timeout % 1000) * 1000;
+
+        wait_time_ptr = &wait_time;
+    }
+
+    while (TRUE) {
+        if (check_edges(ep, FALSE) < 0)
+            goto out;
+
+        __obtain_semaphore(ep->ep_Lock);
+
+        have_files = (BOOL) (ep->ep_NumFiles > 0);
+
+        __release_semaphore(ep->ep_Lock);
+
+        if (have_files)
+            result = wait_for_descriptors(ep, events, maxevents, wait_time_ptr);
+        else
+            result = wait_for_sockets(ep, events, maxevents, wait_time_ptr);
+
+        if (result < 0) {
+            /* One of the sockets was closed; try again without it. */
+            if (__get_errno() == EBADF && drop_closed_items(ep) > 0) {
+                SHOWMSG("dropped closed descriptors");
+            } else {
+                goto out;
+            }
+        } else if (result > 0) {
+            /* Without this, the next call can still tell when the events
+               went away, just not when more input arrived. */
+            (void) check_edges(ep, TRUE);
+            break;
+        }
+
+        /* Is the time up? Otherwise, whatever woke us up was taken off the
+           list, or changed, in the meantime. */
+        if (wait_time_ptr != NULL && NOT get_time_left(&deadline, &wait_time)) {
+            result = 0;
+            break;
+        }
+
+        SHOWMSG("looking again");
+    }
+
+out:
+
+    if (ep != NULL)
+        __release_epoll_instance(ep);
+
+    __check_abort();
+
+    RETURN(result);
+    return (result);
+}
@@ -1,11 +1,15 @@
 /*
- * $Id: socket_getpeername.c,v 1.8 2006-11-16 10:41:15 clib2devs Exp $
+ * $Id: socket_getpeername.c,v 1.9 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _SOCKET_HEADERS_H
 #include "socket_headers.h"
 #endif /* _SOCKET_HEADERS_H */
 
+#ifndef _UNISTD_HEADERS_H
+#include "unistd_headers.h"
+#endif /* _UNISTD_HEADERS_H */
+
 int
 getpeername(int sockfd, struct sockaddr *name, socklen_t *namelen) {
     struct fd *fd;
@@ -18,7 +22,6 @@ getpeername(int sockfd, struct sockaddr *name, socklen_t *namelen) {
     SHOWPOINTER(namelen);
 
     assert(name != NULL && namelen != NULL);
-    assert(__SocketBase != NULL);
 
     if (name == NULL || namelen == NULL) {
         SHOWMSG("invalid parameters");
@@ -30,7 +33,15 @@ getpeername(int sockfd, struct sockaddr *name, socklen_t *namelen) {
     assert(sockfd >= 0 && sockfd < __num_fd);
     assert(__fd[sockfd] != NULL);
     assert(FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IN_USE));
-    assert(FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IS_SOCKET));
+
+    /* Socket pairs within the program do not go through the TCP/IP stack. */
+    fd = __get_file_descriptor(sockfd);
+    if (fd != NULL && FLAG_IS_SET(fd->fd_Flags, FDF_IS_RING_PIPE)) {
+        result = __ring_pipe_getname(fd, name, namelen);
+        goto out;
+    }
+
+    assert(__SocketBase != NULL);
 
     fd = __get_file_descriptor_socket(sockfd);
     if (fd == NULL)
@@ -1,11 +1,15 @@
 /*
- * $Id: socket_getsockopt.c,v 1.8 2006-11-16 10:41:15 clib2devs Exp $
+ * $Id: socket_getsockopt.c,v 1.9 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _SOCKET_HEADERS_H
 #include "socket_headers.h"
 #endif /* _SOCKET_HEADERS_H */
 
+#ifndef _UNISTD_HEADERS_H
+#include "unistd_headers.h"
+#endif /* _UNISTD_HEADERS_H */
+
 int getsockopt(int sockfd, int level, int optname, void *optval, socklen_t *optlen) {
     struct fd *fd;
     int result = ERROR;
@@ -19,7 +23,6 @@ int getsockopt(int sockfd, int level, int optname, void *optval, socklen_t *optl
     SHOWPOINTER(optlen);
 
     assert(optval != NULL && optlen != NULL);
-    assert(__SocketBase != NULL);
 
     if (optval == NULL || optlen == NULL) {
         SHOWMSG("invalid parameters");
@@ -31,7 +34,15 @@ int getsockopt(int sockfd, int level, int optname, void *optval, socklen_t *optl
     assert(sockfd >= 0 && sockfd < __num_fd);
     assert(__fd[sockfd] != NULL);
     assert(FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IN_USE));
-    assert(FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IS_SOCKET));
+
+    /* Socket pairs within the program do not go through the TCP/IP stack. */
+    fd = __get_file_descriptor(sockfd);
+    if (fd != NULL && FLAG_IS_SET(fd->fd_Flags, FDF_IS_RING_PIPE)) {
+        result = __ring_pipe_getsockopt(fd, level, optname, optval, optlen);
+        goto out;
+    }
+
+    assert(__SocketBase != NULL);
 
     fd = __get_file_descriptor_socket(sockfd);
     if (fd == NULL)
@@ -1,5 +1,5 @@
 /*
- * $Id: socket_hook_entry.c,v 1.19 2021-01-231 13:12:58 clib2devs Exp $
+ * $Id: socket_hook_entry.c,v 1.20 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _SOCKET_HEADERS_H
@@ -36,9 +36,13 @@ __socket_hook_entry(struct fd *fd, struct file_action_message *fam) {
             SHOWVALUE(fam->fam_Size);
 
             result = __recv(fd->fd_Socket, fam->fam_Data, fam->fam_Size, 0);
-            if (result < 0)
+            if (result < 0) {
                 fam->fam_Error = __get_errno();
 
+                if (fam->fam_Error == EWOULDBLOCK)
+                    __fd_count_blocked(fd, fd_NumEmptyReads);
+            }
+
             break;
 
         case file_action_write:
@@ -51,9 +55,13 @@ __socket_hook_entry(struct fd *fd, struct file_action_message *fam) {
             SHOWVALUE(fam->fam_Size);
 
             result = __send(fd->fd_Socket, fam->fam_Data, fam->fam_Size, 0);
-            if (result < 0)
+            if (result < 0) {
                 fam->fam_Error = __get_errno();
 
+                if (fam->fam_Error == EWOULDBLOCK)
+                    __fd_count_blocked(fd, fd_NumFullWrites);
+            }
+
             break;
 
         case file_action_close:
@@ -85,6 +93,12 @@ __socket_hook_entry(struct fd *fd, struct file_action_message *fam) {
             result = ERROR;
             fam->fam_Error = ESPIPE;
             break;
+        case file_action_pread:
+        case file_action_pwrite:
+            SHOWMSG("file_action_pread/file_action_pwrite");
+            result = ERROR;
+            fam->fam_Error = ESPIPE;
+            break;
         case file_action_set_blocking:
             SHOWMSG("file_action_set_blocking");
             param = (int) (fam->fam_Arg == 0);
@@ -1,11 +1,15 @@
 /*
- * $Id: socket_ioctl.c,v 1.14 2006-11-16 10:41:15 clib2devs Exp $
+ * $Id: socket_ioctl.c,v 1.15 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _SOCKET_HEADERS_H
 #include "socket_headers.h"
 #endif /* _SOCKET_HEADERS_H */
 
+#ifndef _UNISTD_HEADERS_H
+#include "unistd_headers.h"
+#endif /* _UNISTD_HEADERS_H */
+
 #ifndef _STDARG_H
 #include <stdarg.h>
 #endif /* _STDARG_H */
@@ -88,7 +92,18 @@ ioctl(int sockfd, int request, ... /* char *arg */) {
     __set_errno(0);
 
     if (request != TIOCGWINSZ && request != TIOCSWINSZ) {
-        if (FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IS_SOCKET)) {
+        if (FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IS_RING_PIPE)) {
+            fd = __get_file_descriptor(sockfd);
+            if (fd == NULL)
+                goto out;
+
+            va_start(arg, request);
+            param = va_arg(arg, char *);
+            va_end(arg);
+
+            result = __ring_pipe_ioctl(fd, request, param);
+        }
+        else if (FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IS_SOCKET)) {
             assert(__SocketBase != NULL);
 
             assert(sockfd >= 0 && sockfd < __num_fd);
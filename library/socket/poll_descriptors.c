@@ -0,0 +1,532 @@
+/*
+ * $Id: socket_poll_descriptors.c,v 1.1 2026-10-17 12:00:00 clib2devs Exp $
+*/
+
+#ifndef _SOCKET_HEADERS_H
+#include "socket_headers.h"
+#endif /* _SOCKET_HEADERS_H */
+
+#ifndef _UNISTD_HEADERS_H
+#include "unistd_headers.h"
+#endif /* _UNISTD_HEADERS_H */
+
+#ifndef _TERMIOS_HEADERS_H
+#include "termios_headers.h"
+#endif /* _TERMIOS_HEADERS_H */
+
+/* This is what select() and poll() have in common. Sockets are handed to
+ * WaitSelect(). Consoles, pipes and disk files cannot be, but each of them
+ * has a waiter which sends a packet or asks for a change notification, and
+ * the reply arrives with a signal which WaitSelect() waits for, too. So
+ * there is only one place where the task goes to sleep, and it sleeps
+ * until something has actually happened, or the time is up. Pipes within
+ * the program signal their waiters directly.
+ */
+
+/* How long a console or pipe is asked to wait for input, at most. The
+   packet cannot be called back, which means that closing the file may
+   have to wait for this long. */
+#define WAIT_CHAR_TIMEOUT 500000
+
+/* Files whose handler supports neither packet nor notification still have
+   to be looked at every now and then. */
+#define POLL_INTERVAL (1000000 / TICKS_PER_SECOND)
+
+/* WaitSelect() does not mind descriptor sets larger than FD_SETSIZE, but
+   FD_SET() does. */
+#define SET_BIT(bits, n) ((bits)[(n) >> 5] |= (1UL << ((n) & 31)))
+#define BIT_IS_SET(bits, n) (((bits)[(n) >> 5] & (1UL << ((n) & 31))) != 0)
+
+/****************************************************************************/
+
+static void
+get_uptime(struct timeval *tv) {
+    struct TimerIFace *ITimer = __ITimer;
+
+    GetUpTime((struct TimeVal *) tv);
+}
+
+/****************************************************************************/
+
+/* Figures out how much time is left until the deadline; returns FALSE if
+   there is none. */
+static BOOL
+get_time_left(const struct timeval *deadline, struct timeval *time_left) {
+    struct timeval now;
+
+    get_uptime(&now);
+
+    if (now.tv_sec > deadline->tv_sec || (now.tv_sec == deadline->tv_sec && now.tv_usec >= deadline->tv_usec)) {
+        time_left->tv_sec = time_left->tv_usec = 0;
+        return (FALSE);
+    }
+
+    time_left->tv_sec = deadline->tv_sec - now.tv_sec;
+    time_left->tv_usec = deadline->tv_usec - now.tv_usec;
+
+    if (time_left->tv_usec < 0) {
+        time_left->tv_sec--;
+        time_left->tv_usec += 1000000;
+    }
+
+    return (TRUE);
+}
+
+/****************************************************************************/
+
+/* Look up a descriptor which is not a socket; NULL if it is one, or if
+   there is no such descriptor. */
+static struct fd *
+get_file(int file_descriptor) {
+    struct fd *fd;
+
+    fd = __get_file_descriptor(file_descriptor);
+    if (fd != NULL && FLAG_IS_SET(fd->fd_Flags, FDF_IS_SOCKET))
+        fd = NULL;
+
+    return (fd);
+}
+
+/****************************************************************************/
+
+/* Check without waiting which of the requested events a file can deliver
+   now. Has to be called with the file descriptor locked. */
+static int
+check_file(struct fd *fd, BPTR file, int events) {
+    struct fd_waiter *fw = fd->fd_Waiter;
+    struct ExamineData *fib;
+    int revents = 0;
+    int64_t size;
+
+    /* Descriptors under poll control are always ready. */
+    if (FLAG_IS_SET(fd->fd_Flags, FDF_POLL))
+        return (events & (POLLIN | POLLOUT));
+
+    /* If this is a writable stream, assume that we can write to it.
+       ZZZ AmigaDOS needs a method to check if the write will block. */
+    if (FLAG_IS_SET(events, POLLOUT) && FLAG_IS_SET(fd->fd_Flags, FDF_WRITE))
+        revents |= POLLOUT;
+
+    if (FLAG_IS_CLEAR(events, POLLIN) || FLAG_IS_CLEAR(fd->fd_Flags, FDF_READ))
+        goto out;
+
+    assert(fw != NULL);
+
+    switch (fw->fw_Kind) {
+        case fd_waiter_console:
+
+            if (FLAG_IS_SET(fd->fd_Flags, FDF_TERMIOS)) {
+                struct termios *tios = fd->fd_Aux;
+
+                SetMode(file, DOSTRUE);
+
+                /* Reading never has to wait in this mode. */
+                if (FLAG_IS_CLEAR(tios->c_cflag, ICANON) && FLAG_IS_SET(tios->c_cflag, NCURSES)) {
+                    revents |= POLLIN;
+                    break;
+                }
+            }
+
+            /* With our packet still outstanding, the handler has not
+               seen any input yet. */
+            if (fw->fw_PacketPending)
+                break;
+
+            /* For an interactive stream, we simply ask. */
+            if (WaitForChar(file, 1))
+                revents |= POLLIN;
+
+            break;
+
+        case fd_waiter_pipe:
+
+            /* Any data reported to be in the "file" indicates that there
+               is something worth reading available. */
+            if (fw->fw_PacketPending)
+                break;
+
+            fib = ExamineObjectTags(EX_FileHandleInput, file, TAG_DONE);
+            if (fib != NULL) {
+                if (fib->FileSize != 0)
+                    revents |= POLLIN;
+
+                FreeDosObject(DOS_EXAMINEDATA, fib);
+            }
+
+            break;
+
+        case fd_waiter_file:
+
+            /* Is there new data to read? */
+            size = GetFileSize(file);
+            if (size != GETPOSITION_ERROR && size > fd->fd_Position)
+                revents |= POLLIN;
+
+            break;
+
+        default:
+
+            break;
+    }
+
+out:
+
+    return (revents);
+}
+
+/****************************************************************************/
+
+int
+__poll_descriptors(struct pollfd *fds, nfds_t nfds, const struct timeval *timeout, ULONG *signal_mask_ptr) {
+    unsigned long local_bits[3 * ((FD_SETSIZE + 31) / 32)];
+    unsigned long *socket_bits = NULL;
+    unsigned long *allocated_bits = NULL;
+    fd_set *socket_read_fds = NULL;
+    fd_set *socket_write_fds = NULL;
+    fd_set *socket_except_fds = NULL;
+    size_t num_longs = 0;
+    struct Task *this_task = FindTask(NULL);
+    struct timeval deadline;
+    struct timeval wait_time;
+    struct timeval *wait_time_ptr;
+    ULONG signal_mask;
+    ULONG waiter_mask = 0;
+    ULONG break_mask;
+    BOOL waiters_armed = FALSE;
+    int signal_bit = -1;
+    int max_socket = -1;
+    int result = ERROR;
+    int num_ready;
+    struct fd *fd;
+    nfds_t i;
+    BPTR file;
+
+    ENTER();
+
+    SHOWPOINTER(fds);
+    SHOWVALUE(nfds);
+    SHOWPOINTER(timeout);
+
+    if (timeout != NULL) {
+        SHOWVALUE(timeout->tv_sec);
+        SHOWVALUE(timeout->tv_usec);
+    }
+
+    assert(__SocketBase != NULL);
+
+    if (signal_mask_ptr != NULL) {
+        signal_mask = (*signal_mask_ptr);
+        (*signal_mask_ptr) = 0;
+    } else {
+        signal_mask = 0;
+    }
+
+    __check_abort();
+
+    /* Find out what we are dealing with. */
+    for (i = 0; i < nfds; i++) {
+        fds[i].revents = 0;
+
+        if (fds[i].fd < 0)
+            continue;
+
+        fd = __get_file_descriptor(fds[i].fd);
+        if (fd == NULL) {
+            SHOWMSG("no file is attached to this descriptor");
+            continue;
+        }
+
+        if (FLAG_IS_SET(fd->fd_Flags, FDF_IS_SOCKET)) {
+            if (max_socket < fd->fd_Socket)
+                max_socket = fd->fd_Socket;
+
+            continue;
+        }
+
+        if (FLAG_IS_SET(fd->fd_Flags, FDF_IS_RING_PIPE))
+            continue;
+
+        /* If we are dealing with STDIN, mark it as Socket. This flag is used in
+         * read() calls to handle carriage return
+         */
+        if (fd->fd_File == STDIN_FILENO) {
+            SET_FLAG(fd->fd_Flags, FDF_NON_BLOCKING);
+            SET_FLAG(fd->fd_Flags, FDF_STDIN_AS_SOCKET);
+        }
+
+        __fd_lock(fd);
+
+        file = __resolve_fd_file(fd);
+        if (file != ZERO && __get_fd_waiter(fd, file) == NULL) {
+            __fd_unlock(fd);
+            goto out;
+        }
+
+        __fd_unlock(fd);
+    }
+
+    /* The descriptor sets for the sockets. */
+    if (max_socket >= 0) {
+        num_longs = (max_socket + 32) / 32;
+
+        if (max_socket < FD_SETSIZE) {
+            socket_bits = local_bits;
+        } else {
+            allocated_bits = malloc(3 * num_longs * sizeof(unsigned long));
+            if (allocated_bits == NULL) {
+                __set_errno(ENOMEM);
+                goto out;
+            }
+
+            socket_bits = allocated_bits;
+        }
+
+        socket_read_fds = (fd_set *) &socket_bits[0];
+        socket_write_fds = (fd_set *) &socket_bits[num_longs];
+        socket_except_fds = (fd_set *) &socket_bits[2 * num_longs];
+    }
+
+    if (timeout != NULL) {
+        get_uptime(&deadline);
+
+        deadline.tv_sec += timeout->tv_sec + (timeout->tv_usec / 1000000);
+        deadline.tv_usec += timeout->tv_usec % 1000000;
+
+        if (deadline.tv_usec >= 1000000) {
+            deadline.tv_sec++;
+            deadline.tv_usec -= 1000000;
+        }
+    }
+
+    while (TRUE) {
+        BOOL must_poll = FALSE;
+        int n;
+
+        __check_abort();
+
+        num_ready = 0;
+
+        /* Check all files without waiting. */
+        for (i = 0; i < nfds; i++) {
+            if (fds[i].fd < 0)
+                continue;
+
+            fd = __get_file_descriptor(fds[i].fd);
+            if (fd == NULL) {
+                fds[i].revents = POLLNVAL;
+                num_ready++;
+                continue;
+            }
+
+            if (FLAG_IS_SET(fd->fd_Flags, FDF_IS_SOCKET))
+                continue;
+
+            __fd_lock(fd);
+
+            file = __resolve_fd_file(fd);
+            if (FLAG_IS_SET(fd->fd_Flags, FDF_IS_RING_PIPE))
+                fds[i].revents = __check_ring_pipe(fd, fds[i].events);
+            else if (file != ZERO && fd->fd_Waiter != NULL)
+                fds[i].revents = check_file(fd, file, fds[i].events);
+            else
+                fds[i].revents = 0;
+
+            __fd_unlock(fd);
+
+            if (fds[i].revents != 0)
+                num_ready++;
+        }
+
+        /* How long can we wait? */
+        if (num_ready > 0) {
+            wait_time.tv_sec = wait_time.tv_usec = 0;
+            wait_time_ptr = &wait_time;
+        } else if (timeout != NULL) {
+            get_time_left(&deadline, &wait_time);
+            wait_time_ptr = &wait_time;
+        } else {
+            wait_time_ptr = NULL;
+        }
+
+        /* Have the files which are not ready yet tell us when they are. */
+        if (wait_time_ptr == NULL || wait_time.tv_sec > 0 || wait_time.tv_usec > 0) {
+            ULONG timeout_micros = WAIT_CHAR_TIMEOUT;
+
+            if (wait_time_ptr != NULL && wait_time.tv_sec == 0 && wait_time.tv_usec < WAIT_CHAR_TIMEOUT)
+                timeout_micros = wait_time.tv_usec;
+
+            if (signal_bit < 0) {
+                signal_bit = AllocSignal(-1);
+                if (signal_bit >= 0)
+                    waiter_mask = (1UL << signal_bit);
+            }
+
+            for (i = 0; i < nfds; i++) {
+                if (fds[i].fd < 0)
+                    continue;
+
+                fd = get_file(fds[i].fd);
+                if (fd == NULL)
+                    continue;
+
+                /* A pipe within the program can wait for room to write, too. */
+                if (FLAG_IS_SET(fd->fd_Flags, FDF_IS_RING_PIPE)) {
+                    if ((fds[i].events & (POLLIN | POLLOUT)) == 0)
+                        continue;
+
+                    __fd_lock(fd);
+
+                    if (signal_bit < 0 || __arm_ring_pipe_waiter(fd, fds[i].events, this_task, signal_bit) < 0)
+                        must_poll = TRUE;
+
+                    waiters_armed = TRUE;
+
+                    __fd_unlock(fd);
+
+                    continue;
+                }
+
+                if (FLAG_IS_CLEAR(fds[i].events, POLLIN) || FLAG_IS_SET(fds[i].revents, POLLIN))
+                    continue;
+
+                __fd_lock(fd);
+
+                file = __resolve_fd_file(fd);
+                if (file != ZERO && fd->fd_Waiter != NULL && fd->fd_Waiter->fw_Kind != fd_waiter_never && FLAG_IS_SET(fd->fd_Flags, FDF_READ)) {
+                    if (signal_bit < 0 || __arm_fd_waiter(fd->fd_Waiter, file, this_task, signal_bit, timeout_micros) < 0)
+                        must_poll = TRUE;
+
+                    waiters_armed = TRUE;
+                }
+
+                __fd_unlock(fd);
+            }
+
+            if (must_poll && (wait_time_ptr == NULL || wait_time.tv_sec > 0 || wait_time.tv_usec > POLL_INTERVAL)) {
+                SHOWMSG("some files have to be polled");
+
+                wait_time.tv_sec = 0;
+                wait_time.tv_usec = POLL_INTERVAL;
+                wait_time_ptr = &wait_time;
+            }
+        }
+
+        /* Now for the sockets. */
+        if (max_socket >= 0) {
+            memset(socket_bits, 0, 3 * num_longs * sizeof(unsigned long));
+
+            for (i = 0; i < nfds; i++) {
+                if (fds[i].fd < 0)
+                    continue;
+
+                fd = __get_file_descriptor(fds[i].fd);
+                if (fd == NULL || FLAG_IS_CLEAR(fd->fd_Flags, FDF_IS_SOCKET) || fd->fd_Socket > max_socket)
+                    continue;
+
+                if (FLAG_IS_SET(fds[i].events, POLLIN))
+                    SET_BIT(socket_read_fds->bits, fd->fd_Socket);
+
+                if (FLAG_IS_SET(fds[i].events, POLLOUT))
+                    SET_BIT(socket_write_fds->bits, fd->fd_Socket);
+
+                if (FLAG_IS_SET(fds[i].events, POLLPRI))
+                    SET_BIT(socket_except_fds->bits, fd->fd_Socket);
+            }
+        }
+
+        /* Signals to stop on; we want to stop when a break signal arrives. */
+        break_mask = signal_mask | waiter_mask;
+
+        if (__check_abort_enabled)
+            break_mask |= __break_signal_mask;
+
+        n = __WaitSelect(max_socket + 1, socket_read_fds, socket_write_fds, socket_except_fds, (struct TimeVal *) wait_time_ptr, &break_mask);
+
+        /* Stop if a break signal arrives. */
+        if ((n < 0 && __get_errno() == EINTR) || FLAG_IS_SET(break_mask, __break_signal_mask)) {
+            SetSignal(__break_signal_mask, __break_signal_mask);
+            __check_abort();
+        }
+
+        /* Update the signal mask if we received an interesting signal. */
+        if (signal_mask_ptr != NULL && (break_mask & signal_mask) != 0)
+            (*signal_mask_ptr) = signal_mask & break_mask;
+
+        /* Timeout, abort or serious error. */
+        if (n < 0)
+            goto out;
+
+        if (n > 0) {
+            for (i = 0; i < nfds; i++) {
+                if (fds[i].fd < 0)
+                    continue;
+
+                fd = __get_file_descriptor(fds[i].fd);
+                if (fd == NULL || FLAG_IS_CLEAR(fd->fd_Flags, FDF_IS_SOCKET) || fd->fd_Socket > max_socket)
+                    continue;
+
+                if (FLAG_IS_SET(fds[i].events, POLLIN) && BIT_IS_SET(socket_read_fds->bits, fd->fd_Socket))
+                    fds[i].revents |= POLLIN;
+
+                if (FLAG_IS_SET(fds[i].events, POLLOUT) && BIT_IS_SET(socket_write_fds->bits, fd->fd_Socket))
+                    fds[i].revents |= POLLOUT;
+
+                if (FLAG_IS_SET(fds[i].events, POLLPRI) && BIT_IS_SET(socket_except_fds->bits, fd->fd_Socket))
+                    fds[i].revents |= POLLPRI;
+
+                if (fds[i].revents != 0)
+                    num_ready++;
+            }
+        }
+
+        /* Did we receive a stop signal, or is there anything to report? */
+        if ((break_mask & signal_mask) != 0 || num_ready > 0)
+            break;
+
+        /* Is the time up? */
+        if (wait_time_ptr != NULL && wait_time.tv_sec == 0 && wait_time.tv_usec == 0)
+            break;
+
+        if (timeout != NULL && NOT get_time_left(&deadline, &wait_time))
+            break;
+
+        /* Something may have happened to one of the files. Take another look. */
+        SHOWMSG("looking again");
+    }
+
+    result = num_ready;
+
+out:
+
+    /* The replies may keep coming, but not to this task. */
+    if (waiters_armed) {
+        for (i = 0; i < nfds; i++) {
+            if (fds[i].fd < 0)
+                continue;
+
+            fd = get_file(fds[i].fd);
+            if (fd == NULL)
+                continue;
+
+            __fd_lock(fd);
+
+            if (FLAG_IS_SET(fd->fd_Flags, FDF_IS_RING_PIPE))
+                __disarm_ring_pipe_waiter(fd, this_task);
+            else if (fd->fd_Waiter != NULL && fd->fd_Waiter->fw_Task == this_task)
+                __disarm_fd_waiter(fd->fd_Waiter);
+
+            __fd_unlock(fd);
+        }
+    }
+
+    if (signal_bit >= 0) {
+        SetSignal(0, waiter_mask);
+        FreeSignal(signal_bit);
+    }
+
+    if (allocated_bits != NULL)
+        free(allocated_bits);
+
+    RETURN(result);
+    return (result);
+}
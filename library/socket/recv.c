@@ -1,11 +1,15 @@
 /*
- * $Id: socket_recv.c,v 1.7 2006-11-16 10:41:15 clib2devs Exp $
+ * $Id: socket_recv.c,v 1.9 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _SOCKET_HEADERS_H
 #include "socket_headers.h"
 #endif /* _SOCKET_HEADERS_H */
 
+#ifndef _UNISTD_HEADERS_H
+#include "unistd_headers.h"
+#endif /* _UNISTD_HEADERS_H */
+
 int
 recv(int sockfd, void *buff, size_t nbytes, int flags) {
     struct fd *fd;
@@ -20,7 +24,6 @@ recv(int sockfd, void *buff, size_t nbytes, int flags) {
 
     assert((int) nbytes >= 0);
     assert(buff != NULL);
-    assert(__SocketBase != NULL);
 
     if (buff == NULL) {
         SHOWMSG("invalid buffer parameter");
@@ -29,11 +32,22 @@ recv(int sockfd, void *buff, size_t nbytes, int flags) {
         goto out;
     }
 
+    /* Socket pairs within the program do not go through the TCP/IP stack. */
+    fd = __get_file_descriptor(sockfd);
+    if (fd != NULL && FLAG_IS_SET(fd->fd_Flags, FDF_IS_RING_PIPE)) {
+        result = __ring_pipe_read(fd, buff, nbytes, flags);
+        goto out;
+    }
+
+    assert(__SocketBase != NULL);
+
     fd = __get_file_descriptor_socket(sockfd);
     if (fd == NULL)
         goto out;
 
     result = __recv(fd->fd_Socket, buff, (LONG) nbytes, flags);
+    if (result < 0 && __get_errno() == EWOULDBLOCK)
+        __fd_count_blocked(fd, fd_NumEmptyReads);
 
 out:
 
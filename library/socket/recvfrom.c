@@ -1,11 +1,15 @@
 /*
- * $Id: socket_recvfrom.c,v 1.9 2006-11-16 10:41:15 clib2devs Exp $
+ * $Id: socket_recvfrom.c,v 1.11 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _SOCKET_HEADERS_H
 #include "socket_headers.h"
 #endif /* _SOCKET_HEADERS_H */
 
+#ifndef _UNISTD_HEADERS_H
+#include "unistd_headers.h"
+#endif /* _UNISTD_HEADERS_H */
+
 ssize_t
 recvfrom(int sockfd, void *buff, size_t len, int flags, struct sockaddr *from, socklen_t *fromlen) {
     struct fd *fd;
@@ -20,11 +24,10 @@ recvfrom(int sockfd, void *buff, size_t len, int flags, struct sockaddr *from, s
     SHOWPOINTER(from);
     SHOWPOINTER(fromlen);
 
-    assert(buff != NULL && from != NULL && fromlen != NULL);
-    assert(__SocketBase != NULL);
+    assert(buff != NULL);
 
-    if (buff == NULL || from == NULL || fromlen == NULL) {
-        SHOWMSG("invalid parameters");
+    if (buff == NULL) {
+        SHOWMSG("invalid buffer parameter");
 
         __set_errno(EFAULT);
         goto out;
@@ -33,13 +36,35 @@ recvfrom(int sockfd, void *buff, size_t len, int flags, struct sockaddr *from, s
     assert(sockfd >= 0 && sockfd < __num_fd);
     assert(__fd[sockfd] != NULL);
     assert(FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IN_USE));
-    assert(FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IS_SOCKET));
+
+    /* Socket pairs within the program do not go through the TCP/IP stack;
+       the data comes from an unnamed peer, and there is no address. */
+    fd = __get_file_descriptor(sockfd);
+    if (fd != NULL && FLAG_IS_SET(fd->fd_Flags, FDF_IS_RING_PIPE)) {
+        result = __ring_pipe_read(fd, buff, len, flags);
+        if (result >= 0 && fromlen != NULL)
+            (*fromlen) = 0;
+
+        goto out;
+    }
+
+    assert(from != NULL && fromlen != NULL);
+    assert(__SocketBase != NULL);
+
+    if (from == NULL || fromlen == NULL) {
+        SHOWMSG("invalid address parameters");
+
+        __set_errno(EFAULT);
+        goto out;
+    }
 
     fd = __get_file_descriptor_socket(sockfd);
     if (fd == NULL)
         goto out;
 
     result = __recvfrom(fd->fd_Socket, buff, len, flags, from, fromlen);
+    if (result < 0 && __get_errno() == EWOULDBLOCK)
+        __fd_count_blocked(fd, fd_NumEmptyReads);
 
 out:
 
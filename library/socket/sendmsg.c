@@ -1,11 +1,15 @@
 /*
- * $Id: socket_sendmsg.c,v 1.8 2006-11-16 10:41:15 clib2devs Exp $
+ * $Id: socket_sendmsg.c,v 1.10 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _SOCKET_HEADERS_H
 #include "socket_headers.h"
 #endif /* _SOCKET_HEADERS_H */
 
+#ifndef _UNISTD_HEADERS_H
+#include "unistd_headers.h"
+#endif /* _UNISTD_HEADERS_H */
+
 int
 sendmsg(int sockfd, const struct msghdr *msg, int flags) {
     struct fd *fd;
@@ -18,7 +22,6 @@ sendmsg(int sockfd, const struct msghdr *msg, int flags) {
     SHOWVALUE(flags);
 
     assert(msg != NULL);
-    assert(__SocketBase != NULL);
 
     if (msg == NULL) {
         SHOWMSG("invalid msg parameter");
@@ -30,13 +33,23 @@ sendmsg(int sockfd, const struct msghdr *msg, int flags) {
     assert(sockfd >= 0 && sockfd < __num_fd);
     assert(__fd[sockfd] != NULL);
     assert(FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IN_USE));
-    assert(FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IS_SOCKET));
+
+    /* Socket pairs within the program do not go through the TCP/IP stack. */
+    fd = __get_file_descriptor(sockfd);
+    if (fd != NULL && FLAG_IS_SET(fd->fd_Flags, FDF_IS_RING_PIPE)) {
+        result = __ring_pipe_sendmsg(fd, msg, flags);
+        goto out;
+    }
+
+    assert(__SocketBase != NULL);
 
     fd = __get_file_descriptor_socket(sockfd);
     if (fd == NULL)
         goto out;
 
     result = __sendmsg(fd->fd_Socket, (struct msghdr *) msg, flags);
+    if (result < 0 && __get_errno() == EWOULDBLOCK)
+        __fd_count_blocked(fd, fd_NumFullWrites);
 
 out:
 
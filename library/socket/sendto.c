@@ -1,11 +1,15 @@
 /*
- * $Id: socket_sendto.c,v 1.11 2006-11-16 10:41:15 clib2devs Exp $
+ * $Id: socket_sendto.c,v 1.13 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _SOCKET_HEADERS_H
 #include "socket_headers.h"
 #endif /* _SOCKET_HEADERS_H */
 
+#ifndef _UNISTD_HEADERS_H
+#include "unistd_headers.h"
+#endif /* _UNISTD_HEADERS_H */
+
 int
 sendto(int sockfd, const void *buff, size_t len, int flags, const struct sockaddr *to, socklen_t tolen) {
     struct fd *fd;
@@ -20,11 +24,10 @@ sendto(int sockfd, const void *buff, size_t len, int flags, const struct sockadd
     SHOWPOINTER(to);
     SHOWVALUE(tolen);
 
-    assert(buff != NULL && to != NULL);
-    assert(__SocketBase != NULL);
+    assert(buff != NULL);
 
-    if (buff == NULL || to == NULL) {
-        SHOWMSG("invalid parameters");
+    if (buff == NULL) {
+        SHOWMSG("invalid buffer parameter");
 
         __set_errno(EFAULT);
         goto out;
@@ -33,13 +36,32 @@ sendto(int sockfd, const void *buff, size_t len, int flags, const struct sockadd
     assert(sockfd >= 0 && sockfd < __num_fd);
     assert(__fd[sockfd] != NULL);
     assert(FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IN_USE));
-    assert(FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IS_SOCKET));
+
+    /* Socket pairs within the program do not go through the TCP/IP stack;
+       they are connected, and the address is ignored. */
+    fd = __get_file_descriptor(sockfd);
+    if (fd != NULL && FLAG_IS_SET(fd->fd_Flags, FDF_IS_RING_PIPE)) {
+        result = __ring_pipe_write(fd, buff, len, flags);
+        goto out;
+    }
+
+    assert(to != NULL);
+    assert(__SocketBase != NULL);
+
+    if (to == NULL) {
+        SHOWMSG("invalid address parameter");
+
+        __set_errno(EFAULT);
+        goto out;
+    }
 
     fd = __get_file_descriptor_socket(sockfd);
     if (fd == NULL)
         goto out;
 
     result = __sendto(fd->fd_Socket, (void *) buff, len, flags, (struct sockaddr *) to, tolen);
+    if (result < 0 && __get_errno() == EWOULDBLOCK)
+        __fd_count_blocked(fd, fd_NumFullWrites);
 
 out:
 
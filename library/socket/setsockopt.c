@@ -1,11 +1,15 @@
 /*
- * $Id: socket_setsockopt.c,v 1.10 2006-11-16 10:41:15 clib2devs Exp $
+ * $Id: socket_setsockopt.c,v 1.11 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _SOCKET_HEADERS_H
 #include "socket_headers.h"
 #endif /* _SOCKET_HEADERS_H */
 
+#ifndef _UNISTD_HEADERS_H
+#include "unistd_headers.h"
+#endif /* _UNISTD_HEADERS_H */
+
 int
 setsockopt(int sockfd, int level, int optname, const void *optval, socklen_t optlen) {
     struct fd *fd;
@@ -20,7 +24,6 @@ setsockopt(int sockfd, int level, int optname, const void *optval, socklen_t opt
     SHOWVALUE(optlen);
 
     assert(optval != NULL);
-    assert(__SocketBase != NULL);
 
     if (optval == NULL) {
         SHOWMSG("invalid optval parameter");
@@ -32,7 +35,15 @@ setsockopt(int sockfd, int level, int optname, const void *optval, socklen_t opt
     assert(sockfd >= 0 && sockfd < __num_fd);
     assert(__fd[sockfd] != NULL);
     assert(FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IN_USE));
-    assert(FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IS_SOCKET));
+
+    /* Socket pairs within the program do not go through the TCP/IP stack. */
+    fd = __get_file_descriptor(sockfd);
+    if (fd != NULL && FLAG_IS_SET(fd->fd_Flags, FDF_IS_RING_PIPE)) {
+        result = __ring_pipe_setsockopt(fd, level, optname, optval, optlen);
+        goto out;
+    }
+
+    assert(__SocketBase != NULL);
 
     fd = __get_file_descriptor_socket(sockfd);
     if (fd == NULL)
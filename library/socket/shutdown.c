@@ -1,11 +1,15 @@
 /*
- * $Id: socket_shutdown.c,v 1.6 2006-11-16 10:41:15 clib2devs Exp $
+ * $Id: socket_shutdown.c,v 1.7 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _SOCKET_HEADERS_H
 #include "socket_headers.h"
 #endif /* _SOCKET_HEADERS_H */
 
+#ifndef _UNISTD_HEADERS_H
+#include "unistd_headers.h"
+#endif /* _UNISTD_HEADERS_H */
+
 int
 shutdown(int sockfd, int how) {
     struct fd *fd;
@@ -16,12 +20,17 @@ shutdown(int sockfd, int how) {
     SHOWVALUE(sockfd);
     SHOWVALUE(how);
 
-    assert(__SocketBase != NULL);
-
     assert(sockfd >= 0 && sockfd < __num_fd);
     assert(__fd[sockfd] != NULL);
     assert(FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IN_USE));
-    assert(FLAG_IS_SET(__fd[sockfd]->fd_Flags, FDF_IS_SOCKET));
+
+    fd = __get_file_descriptor(sockfd);
+    if (fd != NULL && FLAG_IS_SET(fd->fd_Flags, FDF_IS_RING_PIPE)) {
+        result = __ring_pipe_shutdown(fd, how);
+        goto out;
+    }
+
+    assert(__SocketBase != NULL);
 
     fd = __get_file_descriptor_socket(sockfd);
     if (fd == NULL)
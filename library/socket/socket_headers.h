@@ -45,6 +45,14 @@
 #include <syslog.h>
 #endif
 
+#ifndef _POLL_H
+#include <poll.h>
+#endif /* _POLL_H */
+
+#ifndef _SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif /* _SYS_EPOLL_H */
+
 /* Code value. */
 #define SBTB_CODE 1
 #define SBTS_CODE 0x3FFF
@@ -82,6 +90,68 @@ extern int __get_h_errno(void);
 extern void __set_h_errno(int new_h_errno);
 extern BOOL __obtain_daemon_message(VOID);
 extern int __select(int num_fds,fd_set *read_fds,fd_set *write_fds,fd_set *except_fds,struct timeval *timeout,ULONG * signal_mask_ptr);
+extern int __poll_descriptors(struct pollfd *fds,nfds_t nfds,const struct timeval *timeout,ULONG * signal_mask_ptr);
+
+/* The descriptor flags which tell a socket from a file, and a descriptor
+   in use from a closed one. */
+#define EPOLL_FD_FLAGS (FDF_IN_USE | FDF_IS_SOCKET | FDF_IS_RING_PIPE)
+
+/* What a descriptor looked like when an edge-triggered event was reported. */
+struct epoll_edge_state
+{
+	LONG				es_ReadCount;		/* Bytes waiting to be read, or -1 if unknown */
+	ULONG				es_NumEmptyReads;	/* The descriptor's fd_NumEmptyReads */
+	ULONG				es_NumFullWrites;	/* and fd_NumFullWrites */
+};
+
+/* One entry on an epoll instance's interest list. */
+struct epoll_item
+{
+	int					ei_Descriptor;	/* File descriptor table index */
+	ULONG				ei_FdFlags;		/* What the descriptor looked like when it was added, */
+	BPTR				ei_FdFile;		/* so that we can tell if it was closed since */
+	LONG				ei_Socket;		/* Socket number, or -1 for anything else */
+	uint32_t			ei_Events;		/* What to watch for, plus EPOLLET and EPOLLONESHOT */
+	epoll_data_t		ei_Data;		/* Handed back with each event */
+	uint32_t			ei_Reported;	/* Edge-triggered events which were reported and
+										   have not yet been seen to go away */
+	struct epoll_edge_state	ei_EdgeState;	/* What they are compared with */
+	BOOL				ei_EdgeStateValid;
+	BOOL				ei_Disabled;	/* One-shot event was reported */
+};
+
+/* An epoll instance, attached to its file descriptor through fd_Aux. The
+   descriptor sets for WaitSelect() are kept up to date by epoll_ctl(), so
+   that epoll_wait() only needs to copy them. */
+struct epoll_instance
+{
+	struct SignalSemaphore *	ep_Lock;
+	struct epoll_item *			ep_Items;			/* The interest list */
+	int							ep_NumItems;
+	int							ep_MaxItems;
+	int *						ep_ItemByFd;		/* File descriptor -> item index, or -1 */
+	int							ep_NumFds;
+	int *						ep_ItemBySocket;	/* Socket number -> item index, or -1 */
+	int							ep_NumSockets;
+	int							ep_NumFiles;		/* Items which are not sockets */
+	unsigned long *				ep_SocketBits;		/* Read, write and except sets, by socket number */
+	int							ep_NumLongs;		/* Size of each of these sets */
+	int							ep_MaxSocket;		/* Highest socket number on the list, or -1 */
+	int *						ep_Edges;			/* Descriptors with edge-triggered events reported */
+	int							ep_NumEdges;
+	int							ep_NextScan;		/* Where the search for ready sockets resumes */
+	int							ep_Users;			/* epoll_ctl() and epoll_wait() calls in progress;
+													   protected by Forbid() rather than ep_Lock */
+	BOOL						ep_Closed;			/* Last user has to free the instance */
+};
+
+extern int64_t __epoll_hook_entry(struct fd * fd,struct file_action_message * fam);
+extern struct epoll_instance * __obtain_epoll_instance(int epfd);
+extern void __release_epoll_instance(struct epoll_instance * ep);
+extern void __update_epoll_item(struct epoll_instance * ep,struct epoll_item * ei);
+extern BOOL __epoll_item_is_stale(const struct epoll_item * ei,const struct fd * fd);
+extern void __remove_epoll_edge(struct epoll_instance * ep,int descriptor);
+extern void __remove_epoll_item(struct epoll_instance * ep,int descriptor);
 
 /* Syslog stuff */
 extern int syslog_openlog_flags;
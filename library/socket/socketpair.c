@@ -1,11 +1,15 @@
 /*
- * $Id: socket_socketpair.c,v 1.0 2021-01-24 18:27:15 clib2devs Exp $
+ * $Id: socket_socketpair.c,v 1.1 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _SOCKET_HEADERS_H
 #include "socket_headers.h"
 #endif /* _SOCKET_HEADERS_H */
 
+#ifndef _UNISTD_HEADERS_H
+#include "unistd_headers.h"
+#endif /* _UNISTD_HEADERS_H */
+
 int
 socketpair(int domain, int type, int protocol, int socks[2])
 {
@@ -18,8 +22,6 @@ socketpair(int domain, int type, int protocol, int socks[2])
     int listener;
     socklen_t addrlen = sizeof(a.inaddr);
     int reuse = 1;
-    (void)domain;
-    (void)type;
     (void)protocol;
 
     ENTER();
@@ -34,6 +36,17 @@ socketpair(int domain, int type, int protocol, int socks[2])
 
     socks[0] = socks[1] = -1;
 
+    /* A local stream socket pair stays within the program; anything else
+       is made from two connected TCP/IP sockets. */
+    if ((domain == AF_UNIX || domain == AF_LOCAL) && type == SOCK_STREAM) {
+        int result;
+
+        result = __create_ring_pipe(socks, TRUE, FALSE);
+
+        RETURN(result);
+        return result;
+    }
+
     listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
     if (listener == -1) {
         RETURN(ERROR);
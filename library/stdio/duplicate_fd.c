@@ -1,5 +1,5 @@
 /*
- * $Id: stdio_duplicate_fd.c,v 1.6 2006-10-10 13:39:26 clib2devs Exp $
+ * $Id: stdio_duplicate_fd.c,v 1.7 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _STDIO_HEADERS_H
@@ -18,6 +18,10 @@ __duplicate_fd(struct fd *duplicate_fd, struct fd *original_fd)
 	/* Initialize the duplicate to match the original. */
 	__initialize_fd(duplicate_fd, original_fd->fd_Action, original_fd->fd_DefaultFile, original_fd->fd_Flags, original_fd->fd_Lock);
 
+	/* Ring pipes and epoll instances hang off the descriptor; the
+	   duplicate refers to the same one. */
+	duplicate_fd->fd_Aux = original_fd->fd_Aux;
+
 	/* Figure out where the linked list of file descriptors associated
 	   with this one starts. */
 	if (original_fd->fd_Original != NULL)
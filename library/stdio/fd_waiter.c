@@ -0,0 +1,341 @@
+/*
+ * $Id: stdio_fd_waiter.c,v 1.0 2026-10-17 12:00:00 clib2devs Exp $
+*/
+
+#ifndef _STDIO_HEADERS_H
+#include "stdio_headers.h"
+#endif /* _STDIO_HEADERS_H */
+
+/* Room for the name of a disk file to be watched. */
+#define NOTIFY_NAME_SIZE 1024
+
+/****************************************************************************/
+
+/* Pick up whatever arrived at the waiter's port. Returns how many of the
+   messages said that something may have changed; a packet which merely
+   timed out does not count. */
+static int
+collect_replies(struct fd_waiter *fw) {
+    struct Message *msg;
+    int num_news = 0;
+
+    while ((msg = GetMsg(fw->fw_Port)) != NULL) {
+        if (fw->fw_Packet != NULL && msg == fw->fw_Packet->dp_Link) {
+            fw->fw_PacketPending = FALSE;
+
+            if (fw->fw_Packet->dp_Res1 != DOSFALSE) {
+                num_news++;
+            } else if (fw->fw_Packet->dp_Res2 == ERROR_ACTION_NOT_KNOWN) {
+                /* A handler which does not know the packet will never
+                   tell us about new input; that file has to be polled. */
+                fw->fw_Unsupported = TRUE;
+            }
+        } else {
+            /* This must be a change notification. */
+            ReplyMsg(msg);
+
+            num_news++;
+        }
+    }
+
+    return (num_news);
+}
+
+/****************************************************************************/
+
+/* Find out what kind of file this is; has to be called with the file
+   descriptor locked. */
+struct fd_waiter *
+__get_fd_waiter(struct fd *fd, BPTR file) {
+    struct fd_waiter *result = NULL;
+    struct ExamineData *fib;
+    struct fd_waiter *fw;
+
+    ENTER();
+
+    assert(fd != NULL && FLAG_IS_CLEAR(fd->fd_Flags, FDF_IS_SOCKET));
+
+    fw = fd->fd_Waiter;
+    if (fw != NULL) {
+        result = fw;
+        goto out;
+    }
+
+    fw = AllocVecTags(sizeof(*fw), AVT_Type, MEMF_SHARED, AVT_ClearWithValue, 0, TAG_DONE);
+    if (fw == NULL) {
+        __set_errno(ENOMEM);
+        goto out;
+    }
+
+    fw->fw_Port = AllocSysObjectTags(ASOT_PORT, ASOPORT_AllocSig, FALSE, ASOPORT_Signal, SIGB_SINGLE, TAG_DONE);
+    if (fw->fw_Port == NULL) {
+        FreeVec(fw);
+
+        __set_errno(ENOMEM);
+        goto out;
+    }
+
+    /* Nobody is waiting yet. */
+    fw->fw_Port->mp_Flags = PA_IGNORE;
+
+    if (FLAG_IS_SET(fd->fd_Flags, FDF_IS_INTERACTIVE)) {
+        SHOWMSG("this is an interactive stream");
+
+        fw->fw_Kind = fd_waiter_console;
+    } else if (FLAG_IS_SET(fd->fd_Flags, FDF_STDIO)) {
+        SHOWMSG("this is a redirected standard I/O stream");
+
+        fw->fw_Kind = fd_waiter_never;
+    } else {
+        /* Let's see if we can examine the file. Some file systems
+           may not support this. */
+        fib = ExamineObjectTags(EX_FileHandleInput, file, TAG_DONE);
+        if (fib != NULL) {
+            if (fib->Type == ST_PIPEFILE) {
+                SHOWMSG("this is a pipe");
+
+                fw->fw_Kind = fd_waiter_pipe;
+            } else if (FLAG_IS_SET(fd->fd_Flags, FDF_CACHE_POSITION)) {
+                SHOWMSG("this is a disk file");
+
+                fw->fw_Kind = fd_waiter_file;
+            } else {
+                SHOWMSG("file is unusable; it is not a file system and not a pipe.");
+
+                fw->fw_Kind = fd_waiter_never;
+            }
+
+            FreeDosObject(DOS_EXAMINEDATA, fib);
+        } else {
+            SHOWMSG("file is unusable; we cannot examine the file.");
+
+            fw->fw_Kind = fd_waiter_never;
+        }
+    }
+
+    fd->fd_Waiter = fw;
+
+    result = fw;
+
+out:
+
+    RETURN(result);
+    return (result);
+}
+
+/****************************************************************************/
+
+/* Have the task woken up through the given signal as soon as there may be
+   input to read. Returns ERROR if this file has to be polled instead. Has
+   to be called with the file descriptor locked. */
+int
+__arm_fd_waiter(struct fd_waiter *fw, BPTR file, struct Task *task, int signal_bit, ULONG timeout_micros) {
+    struct FileHandle *fh = BADDR(file);
+    int result = ERROR;
+
+    ENTER();
+
+    SHOWPOINTER(fw);
+    SHOWVALUE(signal_bit);
+    SHOWVALUE(timeout_micros);
+
+    assert(fw != NULL && task != NULL && signal_bit >= 0);
+
+    /* Another thread is already waiting for this file. */
+    if (fw->fw_Task != NULL && fw->fw_Task != task) {
+        SHOWMSG("somebody else is waiting");
+        goto out;
+    }
+
+    /* Anything arriving from now on will wake the task up. */
+    Forbid();
+
+    fw->fw_Port->mp_SigTask = task;
+    fw->fw_Port->mp_SigBit = signal_bit;
+    fw->fw_Port->mp_Flags = PA_SIGNAL;
+
+    Permit();
+
+    fw->fw_Task = task;
+
+    /* Whatever arrived before may be news to the caller, who
+       should take another look before going to sleep. */
+    if (collect_replies(fw) > 0) {
+        SHOWMSG("there is news");
+
+        Signal(task, 1UL << signal_bit);
+
+        result = OK;
+        goto out;
+    }
+
+    if (fw->fw_Unsupported) {
+        SHOWMSG("the file has to be polled");
+        goto out;
+    }
+
+    switch (fw->fw_Kind) {
+        case fd_waiter_console:
+        case fd_waiter_pipe:
+
+            /* Only one packet is ever in flight; there is no calling it
+               back, and that is why it is sent with a timeout. */
+            if (fw->fw_PacketPending)
+                break;
+
+            /* "NIL:" has no handler and will never have any input. */
+            if (fh == NULL || fh->fh_MsgPort == NULL)
+                break;
+
+            if (fw->fw_Packet == NULL) {
+                fw->fw_Packet = AllocDosObject(DOS_STDPKT, NULL);
+                if (fw->fw_Packet == NULL) {
+                    SHOWMSG("no memory for the packet");
+                    goto out;
+                }
+            }
+
+            fw->fw_Packet->dp_Type = ACTION_WAIT_CHAR;
+            fw->fw_Packet->dp_Arg1 = (LONG) timeout_micros;
+
+            SendPkt(fw->fw_Packet, fh->fh_MsgPort, fw->fw_Port);
+
+            fw->fw_PacketPending = TRUE;
+
+            break;
+
+        case fd_waiter_file:
+
+            /* The notification stays active until the file is closed. */
+            if (fw->fw_Notifying)
+                break;
+
+            if (fw->fw_NotifyRequest.nr_Name == NULL) {
+                fw->fw_NotifyRequest.nr_Name = AllocVecTags(NOTIFY_NAME_SIZE, AVT_Type, MEMF_SHARED, TAG_DONE);
+                if (fw->fw_NotifyRequest.nr_Name == NULL) {
+                    SHOWMSG("no memory for the file name");
+                    goto out;
+                }
+            }
+
+            if (CANNOT NameFromFH(file, fw->fw_NotifyRequest.nr_Name, NOTIFY_NAME_SIZE)) {
+                SHOWMSG("could not get the file name");
+
+                fw->fw_Unsupported = TRUE;
+                goto out;
+            }
+
+            fw->fw_NotifyRequest.nr_Flags = NRF_SEND_MESSAGE;
+            fw->fw_NotifyRequest.nr_stuff.nr_Msg.nr_Port = fw->fw_Port;
+
+            if (CANNOT StartNotify(&fw->fw_NotifyRequest)) {
+                SHOWMSG("file system does not support notification");
+
+                fw->fw_Unsupported = TRUE;
+                goto out;
+            }
+
+            fw->fw_Notifying = TRUE;
+
+            break;
+
+        default:
+
+            break;
+    }
+
+    result = OK;
+
+out:
+
+    RETURN(result);
+    return (result);
+}
+
+/****************************************************************************/
+
+/* Stop waking the task up; replies arriving now will simply queue up.
+   Has to be called with the file descriptor locked. */
+void
+__disarm_fd_waiter(struct fd_waiter *fw) {
+    ENTER();
+
+    SHOWPOINTER(fw);
+
+    assert(fw != NULL);
+
+    Forbid();
+
+    fw->fw_Port->mp_Flags = PA_IGNORE;
+
+    Permit();
+
+    fw->fw_Task = NULL;
+
+    LEAVE();
+}
+
+/****************************************************************************/
+
+/* Called when the file is closed, with the file descriptor locked. */
+void
+__delete_fd_waiter(struct fd *fd) {
+    struct fd_waiter *fw;
+
+    ENTER();
+
+    SHOWPOINTER(fd);
+
+    assert(fd != NULL);
+
+    fw = fd->fd_Waiter;
+    if (fw == NULL)
+        goto out;
+
+    fd->fd_Waiter = NULL;
+
+    if (fw->fw_Notifying)
+        EndNotify(&fw->fw_NotifyRequest);
+
+    /* A packet still in flight has to come back before its port
+       can go away; at the latest, that is when its timeout has
+       elapsed. */
+    if (fw->fw_PacketPending) {
+        SHOWMSG("waiting for the packet to return");
+
+        Forbid();
+
+        fw->fw_Port->mp_SigTask = FindTask(NULL);
+        fw->fw_Port->mp_SigBit = SIGB_SINGLE;
+        fw->fw_Port->mp_Flags = PA_SIGNAL;
+
+        Permit();
+
+        SetSignal(0, SIGF_SINGLE);
+
+        collect_replies(fw);
+
+        while (fw->fw_PacketPending) {
+            Wait(SIGF_SINGLE);
+
+            collect_replies(fw);
+        }
+    }
+
+    /* Notifications have to be replied to. */
+    collect_replies(fw);
+
+    FreeSysObject(ASOT_PORT, fw->fw_Port);
+
+    if (fw->fw_Packet != NULL)
+        FreeDosObject(DOS_STDPKT, fw->fw_Packet);
+
+    if (fw->fw_NotifyRequest.nr_Name != NULL)
+        FreeVec(fw->fw_NotifyRequest.nr_Name);
+
+    FreeVec(fw);
+
+out:
+
+    LEAVE();
+}
@@ -1,5 +1,5 @@
 /*
- * $Id: stdio_fdhookentry.c,v 1.37 2022-08-11 17:12:23 clib2devs Exp $
+ * $Id: stdio_fdhookentry.c,v 1.38 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _STDIO_HEADERS_H
@@ -24,6 +24,7 @@
 int64_t __fd_hook_entry(struct fd *fd, struct file_action_message *fam) {
     struct ExamineData *exd = NULL;
     BOOL fib_is_valid = FALSE;
+    BOOL position_changed;
     struct FileHandle *fh;
     int64_t current_position = 0;
     int64_t new_position = 0;
@@ -142,6 +143,118 @@ int64_t __fd_hook_entry(struct fd *fd, struct file_action_message *fam) {
 
             break;
 
+        case file_action_pread:
+        case file_action_pwrite:
+
+            SHOWMSG((fam->fam_Action == file_action_pread) ? "file_action_pread" : "file_action_pwrite");
+
+            assert(fam->fam_Data != NULL);
+            assert(fam->fam_Size > 0);
+
+            if (FLAG_IS_SET(fd->fd_Flags, FDF_IS_DIRECTORY) || FLAG_IS_SET(fd->fd_Flags, FDF_PATH_ONLY)) {
+                fam->fam_Error = EBADF;
+                goto out;
+            }
+
+            if (FLAG_IS_SET(fd->fd_Flags, FDF_IS_INTERACTIVE)) {
+                SHOWMSG("can't seek in an interactive stream");
+
+                fam->fam_Error = ESPIPE;
+                goto out;
+            }
+
+            /* This is where the file position has to return to. */
+            if (FLAG_IS_SET(fd->fd_Flags, FDF_CACHE_POSITION)) {
+                current_position = fd->fd_Position;
+            } else {
+                current_position = GetFilePosition(file);
+                if (current_position == GETPOSITION_ERROR) {
+                    fam->fam_Error = __translate_io_error_to_errno(IoErr());
+                    goto out;
+                }
+            }
+
+            /* Seek and transfer in one go, so that nobody else can move the
+               file position in between. No seek at all is needed if the file
+               position is already where the data goes. */
+            position_changed = FALSE;
+
+            if (fam->fam_Action == file_action_pwrite && FLAG_IS_SET(fd->fd_Flags, FDF_APPEND)) {
+                SHOWMSG("appending data");
+
+                if (ChangeFilePosition(file, 0, OFFSET_END) == CHANGE_FILE_ERROR) {
+                    fam->fam_Error = __translate_io_error_to_errno(IoErr());
+                    goto out;
+                }
+
+                position_changed = TRUE;
+            } else if (fam->fam_Offset != current_position) {
+                D(("moving from position %lld to %lld", current_position, fam->fam_Offset));
+
+                position_changed = TRUE;
+
+                if (ChangeFilePosition(file, fam->fam_Offset, OFFSET_BEGINNING) == CHANGE_FILE_ERROR) {
+                    LONG error = IoErr();
+
+                    /* Did this fail because the file is shorter than that? */
+                    file_size = GetFileSize(file);
+                    if (file_size == GETPOSITION_ERROR || fam->fam_Offset <= file_size) {
+                        fam->fam_Error = __translate_io_error_to_errno(error);
+                        goto restore_position;
+                    }
+
+                    /* There is nothing to read past the end of the file. */
+                    if (fam->fam_Action == file_action_pread) {
+                        result = 0;
+                        goto restore_position;
+                    }
+
+                    /* Writing past the end of the file makes it grow, just
+                       like seeking past it does. */
+                    if (NOT __unix_path_semantics) {
+                        fam->fam_Error = __translate_io_error_to_errno(error);
+                        goto restore_position;
+                    }
+
+                    if (__grow_file_size(fd, fam->fam_Offset - file_size) < 0) {
+                        fam->fam_Error = __translate_io_error_to_errno(IoErr());
+                        goto restore_position;
+                    }
+                }
+            }
+
+            if (fam->fam_Action == file_action_pread) {
+                D(("read %ld bytes from position %lld to 0x%08lx", fam->fam_Size, fam->fam_Offset, fam->fam_Data));
+
+                result = (int64_t) Read(file, fam->fam_Data, fam->fam_Size);
+            } else {
+                D(("write %ld bytes to position %lld from 0x%08lx", fam->fam_Size, fam->fam_Offset, fam->fam_Data));
+
+                result = (int64_t) Write(file, fam->fam_Data, fam->fam_Size);
+            }
+
+            if (result == EOF) {
+                D(("transfer failed ioerr=%ld", IoErr()));
+
+                fam->fam_Error = __translate_io_error_to_errno(IoErr());
+            }
+
+            if (result > 0)
+                position_changed = TRUE;
+
+        restore_position:
+
+            if (position_changed && ChangeFilePosition(file, current_position, OFFSET_BEGINNING) == CHANGE_FILE_ERROR) {
+                D(("could not return to position %lld; ioerr=%ld", current_position, IoErr()));
+
+                fam->fam_Error = __translate_io_error_to_errno(IoErr());
+                result = EOF;
+            }
+
+            fd->fd_Position = current_position;
+
+            break;
+
         case file_action_close:
 
             SHOWMSG("file_action_close");
@@ -151,6 +264,12 @@ int64_t __fd_hook_entry(struct fd *fd, struct file_action_message *fam) {
             if (!FLAG_IS_SET(fd->fd_Flags, FDF_IS_DIRECTORY) && !FLAG_IS_SET(fd->fd_Flags, FDF_PATH_ONLY)) {
                 /* If this is an alias, just remove it. */
                 is_aliased = __fd_is_aliased(fd);
+
+                /* Nobody can wait for input through this descriptor any more. Every
+                   alias has a waiter of its own, so this goes for aliases, too. */
+                if (fd->fd_Waiter != NULL)
+                    __delete_fd_waiter(fd);
+
                 if (is_aliased) {
                     __remove_fd_alias(fd);
                 } else if (FLAG_IS_CLEAR(fd->fd_Flags, FDF_STDIO)) {
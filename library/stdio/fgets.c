@@ -10,7 +10,6 @@ char *
 fgets(char *buf, int n, FILE *stream) {
     struct iob *file = (struct iob *) stream;
     char *s = buf;
-    int c;
 
     ENTER();
     SHOWPOINTER(buf);
@@ -48,53 +47,15 @@ fgets(char *buf, int n, FILE *stream) {
     n--;
 
     while (n > 0) {
-        /* If there is data in the buffer, try to copy it directly
-           into the string buffer. If there is a line feed in the
-           buffer, too, try to conclude the read operation. */
-        if (file->iob_BufferPosition < file->iob_BufferReadBytes) {
-            const unsigned char *buffer = &file->iob_Buffer[file->iob_BufferPosition];
-            size_t num_bytes_in_buffer;
-            const unsigned char *lf;
-
-            /* Copy only as much data as will fit into the string buffer. */
-            num_bytes_in_buffer = (size_t) file->iob_BufferReadBytes - (size_t) file->iob_BufferPosition;
-            if (num_bytes_in_buffer > (off_t) n)
-                num_bytes_in_buffer = n;
-
-            /* Try to find a line feed character which could conclude
-               the read operation if the remaining buffer data, including
-               the line feed character, fit into the string buffer. */
-            lf = (unsigned char *) memchr(buffer, '\n', num_bytes_in_buffer);
-            if (lf != NULL) {
-                size_t num_characters_in_line = ++lf - buffer;
-
-                /* Copy the remainder of the read buffer into the
-                   string buffer, including the terminating line
-                   feed character. */
-                memcpy(s, buffer, num_characters_in_line);
-
-                file->iob_BufferPosition += num_characters_in_line;
-                s[num_characters_in_line] = 0;
-                /* And that concludes the line read operation. */
-                goto out;
-            }
+        const unsigned char *buffer;
+        size_t num_bytes_in_buffer;
+        const unsigned char *lf;
 
-            memcpy(s, buffer, num_bytes_in_buffer);
-            s += num_bytes_in_buffer;
+        /* The read buffer is only refilled once it has been used up. */
+        if (__iob_read_buffer_is_empty(file)) {
+            __check_abort();
 
-            file->iob_BufferPosition += num_bytes_in_buffer;
-
-            /* Stop if the string buffer has been filled. */
-            n -= num_bytes_in_buffer;
-            if (n == 0)
-                break;
-        }
-
-        /* Read the next buffered character; this will refill the read
-           buffer, if necessary. */
-        c = __getc(stream);
-        if (c == EOF) {
-            if (ferror(stream)) {
+            if (__fill_iob_read_buffer(file) < 0) {
                 /* Just to be on the safe side. */
                 (*s) = '\0';
 
@@ -102,19 +63,53 @@ fgets(char *buf, int n, FILE *stream) {
                 goto out;
             }
 
-            /* Make sure that we return NULL if we really
-               didn't read anything at all */
-            if (buf == s)
-                buf = NULL;
+            if (__iob_read_buffer_is_empty(file)) {
+                SET_FLAG(file->iob_Flags, IOBF_EOF_REACHED);
 
-            break;
+                /* Make sure that we return NULL if we really
+                   didn't read anything at all */
+                if (buf == s)
+                    buf = NULL;
+
+                break;
+            }
         }
 
-        (*s++) = c;
-        if (c == '\n')
-            break;
+        /* Copy the buffered data directly into the string buffer. If
+           there is a line feed in the buffer, too, try to conclude the
+           read operation. */
+        buffer = &file->iob_Buffer[file->iob_BufferPosition];
+
+        /* Copy only as much data as will fit into the string buffer. */
+        num_bytes_in_buffer = (size_t) file->iob_BufferReadBytes - (size_t) file->iob_BufferPosition;
+        if (num_bytes_in_buffer > (size_t) n)
+            num_bytes_in_buffer = n;
+
+        /* Try to find a line feed character which could conclude
+           the read operation if the remaining buffer data, including
+           the line feed character, fit into the string buffer. */
+        lf = (unsigned char *) memchr(buffer, '\n', num_bytes_in_buffer);
+        if (lf != NULL) {
+            size_t num_characters_in_line = ++lf - buffer;
+
+            /* Copy the remainder of the read buffer into the
+               string buffer, including the terminating line
+               feed character. */
+            memcpy(s, buffer, num_characters_in_line);
+
+            file->iob_BufferPosition += num_characters_in_line;
+            s[num_characters_in_line] = 0;
+            /* And that concludes the line read operation. */
+            goto out;
+        }
+
+        memcpy(s, buffer, num_bytes_in_buffer);
+        s += num_bytes_in_buffer;
+
+        file->iob_BufferPosition += num_bytes_in_buffer;
 
-        n--;
+        /* Stop if the string buffer has been filled. */
+        n -= num_bytes_in_buffer;
     }
 
     (*s) = '\0';
@@ -1,5 +1,5 @@
 /*
- * $Id: stdio_flockfile.c,v 1.4 2006-01-08 12:04:24 clib2devs Exp $
+ * $Id: stdio_flockfile.c,v 1.5 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _STDIO_HEADERS_H
@@ -32,7 +32,7 @@ flockfile(FILE *stream) {
     }
 
     if (file->iob_Lock != NULL)
-        ObtainSemaphore(file->iob_Lock);
+        __OBTAIN_SEMAPHORE_AT(file->iob_Lock, __CLIB2_LOCK_IOB);
 
 out:
     return;
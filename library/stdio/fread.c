@@ -87,8 +87,9 @@ fread(void *ptr, size_t element_size, size_t count, FILE *stream) {
         } else {
             while (total_size > 0) {
                 /* If there is more data to be read and the read buffer is empty
-                   anyway, we'll bypass the buffer entirely. */
-                if (file->iob_BufferReadBytes == 0 && total_size >= (size_t) file->iob_BufferSize) {
+                   anyway, we'll bypass the buffer entirely. Streams in streaming
+                   mode may have read ahead, so they have to use the buffer. */
+                if (file->iob_BufferReadBytes == 0 && total_size >= (size_t) file->iob_BufferSize && file->iob_Stream == NULL) {
                     ssize_t num_bytes_read;
 
                     /* We bypass the buffer entirely. */
@@ -36,7 +36,7 @@ ftrylockfile(FILE *stream) {
         goto out;
     }
 
-    if (file->iob_Lock != NULL && CANNOT AttemptSemaphore(file->iob_Lock))
+    if (file->iob_Lock != NULL && CANNOT __attempt_semaphore(file->iob_Lock))
     goto out;
 
     result = OK;
@@ -30,7 +30,7 @@ funlockfile(FILE *stream) {
     }
 
     if (file->iob_Lock != NULL)
-        ReleaseSemaphore(file->iob_Lock);
+        __release_semaphore(file->iob_Lock);
 
 out:
     return;
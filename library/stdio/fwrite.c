@@ -150,8 +150,9 @@ fwrite(const void *ptr, size_t element_size, size_t count, FILE *stream) {
                 while (total_size > 0) {
                     /* If there is more data to be written than the write buffer will hold
                        and the write buffer is empty anyway, then we'll bypass the write
-                       buffer entirely. */
-                    if (file->iob_BufferWriteBytes == 0 && total_size >= (size_t) file->iob_BufferSize) {
+                       buffer entirely. Streams in streaming mode keep using the buffer,
+                       so that they can write it behind. */
+                    if (file->iob_BufferWriteBytes == 0 && total_size >= (size_t) file->iob_BufferSize && file->iob_Stream == NULL) {
                         ssize_t num_bytes_written;
 
                         /* We bypass the buffer entirely. */
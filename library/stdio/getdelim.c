@@ -8,39 +8,127 @@
 
 ssize_t
 getdelim(char **lineptr, size_t *n, int delimiter, FILE *stream) {
-    char *ptr = *lineptr;
-    size_t size = (ptr != NULL) ? *n : 0;
+    struct iob *file = (struct iob *) stream;
+    ssize_t result = -1;
+    size_t size;
     size_t len = 0;
+    char *ptr;
 
     ENTER();
-    SHOWPOINTER(*lineptr);
+    SHOWPOINTER(lineptr);
     SHOWPOINTER(n);
     SHOWVALUE(delimiter);
     SHOWPOINTER(stream);
 
+    assert(lineptr != NULL && n != NULL && stream != NULL);
+
+    if (lineptr == NULL || n == NULL || stream == NULL) {
+        SHOWMSG("invalid parameters");
+
+        __set_errno(EINVAL);
+
+        RETURN(result);
+        return result;
+    }
+
+    flockfile(stream);
+
+    /* Take care of the checks and data structure changes that
+     * need to be handled only once for this stream.
+     */
+    if (__fgetc_check(stream) < 0)
+        goto out;
+
+    ptr = (*lineptr);
+    size = (ptr != NULL) ? (*n) : 0;
+
     for (;;) {
-        if ((size - len) <= 2) {
-            size = size ? (size * 2) : 256;
-            ptr = realloc(*lineptr, size);
-            if (ptr == NULL)
-                return -1;
-            *lineptr = ptr;
-            *n = size;
+        const unsigned char *buffer;
+        const unsigned char *delim;
+        size_t num_bytes_in_buffer;
+        size_t num_bytes;
+
+        /* The read buffer is only refilled once it has been used up. */
+        if (__iob_read_buffer_is_empty(file)) {
+            __check_abort();
+
+            if (__fill_iob_read_buffer(file) < 0)
+                goto out;
+
+            if (__iob_read_buffer_is_empty(file)) {
+                SET_FLAG(file->iob_Flags, IOBF_EOF_REACHED);
+
+                /* Nothing at all could be read? */
+                if (len == 0)
+                    goto out;
+
+                break;
+            }
+        }
+
+        /* Look for the delimiter in what is left of the read buffer,
+         * and take everything up to and including it in one go.
+         */
+        buffer = &file->iob_Buffer[file->iob_BufferPosition];
+        num_bytes_in_buffer = (size_t) file->iob_BufferReadBytes - (size_t) file->iob_BufferPosition;
+
+        delim = memchr(buffer, (unsigned char) delimiter, num_bytes_in_buffer);
+        if (delim != NULL)
+            num_bytes = delim + 1 - buffer;
+        else
+            num_bytes = num_bytes_in_buffer;
+
+        if (num_bytes >= (size_t) SSIZE_MAX - len) {
+            SHOWMSG("line too long");
+
+            SET_FLAG(file->iob_Flags, IOBF_ERROR);
+
+            __set_errno(EOVERFLOW);
+            goto out;
         }
 
-        int c = fgetc(stream);
-        if (c == -1) {
-            if (len == 0 || ferror(stream))
-                return -1;
-            break; /* EOF */
+        /* Make room for the data and the terminating '\0'. The buffer grows
+         * geometrically, so that long lines need few reallocations.
+         */
+        if (size - len <= num_bytes) {
+            size_t new_size = (size > 0) ? size : 128;
+            char *new_ptr;
+
+            while (new_size - len <= num_bytes)
+                new_size *= 2;
+
+            new_ptr = realloc(ptr, new_size);
+            if (new_ptr == NULL) {
+                SHOWMSG("not enough memory");
+
+                __set_errno(ENOMEM);
+                goto out;
+            }
+
+            ptr = new_ptr;
+            size = new_size;
+
+            (*lineptr) = ptr;
+            (*n) = size;
         }
-        ptr[len++] = c;
-        if (c == delimiter)
+
+        memcpy(&ptr[len], buffer, num_bytes);
+        len += num_bytes;
+
+        file->iob_BufferPosition += num_bytes;
+
+        if (delim != NULL)
             break;
     }
 
     ptr[len] = '\0';
 
-    RETURN(len);
-    return len;
+    result = len;
+
+out:
+
+    funlockfile(stream);
+
+    RETURN(result);
+    return result;
 }
@@ -0,0 +1,658 @@
+/*
+ * $Id: stdio_iobstream.c,v 1.0 2026-10-17 12:00:00 clib2devs Exp $
+*/
+
+#ifndef _STDIO_HEADERS_H
+#include "stdio_headers.h"
+#endif /* _STDIO_HEADERS_H */
+
+#ifndef _STDLIB_MEMORY_H
+#include "stdlib_memory.h"
+#endif /* _STDLIB_MEMORY_H */
+
+/****************************************************************************/
+
+/* A stream opened with the 'S' mode letter, e.g. fopen(name, "rS"), reads
+   and writes through two large buffers. While the program works on the
+   data in one of them, a helper process reads the next part of the file
+   into the other one, or writes out what was put into it before. The
+   buffer size follows the size of the file. */
+
+/* Buffer sizes for streaming mode, in bytes. */
+#define STREAM_MIN_BUFFER_SIZE		(64 * 1024)
+#define STREAM_MAX_BUFFER_SIZE		(1024 * 1024)
+#define STREAM_DEFAULT_BUFFER_SIZE	(256 * 1024)
+
+/****************************************************************************/
+
+/* What the helper process is asked to do. */
+enum stream_job
+{
+	STREAM_JOB_NONE,
+	STREAM_JOB_READ,
+	STREAM_JOB_WRITE,
+	STREAM_JOB_QUIT
+};
+
+struct iob_stream
+{
+	/* These are shared with the helper process and may only be
+	   looked at or changed while in Forbid(). */
+	struct Process *	is_Helper;			/* Does the reading and writing */
+	uint32				is_HelperID;		/* Its process ID */
+	struct Task *		is_Waiter;			/* Waits for the job to finish */
+	enum stream_job		is_Job;				/* Current job; STREAM_JOB_NONE when done */
+	BPTR				is_File;			/* File to read from or write to */
+	UBYTE *				is_JobData;			/* Where the data goes or comes from */
+	LONG				is_JobSize;			/* How much of it */
+	LONG				is_JobResult;		/* What Read() or Write() returned */
+	LONG				is_JobError;		/* IoErr() if that failed */
+
+	/* The rest belongs to the stream, which is locked while it is used. */
+	APTR				is_Memory[2];		/* The buffers as allocated */
+	UBYTE *				is_Spare;			/* The buffer not in use as iob_Buffer */
+	LONG				is_BufferSize;		/* Size of both buffers */
+	enum stream_job		is_Pending;			/* Job in progress on the spare buffer */
+	LONG				is_AheadPosition;	/* Data read ahead into the spare buffer */
+	LONG				is_AheadLength;		/* which the stream has not used yet */
+	int					is_Error;			/* Write-behind error not yet reported */
+	BOOL				is_NoHelper;		/* The helper process could not be started */
+};
+
+/****************************************************************************/
+
+static int
+stream_helper(void)
+{
+	struct Process *this_process = (struct Process *)FindTask(NULL);
+	struct iob_stream *is = (struct iob_stream *)this_process->pr_Task.tc_UserData;
+	enum stream_job job;
+	LONG result;
+	LONG error;
+
+	do
+	{
+		Wait(SIGBREAKF_CTRL_E);
+
+		Forbid();
+		job = is->is_Job;
+		Permit();
+
+		if (job == STREAM_JOB_NONE)
+			continue;
+
+		result = 0;
+		error = OK;
+
+		if (job == STREAM_JOB_READ)
+			result = Read(is->is_File, is->is_JobData, is->is_JobSize);
+		else if (job == STREAM_JOB_WRITE)
+			result = Write(is->is_File, is->is_JobData, is->is_JobSize);
+
+		if (result < 0)
+			error = IoErr();
+
+		/* The stream may be gone as soon as this is done, so
+		   'is' must not be touched after the Permit(). */
+		Forbid();
+
+		is->is_JobResult = result;
+		is->is_JobError = error;
+		is->is_Job = STREAM_JOB_NONE;
+
+		if (is->is_Waiter != NULL)
+			Signal(is->is_Waiter, SIGF_SINGLE);
+
+		Permit();
+	}
+	while (job != STREAM_JOB_QUIT);
+
+	return (RETURN_OK);
+}
+
+/****************************************************************************/
+
+/* Wait for the helper process to finish its current job. */
+static void
+wait_for_job(struct iob_stream *is)
+{
+	Forbid();
+
+	while (is->is_Job != STREAM_JOB_NONE)
+	{
+		/* Wait() breaks the Forbid() only while we are waiting,
+		   so the helper can signal us only while we are in there. */
+		is->is_Waiter = FindTask(NULL);
+		Wait(SIGF_SINGLE);
+	}
+
+	is->is_Waiter = NULL;
+
+	Permit();
+}
+
+/****************************************************************************/
+
+static BOOL
+submit_job(struct iob_stream *is, enum stream_job job, BPTR file, UBYTE *data, LONG size)
+{
+	BOOL success = FALSE;
+
+	if (is->is_NoHelper)
+		goto out;
+
+	if (is->is_Helper == NULL)
+	{
+		SHOWMSG("starting the helper process");
+
+		is->is_Helper = CreateNewProcTags(
+			NP_Name,		"CLIB2_STREAM_HELPER",
+			NP_Entry,		stream_helper,
+			NP_Child,		TRUE,
+			NP_UserData,	is,
+			TAG_END);
+		if (is->is_Helper == NULL)
+		{
+			SHOWMSG("that didn't work; staying synchronous");
+
+			is->is_NoHelper = TRUE;
+			goto out;
+		}
+
+		is->is_HelperID = is->is_Helper->pr_ProcessID;
+	}
+
+	Forbid();
+
+	is->is_File = file;
+	is->is_JobData = data;
+	is->is_JobSize = size;
+	is->is_Job = job;
+
+	Permit();
+
+	Signal((struct Task *)is->is_Helper, SIGBREAKF_CTRL_E);
+
+	success = TRUE;
+
+out:
+
+	return (success);
+}
+
+/****************************************************************************/
+
+/* Find the file handle the helper process should use, and the descriptor
+   whose position it moves. */
+static BPTR
+stream_file(struct iob *file, struct fd **fd_ptr)
+{
+	BPTR result = ZERO;
+	struct fd *fd;
+
+	fd = __get_file_descriptor(file->iob_Descriptor);
+	if (fd != NULL)
+	{
+		__fd_lock(fd);
+		result = __resolve_fd_file(fd);
+		__fd_unlock(fd);
+	}
+
+	(*fd_ptr) = fd;
+
+	return (result);
+}
+
+/****************************************************************************/
+
+/* Wait for the pending job and account for it: the file position moves
+   by what was read or written, and a failed write is remembered so that
+   the next operation can report it. */
+static void
+collect_job(struct iob *file, struct iob_stream *is)
+{
+	struct fd *fd;
+	LONG result;
+
+	if (is->is_Pending == STREAM_JOB_NONE)
+		return;
+
+	wait_for_job(is);
+
+	result = is->is_JobResult;
+
+	if (is->is_Pending == STREAM_JOB_READ)
+	{
+		/* A failed read-ahead is simply forgotten; reading
+		   from the file again will report the error. */
+		is->is_AheadPosition = 0;
+		is->is_AheadLength = (result > 0) ? result : 0;
+	}
+	else if (result != is->is_JobSize && is->is_Error == OK)
+	{
+		D(("write-behind failed; result=%ld ioerr=%ld", result, is->is_JobError));
+
+		is->is_Error = (result < 0) ? __translate_io_error_to_errno(is->is_JobError) : ENOSPC;
+	}
+
+	is->is_Pending = STREAM_JOB_NONE;
+
+	if (result > 0)
+	{
+		fd = __get_file_descriptor(file->iob_Descriptor);
+		if (fd != NULL)
+		{
+			__fd_lock(fd);
+			fd->fd_Position += result;
+			__fd_unlock(fd);
+		}
+	}
+}
+
+/****************************************************************************/
+
+/* Bring the file back to where the stream says it is: finish the pending
+   job and give back any data which was read ahead but not used. */
+static int
+drain_stream(struct iob *file, struct iob_stream *is, struct file_action_message *fam)
+{
+	int result = ERROR;
+	LONG unused;
+
+	collect_job(file, is);
+
+	if (is->is_Error != OK)
+	{
+		fam->fam_Error = is->is_Error;
+		is->is_Error = OK;
+		goto out;
+	}
+
+	unused = is->is_AheadLength - is->is_AheadPosition;
+
+	is->is_AheadPosition = is->is_AheadLength = 0;
+
+	if (unused > 0)
+	{
+		struct file_action_message seek_fam;
+
+		D(("seeking back over %ld bytes read ahead", unused));
+
+		seek_fam.fam_Action = file_action_seek;
+		seek_fam.fam_Offset = -unused;
+		seek_fam.fam_Mode = SEEK_CUR;
+
+		if (__iob_hook_entry(file, &seek_fam) < 0)
+		{
+			fam->fam_Error = seek_fam.fam_Error;
+			goto out;
+		}
+	}
+
+	result = OK;
+
+out:
+
+	return (result);
+}
+
+/****************************************************************************/
+
+static BOOL
+is_stream_buffer(struct iob *file, struct iob_stream *is, const void *data)
+{
+	return (BOOL)(data == file->iob_Buffer && file->iob_BufferSize == is->is_BufferSize);
+}
+
+/****************************************************************************/
+
+static int64_t
+stream_read(struct iob *file, struct iob_stream *is, struct file_action_message *fam)
+{
+	int64_t result = EOF;
+	LONG available;
+	struct fd *fd;
+	BPTR fh;
+
+	/* Any write-behind has to be on disk before reading. */
+	if (is->is_Pending == STREAM_JOB_WRITE || is->is_Error != OK)
+	{
+		if (drain_stream(file, is, fam) < 0)
+			goto out;
+	}
+
+	collect_job(file, is);
+
+	available = is->is_AheadLength - is->is_AheadPosition;
+	if (available > 0)
+	{
+		if (is->is_AheadPosition == 0 && available <= fam->fam_Size && is_stream_buffer(file, is, fam->fam_Data))
+		{
+			UBYTE *buffer = file->iob_Buffer;
+
+			/* The data is already where it needs to be; just trade buffers. */
+			file->iob_Buffer = is->is_Spare;
+			is->is_Spare = buffer;
+		}
+		else
+		{
+			if (available > fam->fam_Size)
+				available = fam->fam_Size;
+
+			memcpy(fam->fam_Data, &is->is_Spare[is->is_AheadPosition], available);
+		}
+
+		is->is_AheadPosition += available;
+
+		result = available;
+	}
+	else
+	{
+		result = __iob_hook_entry(file, fam);
+
+		/* A short read most likely stopped at the end of the file;
+		   reading ahead past it would be wasted effort. */
+		if (result < fam->fam_Size)
+			goto out;
+	}
+
+	/* Start reading the next part of the file while the caller
+	   works on this one. */
+	if (is->is_AheadPosition == is->is_AheadLength)
+	{
+		fh = stream_file(file, &fd);
+		if (fh != ZERO && submit_job(is, STREAM_JOB_READ, fh, is->is_Spare, is->is_BufferSize))
+			is->is_Pending = STREAM_JOB_READ;
+	}
+
+out:
+
+	return (result);
+}
+
+/****************************************************************************/
+
+static int64_t
+stream_write(struct iob *file, struct iob_stream *is, struct file_action_message *fam)
+{
+	int64_t result = EOF;
+	struct fd *fd;
+	BPTR fh;
+
+	/* Wait for the previous write, and give up what was read ahead. */
+	if (drain_stream(file, is, fam) < 0)
+		goto out;
+
+	/* Hand the buffer contents to the helper process and let the stream
+	   carry on with the other buffer. In append mode every write has to
+	   go to the end of the file, which the file hook takes care of. */
+	if (is_stream_buffer(file, is, fam->fam_Data) && fam->fam_Size <= is->is_BufferSize)
+	{
+		fh = stream_file(file, &fd);
+		if (fh != ZERO && FLAG_IS_CLEAR(fd->fd_Flags, FDF_APPEND) &&
+		    submit_job(is, STREAM_JOB_WRITE, fh, file->iob_Buffer, fam->fam_Size))
+		{
+			is->is_Pending = STREAM_JOB_WRITE;
+
+			file->iob_Buffer = is->is_Spare;
+			is->is_Spare = (UBYTE *)fam->fam_Data;
+
+			result = fam->fam_Size;
+			goto out;
+		}
+	}
+
+	result = __iob_hook_entry(file, fam);
+
+out:
+
+	return (result);
+}
+
+/****************************************************************************/
+
+/* Where the stream is now, without disturbing any read-ahead. */
+static int64_t
+stream_position(struct iob *file, struct iob_stream *is)
+{
+	int64_t result = EOF;
+	struct fd *fd;
+
+	fd = __get_file_descriptor(file->iob_Descriptor);
+	if (fd == NULL)
+		goto out;
+
+	__fd_lock(fd);
+
+	if (FLAG_IS_SET(fd->fd_Flags, FDF_CACHE_POSITION))
+	{
+		/* The descriptor's position does not yet include the job
+		   the helper process is working on. */
+		result = fd->fd_Position - (is->is_AheadLength - is->is_AheadPosition);
+
+		if (is->is_Pending == STREAM_JOB_WRITE)
+			result += is->is_JobSize;
+	}
+
+	__fd_unlock(fd);
+
+out:
+
+	return (result);
+}
+
+/****************************************************************************/
+
+/* Wait for the helper process to finish, stop it and release the buffers.
+   The stream is left with a one byte buffer and the plain file hook. */
+static int
+stop_stream(struct iob *file, struct iob_stream *is, struct file_action_message *fam)
+{
+	int result;
+	int i;
+
+	result = drain_stream(file, is, fam);
+
+	if (is->is_Helper != NULL)
+	{
+		SHOWMSG("stopping the helper process");
+
+		submit_job(is, STREAM_JOB_QUIT, ZERO, NULL, 0);
+		wait_for_job(is);
+
+		WaitForChildExit(is->is_HelperID);
+	}
+
+	for (i = 0 ; i < 2 ; i++)
+		free(is->is_Memory[i]);
+
+	free(is);
+
+	file->iob_Stream = NULL;
+	file->iob_Action = __iob_hook_entry;
+	file->iob_Buffer = &file->iob_SingleByte;
+	file->iob_BufferSize = 1;
+
+	return (result);
+}
+
+/****************************************************************************/
+
+int
+__start_iob_stream(struct iob *file)
+{
+	struct iob_stream *is = NULL;
+	LONG size = STREAM_DEFAULT_BUFFER_SIZE;
+	struct stat st;
+	struct fd *fd;
+	int result = ERROR;
+	int i;
+
+	ENTER();
+
+	SHOWPOINTER(file);
+
+	assert(file != NULL && file->iob_Stream == NULL);
+
+	/* Only regular disk files can be read ahead. */
+	fd = __get_file_descriptor(file->iob_Descriptor);
+	if (fd == NULL || FLAG_IS_CLEAR(fd->fd_Flags, FDF_CACHE_POSITION) ||
+	    FLAG_IS_SET(fd->fd_Flags, FDF_IS_SOCKET|FDF_IS_INTERACTIVE|FDF_IS_DIRECTORY|FDF_PATH_ONLY))
+	{
+		SHOWMSG("not a disk file");
+		goto out;
+	}
+
+	/* Larger files get larger buffers, so that every read or write
+	   covers about an eighth of the file. New or empty files get a
+	   buffer of medium size. */
+	if (fstat(file->iob_Descriptor, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+	{
+		size = STREAM_MIN_BUFFER_SIZE;
+
+		while (size < STREAM_MAX_BUFFER_SIZE && size < st.st_size / 8)
+			size *= 2;
+	}
+
+	SHOWVALUE(size);
+
+	is = calloc(1, sizeof(*is));
+	if (is == NULL)
+		goto out;
+
+	for (i = 0 ; i < 2 ; i++)
+	{
+		/* Allocate a little more memory than necessary. */
+		is->is_Memory[i] = malloc(size + (__cache_line_size - 1));
+		if (is->is_Memory[i] == NULL)
+			goto out;
+	}
+
+	/* Get rid of the buffer the stream came with. */
+	assert(file->iob_BufferReadBytes == 0 && file->iob_BufferWriteBytes == 0);
+
+	if (file->iob_CustomBuffer != NULL)
+	{
+		free(file->iob_CustomBuffer);
+		file->iob_CustomBuffer = NULL;
+	}
+
+	/* Align the buffer start addresses to a cache line boundary. */
+	file->iob_Buffer = (UBYTE *)((ULONG)((UBYTE *)is->is_Memory[0] + (__cache_line_size - 1)) & ~(__cache_line_size - 1));
+	file->iob_BufferSize = size;
+
+	is->is_Spare = (UBYTE *)((ULONG)((UBYTE *)is->is_Memory[1] + (__cache_line_size - 1)) & ~(__cache_line_size - 1));
+	is->is_BufferSize = size;
+
+	file->iob_Stream = is;
+	file->iob_Action = __iob_stream_hook_entry;
+
+	is = NULL;
+
+	result = OK;
+
+out:
+
+	if (is != NULL)
+	{
+		for (i = 0 ; i < 2 ; i++)
+			free(is->is_Memory[i]);
+
+		free(is);
+	}
+
+	RETURN(result);
+	return (result);
+}
+
+/****************************************************************************/
+
+int
+__end_iob_stream(struct iob *file)
+{
+	struct file_action_message fam;
+	int result = OK;
+
+	ENTER();
+
+	SHOWPOINTER(file);
+
+	if (file->iob_Stream != NULL)
+	{
+		result = stop_stream(file, file->iob_Stream, &fam);
+		if (result < 0)
+			__set_errno(fam.fam_Error);
+	}
+
+	RETURN(result);
+	return (result);
+}
+
+/****************************************************************************/
+
+int64_t
+__iob_stream_hook_entry(
+	struct iob *file,
+	struct file_action_message *fam)
+{
+	struct iob_stream *is = file->iob_Stream;
+	int64_t result = EOF;
+	int error;
+
+	assert(fam != NULL && file != NULL && is != NULL);
+
+	switch (fam->fam_Action)
+	{
+		case file_action_read:
+
+			result = stream_read(file, is, fam);
+			break;
+
+		case file_action_write:
+
+			result = stream_write(file, is, fam);
+			break;
+
+		case file_action_seek:
+
+			/* ftell() should not cost the read-ahead. */
+			if (fam->fam_Mode == SEEK_CUR && fam->fam_Offset == 0)
+			{
+				result = stream_position(file, is);
+				if (result >= 0)
+					break;
+			}
+
+			if (drain_stream(file, is, fam) == OK)
+				result = __iob_hook_entry(file, fam);
+
+			break;
+
+		case file_action_close:
+
+			/* The file has to be closed even if the last
+			   write-behind failed. */
+			if (stop_stream(file, is, fam) < 0)
+			{
+				error = fam->fam_Error;
+
+				__iob_hook_entry(file, fam);
+
+				fam->fam_Error = error;
+				break;
+			}
+
+			result = __iob_hook_entry(file, fam);
+			break;
+
+		default:
+
+			if (drain_stream(file, is, fam) == OK)
+				result = __iob_hook_entry(file, fam);
+
+			break;
+	}
+
+	RETURN(result);
+	return (result);
+}
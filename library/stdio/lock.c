@@ -1,5 +1,5 @@
 /*
- * $Id: stdio_lock.c,v 1.5 2006-01-08 12:04:24 clib2devs Exp $
+ * $Id: stdio_lock.c,v 1.6 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _STDIO_HEADERS_H
@@ -13,7 +13,7 @@ __stdio_lock(void) {
     assert(stdio_lock != NULL);
 
     if (stdio_lock != NULL)
-        ObtainSemaphore(stdio_lock);
+        __OBTAIN_SEMAPHORE_AT(stdio_lock, __CLIB2_LOCK_STDIO);
 }
 
 void
@@ -21,7 +21,32 @@ __stdio_unlock(void) {
     assert(stdio_lock != NULL);
 
     if (stdio_lock != NULL)
-        ReleaseSemaphore(stdio_lock);
+        __release_semaphore(stdio_lock);
+}
+
+/* Let go of the stdio lock, however often the calling task holds it, while
+   it waits for another thread which may need the lock to make progress.
+   Returns how often it was held, to be handed to __stdio_relock(). */
+LONG
+__stdio_unlock_all(void) {
+    LONG count = 0;
+    LONG i;
+
+    /* For as long as locking is skipped, there is nobody to let go. */
+    if (stdio_lock != NULL && stdio_lock->ss_Owner == FindTask(NULL)) {
+        count = stdio_lock->ss_NestCount;
+
+        for (i = 0; i < count; i++)
+            __release_semaphore(stdio_lock);
+    }
+
+    return (count);
+}
+
+void
+__stdio_relock(LONG count) {
+    while (count-- > 0)
+        __stdio_lock();
 }
 
 void
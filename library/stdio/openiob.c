@@ -20,6 +20,8 @@ __open_iob(const char *filename, const char *mode, int file_descriptor, int slot
     STRPTR buffer = NULL;
     STRPTR aligned_buffer;
     struct iob *file;
+    BOOL streaming = FALSE;
+    int i;
 
     ENTER();
 
@@ -91,6 +93,17 @@ __open_iob(const char *filename, const char *mode, int file_descriptor, int slot
         SET_FLAG(open_mode, O_RDWR);
     }
 
+    /* An 'S' anywhere among the remaining characters asks for large
+       buffers with read-ahead and write-behind, see stdio_iobstream.c. */
+    for (i = 1; mode[i] != '\0' && mode[i] != ','; i++) {
+        if (mode[i] == 'S') {
+            SHOWMSG("streaming mode");
+
+            streaming = TRUE;
+            break;
+        }
+    }
+
     SHOWMSG("allocating file buffer");
 
     /* Allocate a little more memory than necessary. */
@@ -148,6 +161,11 @@ __open_iob(const char *filename, const char *mode, int file_descriptor, int slot
 
     buffer = NULL;
 
+    /* Streaming mode is only a hint; without it, the file simply
+       keeps the default buffer. */
+    if (streaming)
+        __start_iob_stream(file);
+
     result = OK;
 
 out:
@@ -221,6 +221,9 @@ popen(const char *command, const char *type) {
         goto out;
     }
 
+    /* The program will run alongside this one. */
+    __enable_locking();
+
     /* Now try to launch the program. */
     status = SystemTags((STRPTR) command,
                         SYS_Input, input,
@@ -1,5 +1,5 @@
 /*
- * $Id: stdio_remove_fd_alias.c,v 1.5 2006-10-10 13:39:26 clib2devs Exp $
+ * $Id: stdio_remove_fd_alias.c,v 1.6 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _STDIO_HEADERS_H
@@ -30,6 +30,7 @@ __remove_fd_alias(struct fd *fd) {
         }
     } else if (fd->fd_NextAlias != NULL) /* this one has aliases attached; it is the 'original' resource */
     {
+        struct fd_waiter *first_waiter;
         struct fd *first_alias;
         struct fd *next_alias;
         struct fd *list_fd;
@@ -38,9 +39,13 @@ __remove_fd_alias(struct fd *fd) {
         first_alias = fd->fd_NextAlias;
         next_alias = first_alias->fd_NextAlias;
 
-        /* Structure copy... */
+        /* Structure copy... but the first link keeps its own waiter. */
+        first_waiter = first_alias->fd_Waiter;
+
         (*first_alias) = (*fd);
 
+        first_alias->fd_Waiter = first_waiter;
+
         /* Fix up the linkage. */
         first_alias->fd_NextAlias = next_alias;
         first_alias->fd_Original = NULL;
@@ -95,6 +95,12 @@ setvbuf(FILE *stream, char *buf, int bufmode, size_t size) {
         goto out;
     }
 
+    /* A buffer of the caller's choosing ends streaming mode. */
+    if (file->iob_Stream != NULL && __end_iob_stream(file) < 0) {
+        SHOWMSG("could not finish streaming");
+        goto out;
+    }
+
     /* Get rid of any buffer specially allocated for this stream. */
     if (file->iob_CustomBuffer != NULL) {
         free(file->iob_CustomBuffer);
@@ -35,6 +35,10 @@
 #include <dos/record.h>
 #endif /* DOS_RECORD_H */
 
+#ifndef DOS_NOTIFY_H
+#include <dos/notify.h>
+#endif /* DOS_NOTIFY_H */
+
 #ifndef LIBRARIES_LOCALE_H
 #include <libraries/locale.h>
 #endif /* LIBRARIES_LOCALE_H */
@@ -108,6 +112,7 @@
 /* Forward declarations for below... */
 struct fd;
 struct iob;
+struct iob_stream;
 
 /****************************************************************************/
 
@@ -199,6 +204,7 @@ typedef struct iob
 	BPTR				iob_TempFileLock;		/* The directory in which this temporary file is stored */
 	UBYTE				iob_SingleByte;			/* Fall-back buffer for 'unbuffered' files */
 	struct SignalSemaphore * iob_Lock;			/* For thread locking */
+	struct iob_stream *	iob_Stream;				/* Read-ahead/write-behind state of a stream opened in streaming mode */
 } __iob64;
 
 
@@ -279,6 +285,39 @@ struct fd
 													   file descriptor; NULL for none */
 	void *						fd_Aux;				/* Auxilliary data for "special" files,
 													   e.g. termios support. */
+	struct fd_waiter *			fd_Waiter;			/* Tells select() and poll() when input
+													   arrives; NULL until first needed */
+	ULONG						fd_NumEmptyReads;	/* Reads which found nothing to read, */
+	ULONG						fd_NumFullWrites;	/* and writes which found no room;
+													   kept in the original descriptor */
+};
+
+/****************************************************************************/
+
+/* How select() and poll() can find out if a file has input waiting. */
+enum fd_waiter_kind_t
+{
+	fd_waiter_never,		/* Never has input, as far as we can tell */
+	fd_waiter_console,		/* Interactive; asked with ACTION_WAIT_CHAR */
+	fd_waiter_pipe,			/* Pipe; has input if it is not empty */
+	fd_waiter_file			/* Disk file; has input if it grew past the
+							   current position */
+};
+
+/* Consoles and pipes are sent an ACTION_WAIT_CHAR packet, disk files get
+   a change notification. Either way, the reply turns up at a port which
+   is bound to the waiting task's signal only while it waits; otherwise
+   the messages just queue up. */
+struct fd_waiter
+{
+	enum fd_waiter_kind_t	fw_Kind;
+	struct MsgPort *		fw_Port;			/* Packet replies and notifications */
+	struct DosPacket *		fw_Packet;			/* For ACTION_WAIT_CHAR */
+	BOOL					fw_PacketPending;	/* Packet sent, reply not yet collected */
+	struct NotifyRequest	fw_NotifyRequest;	/* For disk files */
+	BOOL					fw_Notifying;		/* StartNotify() succeeded */
+	BOOL					fw_Unsupported;		/* Neither works; the file has to be polled */
+	struct Task *			fw_Task;			/* Who is waiting, if anybody */
 };
 
 /****************************************************************************/
@@ -373,15 +412,25 @@ extern ULONG __cache_line_size;
 #define __fd_is_aliased(fd) \
 	((fd)->fd_Original != NULL || (fd)->fd_NextAlias != NULL)
 
+/* Count a read or write which would have blocked, for all aliases of the
+   descriptor together. This is how epoll_wait() finds out that an
+   edge-triggered event went away since it was reported. */
+#define __fd_count_blocked(fd, counter) \
+	(((fd)->fd_Original != NULL ? (fd)->fd_Original : (fd))->counter++)
+
 /****************************************************************************/
 
 extern void	__stdio_lock(void);
 extern void	__stdio_unlock(void);
+extern LONG	__stdio_unlock_all(void);
+extern void	__stdio_relock(LONG count);
 extern void	__stdio_lock_exit(void);
 extern int	__stdio_lock_init(void);
 
 extern void __fd_lock(struct fd *fd);
 extern void __fd_unlock(struct fd *fd);
+extern LONG __fd_unlock_all(struct fd *fd);
+extern void __fd_relock(struct fd *fd, LONG count);
 
 extern BPTR __resolve_fd_file(struct fd * fd);
 
@@ -64,6 +64,13 @@ extern int64_t __iob_hook_entry(struct iob *iob, struct file_action_message *fam
 
 /****************************************************************************/
 
+/* stdio_iobstream.c */
+extern int __start_iob_stream(struct iob *file);
+extern int __end_iob_stream(struct iob *file);
+extern int64_t __iob_stream_hook_entry(struct iob *file, struct file_action_message *fam);
+
+/****************************************************************************/
+
 /* stdio_fdhookentry.c */
 extern int64_t __fd_hook_entry(struct fd *fd, struct file_action_message *fam);
 
@@ -138,18 +145,9 @@ extern int64_t __sscanf_hook_entry(struct iob *string, struct file_action_messag
 
 /****************************************************************************/
 
-/* stdio_vasprintf_hook_entry.c */
-extern int64_t __vasprintf_hook_entry(struct iob *string, struct file_action_message *fam);
-
-/****************************************************************************/
-
-/* stdio_vsprintf_hook_entry.c */
-extern int64_t __vsprintf_hook_entry(struct iob *string, struct file_action_message *fam);
-
-/****************************************************************************/
-
-/* stdio_vsnprintf_hook_entry.c */
-extern int64_t __vsnprintf_hook_entry(struct iob *string, struct file_action_message *fam);
+/* stdio_vfprintf.c */
+extern int __vsnprintf_buffer(char *buffer, size_t size, const char *format, va_list ap);
+extern int __vasprintf_buffer(char **ret, const char *format, va_list ap);
 
 /****************************************************************************/
 
@@ -168,6 +166,14 @@ extern int64_t __grow_file_size(struct fd *fd, int num_bytes);
 
 /****************************************************************************/
 
+/* stdio_fd_waiter.c */
+extern struct fd_waiter *__get_fd_waiter(struct fd *fd, BPTR file);
+extern int __arm_fd_waiter(struct fd_waiter *fw, BPTR file, struct Task *task, int signal_bit, ULONG timeout_micros);
+extern void __disarm_fd_waiter(struct fd_waiter *fw);
+extern void __delete_fd_waiter(struct fd *fd);
+
+/****************************************************************************/
+
 /* unistd_sync_fd.c */
 extern int __sync_fd(struct fd *fd, int mode);
 
@@ -18,9 +18,7 @@
 
 __static int
 __vasprintf(const char *file, int line, char **ret, const char *format, va_list arg) {
-    struct iob string_iob;
     int result = EOF;
-    char local_buffer[32];
 
     ENTER();
 
@@ -38,32 +36,14 @@ __vasprintf(const char *file, int line, char **ret, const char *format, va_list
 
     (*ret) = NULL;
 
-    __initialize_iob(&string_iob, __vasprintf_hook_entry,
-                     NULL,
-                     local_buffer, sizeof(local_buffer),
-                     -1,
-                     -1,
-                     IOBF_IN_USE | IOBF_WRITE | IOBF_BUFFER_MODE_NONE | IOBF_INTERNAL,
-                     NULL);
-
-    string_iob.iob_String = NULL;
-    string_iob.iob_StringSize = 0;
-    string_iob.iob_File = (char *) file;
-    string_iob.iob_Line = line;
-
-    result = vfprintf((FILE * ) & string_iob, format, arg);
+    /* The buffer grows as the text is written into it. */
+    result = __vasprintf_buffer(ret, format, arg);
     if (result < 0) {
         SHOWMSG("ouch. that didn't work");
-
-        if (string_iob.iob_String != NULL)
-            free(string_iob.iob_String);
-
         goto out;
     }
 
-    SHOWSTRING(string_iob.iob_String);
-
-    (*ret) = string_iob.iob_String;
+    SHOWSTRING(*ret);
 
 out:
 
@@ -14,6 +14,10 @@
 #include "math_headers.h"
 #endif /* _MATH_HEADERS_H */
 
+#ifndef _STDLIB_FPCONV_H
+#include "stdlib_fpconv.h"
+#endif /* _STDLIB_FPCONV_H */
+
 #include <sys/param.h> // max
 #include "wchar_wprintf_core.h"
 
@@ -26,6 +30,56 @@ static void out_init_file(Out *out, FILE *f) {
     out->file = f;
 }
 
+/* The buffer is 'size' characters long, not counting the terminating NUL
+   which always follows the text written so far. */
+static void out_init_string(Out *out, char *buffer, size_t size, int grow) {
+    memset(out, 0, sizeof(*out));
+    out->buffer = buffer;
+    out->buffer_size = size;
+    out->grow = grow;
+}
+
+/* Makes room for at least 'length' more characters by doubling the size of
+   the buffer, and returns how many there are room for now. */
+static size_t out_grow(Out *_out, size_t length) {
+    size_t new_size = 2 * (_out->buffer_size + 1);
+    char *buffer;
+
+    if (new_size < _out->buffer_pos + length + 1)
+        new_size = _out->buffer_pos + length + 1;
+
+    buffer = realloc(_out->buffer, new_size);
+    if (buffer != NULL) {
+        _out->buffer = buffer;
+        _out->buffer_size = new_size - 1;
+    } else {
+        _out->failed = 1;
+    }
+
+    return _out->buffer_size - _out->buffer_pos;
+}
+
+/* Returns how many characters may be stored in the write buffer of the
+   stream right away, without having to flush it first. This is zero if
+   the stream is unbuffered or cannot be written to at all. */
+static size_t out_file_room(Out *_out) {
+    struct iob *file = (struct iob *) _out->file;
+
+    if ((file->iob_Flags & (IOBF_IN_USE | IOBF_WRITE)) != (IOBF_IN_USE | IOBF_WRITE))
+        return 0;
+
+    if ((file->iob_Flags & IOBF_BUFFER_MODE) == IOBF_BUFFER_MODE_NONE)
+        return 0;
+
+    return (size_t) (file->iob_BufferSize - file->iob_BufferWriteBytes);
+}
+
+static int out_file_is_line_buffered(Out *_out) {
+    struct iob *file = (struct iob *) _out->file;
+
+    return ((file->iob_Flags & IOBF_BUFFER_MODE) == IOBF_BUFFER_MODE_LINE);
+}
+
 static void out(Out *_out, const char *text, size_t l) {
 
     size_t length = ((l > 0) ? (size_t) l : 0U);
@@ -34,14 +88,27 @@ static void out(Out *_out, const char *text, size_t l) {
         return;
     }
     if (_out->file != NULL) {
-        const char *w = text;
+        struct iob *file = (struct iob *) _out->file;
+
         _out->buffer_pos += length;
-        while (length--) {
-            __putc_unlocked(*w++, _out->file);
+
+        /* The whole span is copied into the write buffer if it fits and
+           does not have to be flushed because of a line feed. Everything
+           else, including the buffer flushing and the direct writes for
+           long spans, is left to fwrite(). */
+        if (length <= out_file_room(_out) &&
+            (!out_file_is_line_buffered(_out) || memchr(text, '\n', length) == NULL)) {
+            memcpy(&file->iob_Buffer[file->iob_BufferWriteBytes], text, length);
+            file->iob_BufferWriteBytes += length;
+        } else {
+            fwrite(text, 1, length, _out->file);
         }
     } else {
         // Write into a bounded buffer.
         size_t avail = _out->buffer_size - _out->buffer_pos;
+        if (length > avail && _out->grow && !_out->failed) {
+            avail = out_grow(_out, length);
+        }
         if (length > avail) {
             length = avail;
         }
@@ -50,18 +117,48 @@ static void out(Out *_out, const char *text, size_t l) {
     }
 }
 
-static void pad(Out *f, char c, int w, int l, int fl) {
+/* Writes 'length' copies of the character 'c'. */
+static void out_fill(Out *_out, char c, size_t length) {
     char _pad[256];
-    const int _psz = (int) (sizeof(_pad));
 
-    if ((fl & (__S_LEFT_ADJ | __S_ZERO_PAD)) || (l >= w))
+    if (!length) {
+        return;
+    }
+    if (_out->file != NULL) {
+        struct iob *file = (struct iob *) _out->file;
+
+        /* Fill the write buffer directly if there is room enough. */
+        if (length <= out_file_room(_out) && (c != '\n' || !out_file_is_line_buffered(_out))) {
+            memset(&file->iob_Buffer[file->iob_BufferWriteBytes], c, length);
+            file->iob_BufferWriteBytes += length;
+            _out->buffer_pos += length;
+            return;
+        }
+    } else {
+        size_t avail = _out->buffer_size - _out->buffer_pos;
+        if (length > avail && _out->grow && !_out->failed) {
+            avail = out_grow(_out, length);
+        }
+        if (length > avail) {
+            length = avail;
+        }
+        memset(_out->buffer + _out->buffer_pos, c, length);
+        _out->buffer_pos += length;
         return;
-    l = (w - l);
-    memset(_pad, c, (size_t)((l > _psz) ? _psz : l));
-    for (; (l >= _psz); l -= _psz) {
-        out(f, _pad, _psz);
     }
-    out(f, _pad, l);
+
+    memset(_pad, c, (length > sizeof(_pad)) ? sizeof(_pad) : length);
+    for (; length >= sizeof(_pad); length -= sizeof(_pad)) {
+        out(_out, _pad, sizeof(_pad));
+    }
+    out(_out, _pad, length);
+}
+
+static void pad(Out *f, char c, int w, int l, int fl) {
+    if ((fl & (__S_LEFT_ADJ | __S_ZERO_PAD)) || (l >= w))
+        return;
+
+    out_fill(f, c, (size_t) (w - l));
 }
 
 
@@ -94,8 +191,179 @@ static char *fmt_u(uintmax_t x, char *s) {
     return s;
 }
 
+/* Writes the digits 'from' .. 'from + count - 1' of a number whose 'nd'
+   significant digits are given; all others are zero. */
+static void out_digits(Out *f, const char *digits, int nd, int from, int count) {
+    int n;
+
+    if (from < 0 && count > 0) {
+        n = MIN(-from, count);
+        out_fill(f, '0', (size_t) n);
+        from += n;
+        count -= n;
+    }
+    if (from < nd && count > 0) {
+        n = MIN(nd - from, count);
+        out(f, digits + from, (size_t) n);
+        from += n;
+        count -= n;
+    }
+    if (count > 0) {
+        out_fill(f, '0', (size_t) count);
+    }
+}
+
+/* Formats 'y' (finite and not negative) for %e, %f and %g, starting from the
+   shortest decimal number which reads back as 'y'. This works if those digits,
+   rounded or padded with zeros, are the correctly rounded result as well.
+   Returns -1 if that cannot be guaranteed; fmt_fp() does the exact work then. */
+static int fmt_fp_shortest(Out *f, long double y, int w, int p, int fl, int t, const char *prefix, int pl) {
+    char ebuf0[(3 * sizeof(int))], *ebuf = &ebuf0[(3 * sizeof(int))], *estr = ebuf;
+    char digits[24];
+    int nd, e, P, k, i, l, q, is_f;
+
+    if (y == 0) {
+        digits[0] = '0';
+        nd = 1;
+        e = 0;
+    } else {
+        double d = (double) y;
+        uint64_t bits;
+        int e2;
+
+        /* The long double must not hold more than a double does. */
+        if ((long double) d != y)
+            return -1;
+
+        /* The unit in the last place of 'y' is 2^e2. */
+        memcpy(&bits, &d, sizeof(bits));
+        e2 = (int) ((bits >> 52) & 0x7ff);
+        e2 = ((e2 == 0) ? -1074 : (e2 - 1075));
+
+        /* No double has more than 17 significant digits, and asking for more
+           than 16 of them always needs the exact digits. For %f the decimal
+           exponent is bounded from below by the binary one, with log10(2)
+           bracketed by 1233/4096 and 1234/4096. */
+        if ((t | 32) == 'f') {
+            i = ((e2 == -1074) ? e2 : (e2 + 52));
+            i = ((i >= 0) ? ((i * 1233) / 4096) : -((-i * 1234 + 4095) / 4096));
+            if (i + 1 + p > 16)
+                return -1;
+        } else if (p > 16) {
+            return -1;
+        }
+
+        nd = __fpconv_shortest(d, digits, &e);
+        e += nd - 1;
+
+        /* The number of significant digits requested, and the power of ten
+           of the last one. For %e and %g that is one place further down, in
+           case the number rounds down to the next lower power of ten. */
+        if ((t | 32) == 'f') {
+            P = e + 1 + p;
+            k = -p;
+        } else {
+            P = ((t | 32) == 'e') ? (p + 1) : (p ? p : 1);
+            k = e - P;
+        }
+        if (P <= 0 || P > 16)
+            return -1;
+
+        if (nd <= P) {
+            /* Padding with zeros is good enough if the error of the shortest
+               digits, half an ulp at most, is below half a unit of the last
+               digit shown: 2^e2 <= 10^k, with log2(10) bracketed by
+               1700/512 and 1701/512. */
+            if (e2 > ((k >= 0) ? ((k * 1700) / 512) : -((-k * 1701 + 511) / 512)))
+                return -1;
+        } else {
+            /* Rounding the shortest digits gives the same result as rounding
+               'y' itself, unless they end in a tie. */
+            if (digits[P] == '5') {
+                for (i = P + 1; i < nd && digits[i] == '0'; i++);
+                if (i == nd)
+                    return -1;
+            }
+            if (digits[P] >= '5') {
+                for (i = P - 1; i >= 0 && digits[i] == '9'; i--)
+                    digits[i] = '0';
+                if (i >= 0) {
+                    digits[i]++;
+                } else {
+                    digits[0] = '1';
+                    e++;
+                }
+            }
+            nd = P;
+        }
+    }
+
+    if ((t | 32) == 'g') {
+        P = (p ? p : 1);
+        if (P > e && e >= -4) {
+            t--;
+            q = P - (e + 1);
+        } else {
+            t -= 2;
+            q = P - 1;
+        }
+        if (!(fl & __S_ALT_FORM)) {
+            /* Drop the trailing zeros */
+            for (i = nd; i > 1 && digits[i - 1] == '0'; i--);
+            if ((t | 32) == 'f')
+                q = MIN(q, MAX(0, i - (e + 1)));
+            else
+                q = MIN(q, i - 1);
+        }
+    } else {
+        q = p;
+    }
+
+    is_f = ((t | 32) == 'f');
+
+    l = 1 + q + (q || (fl & __S_ALT_FORM));
+    if (is_f) {
+        if (e > 0)
+            l += e;
+    } else {
+        estr = fmt_u((uintmax_t) ((e < 0) ? -e : e), ebuf);
+        while ((ebuf - estr) < 2) {
+            *--estr = '0';
+        }
+        *--estr = (e < 0 ? '-' : '+');
+        *--estr = (char) t;
+        l += (int) (ebuf - estr);
+    }
+
+    pad(f, ' ', w, pl + l, fl);
+    out(f, prefix, pl);
+    pad(f, '0', w, pl + l, fl ^ __S_ZERO_PAD);
+
+    if (is_f) {
+        if (e >= 0) {
+            out_digits(f, digits, nd, 0, e + 1);
+        } else {
+            out(f, "0", 1);
+        }
+        if (q || (fl & __S_ALT_FORM))
+            out(f, ".", 1);
+        out_digits(f, digits, nd, e + 1, q);
+    } else {
+        out(f, digits, 1);
+        if (q || (fl & __S_ALT_FORM))
+            out(f, ".", 1);
+        out_digits(f, digits, nd, 1, q);
+        out(f, estr, (size_t) (ebuf - estr));
+    }
+
+    pad(f, ' ', w, pl + l, fl ^ __S_LEFT_ADJ);
+
+    return MAX(w, pl + l);
+}
+
 static int fmt_fp(Out *f, long double y, int w, int p, int fl, int t) {
-    uint32_t big[(LDBL_MAX_EXP + LDBL_MANT_DIG) / 9 + 1];
+    uint32_t big[(LDBL_MANT_DIG + 28) / 29 + 1                  // mantissa expansion
+                 + (LDBL_MAX_EXP + LDBL_MANT_DIG + 28 + 8) / 9]; // exponent expansion
     uint32_t *a, *d, *r, *z;
     int e2 = 0, e, i, j, l, pl;
     const char *prefix = "-0X+0X 0X-0x+0x 0x";
@@ -131,6 +399,13 @@ static int fmt_fp(Out *f, long double y, int w, int p, int fl, int t) {
         return MAX(w, 3 + pl);
     }
 
+    if ((t | 32) != 'a') {
+        l = fmt_fp_shortest(f, y, w, (p < 0) ? 6 : p, fl, t, prefix, pl);
+        if (l >= 0) {
+            return l;
+        }
+    }
+
     y = (__stdlib_frexp(y, &e2) * 2);
     if (y > 0)
         e2--;
@@ -220,15 +495,15 @@ static int fmt_fp(Out *f, long double y, int w, int p, int fl, int t) {
             *d = (uint32_t)(x % 1000000000);
             carry = (uint32_t)(x / 1000000000);
         }
-        if (!z[-1] && z > a)
-            z--;
         if (carry)
             *--a = carry;
+        while (z > a && !z[-1])
+            z--;
         e2 -= sh;
     }
     while (e2 < 0) {
         uint32_t carry = 0, *b;
-        int sh = MIN(9, -e2);
+        int sh = MIN(9, -e2), need = 1 + (p + LDBL_MANT_DIG / 3U + 8) / 9;
         for (d = a; d < z; d++) {
             uint32_t rm = (*d & (uint32_t)((1 << sh) - 1));
             *d = ((*d >> sh) + carry);
@@ -240,8 +515,8 @@ static int fmt_fp(Out *f, long double y, int w, int p, int fl, int t) {
             *z++ = carry;
         /* Avoid (slow!) computation past requested precision */
         b = (t | 32) == 'f' ? r : a;
-        if (z - b > 2 + p / 9)
-            z = b + 2 + p / 9;
+        if (z - b > need)
+            z = b + need;
         e2 += sh;
     }
 
@@ -264,7 +539,7 @@ static int fmt_fp(Out *f, long double y, int w, int p, int fl, int t) {
         /* Are there any significant digits past j? */
         if (x || ((d + 1) != z)) {
             long double small, rnd = __WEV(0x1p, LDBL_MANT_DIG);
-            if ((*d / (uint32_t) i) & 1) {
+            if (((*d / (uint32_t) i) & 1) || (i == 1000000000 && d > a && (d[-1] & 1))) {
                 rnd += 2;
             }
             if (x < (uint32_t)(i / 2)) {
@@ -282,22 +557,20 @@ static int fmt_fp(Out *f, long double y, int w, int p, int fl, int t) {
             /* Decide whether to round by probing round+small */
             if ((rnd + small) != rnd) {
                 *d = (*d + (uint32_t) i);
-                while (*d == 0xFFFF) // == 65535 // Fix? (*d > 999999999)
-                {
+                while (*d > 999999999) {
                     *d-- = 0;
+                    if (d < a)
+                        *--a = 0;
                     (*d)++;
                 }
-                if (d < a) {
-                    a = d;
-                }
                 for (i = 10, e = (int) (9 * (r - a)); *a >= (uint32_t) i; i *= 10, e++);
             }
         }
         if (z > (d + 1)) {
             z = (d + 1);
         }
-        for (; !z[-1] && z > a; z--);
     }
+    for (; z > a && !z[-1]; z--);
 
     if ((t | 32) == 'g') {
         if (!p)
@@ -704,8 +977,101 @@ vfprintf(FILE *f, const char *format, va_list ap) {
 
     va_end(ap2);
 
-    fflush(f);
+    /* A fully buffered stream is left alone until its buffer fills up;
+       everything else is written out right away, as before. */
+    if ((((struct iob *) f)->iob_Flags & IOBF_BUFFER_MODE) != IOBF_BUFFER_MODE_FULL)
+        fflush(f);
+
+    RETURN(ret);
+    return ret;
+}
+
+/* Formats straight into a string buffer, without going through a stream. */
+static int
+vprintf_buffer(Out *_out, const char *format, va_list ap) {
+    va_list ap2;
+    int ret, nl_type[NL_ARGMAX] = {0};
+    union arg nl_arg[NL_ARGMAX];
+
+    va_copy(ap2, ap);
+
+    __check_abort();
+
+    // Check for error in format string before writing anything.
+    if (printf_core(0, format, &ap2, nl_arg, nl_type) < 0)
+        ret = EOF;
+    else
+        ret = printf_core(_out, format, &ap2, nl_arg, nl_type);
+
+    va_end(ap2);
+
+    /* Whatever fitted into the buffer is always terminated. */
+    if (_out->buffer != NULL)
+        _out->buffer[_out->buffer_pos] = '\0';
+
+    return ret;
+}
+
+int
+__vsnprintf_buffer(char *buffer, size_t size, const char *format, va_list ap) {
+    Out _out[1];
+    int ret;
+
+    ENTER();
+    SHOWPOINTER(buffer);
+    SHOWVALUE(size);
+    SHOWSTRING(format);
+
+    /* Store up to 'size-1' characters in the output buffer. This
+       does not include the terminating NUL character */
+    if (size > 0)
+        out_init_string(_out, buffer, size - 1, 0);
+    else
+        out_init_string(_out, NULL, 0, 0);
+
+    /* We will return the number of characters that would have been
+       stored if there had been enough room. */
+    ret = vprintf_buffer(_out, format, ap);
 
     RETURN(ret);
     return ret;
 }
+
+int
+__vasprintf_buffer(char **ret, const char *format, va_list ap) {
+    const size_t initial_size = 64;
+    Out _out[1];
+    char *buffer;
+    int result;
+
+    ENTER();
+    SHOWSTRING(format);
+
+    buffer = malloc(initial_size);
+    if (buffer == NULL) {
+        __set_errno(ENOMEM);
+
+        RETURN(EOF);
+        return EOF;
+    }
+
+    /* The buffer grows as the text is written into it. */
+    out_init_string(_out, buffer, initial_size - 1, 1);
+
+    result = vprintf_buffer(_out, format, ap);
+    if (result < 0 || _out->failed) {
+        SHOWMSG("ouch. that didn't work");
+
+        if (_out->failed)
+            __set_errno(ENOMEM);
+
+        free(_out->buffer);
+
+        result = EOF;
+    } else {
+        (*ret) = _out->buffer;
+    }
+
+    RETURN(result);
+    return result;
+}
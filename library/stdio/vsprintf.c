@@ -8,9 +8,7 @@
 
 int
 vsprintf(char *s, const char *format, va_list arg) {
-    struct iob string_iob;
     int result = EOF;
-    char buffer[32] = {0};
 
     assert(s != NULL && format != NULL);
 
@@ -19,23 +17,8 @@ vsprintf(char *s, const char *format, va_list arg) {
         goto out;
     }
 
-    __initialize_iob(&string_iob, __vsprintf_hook_entry,
-                     NULL,
-                     buffer, sizeof(buffer),
-                     -1,
-                     -1,
-                     IOBF_IN_USE | IOBF_WRITE | IOBF_BUFFER_MODE_NONE | IOBF_INTERNAL,
-                     NULL);
-
-    string_iob.iob_String = (STRPTR) s;
-
-    result = vfprintf((FILE * ) &string_iob, format, arg);
-
-    /* Put a \0 at the end */
-    if (__putc('\0', (FILE * ) &string_iob, IOBF_BUFFER_MODE_NONE) == EOF) {
-        result = EOF;
-    }
-    __flush((FILE * ) &string_iob);
+    /* There is no limit to how much may be stored in the buffer. */
+    result = __vsnprintf_buffer(s, (size_t) -1, format, arg);
 
 out:
 
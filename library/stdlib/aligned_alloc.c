@@ -29,11 +29,6 @@ aligned_alloc(size_t align, size_t size)
         return NULL;
     }
 
-    if (align <= SIZE_ALIGN) {
-        LEAVE();
-        return malloc(size);
-    }
-
     LEAVE();
     return memalign(align, size);
 }
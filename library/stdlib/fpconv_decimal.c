@@ -0,0 +1,601 @@
+/*
+ * $Id: stdlib_fpconv_decimal.c,v 1.0 2026-10-17 19:02:11 clib2devs Exp $
+*/
+
+#ifndef _STDLIB_FPCONV_H
+#include "stdlib_fpconv.h"
+#endif /* _STDLIB_FPCONV_H */
+
+#include <string.h>
+
+/****************************************************************************/
+
+/* Reading a decimal number takes up to three attempts, from fast to slow:
+
+   1) If the significant digits and the power of ten are both small enough
+      to be represented exactly, a single multiplication or division by
+      the FPU will round correctly (Clinger 1990).
+
+   2) Otherwise the first 19 significant digits are multiplied by a 128 bit
+      approximation of the power of ten (Eisel-Lemire, see Lemire: "Number
+      Parsing at a Gigabyte per Second", 2021). This gives up if the result
+      is too close to the middle between two floating point numbers, or if
+      more digits would have to be taken into account.
+
+   3) What's left is done exactly, on a decimal representation of up to 800
+      digits which is repeatedly scaled by powers of two until the binary
+      mantissa can be read off it (as in the Go strconv package). */
+
+/****************************************************************************/
+
+struct fp_format {
+    int mantissa_bits;  /* Explicitly stored mantissa bits */
+    int exponent_bits;
+    int bias;           /* Exponent bias */
+};
+
+static const struct fp_format double_format = {52, 11, 1023};
+static const struct fp_format float_format = {23, 8, 127};
+
+/* The largest number of significant digits which always fit into 64 bits. */
+#define MAX_MANTISSA_DIGITS 19
+
+/* Exponents beyond this are clamped; they are far out of range anyway. */
+#define MAX_EXPONENT 100000
+
+/****************************************************************************/
+
+static const double exact_double_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const float exact_float_pow10[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+static int
+clinger(uint64_t mantissa, int exp10, int is_float, uint64_t *result) {
+    if (is_float) {
+        float f;
+        uint32_t bits;
+
+        if (mantissa > ((uint64_t) 1 << 24) || exp10 < -10 || exp10 > 10)
+            return 0;
+
+        f = (float) mantissa;
+        if (exp10 < 0)
+            f /= exact_float_pow10[-exp10];
+        else
+            f *= exact_float_pow10[exp10];
+
+        memcpy(&bits, &f, sizeof(bits));
+        (*result) = bits;
+    } else {
+        double d;
+
+        if (mantissa > ((uint64_t) 1 << 53) || exp10 < -22 || exp10 > 22)
+            return 0;
+
+        d = (double) mantissa;
+        if (exp10 < 0)
+            d /= exact_double_pow10[-exp10];
+        else
+            d *= exact_double_pow10[exp10];
+
+        memcpy(result, &d, sizeof(d));
+    }
+
+    return 1;
+}
+
+/****************************************************************************/
+
+/* Converts mantissa * 10^exp10 (mantissa != 0). Returns 0 if the result could
+   not be determined reliably, or if it would be subnormal, zero or infinite;
+   these are left to the exact algorithm. */
+static int
+eisel_lemire(uint64_t mantissa, int exp10, const struct fp_format *fmt, uint64_t *result) {
+    const int shift = 64 - fmt->mantissa_bits - 3;
+    const uint64_t mask = (((uint64_t) 1) << shift) - 1;
+    const uint64_t *pow10;
+    uint64_t high, low, m;
+    int clz, exp2, msb;
+
+    if (exp10 < FPCONV_POW10_MIN || exp10 > FPCONV_POW10_MAX)
+        return 0;
+
+    pow10 = __fpconv_pow10[exp10 - FPCONV_POW10_MIN];
+
+    /* Normalization. */
+    clz = __builtin_clzll(mantissa);
+    mantissa <<= clz;
+
+    /* log2(10) * 2^16 = 217706.6 */
+    exp2 = ((217706 * exp10) >> 16) + 64 + fmt->bias - clz;
+
+    /* Multiplication by the upper 64 bits of the power of ten. */
+    low = __fpconv_umul128(mantissa, pow10[1], &high);
+
+    /* If the bits below the mantissa are all ones, the result could still
+       change once the lower 64 bits of the power of ten are accounted for. */
+    if ((high & mask) == mask && low + mantissa < mantissa) {
+        uint64_t high2, low2, merged_high, merged_low;
+
+        low2 = __fpconv_umul128(mantissa, pow10[0], &high2);
+
+        merged_high = high;
+        merged_low = low + high2;
+        if (merged_low < low)
+            merged_high++;
+
+        if ((merged_high & mask) == mask && merged_low + 1 == 0 && low2 + mantissa < mantissa)
+            return 0;
+
+        high = merged_high;
+        low = merged_low;
+    }
+
+    /* Shift down to mantissa_bits + 2 bits. */
+    msb = (int) (high >> 63);
+    m = high >> (msb + shift);
+    exp2 -= 1 ^ msb;
+
+    /* The number lies exactly halfway between two floating point numbers,
+       or so it seems. */
+    if (low == 0 && (high & mask) == 0 && (m & 3) == 1)
+        return 0;
+
+    /* Round to nearest. */
+    m += m & 1;
+    m >>= 1;
+
+    if ((m >> (fmt->mantissa_bits + 1)) != 0) {
+        m >>= 1;
+        exp2++;
+    }
+
+    if (exp2 <= 0 || exp2 >= (1 << fmt->exponent_bits) - 1)
+        return 0;
+
+    (*result) = ((uint64_t) exp2 << fmt->mantissa_bits) | (m & ((((uint64_t) 1) << fmt->mantissa_bits) - 1));
+
+    return 1;
+}
+
+/****************************************************************************/
+
+#define DECIMAL_DIGITS 800
+
+/* The largest shift which keeps all intermediate results within 64 bits. */
+#define MAX_SHIFT 60
+
+/* A decimal number 0.d[0]d[1]...d[nd-1] * 10^dp. The digits are stored as
+   numbers 0..9. If 'trunc' is set, there were more non-zero digits than
+   would fit. */
+struct decimal {
+    unsigned char d[DECIMAL_DIGITS];
+    int nd;
+    int dp;
+    int trunc;
+};
+
+static void
+decimal_trim(struct decimal *a) {
+    while (a->nd > 0 && a->d[a->nd - 1] == 0)
+        a->nd--;
+
+    if (a->nd == 0)
+        a->dp = 0;
+}
+
+/* Reads the digits between 'str' and 'end', which were checked before. */
+static void
+decimal_set(struct decimal *a, const char *str, const char *end, int decimal_point, int exp10) {
+    int total = 0;
+    int saw_dot = 0;
+
+    a->nd = a->dp = a->trunc = 0;
+
+    for (; str < end; str++) {
+        int c = (*str);
+
+        if (c == decimal_point || c == '.') {
+            saw_dot = 1;
+            a->dp = total;
+            continue;
+        }
+
+        if (c == '0' && total == 0) {
+            /* Leading zeros. */
+            a->dp--;
+            continue;
+        }
+
+        if (a->nd < DECIMAL_DIGITS)
+            a->d[a->nd++] = (unsigned char) (c - '0');
+        else if (c != '0')
+            a->trunc = 1;
+
+        total++;
+    }
+
+    if (!saw_dot)
+        a->dp = total;
+
+    a->dp += exp10;
+
+    decimal_trim(a);
+}
+
+/* Multiplies by 2^k, with k <= MAX_SHIFT. */
+static void
+decimal_left_shift(struct decimal *a, int k) {
+    unsigned char tmp[DECIMAL_DIGITS + 20];
+    int w = sizeof(tmp);
+    uint64_t n = 0;
+    int r, nd;
+
+    for (r = a->nd - 1; r >= 0; r--) {
+        n += ((uint64_t) a->d[r]) << k;
+        tmp[--w] = (unsigned char) (n % 10);
+        n /= 10;
+    }
+
+    while (n > 0) {
+        tmp[--w] = (unsigned char) (n % 10);
+        n /= 10;
+    }
+
+    nd = (int) sizeof(tmp) - w;
+    a->dp += nd - a->nd;
+
+    if (nd > DECIMAL_DIGITS) {
+        for (r = DECIMAL_DIGITS; r < nd; r++) {
+            if (tmp[w + r] != 0) {
+                a->trunc = 1;
+                break;
+            }
+        }
+
+        nd = DECIMAL_DIGITS;
+    }
+
+    memcpy(a->d, &tmp[w], nd);
+    a->nd = nd;
+
+    decimal_trim(a);
+}
+
+/* Divides by 2^k, with k <= MAX_SHIFT. */
+static void
+decimal_right_shift(struct decimal *a, int k) {
+    const uint64_t mask = (((uint64_t) 1) << k) - 1;
+    uint64_t n = 0;
+    int r = 0, w = 0;
+
+    /* Pick up enough leading digits to cover the shift. */
+    for (; (n >> k) == 0; r++) {
+        if (r >= a->nd) {
+            if (n == 0) {
+                a->nd = 0;
+                return;
+            }
+
+            while ((n >> k) == 0) {
+                n = n * 10;
+                r++;
+            }
+
+            break;
+        }
+
+        n = n * 10 + a->d[r];
+    }
+
+    a->dp -= r - 1;
+
+    /* Pick up a digit, put down a digit. */
+    for (; r < a->nd; r++) {
+        uint64_t c = a->d[r];
+
+        a->d[w++] = (unsigned char) (n >> k);
+        n = ((n & mask) * 10) + c;
+    }
+
+    /* Put down the extra digits. */
+    while (n > 0) {
+        uint64_t dig = n >> k;
+
+        n &= mask;
+
+        if (w < DECIMAL_DIGITS)
+            a->d[w++] = (unsigned char) dig;
+        else if (dig > 0)
+            a->trunc = 1;
+
+        n = n * 10;
+    }
+
+    a->nd = w;
+
+    decimal_trim(a);
+}
+
+static void
+decimal_shift(struct decimal *a, int k) {
+    if (a->nd == 0)
+        return;
+
+    if (k > 0) {
+        while (k > MAX_SHIFT) {
+            decimal_left_shift(a, MAX_SHIFT);
+            k -= MAX_SHIFT;
+        }
+
+        decimal_left_shift(a, k);
+    } else if (k < 0) {
+        while (k < -MAX_SHIFT) {
+            decimal_right_shift(a, MAX_SHIFT);
+            k += MAX_SHIFT;
+        }
+
+        decimal_right_shift(a, -k);
+    }
+}
+
+/* Rounding the number to 'nd' digits would increase the digit before. */
+static int
+decimal_should_round_up(const struct decimal *a, int nd) {
+    if (nd < 0 || nd >= a->nd)
+        return 0;
+
+    /* Exactly halfway: round to even, unless there was more. */
+    if (a->d[nd] == 5 && nd + 1 == a->nd) {
+        if (a->trunc)
+            return 1;
+
+        return nd > 0 && (a->d[nd - 1] % 2) == 1;
+    }
+
+    return a->d[nd] >= 5;
+}
+
+/* The integer part, rounded to nearest. */
+static uint64_t
+decimal_rounded_integer(const struct decimal *a) {
+    uint64_t n = 0;
+    int i;
+
+    if (a->dp > 20)
+        return ~(uint64_t) 0;
+
+    for (i = 0; i < a->dp && i < a->nd; i++)
+        n = n * 10 + a->d[i];
+
+    for (; i < a->dp; i++)
+        n *= 10;
+
+    if (decimal_should_round_up(a, a->dp))
+        n++;
+
+    return n;
+}
+
+/* Converts the decimal number exactly, rounding to nearest even. */
+static uint64_t
+decimal_to_bits(struct decimal *a, const struct fp_format *fmt, int *flags) {
+    /* Shifting by powtab[i] bits turns i decimal digits into none. */
+    static const int powtab[] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+    const int max_exp = (1 << fmt->exponent_bits) - 1;
+    const int bias = -fmt->bias;
+    uint64_t mantissa;
+    int exp;
+
+    if (a->nd == 0)
+        return 0;
+
+    if (a->dp > 310)
+        goto overflow;
+
+    if (a->dp < -330) {
+        (*flags) |= FPCONV_RANGE_ERROR;
+        return 0;
+    }
+
+    /* Scale by powers of two until the number is in [0.5, 1). */
+    exp = 0;
+
+    while (a->dp > 0) {
+        int n = (a->dp >= (int) (sizeof(powtab) / sizeof(powtab[0]))) ? 27 : powtab[a->dp];
+
+        decimal_shift(a, -n);
+        exp += n;
+    }
+
+    while (a->dp < 0 || (a->dp == 0 && a->d[0] < 5)) {
+        int n = (-a->dp >= (int) (sizeof(powtab) / sizeof(powtab[0]))) ? 27 : powtab[-a->dp];
+
+        decimal_shift(a, n);
+        exp -= n;
+    }
+
+    /* The range is [0.5, 1) but floating point numbers are in [1, 2). */
+    exp--;
+
+    /* Too small for a normalized number? Then it is subnormal. */
+    if (exp < bias + 1) {
+        int n = bias + 1 - exp;
+
+        decimal_shift(a, -n);
+        exp += n;
+    }
+
+    if (exp - bias >= max_exp)
+        goto overflow;
+
+    /* Extract the mantissa, with the implicit bit. */
+    decimal_shift(a, 1 + fmt->mantissa_bits);
+    mantissa = decimal_rounded_integer(a);
+
+    /* Rounding might have added a bit. */
+    if (mantissa == ((uint64_t) 2) << fmt->mantissa_bits) {
+        mantissa >>= 1;
+        exp++;
+
+        if (exp - bias >= max_exp)
+            goto overflow;
+    }
+
+    /* Subnormal? */
+    if ((mantissa & (((uint64_t) 1) << fmt->mantissa_bits)) == 0) {
+        exp = bias;
+
+        if (mantissa == 0)
+            (*flags) |= FPCONV_RANGE_ERROR;
+    }
+
+    return (mantissa & ((((uint64_t) 1) << fmt->mantissa_bits) - 1)) |
+           ((uint64_t) ((exp - bias) & max_exp) << fmt->mantissa_bits);
+
+overflow:
+
+    (*flags) |= FPCONV_RANGE_ERROR;
+
+    return (uint64_t) max_exp << fmt->mantissa_bits;
+}
+
+/****************************************************************************/
+
+const char *
+__fpconv_scan_decimal(const char *str, int decimal_point, int is_float, uint64_t *result, int *flags) {
+    const struct fp_format *fmt = is_float ? &float_format : &double_format;
+    const char *s = str;
+    const char *digits_end;
+    uint64_t mantissa = 0;
+    int num_digits = 0;
+    int truncated = 0;
+    int any_digits = 0;
+    int explicit_exp10 = 0;
+    int exp10 = 0;
+    int c;
+
+    (*flags) = 0;
+    (*result) = 0;
+
+    /* Collect up to 19 significant digits; any further digits only
+       count towards the exponent. */
+    while ((c = (*s)) >= '0' && c <= '9') {
+        if (num_digits < MAX_MANTISSA_DIGITS) {
+            mantissa = mantissa * 10 + (c - '0');
+            if (mantissa != 0)
+                num_digits++;
+        } else {
+            exp10++;
+            if (c != '0')
+                truncated = 1;
+        }
+
+        any_digits = 1;
+        s++;
+    }
+
+    if (c == decimal_point || c == '.') {
+        s++;
+
+        while ((c = (*s)) >= '0' && c <= '9') {
+            if (num_digits < MAX_MANTISSA_DIGITS) {
+                mantissa = mantissa * 10 + (c - '0');
+                if (mantissa != 0)
+                    num_digits++;
+
+                exp10--;
+            } else if (c != '0') {
+                truncated = 1;
+            }
+
+            any_digits = 1;
+            s++;
+        }
+    }
+
+    if (!any_digits)
+        return str;
+
+    digits_end = s;
+
+    /* An exponent only counts if there is at least one digit. */
+    if ((*s) == 'e' || (*s) == 'E') {
+        const char *e = s + 1;
+        int negative = 0;
+        int exponent = 0;
+
+        if ((*e) == '-') {
+            negative = 1;
+            e++;
+        } else if ((*e) == '+') {
+            e++;
+        }
+
+        if ((*e) >= '0' && (*e) <= '9') {
+            while ((c = (*e)) >= '0' && c <= '9') {
+                if (exponent < MAX_EXPONENT)
+                    exponent = exponent * 10 + (c - '0');
+
+                e++;
+            }
+
+            explicit_exp10 = negative ? -exponent : exponent;
+            exp10 += explicit_exp10;
+            s = e;
+        }
+    }
+
+    if (mantissa == 0)
+        return s;
+
+    /* The number lies in [10^(magnitude - 1), 10^magnitude). Anything far
+       out of range needs no rounding at all. */
+    {
+        int magnitude = num_digits + exp10;
+
+        if (magnitude - 1 > (is_float ? 38 : 308)) {
+            (*flags) |= FPCONV_RANGE_ERROR;
+            (*result) = (uint64_t) ((1 << fmt->exponent_bits) - 1) << fmt->mantissa_bits;
+            return s;
+        }
+
+        if (magnitude < (is_float ? -45 : -323)) {
+            (*flags) |= FPCONV_RANGE_ERROR;
+            return s;
+        }
+    }
+
+    if (!truncated) {
+        if (clinger(mantissa, exp10, is_float, result))
+            return s;
+
+        if (eisel_lemire(mantissa, exp10, fmt, result))
+            return s;
+    } else {
+        uint64_t upper;
+
+        /* The digits which were cut off lie somewhere between the two;
+           if both round to the same number, that is the result. */
+        if (eisel_lemire(mantissa, exp10, fmt, result) &&
+            eisel_lemire(mantissa + 1, exp10, fmt, &upper) && (*result) == upper) {
+            return s;
+        }
+    }
+
+    /* All this did not work; the hard way then. */
+    {
+        struct decimal a;
+
+        decimal_set(&a, str, digits_end, decimal_point, explicit_exp10);
+
+        (*result) = decimal_to_bits(&a, fmt, flags);
+    }
+
+    return s;
+}
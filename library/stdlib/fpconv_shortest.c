@@ -0,0 +1,299 @@
+/*
+ * $Id: stdlib_fpconv_shortest.c,v 1.0 2026-10-17 19:02:11 clib2devs Exp $
+*/
+
+#ifndef _STDLIB_FPCONV_H
+#include "stdlib_fpconv.h"
+#endif /* _STDLIB_FPCONV_H */
+
+#include <string.h>
+
+/****************************************************************************/
+
+/* This is the core of Ryu (Ulf Adams, "Ryu: fast float-to-string conversion",
+   PLDI 2018), reduced to what printf() needs. All the numbers involved are
+   computed with 64 bit integer arithmetic and the tables from
+   stdlib_fpconv_tables.c. */
+
+#define DOUBLE_MANTISSA_BITS 52
+#define DOUBLE_EXPONENT_BITS 11
+#define DOUBLE_BIAS          1023
+
+/****************************************************************************/
+
+/* ceil(log2(5^e)), or 1 for e == 0; valid for 0 <= e <= 3528. */
+static __inline__ int
+pow5bits(int e) {
+    return (int) (((uint32_t) e * 1217359) >> 19) + 1;
+}
+
+/* floor(log10(2^e)); valid for 0 <= e <= 1650. */
+static __inline__ uint32_t
+log10_pow2(int e) {
+    return ((uint32_t) e * 78913) >> 18;
+}
+
+/* floor(log10(5^e)); valid for 0 <= e <= 2620. */
+static __inline__ uint32_t
+log10_pow5(int e) {
+    return ((uint32_t) e * 732923) >> 20;
+}
+
+/* 64 bit divisions by constants, done through multiplications. On a 32 bit
+   CPU these are a lot faster than calling the generic division routine. */
+static __inline__ uint64_t
+div5(uint64_t x) {
+    uint64_t high;
+
+    __fpconv_umul128(x, 0xCCCCCCCCCCCCCCCDULL, &high);
+
+    return high >> 2;
+}
+
+static __inline__ uint64_t
+div10(uint64_t x) {
+    uint64_t high;
+
+    __fpconv_umul128(x, 0xCCCCCCCCCCCCCCCDULL, &high);
+
+    return high >> 3;
+}
+
+static __inline__ uint64_t
+div100(uint64_t x) {
+    uint64_t high;
+
+    __fpconv_umul128(x >> 2, 0x28F5C28F5C28F5C3ULL, &high);
+
+    return high >> 2;
+}
+
+static __inline__ int
+pow5_factor(uint64_t value) {
+    int count = 0;
+
+    for (;;) {
+        uint64_t q = div5(value);
+
+        if (value - 5 * q != 0)
+            break;
+
+        value = q;
+        count++;
+    }
+
+    return count;
+}
+
+static __inline__ int
+multiple_of_pow5(uint64_t value, uint32_t p) {
+    return (uint32_t) pow5_factor(value) >= p;
+}
+
+static __inline__ int
+multiple_of_pow2(uint64_t value, uint32_t p) {
+    return (value & ((((uint64_t) 1) << p) - 1)) == 0;
+}
+
+/* (m * mul) >> j, for 64 <= j. 'm' has at most 55 bits, 'mul' 125 bits. */
+static __inline__ uint64_t
+mul_shift64(uint64_t m, const uint64_t *mul, int j) {
+    uint64_t high0, high1, low1, sum_low, sum_high;
+
+    __fpconv_umul128(m, mul[0], &high0);
+    low1 = __fpconv_umul128(m, mul[1], &high1);
+
+    sum_low = low1 + high0;
+    sum_high = high1 + (sum_low < low1);
+
+    j -= 64;
+    if (j == 0)
+        return sum_low;
+
+    return (sum_high << (64 - j)) | (sum_low >> j);
+}
+
+/****************************************************************************/
+
+int
+__fpconv_shortest(double value, char *digits, int *exponent) {
+    uint64_t bits, ieee_mantissa, m2, mv, mp, mm, vr, vp, vm, output;
+    uint32_t ieee_exponent, mm_shift, q;
+    int e2, e10, removed, accept_bounds, vm_is_trailing_zeros, vr_is_trailing_zeros;
+    uint8_t last_removed_digit;
+    int count, i;
+    uint32_t small;
+
+    memcpy(&bits, &value, sizeof(bits));
+
+    ieee_mantissa = bits & ((((uint64_t) 1) << DOUBLE_MANTISSA_BITS) - 1);
+    ieee_exponent = (uint32_t) ((bits >> DOUBLE_MANTISSA_BITS) & ((1u << DOUBLE_EXPONENT_BITS) - 1));
+
+    /* Subtract 2 so that the bounds computation has 2 additional bits. */
+    if (ieee_exponent == 0) {
+        e2 = 1 - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = (int) ieee_exponent - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+        m2 = (((uint64_t) 1) << DOUBLE_MANTISSA_BITS) | ieee_mantissa;
+    }
+
+    accept_bounds = ((m2 & 1) == 0);
+
+    /* The interval of numbers which round to 'value' is [mm, mp], scaled
+       by 4. The lower bound is closer if 'value' is a power of two. */
+    mv = 4 * m2;
+    mm_shift = (ieee_mantissa != 0 || ieee_exponent <= 1);
+    mp = 4 * m2 + 2;
+    mm = 4 * m2 - 1 - mm_shift;
+
+    vm_is_trailing_zeros = 0;
+    vr_is_trailing_zeros = 0;
+
+    /* Convert all three to decimal, with just enough precision to tell
+       them apart. */
+    if (e2 >= 0) {
+        int k, i;
+
+        q = log10_pow2(e2) - (e2 > 3);
+        e10 = (int) q;
+        k = FPCONV_POW5_INV_BITCOUNT + pow5bits((int) q) - 1;
+        i = -e2 + (int) q + k;
+
+        vr = mul_shift64(mv, __fpconv_pow5_inv_split[q], i);
+        vp = mul_shift64(mp, __fpconv_pow5_inv_split[q], i);
+        vm = mul_shift64(mm, __fpconv_pow5_inv_split[q], i);
+
+        if (q <= 21) {
+            /* Only one of mp, mv and mm can be a multiple of 5, if any. */
+            if (mv - 5 * div5(mv) == 0)
+                vr_is_trailing_zeros = multiple_of_pow5(mv, q);
+            else if (accept_bounds)
+                vm_is_trailing_zeros = multiple_of_pow5(mm, q);
+            else
+                vp -= multiple_of_pow5(mp, q);
+        }
+    } else {
+        int k, i, j;
+
+        q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = (int) q + e2;
+        i = -e2 - (int) q;
+        k = pow5bits(i) - FPCONV_POW5_BITCOUNT;
+        j = (int) q - k;
+
+        vr = mul_shift64(mv, __fpconv_pow5_split[i], j);
+        vp = mul_shift64(mp, __fpconv_pow5_split[i], j);
+        vm = mul_shift64(mm, __fpconv_pow5_split[i], j);
+
+        if (q <= 1) {
+            /* mv has at least q trailing zero bits, and so does mm if the
+               interval is symmetric. */
+            vr_is_trailing_zeros = 1;
+
+            if (accept_bounds)
+                vm_is_trailing_zeros = (mm_shift == 1);
+            else
+                vp--;
+        } else if (q < 63) {
+            vr_is_trailing_zeros = multiple_of_pow2(mv, q);
+        }
+    }
+
+    /* Remove as many digits as the interval allows. */
+    removed = 0;
+    last_removed_digit = 0;
+
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros) {
+        /* This is the rare case which needs to keep track of ties. */
+        for (;;) {
+            uint64_t vp_div10 = div10(vp);
+            uint64_t vm_div10 = div10(vm);
+            uint64_t vr_div10;
+
+            if (vp_div10 <= vm_div10)
+                break;
+
+            vr_div10 = div10(vr);
+            vm_is_trailing_zeros &= (vm == vm_div10 * 10);
+            vr_is_trailing_zeros &= (last_removed_digit == 0);
+            last_removed_digit = (uint8_t) (vr - vr_div10 * 10);
+            vr = vr_div10;
+            vp = vp_div10;
+            vm = vm_div10;
+            removed++;
+        }
+
+        if (vm_is_trailing_zeros) {
+            for (;;) {
+                uint64_t vm_div10 = div10(vm);
+                uint64_t vr_div10;
+
+                if (vm != vm_div10 * 10)
+                    break;
+
+                vr_div10 = div10(vr);
+                vr_is_trailing_zeros &= (last_removed_digit == 0);
+                last_removed_digit = (uint8_t) (vr - vr_div10 * 10);
+                vr = vr_div10;
+                vp = div10(vp);
+                vm = vm_div10;
+                removed++;
+            }
+        }
+
+        /* Round even if the exact number is .....50..0. */
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0)
+            last_removed_digit = 4;
+
+        output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) || last_removed_digit >= 5);
+    } else {
+        int round_up = 0;
+
+        uint64_t vp_div, vm_div, vr_div;
+
+        /* Two digits at a time first, which is usually worth it. */
+        vp_div = div100(vp);
+        vm_div = div100(vm);
+        if (vp_div > vm_div) {
+            vr_div = div100(vr);
+            round_up = (vr - vr_div * 100 >= 50);
+            vr = vr_div;
+            vp = vp_div;
+            vm = vm_div;
+            removed += 2;
+        }
+
+        for (;;) {
+            vp_div = div10(vp);
+            vm_div = div10(vm);
+            if (vp_div <= vm_div)
+                break;
+
+            vr_div = div10(vr);
+            round_up = (vr - vr_div * 10 >= 5);
+            vr = vr_div;
+            vp = vp_div;
+            vm = vm_div;
+            removed++;
+        }
+
+        output = vr + (vr == vm || round_up);
+    }
+
+    /* Write down the digits, most of them with 32 bit arithmetic. */
+    for (count = 1, vr = output; vr >= 10; vr = div10(vr))
+        count++;
+
+    for (i = count; output > 0xFFFFFFFFUL; output = vr) {
+        vr = div10(output);
+        digits[--i] = (char) ('0' + (output - vr * 10));
+    }
+
+    for (small = (uint32_t) output; i > 0; small /= 10)
+        digits[--i] = (char) ('0' + small % 10);
+
+    (*exponent) = e10 + removed;
+
+    return count;
+}
@@ -1,5 +1,5 @@
 /*
- * $Id: stdlib_free.c,v 1.15 2022-04-03 12:04:25 clib2devs Exp $
+ * $Id: stdlib_free.c,v 1.19 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 /*#define DEBUG*/
@@ -12,34 +12,24 @@
 #include "stdlib_memory.h"
 #endif /* _STDLIB_MEMORY_H */
 
-#include <malloc.h>
-
 #undef free
 
 void
 free(void *ptr) {
-
-    BOOL found = FALSE;
-    struct MemalignEntry *e = NULL;
-    /* Check if we have something created by memalign */
-    if (__global_clib2 != NULL) {
-        e = (struct MemalignEntry *) AVL_FindNode(__global_clib2->__memalign_tree, ptr, MemalignAVLKeyComp);
-        if (e) {
-            found = TRUE;
-        }
-    }
+    /* Small chunks go back to the calling task's cache without locking,
+     * which counts them itself. Pointers returned by memalign() are
+     * recognized by the allocator itself through the header in front of them. */
+    if (__thread_cache_free(ptr))
+        return;
 
     __memory_lock();
 
-    if (found) {
-        /* Free memory */
-        FreeVec(e->me_Exact);
-        e->me_Exact = NULL;
-        /* Remove the node */
-        AVL_RemNodeByAddress(&__global_clib2->__memalign_tree, &e->me_AvlNode);
-        ItemPoolFree(__global_clib2->__memalign_pool, e);
-        e = NULL;
-    } else {
+    /* All the memory went away together with the allocator */
+    if (__wof_allocator != NULL) {
+        /* The allocator is gone after exit, so the size is only looked up
+           once it is known to be there */
+        __COUNT_CALL(__CLIB2_CALL_FREE, (ptr != NULL) ? wof_usable_size(__wof_allocator, ptr) : 0);
+
         wof_free(__wof_allocator, ptr);
     }
 
@@ -1,5 +1,5 @@
 /*
- * $Id: stdlib_malloc.c,v 1.22 2022-04-03 14:09:00 clib2devs Exp $
+ * $Id: stdlib_malloc.c,v 1.23 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _STDLIB_HEADERS_H
@@ -30,9 +30,18 @@ void *
 malloc(size_t size) {
     void *result = NULL;
 
+    __COUNT_CALL(__CLIB2_CALL_MALLOC, size);
+
+    /* Small requests are served from the calling task's cache */
+    result = __thread_cache_alloc(size);
+    if (result != NULL)
+        return (result);
+
     __memory_lock();
 
-    result = wof_alloc(__wof_allocator, size);
+    /* Nothing is left to allocate from once the library is shutting down */
+    if (__wof_allocator != NULL)
+        result = wof_alloc(__wof_allocator, size);
 
     __memory_unlock();
 
@@ -41,12 +50,12 @@ malloc(size_t size) {
 
 void __memory_lock(void) {
     if (memory_semaphore != NULL)
-        ObtainSemaphore(memory_semaphore);
+        __OBTAIN_SEMAPHORE_AT(memory_semaphore, __CLIB2_LOCK_MEMORY);
 }
 
 void __memory_unlock(void) {
     if (memory_semaphore != NULL)
-        ReleaseSemaphore(memory_semaphore);
+        __release_semaphore(memory_semaphore);
 }
 
 STDLIB_DESTRUCTOR(stdlib_memory_exit) {
@@ -54,8 +63,14 @@ STDLIB_DESTRUCTOR(stdlib_memory_exit) {
 
     __memory_lock();
 
-    if (__wof_allocator != NULL)
-    wof_allocator_destroy(__wof_allocator);
+    if (__wof_allocator != NULL) {
+        /* This also switches the caches off for whoever frees memory later,
+           a destructor or an exit function perhaps. */
+        __thread_cache_cleanup();
+
+        wof_allocator_destroy(__wof_allocator);
+        __wof_allocator = NULL;
+    }
 
     __memory_unlock();
 
@@ -82,6 +97,8 @@ STDLIB_CONSTRUCTOR(stdlib_memory_init) {
         goto out;
     }
 
+    __thread_cache_init();
+
     success = TRUE;
 
 out:
@@ -34,7 +34,12 @@ realloc(void *ptr, size_t size)
 	}
 	else
 	{
-        result = wof_realloc(__wof_allocator, ptr, size);
+		__memory_lock();
+		locked = TRUE;
+
+        if (__wof_allocator != NULL)
+            result = wof_realloc(__wof_allocator, ptr, size);
+
         if (result == NULL) {
             SHOWMSG("could not reallocate memory");
             goto out;
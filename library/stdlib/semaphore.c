@@ -1,36 +1,152 @@
 /*
- * $Id: stdlib_semaphore.c,v 1.3 2021-01-31 12:04:26 clib2devs Exp $
+ * $Id: stdlib_semaphore.c,v 1.4 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #include "stdlib_headers.h"
 
+/* The stdio, file descriptor and memory locks are skipped for as long as
+ * the program runs on its own. Instead of obtaining the semaphore, only
+ * the nesting count kept next to it goes up. All semaphores held that way
+ * are linked together, so that when the first thread or process is about
+ * to be started, __enable_locking() can obtain them for real first.
+ */
+struct ElidedSemaphore {
+    struct SignalSemaphore es_Semaphore;
+    struct ElidedSemaphore *es_Next;    /* Links semaphores held without locking */
+    struct ElidedSemaphore *es_Prev;
+    LONG es_NestCount;                  /* How often held without locking */
+};
+
+/* TRUE once another thread or process may call into the library. */
+BOOL NOCOMMON __locking_enabled;
+
+static struct ElidedSemaphore *held_semaphores;
+
+/****************************************************************************/
+
+static void
+unlink_semaphore(struct ElidedSemaphore *es) {
+    if (es->es_Prev != NULL)
+        es->es_Prev->es_Next = es->es_Next;
+    else
+        held_semaphores = es->es_Next;
+
+    if (es->es_Next != NULL)
+        es->es_Next->es_Prev = es->es_Prev;
+}
+
+/****************************************************************************/
+
 struct SignalSemaphore *
 __create_semaphore(void) {
-    struct SignalSemaphore *semaphore;
+    struct ElidedSemaphore *es;
 
     ENTER();
 
-    semaphore = AllocVecTags(sizeof(*semaphore), AVT_Type, MEMF_SHARED, TAG_DONE);
-    if (semaphore != NULL)
-        InitSemaphore(semaphore);
+    es = AllocVecTags(sizeof(*es), AVT_Type, MEMF_SHARED, AVT_ClearWithValue, 0, TAG_DONE);
+    if (es != NULL)
+        InitSemaphore(&es->es_Semaphore);
 
-    SHOWPOINTER(semaphore);
+    SHOWPOINTER(es);
     LEAVE();
 
-    return (semaphore);
+    return ((struct SignalSemaphore *) es);
 }
 
 /****************************************************************************/
 
 void
 __delete_semaphore(struct SignalSemaphore *semaphore) {
+    struct ElidedSemaphore *es = (struct ElidedSemaphore *) semaphore;
+
     ENTER();
     SHOWPOINTER(semaphore);
 
-    if (semaphore != NULL) {
-        FreeVec(semaphore);
+    if (es != NULL) {
+        if (es->es_NestCount > 0)
+            unlink_semaphore(es);
+
+        FreeVec(es);
         //FreeSysObject(ASOT_SEMAPHORE,semaphore);
     }
 
     LEAVE();
 }
+
+/****************************************************************************/
+
+/* These may only be used with semaphores made by __create_semaphore(). */
+void
+__obtain_semaphore(struct SignalSemaphore *semaphore) {
+    struct ElidedSemaphore *es = (struct ElidedSemaphore *) semaphore;
+
+    if (__locking_enabled) {
+        ObtainSemaphore(semaphore);
+    } else if (es->es_NestCount++ == 0) {
+        es->es_Prev = NULL;
+        es->es_Next = held_semaphores;
+
+        if (held_semaphores != NULL)
+            held_semaphores->es_Prev = es;
+
+        held_semaphores = es;
+    }
+}
+
+/****************************************************************************/
+
+BOOL
+__attempt_semaphore(struct SignalSemaphore *semaphore) {
+    /* The only thread can always have it. */
+    if (__locking_enabled)
+        return (BOOL) (AttemptSemaphore(semaphore) != FALSE);
+
+    __obtain_semaphore(semaphore);
+
+    return (TRUE);
+}
+
+/****************************************************************************/
+
+void
+__release_semaphore(struct SignalSemaphore *semaphore) {
+    struct ElidedSemaphore *es = (struct ElidedSemaphore *) semaphore;
+
+    /* The count can only be non-zero while locking is off. */
+    if (es->es_NestCount > 0) {
+        if (--es->es_NestCount == 0)
+            unlink_semaphore(es);
+    } else {
+        ReleaseSemaphore(semaphore);
+    }
+}
+
+/****************************************************************************/
+
+/* Has to be called by the program's only thread before it starts another
+   one, or a process which calls into the library. */
+void
+__enable_locking(void) {
+    struct ElidedSemaphore *es;
+
+    ENTER();
+
+    if (!__locking_enabled) {
+        SHOWMSG("switching locking on");
+
+        /* Whatever is held now has to be really held before anybody
+           else can come along and try to obtain it. */
+        while ((es = held_semaphores) != NULL) {
+            held_semaphores = es->es_Next;
+
+            while (es->es_NestCount > 0) {
+                ObtainSemaphore(&es->es_Semaphore);
+                es->es_NestCount--;
+            }
+        }
+
+        __locking_enabled = TRUE;
+    }
+
+    LEAVE();
+}
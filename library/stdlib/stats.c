@@ -0,0 +1,262 @@
+/*
+ * $Id: stdlib_stats.c,v 1.0 2026-10-17 12:00:00 clib2devs Exp $
+*/
+
+#ifndef _STDLIB_HEADERS_H
+#include "stdlib_headers.h"
+#endif /* _STDLIB_HEADERS_H */
+
+#ifndef _STDLIB_CONSTRUCTOR_H
+#include "stdlib_constructor.h"
+#endif /* _STDLIB_CONSTRUCTOR_H */
+
+#ifndef _TIME_HEADERS_H
+#include "time_headers.h"
+#endif /* _TIME_HEADERS_H */
+
+#if defined(CLIB2_STATS)
+
+/* The instrumented library counts how often its locks are obtained, how
+ * often somebody had to wait for them and for how long, and how much goes
+ * through read(), write(), malloc() and free(). Waiting times are measured
+ * with the time base and kept in ticks, which are only turned into
+ * nanoseconds when somebody asks for them.
+ *
+ * The counters are 64 bits wide, which the CPU cannot add to atomically,
+ * so they are updated with task switching disabled. Only the instrumented
+ * library pays for that; everywhere else the counting compiles to nothing.
+ */
+
+struct lock_counters {
+    uint64 lc_Acquisitions;
+    uint64 lc_Contended;
+    uint64 lc_WaitTicks;
+    uint64 lc_MaxWaitTicks;
+};
+
+struct call_counters {
+    uint64 cc_Calls;
+    uint64 cc_Bytes;
+};
+
+static struct lock_counters lock_counters[__CLIB2_NUM_LOCK_SITES];
+static struct call_counters call_counters[__CLIB2_NUM_CALL_SITES];
+
+/****************************************************************************/
+
+void
+__stats_count_lock(enum __clib2_lock_site site, BOOL contended, uint64 wait_ticks) {
+    struct lock_counters *lc = &lock_counters[site];
+
+    Forbid();
+
+    lc->lc_Acquisitions++;
+
+    if (contended) {
+        lc->lc_Contended++;
+        lc->lc_WaitTicks += wait_ticks;
+
+        if (wait_ticks > lc->lc_MaxWaitTicks)
+            lc->lc_MaxWaitTicks = wait_ticks;
+    }
+
+    Permit();
+}
+
+/****************************************************************************/
+
+void
+__stats_count_call(enum __clib2_call_site site, size_t num_bytes) {
+    struct call_counters *cc = &call_counters[site];
+
+    Forbid();
+
+    cc->cc_Calls++;
+    cc->cc_Bytes += num_bytes;
+
+    Permit();
+}
+
+/****************************************************************************/
+
+/* Only if the semaphore cannot be had right away is the time it takes
+   to get it measured. */
+void
+__stats_obtain_semaphore(struct SignalSemaphore *semaphore, enum __clib2_lock_site site) {
+    uint64 start;
+
+    if (__attempt_semaphore(semaphore)) {
+        __stats_count_lock(site, FALSE, 0);
+    } else {
+        start = rdtsc();
+
+        __obtain_semaphore(semaphore);
+
+        __stats_count_lock(site, TRUE, rdtsc() - start);
+    }
+}
+
+/****************************************************************************/
+
+static uint64
+ticks_to_nanos(uint64 ticks) {
+    struct timespec ts;
+
+    __convert_time_base(ticks, &ts);
+
+    return ((uint64) ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+/****************************************************************************/
+
+int
+__clib2_stats_snapshot(struct __clib2_stats *stats) {
+    struct lock_counters locks[__CLIB2_NUM_LOCK_SITES];
+    int result = ERROR;
+    int i;
+
+    ENTER();
+
+    SHOWPOINTER(stats);
+
+    if (stats == NULL) {
+        SHOWMSG("invalid stats parameter");
+
+        __set_errno(EFAULT);
+        goto out;
+    }
+
+    /* Take all the numbers at the same time. */
+    Forbid();
+
+    memcpy(locks, lock_counters, sizeof(locks));
+
+    for (i = 0; i < __CLIB2_NUM_CALL_SITES; i++) {
+        stats->s_Calls[i].cs_Calls = call_counters[i].cc_Calls;
+        stats->s_Calls[i].cs_Bytes = call_counters[i].cc_Bytes;
+    }
+
+    Permit();
+
+    for (i = 0; i < __CLIB2_NUM_LOCK_SITES; i++) {
+        stats->s_Locks[i].ls_Acquisitions = locks[i].lc_Acquisitions;
+        stats->s_Locks[i].ls_Contended = locks[i].lc_Contended;
+        stats->s_Locks[i].ls_WaitTotal = ticks_to_nanos(locks[i].lc_WaitTicks);
+        stats->s_Locks[i].ls_WaitMax = ticks_to_nanos(locks[i].lc_MaxWaitTicks);
+    }
+
+    result = OK;
+
+out:
+
+    RETURN(result);
+    return (result);
+}
+
+/****************************************************************************/
+
+int
+__clib2_stats_reset(void) {
+    Forbid();
+
+    memset(lock_counters, 0, sizeof(lock_counters));
+    memset(call_counters, 0, sizeof(call_counters));
+
+    Permit();
+
+    return (OK);
+}
+
+/****************************************************************************/
+
+/* Print the numbers when the program exits, to the file named by the
+   CLIB2_STATS environment variable, or to stderr. */
+static void
+dump_stats(void) {
+    static const char *lock_names[__CLIB2_NUM_LOCK_SITES] = {
+        "memory", "stdio", "fd", "iob", "locale", "pthread mutex"
+    };
+    static const char *call_names[__CLIB2_NUM_CALL_SITES] = {
+        "read", "write", "malloc", "free"
+    };
+    struct __clib2_stats stats;
+    const char *name;
+    FILE *out = stderr;
+    int i;
+
+    /* Printing the numbers changes them, so take them first. */
+    if (__clib2_stats_snapshot(&stats) != OK)
+        return;
+
+    name = getenv("CLIB2_STATS");
+    if (name != NULL && name[0] != '\0') {
+        out = fopen(name, "w");
+        if (out == NULL)
+            return;
+    }
+
+    fprintf(out, "%-14s %12s %12s %16s %14s\n", "lock", "acquired", "contended", "wait ns", "max wait ns");
+
+    for (i = 0; i < __CLIB2_NUM_LOCK_SITES; i++) {
+        fprintf(out, "%-14s %12llu %12llu %16llu %14llu\n", lock_names[i],
+                (unsigned long long) stats.s_Locks[i].ls_Acquisitions,
+                (unsigned long long) stats.s_Locks[i].ls_Contended,
+                (unsigned long long) stats.s_Locks[i].ls_WaitTotal,
+                (unsigned long long) stats.s_Locks[i].ls_WaitMax);
+    }
+
+    fprintf(out, "\n%-14s %12s %16s\n", "call", "calls", "bytes");
+
+    for (i = 0; i < __CLIB2_NUM_CALL_SITES; i++) {
+        fprintf(out, "%-14s %12llu %16llu\n", call_names[i],
+                (unsigned long long) stats.s_Calls[i].cs_Calls,
+                (unsigned long long) stats.s_Calls[i].cs_Bytes);
+    }
+
+    if (out != stderr)
+        fclose(out);
+    else
+        fflush(out);
+}
+
+/****************************************************************************/
+
+CLIB_CONSTRUCTOR(stats_init) {
+    ENTER();
+
+    /* This is registered before any of the program's own exit functions,
+       so it is called after all of them. */
+    atexit(dump_stats);
+
+    LEAVE();
+
+    CONSTRUCTOR_SUCCEED();
+}
+
+/****************************************************************************/
+
+#else
+
+/****************************************************************************/
+
+int
+__clib2_stats_snapshot(struct __clib2_stats *stats) {
+    (void) stats;
+
+    __set_errno(ENOSYS);
+
+    return (ERROR);
+}
+
+/****************************************************************************/
+
+int
+__clib2_stats_reset(void) {
+    __set_errno(ENOSYS);
+
+    return (ERROR);
+}
+
+/****************************************************************************/
+
+#endif /* CLIB2_STATS */
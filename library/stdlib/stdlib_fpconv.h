@@ -0,0 +1,93 @@
+/*
+ * $Id: stdlib_fpconv.h,v 1.0 2026-10-17 19:02:11 clib2devs Exp $
+*/
+
+#ifndef _STDLIB_FPCONV_H
+#define _STDLIB_FPCONV_H
+
+/****************************************************************************/
+
+/* Conversion between binary floating point numbers and decimal strings.
+
+   __fpconv_shortest() finds the shortest decimal number which reads back as
+   the same double (Ryu, Ulf Adams 2018). printf() builds on it whenever the
+   requested precision can be served from those digits.
+
+   __fpconv_scan_decimal() reads a decimal number and rounds it correctly to
+   a double or float. The common cases are handled by the Eisel-Lemire
+   algorithm (2020), all others by exact decimal arithmetic.
+
+   All of this only depends upon the compiler so that it can be checked on an
+   ordinary host, too. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/****************************************************************************/
+
+#define FPCONV_POW10_MIN -348
+#define FPCONV_POW10_MAX 347
+
+#define FPCONV_POW5_BITCOUNT       125
+#define FPCONV_POW5_INV_BITCOUNT   125
+#define FPCONV_POW5_TABLE_SIZE     326
+#define FPCONV_POW5_INV_TABLE_SIZE 342
+
+extern const uint64_t __fpconv_pow10[FPCONV_POW10_MAX - FPCONV_POW10_MIN + 1][2];
+extern const uint64_t __fpconv_pow5_split[FPCONV_POW5_TABLE_SIZE][2];
+extern const uint64_t __fpconv_pow5_inv_split[FPCONV_POW5_INV_TABLE_SIZE][2];
+
+/****************************************************************************/
+
+/* The number which was read is too large or too small to be represented. */
+#define FPCONV_RANGE_ERROR 1
+
+/* Finds the shortest decimal number which reads back as 'value', which must
+   be finite and larger than zero. Of all the candidates with that many digits,
+   the one closest to 'value' is chosen. Its digits are stored in 'digits' as
+   characters, without a terminating NUL, and the number is 0.d1d2d3... *
+   10^('exponent' + number of digits). Returns the number of digits, which is
+   at most 17. */
+extern int __fpconv_shortest(double value, char *digits, int *exponent);
+
+/* Reads a decimal number without a sign: digits, optionally followed by the
+   'decimal_point' character and more digits, and an optional exponent. The
+   number is rounded to the nearest double or, if 'is_float' is not zero,
+   float. The result is stored in 'result' as the bit pattern of that type.
+   Returns a pointer to the first character which is no longer part of the
+   number, or 'str' if there were no digits at all. 'flags' receives
+   FPCONV_RANGE_ERROR if the number overflowed to infinity or underflowed to
+   zero. */
+extern const char *__fpconv_scan_decimal(const char *str, int decimal_point, int is_float, uint64_t *result,
+                                         int *flags);
+
+/****************************************************************************/
+
+/* The full 128 bit product of two 64 bit numbers. */
+static __inline__ uint64_t
+__fpconv_umul128(uint64_t a, uint64_t b, uint64_t *high) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 p = (unsigned __int128) a * b;
+
+    (*high) = (uint64_t) (p >> 64);
+
+    return (uint64_t) p;
+#else
+    uint32_t a_lo = (uint32_t) a, a_hi = (uint32_t) (a >> 32);
+    uint32_t b_lo = (uint32_t) b, b_hi = (uint32_t) (b >> 32);
+    uint64_t b00 = (uint64_t) a_lo * b_lo;
+    uint64_t b01 = (uint64_t) a_lo * b_hi;
+    uint64_t b10 = (uint64_t) a_hi * b_lo;
+    uint64_t b11 = (uint64_t) a_hi * b_hi;
+    uint64_t mid1 = b10 + (b00 >> 32);
+    uint64_t mid2 = b01 + (uint32_t) mid1;
+
+    (*high) = b11 + (mid1 >> 32) + (mid2 >> 32);
+
+    return (mid2 << 32) | (uint32_t) b00;
+#endif /* __SIZEOF_INT128__ */
+}
+
+/****************************************************************************/
+
+#endif /* _STDLIB_FPCONV_H */
@@ -55,6 +55,8 @@
 #include <endian.h>
 #include <dos.h>
 
+#include <sys/clib2_stats.h>
+
 #ifndef _STDLIB_LOCALEBASE_H
 #include "stdlib_localebase.h"
 #endif /* _STDLIB_LOCALEBASE_H */
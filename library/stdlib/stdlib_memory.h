@@ -36,17 +36,6 @@ struct AVLMemoryNode {
     ULONG           amn_Size;
 };
 
-/* At moment to align memory we use AllocVectTags that already align the memory
- * The MemalignEntry structure is used when we call memalign and we have two different
- * ways to free memory. In our case if free is called via memalign
- * we have to use FreeVec otherwise we have to use wof_free
- */
-struct MemalignEntry
-{
-    struct AVLNode   me_AvlNode;
-    void            *me_Exact;            /* The address returned by AllocVecTags  */
-};
-
 extern wof_allocator_t NOCOMMON *__wof_allocator;
 
 extern unsigned long NOCOMMON __maximum_memory_allocated;
@@ -57,7 +46,22 @@ extern unsigned long NOCOMMON __current_num_memory_chunks_allocated;
 extern void __memory_lock(void);
 extern void __memory_unlock(void);
 
-extern int32 MemalignAVLNodeComp(struct AVLNode *avlnode1, struct AVLNode *avlnode2);
-extern int32 MemalignAVLKeyComp(struct AVLNode *avlnode1, AVLKey key2);
+/* Per-task caches of small chunks in front of the Wheel-of-Fortune allocator.
+ * Requests up to TCACHE_MAX_SIZE bytes are grouped in the first
+ * TCACHE_NUM_CLASSES slab classes of the allocator, so that a chunk returns
+ * to the list it was taken from. Empty lists are refilled with
+ * TCACHE_BATCH_SIZE chunks at once and lists longer than TCACHE_MAX_COUNT
+ * are halved. */
+#define TCACHE_NUM_CLASSES        10
+#define TCACHE_MAX_SIZE           256
+#define TCACHE_BATCH_SIZE         8
+#define TCACHE_MAX_COUNT          32
+#define TCACHE_MAX_TASKS          128
+
+extern void *__thread_cache_alloc(size_t size);
+extern BOOL __thread_cache_free(void *ptr);
+extern void __thread_cache_init(void);
+extern void __thread_cache_exit(void);
+extern void __thread_cache_cleanup(void);
 
 #endif /* _STDLIB_MEMORY_H */
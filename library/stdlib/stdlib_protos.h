@@ -146,6 +146,37 @@ extern int __get_errno(void);
 /* stdlib_semaphore.c */
 extern struct SignalSemaphore *__create_semaphore(void);
 extern void __delete_semaphore(struct SignalSemaphore *semaphore);
+extern void __obtain_semaphore(struct SignalSemaphore *semaphore);
+extern BOOL __attempt_semaphore(struct SignalSemaphore *semaphore);
+extern void __release_semaphore(struct SignalSemaphore *semaphore);
+extern void __enable_locking(void);
+extern BOOL NOCOMMON __locking_enabled;
+
+/****************************************************************************/
+
+/* stdlib_stats.c */
+extern int __clib2_stats_snapshot(struct __clib2_stats *stats);
+extern int __clib2_stats_reset(void);
+
+/* Counting is compiled in only if the library is built with STATS=yes;
+   otherwise these reduce to the plain operations. */
+#if defined(CLIB2_STATS)
+
+extern void __stats_count_lock(enum __clib2_lock_site site, BOOL contended, uint64 wait_ticks);
+extern void __stats_count_call(enum __clib2_call_site site, size_t num_bytes);
+extern void __stats_obtain_semaphore(struct SignalSemaphore *semaphore, enum __clib2_lock_site site);
+
+#define __OBTAIN_SEMAPHORE_AT(semaphore, site) __stats_obtain_semaphore(semaphore, site)
+#define __COUNT_CALL(site, num_bytes) __stats_count_call(site, num_bytes)
+#define __COUNT_LOCK(site) __stats_count_lock(site, FALSE, 0)
+
+#else
+
+#define __OBTAIN_SEMAPHORE_AT(semaphore, site) __obtain_semaphore(semaphore)
+#define __COUNT_CALL(site, num_bytes) ((void) 0)
+#define __COUNT_LOCK(site) ((void) 0)
+
+#endif /* CLIB2_STATS */
 
 /****************************************************************************/
 
@@ -18,6 +18,10 @@
 #include "math_headers.h"
 #endif /* _MATH_HEADERS_H */
 
+#ifndef _STDLIB_FPCONV_H
+#include "stdlib_fpconv.h"
+#endif /* _STDLIB_FPCONV_H */
+
 float
 strtof(const char *str, char **ptr)
 {
@@ -73,7 +77,8 @@ strtof(const char *str, char **ptr)
 	}
 
 	/* We begin by checking for the "inf" and "nan" strings. */
-	if (strcasecmp(str, "inf") == SAME || strcasecmp(str, "infinity") == SAME)
+	if (((*str) == 'i' || (*str) == 'I') &&
+	    (strcasecmp(str, "inf") == SAME || strcasecmp(str, "infinity") == SAME))
 	{
 		SHOWMSG("infinity");
 
@@ -83,7 +88,8 @@ strtof(const char *str, char **ptr)
 
 		stop = str;
 	}
-	else if (strncasecmp(str, "nan", 3) == SAME && (str[3] == '(' || str[3] == '\0'))
+	else if (((*str) == 'n' || (*str) == 'N') &&
+	         strncasecmp(str, "nan", 3) == SAME && (str[3] == '(' || str[3] == '\0'))
 	{
 		SHOWMSG("not a number");
 
@@ -103,6 +109,35 @@ strtof(const char *str, char **ptr)
 
 		stop = str;
 	}
+	else if ((*str) != '0' || (str[1] != 'x' && str[1] != 'X'))
+	{
+		int decimal_point = '.';
+		const char *end;
+		uint64_t bits;
+		uint32_t float_bits;
+		int flags;
+
+		/* A decimal number, which is rounded correctly. We accept both
+		   the locale configured decimal point and the plain old dot. */
+		__locale_lock();
+
+		if (__locale_table[LC_NUMERIC] != NULL)
+			decimal_point = __locale_table[LC_NUMERIC]->loc_DecimalPoint[0];
+
+		__locale_unlock();
+
+		end = __fpconv_scan_decimal(str, decimal_point, TRUE, &bits, &flags);
+		if (end != str)
+		{
+			float_bits = (uint32_t)bits;
+			memcpy(&sum, &float_bits, sizeof(sum));
+
+			if (flags & FPCONV_RANGE_ERROR)
+				__set_errno(ERANGE);
+
+			stop = end;
+		}
+	}
 	else
 	{
 		size_t num_digits_converted = 0;
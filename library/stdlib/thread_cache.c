@@ -0,0 +1,274 @@
+/*
+ * $Id: stdlib_thread_cache.c,v 1.3 2026-10-17 12:00:00 clib2devs Exp $
+*/
+
+#ifndef _STDLIB_HEADERS_H
+#include "stdlib_headers.h"
+#endif /* _STDLIB_HEADERS_H */
+
+#ifndef _STDLIB_MEMORY_H
+#include "stdlib_memory.h"
+#endif /* _STDLIB_MEMORY_H */
+
+/* Per-task caches of small free chunks which sit in front of the Wheel-of-Fortune
+ * allocator. Every task owns one cache, made of one singly linked free list per
+ * size class. A malloc()/free() pair which hits the cache never touches the
+ * memory semaphore: the semaphore is only obtained to refill an empty list with
+ * a batch of chunks or to give back half of a list which grew too long.
+ *
+ * Cached chunks are still marked as used inside the allocator, so they can
+ * migrate freely between tasks: a chunk allocated by one task and released by
+ * another simply ends up in the cache of the latter.
+ *
+ * Caches are looked up in an open addressed table keyed by the task pointer.
+ * Only the owning task ever inserts its own key, so claiming a slot needs just
+ * a single compare-and-swap and no lock. Only the main program and the pthreads
+ * get a cache, since they are the tasks which are known to give it back when
+ * they exit. Any other task calling malloc() goes to the allocator directly.
+ *
+ * Once the allocator is about to be torn down the caches are switched off for
+ * good, and whatever is freed after that is left alone.
+ */
+
+#define TCACHE_TOMBSTONE ((struct Task *) ~0UL)
+
+struct ThreadCacheBin {
+    void *tcb_Head;
+    ULONG tcb_Count;
+};
+
+struct ThreadCache {
+    struct ThreadCacheBin tc_Bins[TCACHE_NUM_CLASSES];
+};
+
+static struct Task *volatile cache_owners[TCACHE_MAX_TASKS];
+static struct ThreadCache *caches[TCACHE_MAX_TASKS];
+static volatile BOOL caches_disabled;
+
+#define TCACHE_NEXT(CHUNK) (*(void **) (CHUNK))
+
+static inline ULONG
+tcache_hash(struct Task *task) {
+    return (((ULONG) task) >> 4) % TCACHE_MAX_TASKS;
+}
+
+static struct ThreadCache *
+tcache_lookup(struct Task *task, BOOL create) {
+    ULONG slot = tcache_hash(task);
+    LONG reusable = -1;
+    ULONG i;
+
+    for (i = 0; i < TCACHE_MAX_TASKS; i++) {
+        struct Task *owner = cache_owners[slot];
+
+        if (owner == task)
+            return caches[slot];
+
+        if (owner == NULL)
+            break;
+
+        if (owner == TCACHE_TOMBSTONE && reusable < 0)
+            reusable = slot;
+
+        slot = (slot + 1) % TCACHE_MAX_TASKS;
+    }
+
+    if (!create)
+        return NULL;
+
+    /* Prefer a slot released by a task which already exited */
+    if (reusable >= 0) {
+        if (__sync_bool_compare_and_swap(&cache_owners[reusable], TCACHE_TOMBSTONE, task))
+            slot = reusable;
+        else
+            reusable = -1;
+    }
+
+    if (reusable < 0) {
+        if (i == TCACHE_MAX_TASKS)
+            return NULL;
+
+        /* Another task may have claimed our empty slot in the meantime */
+        while (!__sync_bool_compare_and_swap(&cache_owners[slot], NULL, task)) {
+            if (++i == TCACHE_MAX_TASKS)
+                return NULL;
+
+            slot = (slot + 1) % TCACHE_MAX_TASKS;
+        }
+    }
+
+    /* A reused slot keeps the (empty) cache of its previous owner */
+    if (caches[slot] == NULL)
+        caches[slot] = AllocVecTags(sizeof(struct ThreadCache), AVT_Type, MEMF_SHARED, AVT_ClearWithValue, 0, TAG_DONE);
+
+    return caches[slot];
+}
+
+/* Gives back the chunks of a cache to the allocator. The caller must hold the memory lock. */
+static void
+tcache_drain(struct ThreadCache *cache) {
+    struct ThreadCacheBin *bin;
+    void *chunk;
+    int i;
+
+    for (i = 0; i < TCACHE_NUM_CLASSES; i++) {
+        bin = &cache->tc_Bins[i];
+
+        while ((chunk = bin->tcb_Head) != NULL) {
+            bin->tcb_Head = TCACHE_NEXT(chunk);
+            wof_free(__wof_allocator, chunk);
+        }
+
+        bin->tcb_Count = 0;
+    }
+}
+
+void *
+__thread_cache_alloc(size_t size) {
+    struct ThreadCache *cache;
+    struct ThreadCacheBin *bin;
+    void *result;
+    int bin_index;
+
+    if (size == 0 || size > TCACHE_MAX_SIZE || caches_disabled)
+        return NULL;
+
+    cache = tcache_lookup(FindTask(NULL), FALSE);
+    if (cache == NULL)
+        return NULL;
+
+    bin_index = wof_size_class(size);
+    bin = &cache->tc_Bins[bin_index];
+
+    if (bin->tcb_Head == NULL) {
+        size_t class_size = wof_slab_class_size[bin_index];
+        int i;
+
+        /* Refill the list with a whole batch while we own the lock */
+        __memory_lock();
+
+        for (i = 0; i < TCACHE_BATCH_SIZE; i++) {
+            void *chunk = wof_alloc(__wof_allocator, class_size);
+            if (chunk == NULL)
+                break;
+
+            TCACHE_NEXT(chunk) = bin->tcb_Head;
+            bin->tcb_Head = chunk;
+            bin->tcb_Count++;
+        }
+
+        __memory_unlock();
+
+        if (bin->tcb_Head == NULL)
+            return NULL;
+    }
+
+    result = bin->tcb_Head;
+    bin->tcb_Head = TCACHE_NEXT(result);
+    bin->tcb_Count--;
+
+    return result;
+}
+
+BOOL
+__thread_cache_free(void *ptr) {
+    struct ThreadCache *cache;
+    struct ThreadCacheBin *bin;
+    size_t size;
+    int bin_index;
+
+    if (ptr == NULL || caches_disabled)
+        return FALSE;
+
+    cache = tcache_lookup(FindTask(NULL), FALSE);
+    if (cache == NULL)
+        return FALSE;
+
+    /* This needs no memory lock. The caller owns the chunk, so nobody else
+       changes its header; and the slab page it may be on keeps its size
+       class, and stays in the address index, while the chunk is in use. */
+    size = wof_usable_size(__wof_allocator, ptr);
+    if (size < wof_slab_class_size[0] || size > TCACHE_MAX_SIZE)
+        return FALSE;
+
+    /* Slab objects are exactly as large as their class. Anything else is
+       rounded down, so that every chunk in a list can serve the whole class. */
+    bin_index = wof_size_class(size);
+    if (wof_slab_class_size[bin_index] > size)
+        bin_index--;
+
+    bin = &cache->tc_Bins[bin_index];
+
+    TCACHE_NEXT(ptr) = bin->tcb_Head;
+    bin->tcb_Head = ptr;
+    bin->tcb_Count++;
+
+    /* The size is known already, so free() need not look it up again */
+    __COUNT_CALL(__CLIB2_CALL_FREE, size);
+
+    if (bin->tcb_Count > TCACHE_MAX_COUNT) {
+        /* Too many idle chunks: give back half of them in one go */
+        __memory_lock();
+
+        while (bin->tcb_Count > TCACHE_MAX_COUNT / 2) {
+            void *chunk = bin->tcb_Head;
+
+            bin->tcb_Head = TCACHE_NEXT(chunk);
+            bin->tcb_Count--;
+
+            wof_free(__wof_allocator, chunk);
+        }
+
+        __memory_unlock();
+    }
+
+    return TRUE;
+}
+
+/* Called by the main program and by every pthread when it starts. */
+void
+__thread_cache_init(void) {
+    if (!caches_disabled)
+        tcache_lookup(FindTask(NULL), TRUE);
+}
+
+void
+__thread_cache_exit(void) {
+    struct Task *task = FindTask(NULL);
+    struct ThreadCache *cache;
+    ULONG slot;
+
+    cache = tcache_lookup(task, FALSE);
+    if (cache == NULL)
+        return;
+
+    __memory_lock();
+    tcache_drain(cache);
+    __memory_unlock();
+
+    /* Release the slot. The empty cache stays around for the next task. */
+    for (slot = 0; slot < TCACHE_MAX_TASKS; slot++) {
+        if (cache_owners[slot] == task) {
+            cache_owners[slot] = TCACHE_TOMBSTONE;
+            break;
+        }
+    }
+}
+
+void
+__thread_cache_cleanup(void) {
+    ULONG slot;
+
+    caches_disabled = TRUE;
+
+    for (slot = 0; slot < TCACHE_MAX_TASKS; slot++) {
+        if (caches[slot] != NULL) {
+            tcache_drain(caches[slot]);
+
+            FreeVec(caches[slot]);
+            caches[slot] = NULL;
+        }
+
+        cache_owners[slot] = NULL;
+    }
+}
@@ -35,15 +35,21 @@
  * also a nice power of two, of course. */
 #define WOF_BLOCK_SIZE (8 * 1024 * 1024)
 
-/* The header for an entire OS-level 'block' of memory */
+/* The header for an entire OS-level 'block' of memory. The 'size' field is
+ * only used by jumbo blocks, where it holds the size of the user data. */
 typedef struct _wof_block_hdr_t {
     struct _wof_block_hdr_t *prev, *next;
+    size_t size;
 } wof_block_hdr_t;
 
 /* The header for a single 'chunk' of memory as returned from alloc/realloc.
  * The 'jumbo' flag indicates an allocation larger than a normal-sized block
  * would be capable of serving. If this is set, it is the only chunk in the
  * block and the other chunk header fields are irrelevant.
+ *
+ * The 'aligned' flag marks the pseudo header which precedes the pointer returned
+ * by wof_alloc_aligned(). It is not part of the chunk list: its 'prev' field holds
+ * the distance from the start of the real chunk data to the aligned pointer.
  */
 typedef struct _wof_chunk_hdr_t {
     int prev;
@@ -52,8 +58,9 @@ typedef struct _wof_chunk_hdr_t {
     int last: 1;
     int used: 1;
     int jumbo: 1;
+    int aligned: 1;
 
-    int len: 29;
+    int len: 28;
 } wof_chunk_hdr_t;
 
 /* Handy macros for navigating the chunks in a block as if they were a
@@ -95,12 +102,96 @@ typedef struct _wof_free_hdr_t {
  * WOF_*_SIZE macros (which do need to be aligned). */
 #define WOF_FREE_HEADER_SIZE sizeof(wof_free_hdr_t)
 
+/* Small requests (up to WOF_SLAB_MAX_SIZE bytes) are served from slabs: blocks
+ * of WOF_BLOCK_SIZE bytes which are aligned on their own size and cut into pages
+ * of WOF_SLAB_PAGE_SIZE bytes. Every page holds objects of a single size class
+ * and the objects carry no header at all. The page an object belongs to is found
+ * from its address alone: the block is looked up in an index which has one entry
+ * for every WOF_BLOCK_SIZE bytes of the 32 bit address space. */
+#define WOF_SLAB_PAGE_SIZE   (64 * 1024)
+#define WOF_SLAB_PAGES       (WOF_BLOCK_SIZE / WOF_SLAB_PAGE_SIZE)
+#define WOF_SLAB_MAX_SIZE    512
+#define WOF_SLAB_BLOCK_SHIFT 23
+#define WOF_SLAB_INDEX_SIZE  (1UL << (32 - WOF_SLAB_BLOCK_SHIFT))
+#define WOF_SLAB_NO_CLASS    0xff
+
+/* Geometric size classes, all multiples of WOF_ALIGN_AMOUNT */
+const unsigned short wof_slab_class_size[WOF_SLAB_NUM_CLASSES] = {
+        8, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512
+};
+
+/* Maps (size + 7) / 8 to the smallest class which can hold it */
+static const unsigned char wof_slab_size_to_class[WOF_SLAB_MAX_SIZE / 8 + 1] = {
+        0, 0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7, 8, 8, 8, 8, 8,
+        8, 8, 8, 9, 9, 9, 9, 9, 9, 9, 9, 10, 10, 10, 10, 10, 10, 10, 10,
+        10, 10, 10, 10, 10, 10, 10, 10, 11, 11, 11, 11, 11, 11, 11, 11,
+        11, 11, 11, 11, 11, 11, 11, 11
+};
+
+/* A single slab page. Free pages and partially used pages of a class are kept
+ * in doubly-linked lists. Objects which were released are pushed on the page's
+ * free stack; objects which were never used are carved with a bump pointer. */
+typedef struct _wof_slab_page_t {
+    struct _wof_slab_page_t *prev, *next;
+    struct _wof_slab_block_t *block;
+    void *free_stack;
+    unsigned char *bump;
+    unsigned char *limit;
+    unsigned short used;
+    unsigned char class_index;
+    unsigned char partial;
+} wof_slab_page_t;
+
+/* The descriptors of a slab block live outside of the block itself, so that
+ * every page can be used for objects. */
+typedef struct _wof_slab_block_t {
+    struct _wof_slab_block_t *next;
+    unsigned char *base;
+    unsigned int used_pages;
+    wof_slab_page_t pages[WOF_SLAB_PAGES];
+} wof_slab_block_t;
+
 struct _wof_allocator_t {
     wof_block_hdr_t *block_list;
     wof_chunk_hdr_t *master_head;
     wof_chunk_hdr_t *recycler_head;
+
+    wof_slab_block_t *slab_blocks;
+    wof_slab_page_t *slab_free_pages;
+    wof_slab_page_t *slab_partial[WOF_SLAB_NUM_CLASSES];
+    wof_slab_block_t *slab_index[WOF_SLAB_INDEX_SIZE];
 };
 
+/* STATISTICS */
+
+/* The allocator is always called with the memory lock held, so the global
+ * counters can be updated without any further locking. */
+static inline void
+wof_stats_add(size_t size) {
+    __current_memory_allocated += size;
+    __current_num_memory_chunks_allocated++;
+
+    if (__maximum_memory_allocated < __current_memory_allocated)
+        __maximum_memory_allocated = __current_memory_allocated;
+
+    if (__maximum_num_memory_chunks_allocated < __current_num_memory_chunks_allocated)
+        __maximum_num_memory_chunks_allocated = __current_num_memory_chunks_allocated;
+}
+
+static inline void
+wof_stats_remove(size_t size) {
+    __current_memory_allocated -= size;
+    __current_num_memory_chunks_allocated--;
+}
+
+static inline void
+wof_stats_resize(size_t old_size, size_t new_size) {
+    __current_memory_allocated = __current_memory_allocated - old_size + new_size;
+
+    if (__maximum_memory_allocated < __current_memory_allocated)
+        __maximum_memory_allocated = __current_memory_allocated;
+}
+
 /* MASTER/RECYCLER HELPERS */
 
 /* Cycles the recycler. See the design notes in the readme for more details. */
@@ -370,6 +461,7 @@ wof_split_free_chunk(wof_allocator_t *allocator, wof_chunk_hdr_t *chunk,  const
     extra->prev = chunk->len;
     extra->used = FALSE;
     extra->jumbo = FALSE;
+    extra->aligned = FALSE;
 
     /* Correctly update the following chunk's back-pointer */
     if (!last) {
@@ -415,6 +507,7 @@ wof_split_used_chunk(wof_allocator_t *allocator, wof_chunk_hdr_t *chunk, const s
     extra->prev = chunk->len;
     extra->used = FALSE;
     extra->jumbo = FALSE;
+    extra->aligned = FALSE;
 
     /* Correctly update the following chunk's back-pointer */
     if (!last) {
@@ -467,6 +560,7 @@ wof_init_block(wof_allocator_t *allocator,
 
     chunk->used = FALSE;
     chunk->jumbo = FALSE;
+    chunk->aligned = FALSE;
     chunk->last = TRUE;
     chunk->prev = 0;
     chunk->len = WOF_BLOCK_SIZE - WOF_BLOCK_HEADER_SIZE;
@@ -512,12 +606,14 @@ wof_alloc_jumbo(wof_allocator_t *allocator, const size_t size) {
 
     /* add it to the block list */
     wof_add_to_block_list(allocator, block);
+    block->size = size;
 
     /* the new block contains a single jumbo chunk */
     chunk = WOF_BLOCK_TO_CHUNK(block);
     chunk->last = TRUE;
     chunk->used = TRUE;
     chunk->jumbo = TRUE;
+    chunk->aligned = FALSE;
     chunk->len = 0;
     chunk->prev = 0;
 
@@ -540,115 +636,239 @@ wof_free_jumbo(wof_allocator_t *allocator, wof_chunk_hdr_t *chunk) {
     }
 }
 
-/* Reallocs special 'jumbo' blocks of sizes that won't fit normally. */
-static void *
-wof_realloc_jumbo(wof_allocator_t *allocator, wof_chunk_hdr_t *chunk, const size_t size) {
-    void *result;
-    wof_block_hdr_t *block;
-    wof_block_hdr_t *newptr;
-    size_t old_size;
+/* SLAB HELPERS */
 
-    old_size = WOF_CHUNK_DATA_LEN(chunk);
-    block = WOF_CHUNK_TO_BLOCK(chunk);
+/* Returns the slab page holding ptr, or NULL if ptr was not served by a slab. */
+static inline wof_slab_page_t *
+wof_slab_page_of(wof_allocator_t *allocator, const void *ptr) {
+    wof_slab_block_t *block;
 
-    /* If we have an invalid block return NULL */
-    if (block == NULL || old_size <= 0 || size <= 0) {
+    block = allocator->slab_index[((unsigned long) ptr) >> WOF_SLAB_BLOCK_SHIFT];
+    if (block == NULL) {
         return NULL;
     }
 
-    /* If we have the same size return the old chuck */
-    if (size == old_size) {
-        return chunk;
+    return &block->pages[((unsigned char *) ptr - block->base) / WOF_SLAB_PAGE_SIZE];
+}
+
+static void
+wof_slab_push_page(wof_slab_page_t **head, wof_slab_page_t *page) {
+    page->prev = NULL;
+    page->next = *head;
+    if (page->next) {
+        page->next->prev = page;
+    }
+    *head = page;
+}
+
+static void
+wof_slab_remove_page(wof_slab_page_t **head, wof_slab_page_t *page) {
+    if (page->prev) {
+        page->prev->next = page->next;
+    } else {
+        *head = page->next;
+    }
+
+    if (page->next) {
+        page->next->prev = page->prev;
     }
+}
 
-    if (old_size > size) {
-        if (old_size/2 >= size) {
-            /* at least half of the memory can be freed: allocate new, copy and free old. */
-            /* Allocate new block of memory */
-            newptr = (wof_block_hdr_t *) AllocVecTags(size
-                                                      + WOF_BLOCK_HEADER_SIZE
-                                                      + WOF_CHUNK_HEADER_SIZE,
-                                                      AVT_Type, MEMF_SHARED,
-                                                      AVT_ClearWithValue, 0,
-                                                      TAG_DONE);
+/* Puts all the pages of a slab block on the free page list. */
+static void
+wof_slab_init_block(wof_allocator_t *allocator, wof_slab_block_t *block) {
+    int i;
 
-            if (newptr == NULL) {
-                return NULL;
-            }
-            /* Copy old block to new one */
-            memcpy(newptr, block, size);
+    block->used_pages = 0;
 
+    /* push in reverse order so that pages are handed out by ascending address */
+    for (i = WOF_SLAB_PAGES - 1; i >= 0; i--) {
+        wof_slab_page_t *page = &block->pages[i];
 
-            /* Free old block */
-            if (block != NULL) {
-                FreeVec(block);
-                block = NULL;
-            }
+        page->block = block;
+        page->free_stack = NULL;
+        page->bump = block->base + i * WOF_SLAB_PAGE_SIZE;
+        page->limit = page->bump;
+        page->used = 0;
+        page->class_index = WOF_SLAB_NO_CLASS;
+        page->partial = FALSE;
 
-            if (newptr->next) {
-                newptr->next->prev = newptr;
-            }
+        wof_slab_push_page(&allocator->slab_free_pages, page);
+    }
+}
 
-            if (newptr->prev) {
-                newptr->prev->next = newptr;
-            } else {
-                allocator->block_list = newptr;
-            }
-            result = WOF_CHUNK_TO_DATA(WOF_BLOCK_TO_CHUNK(newptr));
-        }
-        else {
-            result = chunk;
-        }
+/* Allocates a new slab block from the OS. The block must be aligned on its own
+ * size, otherwise the address index would not work. */
+static BOOL
+wof_slab_new_block(wof_allocator_t *allocator) {
+    wof_slab_block_t *block;
+    unsigned char *base;
+
+    base = AllocVecTags(WOF_BLOCK_SIZE, AVT_Type, MEMF_SHARED, AVT_Alignment, WOF_BLOCK_SIZE, TAG_DONE);
+    if (base == NULL) {
+        return FALSE;
     }
-    else {
-        /* Allocate new block of memory */
-        newptr = (wof_block_hdr_t *) AllocVecTags(size
-                                                  + WOF_BLOCK_HEADER_SIZE
-                                                  + WOF_CHUNK_HEADER_SIZE,
-                                                  AVT_Type, MEMF_SHARED,
-                                                  AVT_ClearWithValue, 0,
-                                                  TAG_DONE);
 
-        if (newptr == NULL) {
+    block = AllocVecTags(sizeof(wof_slab_block_t), AVT_Type, MEMF_SHARED, TAG_DONE);
+    if (block == NULL) {
+        FreeVec(base);
+        return FALSE;
+    }
+
+    block->base = base;
+    block->next = allocator->slab_blocks;
+    allocator->slab_blocks = block;
+    allocator->slab_index[((unsigned long) base) >> WOF_SLAB_BLOCK_SHIFT] = block;
+
+    wof_slab_init_block(allocator, block);
+
+    return TRUE;
+}
+
+/* Assigns a free page to a size class and makes it the first partial page of
+ * that class. */
+static wof_slab_page_t *
+wof_slab_new_page(wof_allocator_t *allocator, int class_index) {
+    wof_slab_page_t *page;
+    size_t class_size;
+
+    if (allocator->slab_free_pages == NULL && !wof_slab_new_block(allocator)) {
+        return NULL;
+    }
+
+    page = allocator->slab_free_pages;
+    wof_slab_remove_page(&allocator->slab_free_pages, page);
+
+    class_size = wof_slab_class_size[class_index];
+
+    page->class_index = class_index;
+    page->free_stack = NULL;
+    page->bump = page->block->base + (page - page->block->pages) * WOF_SLAB_PAGE_SIZE;
+    page->limit = page->bump + (WOF_SLAB_PAGE_SIZE / class_size) * class_size;
+    page->used = 0;
+    page->partial = TRUE;
+    page->block->used_pages++;
+
+    wof_slab_push_page(&allocator->slab_partial[class_index], page);
+
+    return page;
+}
+
+static void *
+wof_slab_alloc(wof_allocator_t *allocator, const size_t size) {
+    wof_slab_page_t *page;
+    size_t class_size;
+    int class_index;
+    void *result;
+
+    class_index = wof_slab_size_to_class[(size + 7) >> 3];
+    class_size = wof_slab_class_size[class_index];
+
+    page = allocator->slab_partial[class_index];
+    if (page == NULL) {
+        page = wof_slab_new_page(allocator, class_index);
+        if (page == NULL) {
             return NULL;
         }
-        /* Copy old block to new one */
-        memcpy(newptr, block, old_size);
+    }
 
-        /* Free old block */
-        if (block != NULL) {
-            FreeVec(block);
-            block = NULL;
-        }
+    if (page->free_stack) {
+        result = page->free_stack;
+        page->free_stack = *(void **) result;
+    } else {
+        result = page->bump;
+        page->bump += class_size;
+    }
 
-        if (newptr->next) {
-            newptr->next->prev = newptr;
-        }
+    page->used++;
 
-        if (newptr->prev) {
-            newptr->prev->next = newptr;
-        } else {
-            allocator->block_list = newptr;
-        }
-        result = WOF_CHUNK_TO_DATA(WOF_BLOCK_TO_CHUNK(newptr));
+    /* A full page leaves the partial list until one of its objects is freed */
+    if (page->free_stack == NULL && page->bump >= page->limit) {
+        wof_slab_remove_page(&allocator->slab_partial[class_index], page);
+        page->partial = FALSE;
     }
+
     return result;
 }
 
-/* API */
+static void
+wof_slab_free(wof_allocator_t *allocator, wof_slab_page_t *page, void *ptr) {
+    wof_slab_page_t **partial;
 
-__BEGIN_DECLS
+    partial = &allocator->slab_partial[page->class_index];
 
-void *
-wof_alloc(wof_allocator_t *allocator, const size_t size) {
-    wof_chunk_hdr_t *chunk;
+    *(void **) ptr = page->free_stack;
+    page->free_stack = ptr;
+    page->used--;
 
-    if (size == 0) {
-        return NULL;
-    } else if (size > WOF_BLOCK_MAX_ALLOC_SIZE) {
-        return wof_alloc_jumbo(allocator, size);
+    if (!page->partial) {
+        wof_slab_push_page(partial, page);
+        page->partial = TRUE;
     }
 
+    /* Give empty pages back to the free page list, unless it is the last page
+     * of its class: keeping that one avoids flip-flopping on alloc/free pairs. */
+    if (page->used == 0 && (page->prev != NULL || page->next != NULL)) {
+        wof_slab_remove_page(partial, page);
+        page->partial = FALSE;
+        page->class_index = WOF_SLAB_NO_CLASS;
+        page->block->used_pages--;
+
+        wof_slab_push_page(&allocator->slab_free_pages, page);
+    }
+}
+
+/* Returns every slab page to the free page list. */
+static void
+wof_slab_free_all(wof_allocator_t *allocator) {
+    wof_slab_block_t *block;
+    int i;
+
+    allocator->slab_free_pages = NULL;
+    for (i = 0; i < WOF_SLAB_NUM_CLASSES; i++) {
+        allocator->slab_partial[i] = NULL;
+    }
+
+    for (block = allocator->slab_blocks; block != NULL; block = block->next) {
+        wof_slab_init_block(allocator, block);
+    }
+}
+
+/* Returns slab blocks without any used page to the OS. */
+static void
+wof_slab_gc(wof_allocator_t *allocator) {
+    wof_slab_block_t *block, *next, **link;
+    int i;
+
+    link = &allocator->slab_blocks;
+
+    for (block = allocator->slab_blocks; block != NULL; block = next) {
+        next = block->next;
+
+        if (block->used_pages > 0) {
+            link = &block->next;
+            continue;
+        }
+
+        for (i = 0; i < WOF_SLAB_PAGES; i++) {
+            wof_slab_page_t *page = &block->pages[i];
+
+            wof_slab_remove_page(&allocator->slab_free_pages, page);
+        }
+
+        *link = next;
+        allocator->slab_index[((unsigned long) block->base) >> WOF_SLAB_BLOCK_SHIFT] = NULL;
+
+        FreeVec(block->base);
+        FreeVec(block);
+    }
+}
+
+/* Serves a request from the regular chunks of the normal-sized blocks. */
+static wof_chunk_hdr_t *
+wof_alloc_chunk(wof_allocator_t *allocator, const size_t size) {
+    wof_chunk_hdr_t *chunk;
+
     if (allocator->recycler_head &&
         WOF_CHUNK_DATA_LEN(allocator->recycler_head) >= size) {
 
@@ -686,25 +906,163 @@ wof_alloc(wof_allocator_t *allocator, const size_t size) {
     /* mark it as used */
     chunk->used = TRUE;
 
+    return chunk;
+}
+
+/* Returns the start of the chunk data for a pointer which may have been
+ * returned by wof_alloc_aligned(). Must not be used on slab objects. */
+static inline void *
+wof_unalign(void *ptr) {
+    wof_chunk_hdr_t *chunk = WOF_DATA_TO_CHUNK(ptr);
+
+    if (chunk->aligned) {
+        return (unsigned char *) ptr - chunk->prev;
+    }
+
+    return ptr;
+}
+
+/* API */
+
+__BEGIN_DECLS
+
+void *
+wof_alloc(wof_allocator_t *allocator, const size_t size) {
+    wof_chunk_hdr_t *chunk;
+    void *result;
+
+    if (size == 0) {
+        return NULL;
+    } else if (size <= WOF_SLAB_MAX_SIZE) {
+        /* Small objects come from the slabs. If no slab block could be
+         * allocated we still try the regular chunks below. */
+        result = wof_slab_alloc(allocator, size);
+        if (result != NULL) {
+            wof_stats_add(wof_slab_class_size[wof_slab_size_to_class[(size + 7) >> 3]]);
+            return result;
+        }
+    } else if (size > WOF_BLOCK_MAX_ALLOC_SIZE) {
+        result = wof_alloc_jumbo(allocator, size);
+        if (result != NULL) {
+            wof_stats_add(size);
+        }
+        return result;
+    }
+
+    chunk = wof_alloc_chunk(allocator, size);
+    if (chunk == NULL) {
+        return NULL;
+    }
+
+    wof_stats_add(WOF_CHUNK_DATA_LEN(chunk));
+
     /* and return the user's pointer */
     return WOF_CHUNK_TO_DATA(chunk);
 }
 
+void *
+wof_alloc_aligned(wof_allocator_t *allocator, const size_t alignment, const size_t size) {
+    wof_chunk_hdr_t *chunk, *marker;
+    unsigned char *data, *aligned;
+    size_t total;
+
+    if (size == 0) {
+        return NULL;
+    } else if (alignment <= WOF_ALIGN_AMOUNT) {
+        return wof_alloc(allocator, size);
+    }
+
+    /* The power of two slab classes are naturally aligned on their size, since
+     * slab pages are aligned on WOF_SLAB_PAGE_SIZE. */
+    if (size <= WOF_SLAB_MAX_SIZE && alignment <= WOF_SLAB_MAX_SIZE) {
+        size_t slab_size = alignment;
+
+        while (slab_size < size) {
+            slab_size <<= 1;
+        }
+
+        data = wof_slab_alloc(allocator, slab_size);
+        if (data != NULL) {
+            wof_stats_add(slab_size);
+            return data;
+        }
+    }
+
+    /* Otherwise over-allocate a regular chunk, leaving room for the padding
+     * and for the pseudo header in front of the aligned pointer. */
+    total = size + alignment + WOF_CHUNK_HEADER_SIZE;
+    if (total < size) {
+        return NULL;
+    }
+
+    if (total > WOF_BLOCK_MAX_ALLOC_SIZE) {
+        data = wof_alloc_jumbo(allocator, total);
+        if (data == NULL) {
+            return NULL;
+        }
+        chunk = WOF_DATA_TO_CHUNK(data);
+
+        wof_stats_add(total);
+    } else {
+        chunk = wof_alloc_chunk(allocator, total);
+        if (chunk == NULL) {
+            return NULL;
+        }
+        data = WOF_CHUNK_TO_DATA(chunk);
+    }
+
+    if ((((unsigned long) data) & (alignment - 1)) == 0) {
+        aligned = data;
+    } else {
+        aligned = (unsigned char *) ((((unsigned long) data) + WOF_CHUNK_HEADER_SIZE + alignment - 1) & ~(alignment - 1));
+
+        marker = WOF_DATA_TO_CHUNK(aligned);
+        marker->prev = (int) (aligned - data);
+        marker->last = FALSE;
+        marker->used = TRUE;
+        marker->jumbo = FALSE;
+        marker->aligned = TRUE;
+        marker->len = 0;
+    }
+
+    if (!chunk->jumbo) {
+        /* Give the unused tail back */
+        wof_split_used_chunk(allocator, chunk, (aligned - data) + size);
+        wof_cycle_recycler(allocator);
+
+        wof_stats_add(WOF_CHUNK_DATA_LEN(chunk));
+    }
+
+    return aligned;
+}
+
 void
 wof_free(wof_allocator_t *allocator, void *ptr) {
     wof_chunk_hdr_t *chunk;
+    wof_slab_page_t *page;
 
     if (ptr == NULL) {
         return;
     }
 
+    page = wof_slab_page_of(allocator, ptr);
+    if (page != NULL) {
+        wof_stats_remove(wof_slab_class_size[page->class_index]);
+        wof_slab_free(allocator, page, ptr);
+        return;
+    }
+
+    ptr = wof_unalign(ptr);
     chunk = WOF_DATA_TO_CHUNK(ptr);
 
     if (chunk->jumbo) {
+        wof_stats_remove(WOF_CHUNK_TO_BLOCK(chunk)->size);
         wof_free_jumbo(allocator, chunk);
         return;
     }
 
+    wof_stats_remove(WOF_CHUNK_DATA_LEN(chunk));
+
     /* mark it as unused */
     chunk->used = FALSE;
 
@@ -719,6 +1077,9 @@ wof_free(wof_allocator_t *allocator, void *ptr) {
 void *
 wof_realloc(wof_allocator_t *allocator, void *ptr, const size_t size) {
     wof_chunk_hdr_t *chunk;
+    wof_slab_page_t *page;
+    size_t old_size;
+    void *newptr;
 
     if (ptr == NULL) {
         return wof_alloc(allocator, size);
@@ -729,12 +1090,66 @@ wof_realloc(wof_allocator_t *allocator, void *ptr, const size_t size) {
         return NULL;
     }
 
+    page = wof_slab_page_of(allocator, ptr);
+    if (page != NULL) {
+        old_size = wof_slab_class_size[page->class_index];
+
+        /* Stay put if the new size still maps to the same class */
+        if (size <= WOF_SLAB_MAX_SIZE &&
+            wof_slab_size_to_class[(size + 7) >> 3] == page->class_index) {
+            return ptr;
+        }
+
+        newptr = wof_alloc(allocator, size);
+        if (newptr == NULL) {
+            return NULL;
+        }
+        memcpy(newptr, ptr, old_size < size ? old_size : size);
+        wof_free(allocator, ptr);
+
+        return newptr;
+    }
+
+    if (wof_unalign(ptr) != ptr) {
+        /* The alignment does not have to be preserved, so anything which does
+         * not fit in place moves to a regular allocation. */
+        old_size = wof_usable_size(allocator, ptr);
+        if (size <= old_size) {
+            return ptr;
+        }
+
+        newptr = wof_alloc(allocator, size);
+        if (newptr == NULL) {
+            return NULL;
+        }
+        memcpy(newptr, ptr, old_size);
+        wof_free(allocator, ptr);
+
+        return newptr;
+    }
+
     chunk = WOF_DATA_TO_CHUNK(ptr);
 
     if (chunk->jumbo) {
-        return wof_realloc_jumbo(allocator, chunk, size);
+        old_size = WOF_CHUNK_TO_BLOCK(chunk)->size;
+
+        /* Shrinking by less than half is not worth a copy */
+        if (size <= old_size && size >= old_size / 2) {
+            return ptr;
+        }
+
+        newptr = wof_alloc(allocator, size);
+        if (newptr == NULL) {
+            return NULL;
+        }
+        memcpy(newptr, ptr, old_size < size ? old_size : size);
+        wof_free(allocator, ptr);
+
+        return newptr;
     }
 
+    old_size = WOF_CHUNK_DATA_LEN(chunk);
+
     if (size > WOF_CHUNK_DATA_LEN(chunk)) {
         /* grow */
         wof_chunk_hdr_t *tmp;
@@ -778,12 +1193,12 @@ wof_realloc(wof_allocator_t *allocator, void *ptr, const size_t size) {
             /* Now cycle the recycler */
             wof_cycle_recycler(allocator);
 
+            wof_stats_resize(old_size, WOF_CHUNK_DATA_LEN(chunk));
+
             /* And return the same old pointer */
             return ptr;
         } else {
             /* no room to grow, need to alloc, copy, free */
-            void *newptr;
-
             newptr = wof_alloc(allocator, size);
             if (newptr == NULL) {
                 return NULL;
@@ -803,6 +1218,8 @@ wof_realloc(wof_allocator_t *allocator, void *ptr, const size_t size) {
         /* Now cycle the recycler */
         wof_cycle_recycler(allocator);
 
+        wof_stats_resize(old_size, WOF_CHUNK_DATA_LEN(chunk));
+
         return ptr;
     }
 
@@ -810,6 +1227,43 @@ wof_realloc(wof_allocator_t *allocator, void *ptr, const size_t size) {
     return ptr;
 }
 
+/* The smallest slab class which can hold 'size' bytes, or -1 if there is none */
+int
+wof_size_class(size_t size) {
+    if (size == 0 || size > WOF_SLAB_MAX_SIZE) {
+        return -1;
+    }
+
+    return wof_slab_size_to_class[(size + 7) >> 3];
+}
+
+size_t
+wof_usable_size(wof_allocator_t *allocator, void *ptr) {
+    wof_chunk_hdr_t *chunk;
+    wof_slab_page_t *page;
+    void *data;
+    size_t padding;
+
+    if (ptr == NULL) {
+        return 0;
+    }
+
+    page = wof_slab_page_of(allocator, ptr);
+    if (page != NULL) {
+        return wof_slab_class_size[page->class_index];
+    }
+
+    data = wof_unalign(ptr);
+    padding = (unsigned char *) ptr - (unsigned char *) data;
+    chunk = WOF_DATA_TO_CHUNK(data);
+
+    if (chunk->jumbo) {
+        return WOF_CHUNK_TO_BLOCK(chunk)->size - padding;
+    }
+
+    return WOF_CHUNK_DATA_LEN(chunk) - padding;
+}
+
 void
 wof_free_all(wof_allocator_t *allocator) {
     wof_block_hdr_t *cur;
@@ -833,6 +1287,11 @@ wof_free_all(wof_allocator_t *allocator) {
             cur = cur->next;
         }
     }
+
+    wof_slab_free_all(allocator);
+
+    __current_memory_allocated = 0;
+    __current_num_memory_chunks_allocated = 0;
 }
 
 void
@@ -878,6 +1337,8 @@ wof_gc(wof_allocator_t *allocator) {
 
         cur = next;
     }
+
+    wof_slab_gc(allocator);
 }
 
 void
@@ -906,6 +1367,11 @@ wof_allocator_new(void) {
     allocator->master_head = NULL;
     allocator->recycler_head = NULL;
 
+    allocator->slab_blocks = NULL;
+    allocator->slab_free_pages = NULL;
+    memset(allocator->slab_partial, 0, sizeof(allocator->slab_partial));
+    memset(allocator->slab_index, 0, sizeof(allocator->slab_index));
+
     return allocator;
 }
 
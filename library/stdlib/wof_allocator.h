@@ -12,9 +12,17 @@ __BEGIN_DECLS
 
 typedef struct _wof_allocator_t wof_allocator_t;
 
+/* Small objects are grouped in these size classes */
+#define WOF_SLAB_NUM_CLASSES 12
+
+extern const unsigned short wof_slab_class_size[WOF_SLAB_NUM_CLASSES];
+
 extern void *wof_alloc(wof_allocator_t *allocator, const size_t size);
+extern void *wof_alloc_aligned(wof_allocator_t *allocator, const size_t alignment, const size_t size);
 extern void  wof_free(wof_allocator_t *allocator, void *ptr);
 extern void *wof_realloc(wof_allocator_t *allocator, void *ptr, const size_t size);
+extern size_t wof_usable_size(wof_allocator_t *allocator, void *ptr);
+extern int   wof_size_class(size_t size);
 extern void  wof_free_all(wof_allocator_t *allocator);
 extern void  wof_gc(wof_allocator_t *allocator);
 extern void  wof_allocator_destroy(wof_allocator_t *allocator);
@@ -6,6 +6,11 @@
 #include "string_headers.h"
 #endif /* _STRING_HEADERS_H */
 
+void
+__bcopy_generic(const void *src, void *dest, size_t len) {
+    memmove(dest, src, len);
+}
+
 void
 bcopy(const void *src, void *dest, size_t len) {
     ENTER();
@@ -15,20 +20,7 @@ bcopy(const void *src, void *dest, size_t len) {
 
     assert((len == 0) || (src != NULL && dest != NULL && (int) len > 0));
 
-    if (__global_clib2 != NULL && __global_clib2->optimizedCPUFunctions) {
-        /* Check if we have altivec enabled */
-        if (__global_clib2->hasAltivec) {
-            vec_bcopy(src, dest, len);
-        }
-        else {
-            /* Fallback to standard function */
-            memmove(dest, src, len);
-        }
-    }
-    else {
-        /* Fallback to standard function */
-        memmove(dest, src, len);
-    }
+    __string_functions.sf_bcopy(src, dest, len);
 
     LEAVE();
 }
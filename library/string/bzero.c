@@ -13,6 +13,13 @@ explicit_bzero (void *m, size_t len) {
     asm volatile ("" ::: "memory");
 }
 
+void
+__bzero_generic(void *m, size_t len) {
+    DECLARE_UTILITYBASE();
+
+    ClearMem(m, len);
+}
+
 void
 bzero(void *m, size_t len) {
     assert((len == 0) || (m != NULL && (int) len > 0));
@@ -21,22 +28,7 @@ bzero(void *m, size_t len) {
     SHOWPOINTER(m);
     SHOWVALUE(len);
 
-    DECLARE_UTILITYBASE();
-
-    if (__global_clib2 != NULL && __global_clib2->optimizedCPUFunctions) {
-        /* Check if we have altivec enabled */
-        if (__global_clib2->hasAltivec) {
-            vec_bzero(m, len);
-        }
-        else {
-            /* Fallback to standard function */
-            ClearMem(m, len);
-        }
-    }
-    else {
-        /* Fallback to standard function */
-        ClearMem(m, len);
-    }
+    __string_functions.sf_bzero(m, len);
 
     LEAVE();
 }
@@ -0,0 +1,99 @@
+/*
+ * $Id: string_dispatch.c,v 1.0 2026-10-17 16:40:12 clib2devs Exp $
+*/
+
+#ifndef _STDLIB_HEADERS_H
+#include "stdlib_headers.h"
+#endif /* _STDLIB_HEADERS_H */
+
+#ifndef _STRING_HEADERS_H
+#include "string_headers.h"
+#endif /* _STRING_HEADERS_H */
+
+/* Until the library is initialized only the portable functions may be used. */
+struct StringFunctions __string_functions = {
+    __memchr_generic,
+    __memrchr_generic,
+    __memcmp_generic,
+    __memset_generic,
+    __bzero_generic,
+    __bcopy_generic,
+    __strchr_generic,
+    __strcmp_generic,
+    __strcpy_generic,
+    __strlen_generic,
+    __strncmp_generic,
+    __strrchr_generic,
+    __wcslen_generic,
+    __wmemchr_generic,
+    __wmemset_generic
+};
+
+void
+__select_string_functions(void) {
+    struct StringFunctions sf = {
+        __memchr_generic,
+        __memrchr_generic,
+        __memcmp_generic,
+        __memset_generic,
+        __bzero_generic,
+        __bcopy_generic,
+        __strchr_generic,
+        __strcmp_generic,
+        __strcpy_generic,
+        __strlen_generic,
+        __strncmp_generic,
+        __strrchr_generic,
+        __wcslen_generic,
+        __wmemchr_generic,
+        __wmemset_generic
+    };
+
+    ENTER();
+
+    if (__global_clib2 != NULL && __global_clib2->optimizedCPUFunctions) {
+        SHOWVALUE(__global_clib2->cpufamily);
+        SHOWVALUE(__global_clib2->hasAltivec);
+
+        switch (__global_clib2->cpufamily) {
+            /* If we have a SAM4xx use specific version of functions */
+            case CPUFAMILY_4XX:
+                sf.sf_memchr = __memchr440;
+                sf.sf_memcmp = __memcmp440;
+                sf.sf_strchr = __strchr440;
+                sf.sf_strcmp = __strcmp440;
+                sf.sf_strcpy = __strcpy440;
+                sf.sf_strlen = __strlen440;
+                sf.sf_strncmp = __strncmp440;
+                sf.sf_strrchr = __strrchr440;
+                break;
+            default:
+                break;
+        }
+
+        if (__global_clib2->hasAltivec) {
+            sf.sf_memset = _vec_memset;
+            sf.sf_bzero = vec_bzero;
+            sf.sf_bcopy = vec_bcopy;
+            sf.sf_memrchr = vec_memrchr;
+            sf.sf_wcslen = vec_wcslen;
+            sf.sf_wmemchr = vec_wmemchr;
+            sf.sf_wmemset = vec_wmemset;
+
+            if (__global_clib2->cpufamily != CPUFAMILY_4XX) {
+                sf.sf_memchr = vec_memchr;
+                sf.sf_memcmp = vec_memcmp;
+                sf.sf_strchr = vec_strchr;
+                sf.sf_strcmp = vec_strcmp;
+                sf.sf_strcpy = vec_strcpy;
+                sf.sf_strlen = vec_strlen;
+                sf.sf_strncmp = vec_strncmp;
+                sf.sf_strrchr = vec_strrchr;
+            }
+        }
+    }
+
+    __string_functions = sf;
+
+    LEAVE();
+}
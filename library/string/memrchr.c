@@ -6,6 +6,15 @@
 #include "string_headers.h"
 #endif /* _STRING_HEADERS_H */
 
+#ifndef _STRING_SWAR_H
+#include "string_swar.h"
+#endif /* _STRING_SWAR_H */
+
+void *
+__memrchr_generic(const void *s, int c, size_t n) {
+    return __swar_memrchr(s, c, n);
+}
+
 /*
  * Reverse memchr()
  * Find the last occurrence of 'c' in the buffer 's' of size 'n'.
@@ -19,16 +28,9 @@ memrchr(const void *s, int c, size_t n) {
     SHOWVALUE(c);
     SHOWVALUE(n);
 
-    if (n != 0) {
-        cp = (unsigned char *) s + n;
-        do {
-            if (*(--cp) == (unsigned char) c) {
-                SHOWPOINTER(cp);
-                LEAVE();
-                return ((void *) cp);
-            }
-        } while (--n != 0);
-    }
+    cp = __string_functions.sf_memrchr(s, c, n);
+
+    SHOWPOINTER(cp);
     LEAVE();
-    return (NULL);
+    return ((void *) cp);
 }
@@ -10,13 +10,20 @@
 #include "string_headers.h"
 #endif /* _STRING_HEADERS_H */
 
+#ifndef _STRING_SWAR_H
+#include "string_swar.h"
+#endif /* _STRING_SWAR_H */
+
+void *
+__memset_generic(void *ptr, int val, size_t len) {
+    return __swar_memset(ptr, val, len);
+}
+
 void *
 memset(void *ptr, int val, size_t len) {
 	void *result = ptr;
 	unsigned char *m = ptr;
 
-    DECLARE_UTILITYBASE();
-
 	assert((len == 0) || (ptr != NULL && (int)len > 0));
 
 	if (ptr == NULL)
@@ -25,20 +32,7 @@ memset(void *ptr, int val, size_t len) {
 		goto out;
 	}
 
-    if (__global_clib2 != NULL && __global_clib2->optimizedCPUFunctions == TRUE) {
-        /* Check if we have altivec enabled */
-        if (__global_clib2->hasAltivec) {
-            result = _vec_memset(m, (unsigned char)(val & 255), len);
-        }
-        else {
-            /* Fallback to standard function */
-            result = SetMem(ptr, val, len);
-        }
-    }
-    else {
-        /* Fallback to standard function */
-        result = SetMem(ptr, val, len);
-    }
+    result = __string_functions.sf_memset(m, (unsigned char)(val & 255), len);
 
 out:
 
@@ -5,29 +5,24 @@
 #include <string.h>
 #include <ctype.h>
 
+#ifndef _STRING_TWOWAY_H
+#include "string_twoway.h"
+#endif /* _STRING_TWOWAY_H */
+
 char *
 strcasestr(const char *psz_big, const char *psz_little)
 {
-    char *p_pos = (char *)psz_big;
+    unsigned char fold[256];
+    int i;
 
     if (!*psz_little)
-        return p_pos;
+        return (char *)psz_big;
+
+    /* Both strings are compared in upper case, through a table which
+       is set up for the current locale. */
+    for (i = 0; i < 256; i++)
+        fold[i] = toupper(i);
 
-    while (*p_pos)
-    {
-        if (toupper((unsigned char)*p_pos) == toupper((unsigned char)*psz_little))
-        {
-            char *cur1 = p_pos + 1;
-            char *cur2 = (char *)psz_little + 1;
-            while (*cur1 && *cur2 && toupper((unsigned char)*cur1) == toupper((unsigned char)*cur2))
-            {
-                cur1++;
-                cur2++;
-            }
-            if (!*cur2)
-                return p_pos;
-        }
-        p_pos++;
-    }
-    return NULL;
+    return __twoway_search((const unsigned char *)psz_big, (const unsigned char *)psz_big, 1,
+                           (const unsigned char *)psz_little, strlen(psz_little), fold);
 }
@@ -10,58 +10,30 @@
 #include "string_headers.h"
 #endif /* _STRING_HEADERS_H */
 
-extern char *__strchr440(const char *s, int c);
+#ifndef _STRING_SWAR_H
+#include "string_swar.h"
+#endif /* _STRING_SWAR_H */
+
+char *
+__strchr_generic(const char *s, int c)
+{
+	return __swar_strchr(s, c);
+}
 
 char *
 strchr(const char *s, int c)
 {
-	const unsigned char *us = (const unsigned char *)s;
 	char *result = NULL;
-	unsigned char us_c;
-	unsigned char find_this = (c & 0xff);
 
 	assert(s != NULL);
 
-	if (us == NULL)
+	if (s == NULL)
 	{
 		__set_errno(EFAULT);
 		goto out;
 	}
 
-    if  (__global_clib2->optimizedCPUFunctions) {
-        switch (__global_clib2->cpufamily) {
-            case CPUFAMILY_4XX:
-                result = __strchr440(s, c);
-                break;
-            default:
-                while (TRUE) {
-                    us_c = (*us);
-                    if (us_c == find_this) {
-                        result = (char *) us;
-                        break;
-                    }
-
-                    if (us_c == '\0')
-                        break;
-
-                    us++;
-                }
-        }
-    }
-    else {
-        while (TRUE) {
-            us_c = (*us);
-            if (us_c == find_this) {
-                result = (char *) us;
-                break;
-            }
-
-            if (us_c == '\0')
-                break;
-
-            us++;
-        }
-    }
+	result = __string_functions.sf_strchr(s, c);
 
 out:
 
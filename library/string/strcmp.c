@@ -10,33 +10,19 @@
 #include "string_headers.h"
 #endif /* _STRING_HEADERS_H */
 
-INLINE STATIC int
-__strcmp(const char *s1, const char *s2)
-{
-	int result = 0;
-
-	if (s1 != s2)
-	{
-		int c1, c2;
-
-		while ((*s1) == (*s2))
-		{
-			if ((*s1) == '\0')
-				break;
-
-			s1++;
-			s2++;
-		}
+#ifndef _STRING_SWAR_H
+#include "string_swar.h"
+#endif /* _STRING_SWAR_H */
 
-		/* The comparison must be performed as if the
-		   characters were unsigned characters. */
-		c1 = *(unsigned char *)s1;
-		c2 = *(unsigned char *)s2;
-
-		result = c1 - c2;
-	}
+int
+__strcmp_generic(const char *s1, const char *s2)
+{
+	if (s1 == s2)
+		return 0;
 
-	return result;
+	/* The comparison is performed as if the characters
+	   were unsigned characters. */
+	return __swar_strcmp(s1, s2);
 }
 
 int 
@@ -52,21 +38,7 @@ strcmp(const char *s1, const char *s2)
 		goto out;
 	}
 
-	/* Make sure __global_clib2 has been created */
-	if (__global_clib2 != NULL && __global_clib2->optimizedCPUFunctions) {
-		switch (__global_clib2->cpufamily) {
-			case CPUFAMILY_4XX:
-				result = __strcmp440(s1, s2);
-				break;
-			default:
-				result = __strcmp(s1, s2);
-		}
-	}
-	else {
-		/* Fallback to standard function */
-		result = __strcmp(s1, s2);
-	}
-
+	result = __string_functions.sf_strcmp(s1, s2);
 
 out:
 
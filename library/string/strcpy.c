@@ -10,6 +10,18 @@
 #include "string_headers.h"
 #endif /* _STRING_HEADERS_H */
 
+#ifndef _STRING_SWAR_H
+#include "string_swar.h"
+#endif /* _STRING_SWAR_H */
+
+char *
+__strcpy_generic(char *dest, const char *src)
+{
+	__swar_stpcpy(dest, src);
+
+	return (dest);
+}
+
 char *
 strcpy(char *dest, const char *src)
 {
@@ -24,34 +36,8 @@ strcpy(char *dest, const char *src)
 	}
 
 	if (dest != src)
-	{
-		/* Make sure __global_clib2 has been created */
-		if (__global_clib2 != NULL && __global_clib2->optimizedCPUFunctions)
-		{
-			switch (__global_clib2->cpufamily)
-			{
-				case CPUFAMILY_4XX:
-					result = __strcpy440(dest, src);
-					break;
-				default:
-				{
-                    if (__global_clib2->hasAltivec) {
-                        vec_strcpy(dest, src);
-                    }
-                    else {
-                        /* Fallback to standard function */
-                        while (((*dest++) = (*src++)) != '\0')
-                            DO_NOTHING;
-                    }
-				}
-			}
-		}
-		else {
-			/* Fallback to standard function */
-			while (((*dest++) = (*src++)) != '\0')
-				DO_NOTHING;
-		}
-	}
+		__string_functions.sf_strcpy(dest, src);
+
 out:
 
 	return (result);
@@ -8,6 +8,7 @@
 /****************************************************************************/
 
 #include <string.h>
+#include <wchar.h>
 #include <stdlib.h>
 #include <limits.h>
 #include <locale.h>
@@ -55,6 +56,7 @@ extern void   *__memchr440(const void *ptr, int val, size_t len);
 extern int     __memcmp440(const char *m1, const char *m2, size_t len);
 extern void   *__memcpy440(void *dst, const void *src, size_t len);
 extern void   *__memmove440(void *dest, const void *src, size_t len);
+extern char   *__strchr440(const char *s, int c);
 extern int     __strcmp440(const char *s1, const char *s2);
 extern char   *__strcpy440(char *dest, const char *src);
 extern size_t  __strlen440(const char *s);
@@ -69,5 +71,59 @@ extern void    vec_bcopy(const void *src, void *dest, size_t len);
 extern void   *_vec_memset(void *ptr, int val, size_t len);
 extern void    vec_bzero(void *m, size_t len);
 extern char   *vec_strcpy(char *dest, const char *src);
+extern size_t  vec_strlen(const char *s);
+extern char   *vec_strchr(const char *s, int c);
+extern char   *vec_strrchr(const char *s, int c);
+extern void   *vec_memchr(const void *ptr, int val, size_t len);
+extern void   *vec_memrchr(const void *ptr, int val, size_t len);
+extern int     vec_strcmp(const char *s1, const char *s2);
+extern int     vec_strncmp(const char *s1, const char *s2, size_t n);
+extern size_t  vec_wcslen(const wchar_t *s);
+extern wchar_t *vec_wmemchr(const wchar_t *ptr, wchar_t val, size_t len);
+extern wchar_t *vec_wmemset(wchar_t *ptr, wchar_t val, size_t len);
+
+/* Portable C versions, used when no better one is available */
+extern void   *__memchr_generic(const void *ptr, int val, size_t len);
+extern void   *__memrchr_generic(const void *ptr, int val, size_t len);
+extern int     __memcmp_generic(const char *m1, const char *m2, size_t len);
+extern void   *__memset_generic(void *ptr, int val, size_t len);
+extern void    __bzero_generic(void *m, size_t len);
+extern void    __bcopy_generic(const void *src, void *dest, size_t len);
+extern char   *__strchr_generic(const char *s, int c);
+extern int     __strcmp_generic(const char *s1, const char *s2);
+extern char   *__strcpy_generic(char *dest, const char *src);
+extern size_t  __strlen_generic(const char *s);
+extern int     __strncmp_generic(const char *s1, const char *s2, size_t n);
+extern char   *__strrchr_generic(const char *s, int c);
+extern size_t  __wcslen_generic(const wchar_t *s);
+extern wchar_t *__wmemchr_generic(const wchar_t *ptr, wchar_t val, size_t len);
+extern wchar_t *__wmemset_generic(wchar_t *ptr, wchar_t val, size_t len);
+
+/****************************************************************************/
+
+/* The implementation of every CPU specific function is chosen once, when the
+   library is initialized and whenever optimized functions or AltiVec support
+   are switched on or off. The string functions just call through this table. */
+struct StringFunctions {
+    void   *(*sf_memchr)(const void *ptr, int val, size_t len);
+    void   *(*sf_memrchr)(const void *ptr, int val, size_t len);
+    int     (*sf_memcmp)(const char *m1, const char *m2, size_t len);
+    void   *(*sf_memset)(void *ptr, int val, size_t len);
+    void    (*sf_bzero)(void *m, size_t len);
+    void    (*sf_bcopy)(const void *src, void *dest, size_t len);
+    char   *(*sf_strchr)(const char *s, int c);
+    int     (*sf_strcmp)(const char *s1, const char *s2);
+    char   *(*sf_strcpy)(char *dest, const char *src);
+    size_t  (*sf_strlen)(const char *s);
+    int     (*sf_strncmp)(const char *s1, const char *s2, size_t n);
+    char   *(*sf_strrchr)(const char *s, int c);
+    size_t  (*sf_wcslen)(const wchar_t *s);
+    wchar_t *(*sf_wmemchr)(const wchar_t *ptr, wchar_t val, size_t len);
+    wchar_t *(*sf_wmemset)(wchar_t *ptr, wchar_t val, size_t len);
+};
+
+extern struct StringFunctions __string_functions;
+
+extern void __select_string_functions(void);
 
 #endif /* _STRING_HEADERS_H */
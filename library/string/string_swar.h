@@ -0,0 +1,345 @@
+/*
+ * $Id: string_swar.h,v 1.0 2026-10-17 17:05:41 clib2devs Exp $
+*/
+
+#ifndef _STRING_SWAR_H
+#define _STRING_SWAR_H
+
+/****************************************************************************/
+
+/* Portable word-at-a-time string and memory kernels. These are used by the
+   string functions whenever no CPU specific version is available. They only
+   depend upon the compiler, so that they can also be built and checked on
+   an ordinary host (see test_programs/string/fuzz).
+
+   All kernels read whole, aligned machine words. An aligned word never
+   crosses a page boundary, which is why reading a few bytes beyond the
+   terminating NUL of a string is harmless. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/****************************************************************************/
+
+/* Words are read through a type which may alias any other type. */
+typedef unsigned long __attribute__((__may_alias__)) __swar_word;
+
+#define SWAR_SIZE          (sizeof(__swar_word))
+#define SWAR_ONES          ((__swar_word)-1 / 255)
+#define SWAR_HIGHS         (SWAR_ONES * 128)
+
+/* Non-zero if one of the bytes in the word is zero. */
+#define SWAR_HAS_ZERO(x)   (((x) - SWAR_ONES) & ~(x) & SWAR_HIGHS)
+
+/* A word which holds the byte 'c' in each of its bytes. */
+#define SWAR_REPEAT(c)     (SWAR_ONES * (unsigned char)(c))
+
+#define SWAR_ALIGNED(p)    ((((uintptr_t)(p)) & (SWAR_SIZE - 1)) == 0)
+#define SWAR_SAME_ALIGN(a, b) (((((uintptr_t)(a)) ^ ((uintptr_t)(b))) & (SWAR_SIZE - 1)) == 0)
+
+/****************************************************************************/
+
+static __inline__ size_t
+__swar_strlen(const char *str) {
+    const char *s = str;
+    const __swar_word *w;
+
+    for (; !SWAR_ALIGNED(s); s++) {
+        if ((*s) == '\0')
+            return s - str;
+    }
+
+    for (w = (const __swar_word *) s; !SWAR_HAS_ZERO(*w); w++)
+        ;
+
+    for (s = (const char *) w; (*s) != '\0'; s++)
+        ;
+
+    return s - str;
+}
+
+/****************************************************************************/
+
+static __inline__ void *
+__swar_memchr(const void *ptr, int val, size_t len) {
+    const unsigned char *m = ptr;
+    unsigned char c = val;
+
+    for (; len > 0 && !SWAR_ALIGNED(m); m++, len--) {
+        if ((*m) == c)
+            return (void *) m;
+    }
+
+    if (len >= SWAR_SIZE) {
+        const __swar_word *w = (const __swar_word *) m;
+        __swar_word k = SWAR_REPEAT(c);
+
+        /* XOR turns every matching byte into a zero byte. */
+        for (; len >= SWAR_SIZE && !SWAR_HAS_ZERO((*w) ^ k); w++, len -= SWAR_SIZE)
+            ;
+
+        m = (const unsigned char *) w;
+    }
+
+    for (; len > 0; m++, len--) {
+        if ((*m) == c)
+            return (void *) m;
+    }
+
+    return NULL;
+}
+
+/****************************************************************************/
+
+static __inline__ void *
+__swar_memrchr(const void *ptr, int val, size_t len) {
+    const unsigned char *m = (const unsigned char *) ptr + len;
+    unsigned char c = val;
+
+    for (; len > 0 && !SWAR_ALIGNED(m); len--) {
+        if ((*--m) == c)
+            return (void *) m;
+    }
+
+    if (len >= SWAR_SIZE) {
+        const __swar_word *w = (const __swar_word *) m;
+        __swar_word k = SWAR_REPEAT(c);
+
+        for (; len >= SWAR_SIZE && !SWAR_HAS_ZERO(w[-1] ^ k); w--, len -= SWAR_SIZE)
+            ;
+
+        m = (const unsigned char *) w;
+    }
+
+    for (; len > 0; len--) {
+        if ((*--m) == c)
+            return (void *) m;
+    }
+
+    return NULL;
+}
+
+/****************************************************************************/
+
+static __inline__ size_t
+__swar_strnlen(const char *s, size_t maxlen) {
+    const char *p = __swar_memchr(s, '\0', maxlen);
+
+    return p != NULL ? (size_t) (p - s) : maxlen;
+}
+
+/****************************************************************************/
+
+/* Returns a pointer to the first 'c' in the string, or to its terminating
+   NUL if there is no such character. */
+static __inline__ char *
+__swar_strchrnul(const char *s, int val) {
+    unsigned char c = val;
+
+    if (c == '\0')
+        return (char *) s + __swar_strlen(s);
+
+    for (; !SWAR_ALIGNED(s); s++) {
+        if ((*s) == '\0' || (*(const unsigned char *) s) == c)
+            return (char *) s;
+    }
+
+    {
+        const __swar_word *w = (const __swar_word *) s;
+        __swar_word k = SWAR_REPEAT(c);
+
+        for (; !SWAR_HAS_ZERO(*w) && !SWAR_HAS_ZERO((*w) ^ k); w++)
+            ;
+
+        s = (const char *) w;
+    }
+
+    for (; (*s) != '\0' && (*(const unsigned char *) s) != c; s++)
+        ;
+
+    return (char *) s;
+}
+
+static __inline__ char *
+__swar_strchr(const char *s, int val) {
+    char *r = __swar_strchrnul(s, val);
+
+    return (*(unsigned char *) r) == (unsigned char) val ? r : NULL;
+}
+
+/* The terminating NUL is part of the string, which is why it is searched
+   along with the other characters. */
+static __inline__ char *
+__swar_strrchr(const char *s, int val) {
+    return __swar_memrchr(s, val, __swar_strlen(s) + 1);
+}
+
+/****************************************************************************/
+
+static __inline__ int
+__swar_memcmp(const void *ptr1, const void *ptr2, size_t len) {
+    const unsigned char *m1 = ptr1;
+    const unsigned char *m2 = ptr2;
+
+    if (len >= SWAR_SIZE && SWAR_SAME_ALIGN(m1, m2)) {
+        const __swar_word *w1;
+        const __swar_word *w2;
+
+        for (; !SWAR_ALIGNED(m1); m1++, m2++, len--) {
+            if ((*m1) != (*m2))
+                return (*m1) - (*m2);
+        }
+
+        /* Stop at the first word which differs; the bytes below will
+           tell which of them made the difference. */
+        w1 = (const __swar_word *) m1;
+        w2 = (const __swar_word *) m2;
+
+        for (; len >= SWAR_SIZE && (*w1) == (*w2); w1++, w2++, len -= SWAR_SIZE)
+            ;
+
+        m1 = (const unsigned char *) w1;
+        m2 = (const unsigned char *) w2;
+    }
+
+    for (; len > 0; m1++, m2++, len--) {
+        if ((*m1) != (*m2))
+            return (*m1) - (*m2);
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
+static __inline__ int
+__swar_strcmp(const char *s1, const char *s2) {
+    const unsigned char *l = (const unsigned char *) s1;
+    const unsigned char *r = (const unsigned char *) s2;
+
+    if (SWAR_SAME_ALIGN(l, r)) {
+        const __swar_word *wl;
+        const __swar_word *wr;
+
+        for (; !SWAR_ALIGNED(l); l++, r++) {
+            if ((*l) != (*r) || (*l) == '\0')
+                return (*l) - (*r);
+        }
+
+        wl = (const __swar_word *) l;
+        wr = (const __swar_word *) r;
+
+        for (; (*wl) == (*wr) && !SWAR_HAS_ZERO(*wl); wl++, wr++)
+            ;
+
+        l = (const unsigned char *) wl;
+        r = (const unsigned char *) wr;
+    }
+
+    for (; (*l) == (*r) && (*l) != '\0'; l++, r++)
+        ;
+
+    return (*l) - (*r);
+}
+
+static __inline__ int
+__swar_strncmp(const char *s1, const char *s2, size_t n) {
+    const unsigned char *l = (const unsigned char *) s1;
+    const unsigned char *r = (const unsigned char *) s2;
+
+    if (n == 0)
+        return 0;
+
+    if (SWAR_SAME_ALIGN(l, r)) {
+        const __swar_word *wl;
+        const __swar_word *wr;
+
+        for (; n > 0 && !SWAR_ALIGNED(l); l++, r++, n--) {
+            if ((*l) != (*r) || (*l) == '\0')
+                return (*l) - (*r);
+        }
+
+        wl = (const __swar_word *) l;
+        wr = (const __swar_word *) r;
+
+        for (; n >= SWAR_SIZE && (*wl) == (*wr) && !SWAR_HAS_ZERO(*wl); wl++, wr++, n -= SWAR_SIZE)
+            ;
+
+        l = (const unsigned char *) wl;
+        r = (const unsigned char *) wr;
+    }
+
+    for (; n > 0; l++, r++, n--) {
+        if ((*l) != (*r) || (*l) == '\0')
+            return (*l) - (*r);
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
+/* Copies the string and returns a pointer to the terminating NUL of the
+   copy, just like stpcpy() does. Words are only copied if both addresses
+   can be aligned at the same time. */
+static __inline__ char *
+__swar_stpcpy(char *dest, const char *src) {
+    if (SWAR_SAME_ALIGN(dest, src)) {
+        __swar_word *wd;
+        const __swar_word *ws;
+
+        for (; !SWAR_ALIGNED(src); src++, dest++) {
+            if (((*dest) = (*src)) == '\0')
+                return dest;
+        }
+
+        wd = (__swar_word *) dest;
+        ws = (const __swar_word *) src;
+
+        for (; !SWAR_HAS_ZERO(*ws); wd++, ws++)
+            (*wd) = (*ws);
+
+        dest = (char *) wd;
+        src = (const char *) ws;
+    }
+
+    for (; ((*dest) = (*src)) != '\0'; src++, dest++)
+        ;
+
+    return dest;
+}
+
+/****************************************************************************/
+
+static __inline__ void *
+__swar_memset(void *ptr, int val, size_t len) {
+    unsigned char *m = ptr;
+    unsigned char c = val;
+
+    for (; len > 0 && !SWAR_ALIGNED(m); len--)
+        (*m++) = c;
+
+    if (len >= SWAR_SIZE) {
+        __swar_word *w = (__swar_word *) m;
+        __swar_word k = SWAR_REPEAT(c);
+
+        for (; len >= 4 * SWAR_SIZE; w += 4, len -= 4 * SWAR_SIZE) {
+            w[0] = k;
+            w[1] = k;
+            w[2] = k;
+            w[3] = k;
+        }
+
+        for (; len >= SWAR_SIZE; len -= SWAR_SIZE)
+            (*w++) = k;
+
+        m = (unsigned char *) w;
+    }
+
+    while (len-- > 0)
+        (*m++) = c;
+
+    return ptr;
+}
+
+#endif /* _STRING_SWAR_H */
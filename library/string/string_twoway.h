@@ -0,0 +1,311 @@
+/*
+ * $Id: string_twoway.h,v 1.0 2026-10-17 17:22:08 clib2devs Exp $
+*/
+
+#ifndef _STRING_TWOWAY_H
+#define _STRING_TWOWAY_H
+
+/****************************************************************************/
+
+/* Two-Way substring search (Crochemore & Perrin, 1991), shared by strstr(),
+   strcasestr(), strnstr(), memmem() and wcsstr(). It runs in linear time and
+   constant space, no matter how the needle and the haystack look like. The
+   byte version also skips ahead on characters which do not occur in the
+   needle at all.
+
+   Like string_swar.h this only depends upon the compiler so that it can be
+   checked on an ordinary host, too. */
+
+#include <stddef.h>
+#include <wchar.h>
+
+#ifndef _STRING_SWAR_H
+#include "string_swar.h"
+#endif /* _STRING_SWAR_H */
+
+/****************************************************************************/
+
+#define TW_BITOP(a, b, op) \
+    ((a)[(size_t)(b) / (8 * sizeof *(a))] op (size_t)1 << ((size_t)(b) % (8 * sizeof *(a))))
+
+#define TW_MAX(a, b) ((a) > (b) ? (a) : (b))
+
+/* Characters are compared through the optional case folding table. */
+#define TW_C(x) (fold != NULL ? fold[(x)] : (x))
+
+/****************************************************************************/
+
+/* Searches for the needle 'n' of length 'l' (at least 1) in the haystack
+   which starts at 'h'. The haystack is known to extend up to 'z'. If it is
+   NUL terminated, 'terminated' must be non-zero and the end of the haystack
+   beyond 'z' is only looked for as far as the search has to advance. If
+   'fold' is not NULL, all characters are mapped through that table before
+   they are compared. */
+static __inline__ char *
+__twoway_search(const unsigned char *h, const unsigned char *z, int terminated,
+                const unsigned char *n, size_t l, const unsigned char *fold) {
+    size_t i, ip, jp, k, p, ms, p0, mem, mem0;
+    size_t byteset[32 / sizeof(size_t)] = {0};
+    size_t shift[256];
+
+    /* Remember which characters occur in the needle, and where they
+       occur last. */
+    for (i = 0; i < l; i++) {
+        unsigned char c = TW_C(n[i]);
+
+        TW_BITOP(byteset, c, |=);
+        shift[c] = i + 1;
+    }
+
+    /* Compute the maximal suffix of the needle... */
+    ip = (size_t) -1;
+    jp = 0;
+    k = p = 1;
+
+    while (jp + k < l) {
+        if (TW_C(n[ip + k]) == TW_C(n[jp + k])) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else {
+                k++;
+            }
+        } else if (TW_C(n[ip + k]) > TW_C(n[jp + k])) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+
+    ms = ip;
+    p0 = p;
+
+    /* ...and again for the opposite order. The longer of the two suffixes
+       yields the critical factorization. */
+    ip = (size_t) -1;
+    jp = 0;
+    k = p = 1;
+
+    while (jp + k < l) {
+        if (TW_C(n[ip + k]) == TW_C(n[jp + k])) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else {
+                k++;
+            }
+        } else if (TW_C(n[ip + k]) < TW_C(n[jp + k])) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+
+    if (ip + 1 > ms + 1)
+        ms = ip;
+    else
+        p = p0;
+
+    /* Is the needle periodic? If not, the period is replaced by a safe
+       shift which is at least as large. */
+    for (i = 0; i < ms + 1 && TW_C(n[i]) == TW_C(n[i + p]); i++)
+        ;
+
+    if (i < ms + 1) {
+        mem0 = 0;
+        p = TW_MAX(ms, l - ms - 1) + 1;
+    } else {
+        mem0 = l - p;
+    }
+
+    mem = 0;
+
+    for (;;) {
+        /* Make sure that the haystack still holds enough characters. */
+        if ((size_t) (z - h) < l) {
+            const unsigned char *z2;
+            size_t grow;
+
+            if (!terminated)
+                return NULL;
+
+            grow = l | 63;
+
+            z2 = __swar_memchr(z, '\0', grow);
+            if (z2 != NULL) {
+                z = z2;
+                if ((size_t) (z - h) < l)
+                    return NULL;
+            } else {
+                z += grow;
+            }
+        }
+
+        /* Check the last character first and skip ahead if possible. */
+        if (TW_BITOP(byteset, TW_C(h[l - 1]), &)) {
+            k = l - shift[TW_C(h[l - 1])];
+            if (k != 0) {
+                if (k < mem)
+                    k = mem;
+
+                h += k;
+                mem = 0;
+                continue;
+            }
+        } else {
+            h += l;
+            mem = 0;
+            continue;
+        }
+
+        /* Compare the right half... */
+        for (k = TW_MAX(ms + 1, mem); k < l && TW_C(n[k]) == TW_C(h[k]); k++)
+            ;
+
+        if (k < l) {
+            h += k - ms;
+            mem = 0;
+            continue;
+        }
+
+        /* ...then the left half. */
+        for (k = ms + 1; k > mem && TW_C(n[k - 1]) == TW_C(h[k - 1]); k--)
+            ;
+
+        if (k <= mem)
+            return (char *) h;
+
+        h += p;
+        mem = mem0;
+    }
+}
+
+/****************************************************************************/
+
+/* The same for wide character strings, which are always NUL terminated. The
+   alphabet is too large for a shift table, which is why only the critical
+   factorization is used here. */
+static __inline__ wchar_t *
+__twoway_wcsstr(const wchar_t *h, const wchar_t *n) {
+    const wchar_t *z;
+    size_t i, ip, jp, k, p, ms, p0, mem, mem0, l;
+
+    /* Find the length of the needle, and make sure that the haystack is
+       at least as long. */
+    for (l = 0; n[l] != L'\0' && h[l] != L'\0'; l++)
+        ;
+
+    if (n[l] != L'\0')
+        return NULL;
+
+    z = h + l;
+
+    ip = (size_t) -1;
+    jp = 0;
+    k = p = 1;
+
+    while (jp + k < l) {
+        if (n[ip + k] == n[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else {
+                k++;
+            }
+        } else if (n[ip + k] > n[jp + k]) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+
+    ms = ip;
+    p0 = p;
+
+    ip = (size_t) -1;
+    jp = 0;
+    k = p = 1;
+
+    while (jp + k < l) {
+        if (n[ip + k] == n[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else {
+                k++;
+            }
+        } else if (n[ip + k] < n[jp + k]) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+
+    if (ip + 1 > ms + 1)
+        ms = ip;
+    else
+        p = p0;
+
+    for (i = 0; i < ms + 1 && n[i] == n[i + p]; i++)
+        ;
+
+    if (i < ms + 1) {
+        mem0 = 0;
+        p = TW_MAX(ms, l - ms - 1) + 1;
+    } else {
+        mem0 = l - p;
+    }
+
+    mem = 0;
+
+    for (;;) {
+        if ((size_t) (z - h) < l) {
+            size_t grow = l | 63;
+
+            for (i = 0; i < grow && z[i] != L'\0'; i++)
+                ;
+
+            z += i;
+            if (i < grow && (size_t) (z - h) < l)
+                return NULL;
+        }
+
+        for (k = TW_MAX(ms + 1, mem); k < l && n[k] == h[k]; k++)
+            ;
+
+        if (k < l) {
+            h += k - ms;
+            mem = 0;
+            continue;
+        }
+
+        for (k = ms + 1; k > mem && n[k - 1] == h[k - 1]; k--)
+            ;
+
+        if (k <= mem)
+            return (wchar_t *) h;
+
+        h += p;
+        mem = mem0;
+    }
+}
+
+/****************************************************************************/
+
+#undef TW_C
+#undef TW_MAX
+#undef TW_BITOP
+
+#endif /* _STRING_TWOWAY_H */
@@ -10,36 +10,13 @@
 #include "string_headers.h"
 #endif /* _STRING_HEADERS_H */
 
-inline static size_t
-__strlen(const char *str) {
-    uint32 *s32, x, magic1, magic2;
-    char *s = (char *) str;
+#ifndef _STRING_SWAR_H
+#include "string_swar.h"
+#endif /* _STRING_SWAR_H */
 
-    magic1 = 0xFEFEFEFF;
-    magic2 = 0x7F7F7F7F;
-
-    s32 = (uint32 * )((uint32) s & ~3);
-
-    x = (s32 == (uint32 *) s)
-        ? *s32
-        : *s32 | (0xFFFFFFFF << (3 - ((uint32) s & 3) + 1) * 8);
-
-    while (!((x + magic1) & ~(x | magic2))) {
-        x = *++s32;
-    }
-
-    s = (char *) s32;
-    if (x & 0xFF000000) {
-        s++;
-        if (x & 0x00FF0000) {
-            s++;
-            if (x & 0x0000FF00) {
-                s++;
-            }
-        }
-    }
-
-    return s - str;
+size_t
+__strlen_generic(const char *str) {
+    return __swar_strlen(str);
 }
 
 size_t
@@ -53,19 +30,8 @@ strlen(const char *s) {
         goto out;
     }
 
-    /* Make sure __global_clib2 has been created */
-    if (__global_clib2 != NULL && __global_clib2->optimizedCPUFunctions) {
-        switch (__global_clib2->cpufamily) {
-            case CPUFAMILY_4XX:
-                result = __strlen440(s);
-                break;
-            default:
-                result = __strlen(s);
-        }
-    } else {
-        /* Fallback to standard function */
-        result = __strlen(s);
-    }
+    result = __string_functions.sf_strlen(s);
+
 out:
 
     return (result);
@@ -10,36 +10,16 @@
 #include "string_headers.h"
 #endif /* _STRING_HEADERS_H */
 
-STATIC INLINE int
-__strncmp(const char *s1, const char *s2, size_t n)
-{
-	int result = 0;
-
-	while (n-- > 0)
-	{
-		if ((*s1) == (*s2))
-		{
-			if ((*s1) == '\0')
-				break;
-
-			s1++;
-			s2++;
-		}
-		else
-		{
-			int c1, c2;
-
-			/* The comparison must be performed as if the
-				characters were unsigned characters. */
-			c1 = *(unsigned char *)s1;
-			c2 = *(unsigned char *)s2;
+#ifndef _STRING_SWAR_H
+#include "string_swar.h"
+#endif /* _STRING_SWAR_H */
 
-			result = c1 - c2;
-			break;
-		}
-	}
-
-	return result;
+int
+__strncmp_generic(const char *s1, const char *s2, size_t n)
+{
+	/* The comparison is performed as if the characters
+	   were unsigned characters. */
+	return __swar_strncmp(s1, s2, n);
 }
 
 int 
@@ -60,24 +40,7 @@ strncmp(const char *s1, const char *s2, size_t n)
 	 * function is supposed to have no effect.
 	 */
 	if (s1 != s2 && (int)n > 0)
-	{
-		/* Make sure __global_clib2 has been created */
-		if (__global_clib2 != NULL && __global_clib2->optimizedCPUFunctions)
-		{
-			switch (__global_clib2->cpufamily)
-			{
-				case CPUFAMILY_4XX:
-					result = __strncmp440(s1, s2, n);
-					break;
-				default:
-					result = __strncmp(s1, s2, n);
-			}
-		}
-		else {
-			/* Fallback to standard function */
-			result = __strncmp(s1, s2, n);
-		}
-	}
+		result = __string_functions.sf_strncmp(s1, s2, n);
 
 out:
 
@@ -6,13 +6,16 @@
 #include "string_headers.h"
 #endif /* _STRING_HEADERS_H */
 
+#ifndef _STRING_SWAR_H
+#include "string_swar.h"
+#endif /* _STRING_SWAR_H */
+
 #ifndef _STDLIB_PROTOS_H
 #include "stdlib_protos.h"
 #endif /* _STDLIB_PROTOS_H */
 
 size_t
 strnlen(const char *s, size_t maxlen) {
-    const char *start = s;
     size_t result = 0;
 
     assert(s != NULL);
@@ -22,9 +25,7 @@ strnlen(const char *s, size_t maxlen) {
         goto out;
     }
 
-    const char *p = memchr(s, 0, maxlen);
-
-    result = p ? p-s : maxlen;
+    result = __swar_strnlen(s, maxlen);
 
 out:
 
@@ -6,26 +6,24 @@
 #include "string_headers.h"
 #endif /* _STRING_HEADERS_H */
 
+#ifndef _STRING_TWOWAY_H
+#include "string_twoway.h"
+#endif /* _STRING_TWOWAY_H */
+
 char *
 strnstr(const char *src, const char *sub, size_t len)
 {
-	const char *max = src + len;
+	size_t sub_len = strlen(sub);
+
+	if (sub_len == 0)
+		return (char *)src;
 
-	if (*src == '\0')
-		return *sub == '\0' ? (char *)src : (char *)NULL;
+	/* Characters which follow the terminating NUL of 'src' are
+	   not searched. */
+	len = __swar_strnlen(src, len);
+	if (len < sub_len)
+		return (char *)NULL;
 
-	while (src < max)
-	{
-		int i = 0;
-		while (1)
-		{
-			if (sub[i] == '\0')
-				return (char *)src;
-			if (sub[i] != src[i])
-				break;
-			i += 1;
-		}
-		src += 1;
-	}
-	return (char *)NULL;
+	return __twoway_search((const unsigned char *)src, (const unsigned char *)src + len, FALSE,
+	                       (const unsigned char *)sub, sub_len, NULL);
 }
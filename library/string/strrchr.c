@@ -10,35 +10,18 @@
 #include "string_headers.h"
 #endif /* _STRING_HEADERS_H */
 
-STATIC INLINE char *
-__strrchr(const char *s, int c) 
-{
-	const unsigned char *us = (const unsigned char *)s;
-	char *result = NULL;
-	unsigned char us_c;
-	unsigned char find_this = (c & 0xff);
+#ifndef _STRING_SWAR_H
+#include "string_swar.h"
+#endif /* _STRING_SWAR_H */
 
-	/* This is technically the opposite of strchr(), but the
-	 * implementation is very similar. However, instead of
-	 * stopping on the first location that holds the desired
-	 * value we just remember where we found it. When the
-	 * end of the string finally arrives we will thus be
-	 * able to return a pointer to the last occurence of
-	 * the character.
+char *
+__strrchr_generic(const char *s, int c)
+{
+	/* This is technically the opposite of strchr(), but instead of
+	 * remembering every match on the way we find the end of the
+	 * string first and then search backwards from there.
 	 */
-	while (TRUE)
-	{
-		us_c = (*us);
-		if (us_c == find_this)
-			result = (char *)us;
-
-		if (us_c == '\0')
-			break;
-
-		us++;
-	}
-	
-	return result;
+	return __swar_strrchr(s, c);
 }
 
 char *
@@ -55,23 +38,7 @@ strrchr(const char *s, int c)
 		goto out;
 	}
 
-	/* Make sure __global_clib2 has been created */
-	if (__global_clib2 != NULL && __global_clib2->optimizedCPUFunctions)
-	{
-		switch (__global_clib2->cpufamily)
-		{
-			case CPUFAMILY_4XX:
-				result = __strrchr440(s, c);
-				break;
-			default:
-				result = __strrchr(s, c);
-		}
-	}
-	else {
-		/* Fallback to standard function */
-		result = __strrchr(s, c);
-	}
-
+	result = __string_functions.sf_strrchr(s, c);
 
 out:
 
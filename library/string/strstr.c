@@ -6,6 +6,10 @@
 #include "string_headers.h"
 #endif /* _STRING_HEADERS_H */
 
+#ifndef _STRING_TWOWAY_H
+#include "string_twoway.h"
+#endif /* _STRING_TWOWAY_H */
+
 #ifndef _STDLIB_PROTOS_H
 #include "stdlib_protos.h"
 #endif /* _STDLIB_PROTOS_H */
@@ -27,28 +31,21 @@ strstr(const char *src, const char *sub) {
     if ((*sub) == '\0') {
         result = (char *) src;
     } else {
-        size_t i;
-        char c;
+        /* Skip straight to the first possible match. */
+        src = __string_functions.sf_strchr(src, (*sub));
+        if (src == NULL)
+            goto out;
+
+        if (sub[1] == '\0') {
+            result = (char *) src;
+            goto out;
+        }
 
-        /* Try to find 'sub' in 'src'. Watch how we avoid calling
-         * strlen() even once...
+        /* The length of 'src' is only looked at as far as the search
+         * has to advance.
          */
-        while ((*src) != '\0') {
-            for (i = 0;; i++) {
-                c = sub[i];
-
-                /* End of substring? We got a match... */
-                if (c == '\0') {
-                    result = (char *) src;
-                    goto out;
-                }
-
-                if (c != src[i])
-                    break;
-            }
-
-            src++;
-        }
+        result = __twoway_search((const unsigned char *) src, (const unsigned char *) src, TRUE,
+                                 (const unsigned char *) sub, __string_functions.sf_strlen(sub), NULL);
     }
 
 out:
@@ -1,5 +1,5 @@
 /*
- * $Id: termios_console_fdhookentry.c,v 1.7 2021-01-31 13:12:59 clib2devs Exp $
+ * $Id: termios_console_fdhookentry.c,v 1.8 2026-10-17 12:00:00 clib2devs Exp $
  *
  * Hook for termios emulation on a console. This can probably be cleaned up a bit
  * by removing things which will (should) never happen on a console.
@@ -407,6 +407,12 @@ __termios_console_hook(struct fd *fd, struct file_action_message *fam) {
 
             /* If this is an alias, just remove it. */
             is_aliased = __fd_is_aliased(fd);
+
+            /* Nobody can wait for input through this descriptor any more. Every
+               alias has a waiter of its own, so this goes for aliases, too. */
+            if (fd->fd_Waiter != NULL)
+                __delete_fd_waiter(fd);
+
             if (is_aliased) {
                 __remove_fd_alias(fd);
             } else if (FLAG_IS_CLEAR(fd->fd_Flags, FDF_STDIO)) {
@@ -452,6 +458,14 @@ __termios_console_hook(struct fd *fd, struct file_action_message *fam) {
             fam->fam_Error = EINVAL;
             goto out;
 
+        case file_action_pread:
+        case file_action_pwrite:
+
+            SHOWMSG("file_action_pread/file_action_pwrite");
+
+            fam->fam_Error = ESPIPE;
+            goto out;
+
         case file_action_set_blocking:
 
             SHOWMSG("file_action_set_blocking");
@@ -1,12 +1,10 @@
 /*
- * $Id: time_getres.c,v 1.0 2020-01-13 17:27:27 clib2devs Exp $
+ * $Id: time_getres.c,v 1.2 2026-10-17 12:00:00 clib2devs Exp $
 */
 
-#ifndef _STDIO_HEADERS_H
-#include "stdio_headers.h"
-#endif /* _STDIO_HEADERS_H */
-
-#include <time.h>
+#ifndef _TIME_HEADERS_H
+#include "time_headers.h"
+#endif /* _TIME_HEADERS_H */
 
 /* Get resolution of clock.  */
 int clock_getres(clockid_t clock_id, struct timespec *res) {
@@ -17,19 +15,32 @@ int clock_getres(clockid_t clock_id, struct timespec *res) {
     switch (clock_id) {
         case CLOCK_MONOTONIC:
         case CLOCK_REALTIME: {
-            /* This implementation assumes that the realtime clock has a
-                    resolution higher than 1 second.  This is the case for any
-                    reasonable implementation.  */
-            res->tv_sec = 0;
-            res->tv_nsec = 1000000000 / 1000;
+            /* Both are read from the time base. */
+            if (res != NULL) {
+                res->tv_sec = 0;
+                res->tv_nsec = __get_clock_resolution();
+            }
 
             result = 0;
         }
         break;
 
-        default:
-            __set_errno(EINVAL);
-            break;
+        default: {
+            struct timespec ts;
+
+            /* The CPU time clocks are read from the time base, too. */
+            if (__get_cpu_time(clock_id, &ts)) {
+                if (res != NULL) {
+                    res->tv_sec = 0;
+                    res->tv_nsec = __get_clock_resolution();
+                }
+
+                result = 0;
+            } else {
+                __set_errno(EINVAL);
+            }
+        }
+        break;
     }
 
     RETURN(result);
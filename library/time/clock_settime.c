@@ -1,5 +1,5 @@
 /*
- * $Id: time_settime.c,v 1.0 2020-01-13 17:20:12 clib2devs Exp $
+ * $Id: time_settime.c,v 1.1 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _TIME_HEADERS_H
@@ -57,6 +57,8 @@ clock_settime(clockid_t clk_id, const struct timespec *t) {
             DoIO((struct IORequest *) __timer_request);
             GetMsg(__timer_port);
 
+            __invalidate_clock();
+
             result = 0;
             __set_errno(0);
         }
@@ -0,0 +1,316 @@
+/*
+ * $Id: time_cpu_clock.c,v 1.0 2026-10-17 12:00:00 clib2devs Exp $
+*/
+
+#ifndef _TIME_HEADERS_H
+#include "time_headers.h"
+#endif /* _TIME_HEADERS_H */
+
+/* CPU time is measured when exec switches tasks. Every task whose time is
+ * counted (the main program and each pthread) has its tc_Launch and
+ * tc_Switch functions set up, which exec calls whenever the task gets and
+ * loses the CPU. They read the time base and add the time in between to the
+ * task's count, and to the count of the whole program.
+ *
+ * The counts are kept in an open addressed table keyed by the task pointer.
+ * Entries are only added and removed while task switching is disabled, so
+ * the switch functions always find a consistent table. Whoever reads a
+ * count while task switching goes on compares the number of task switches
+ * before and after, and tries again if there was one.
+ */
+
+#define CPU_CLOCK_MAX_TASKS 256
+#define CPU_CLOCK_TOMBSTONE ((struct Task *) ~0UL)
+
+/* Clock IDs for single threads are made up of CPU_CLOCK_ID_FLAG, the index
+   of the table entry and a serial number, so that the ID of a thread which
+   has exited does not refer to the next thread using the same entry. */
+#define CPU_CLOCK_ID(index, serial) (CPU_CLOCK_ID_FLAG | ((ULONG) (index) << 16) | (serial))
+#define CPU_CLOCK_ID_INDEX(id) (((id) >> 16) & 0x7FFF)
+#define CPU_CLOCK_ID_SERIAL(id) ((id) & 0xFFFF)
+
+struct cpu_clock {
+    struct Task *volatile cc_Task;
+    volatile uint64 cc_Ticks;       /* Time base ticks spent running */
+    UWORD cc_Serial;
+};
+
+static struct cpu_clock clocks[CPU_CLOCK_MAX_TASKS];
+static UWORD next_serial;
+
+/* The task whose time is counted and who has the CPU right now, if any,
+   and when it got the CPU. */
+static struct cpu_clock *volatile running;
+static volatile uint64 launch_ticks;
+
+static volatile uint64 process_ticks;
+static volatile ULONG switch_count;
+
+/* Only if the main program's time is counted can there be a total. */
+static struct Task *main_task;
+static BOOL started;
+
+/****************************************************************************/
+
+static inline ULONG
+cpu_clock_hash(struct Task *task) {
+    return (((ULONG) task) >> 4) % CPU_CLOCK_MAX_TASKS;
+}
+
+/****************************************************************************/
+
+static struct cpu_clock *
+find_clock(struct Task *task) {
+    ULONG index = cpu_clock_hash(task);
+    ULONG i;
+
+    for (i = 0; i < CPU_CLOCK_MAX_TASKS; i++) {
+        struct Task *owner = clocks[index].cc_Task;
+
+        if (owner == task)
+            return (&clocks[index]);
+
+        if (owner == NULL)
+            break;
+
+        index = (index + 1) % CPU_CLOCK_MAX_TASKS;
+    }
+
+    return (NULL);
+}
+
+/****************************************************************************/
+
+/* Called by exec when a task we keep count for gets the CPU. */
+static void
+launch_function(void) {
+    running = find_clock(SysBase->ThisTask);
+    launch_ticks = rdtsc();
+
+    switch_count++;
+}
+
+/****************************************************************************/
+
+/* Called by exec when a task we keep count for loses the CPU. */
+static void
+switch_function(void) {
+    struct cpu_clock *cc = running;
+
+    if (cc != NULL) {
+        uint64 ticks = rdtsc() - launch_ticks;
+
+        cc->cc_Ticks += ticks;
+        process_ticks += ticks;
+
+        running = NULL;
+    }
+
+    switch_count++;
+}
+
+/****************************************************************************/
+
+/* Start counting the CPU time of the calling task. The main program does
+   this first, when the time base clock has been set up; the threads follow
+   once they are running. */
+void
+__start_cpu_clock(void) {
+    struct Task *task = FindTask(NULL);
+    struct cpu_clock *cc = NULL;
+    ULONG index;
+    ULONG i;
+
+    ENTER();
+
+    if (__get_time_base_frequency() == 0) {
+        SHOWMSG("no time base to measure with");
+        goto out;
+    }
+
+    Forbid();
+
+    /* The threads only count if the main program does. */
+    if (started && main_task == NULL)
+        goto permit;
+
+    started = TRUE;
+
+    /* Somebody else may already be watching this task, a debugger perhaps. */
+    if (FLAG_IS_CLEAR(task->tc_Flags, TF_SWITCH | TF_LAUNCH) && task->tc_Switch == NULL && task->tc_Launch == NULL) {
+        index = cpu_clock_hash(task);
+
+        for (i = 0; i < CPU_CLOCK_MAX_TASKS; i++) {
+            if (clocks[index].cc_Task == NULL || clocks[index].cc_Task == CPU_CLOCK_TOMBSTONE) {
+                cc = &clocks[index];
+                break;
+            }
+
+            index = (index + 1) % CPU_CLOCK_MAX_TASKS;
+        }
+
+        if (cc != NULL) {
+            cc->cc_Ticks = 0;
+            cc->cc_Serial = ++next_serial;
+            cc->cc_Task = task;
+
+            task->tc_Switch = (APTR) switch_function;
+            task->tc_Launch = (APTR) launch_function;
+            SET_FLAG(task->tc_Flags, TF_SWITCH | TF_LAUNCH);
+
+            /* We are running now. */
+            running = cc;
+            launch_ticks = rdtsc();
+
+            switch_count++;
+
+            if (main_task == NULL)
+                main_task = task;
+        }
+    }
+
+ permit:
+
+    Permit();
+
+ out:
+
+    SHOWPOINTER(cc);
+    LEAVE();
+}
+
+/****************************************************************************/
+
+/* Stop counting the CPU time of the calling task, which is about to exit.
+   The time it used stays part of the total. */
+void
+__stop_cpu_clock(void) {
+    struct Task *task = FindTask(NULL);
+    struct cpu_clock *cc;
+
+    ENTER();
+
+    Forbid();
+
+    cc = find_clock(task);
+    if (cc != NULL) {
+        CLEAR_FLAG(task->tc_Flags, TF_SWITCH | TF_LAUNCH);
+        task->tc_Switch = NULL;
+        task->tc_Launch = NULL;
+
+        if (running == cc) {
+            uint64 ticks = rdtsc() - launch_ticks;
+
+            cc->cc_Ticks += ticks;
+            process_ticks += ticks;
+
+            running = NULL;
+        }
+
+        cc->cc_Task = CPU_CLOCK_TOMBSTONE;
+
+        switch_count++;
+
+        if (task == main_task)
+            main_task = NULL;
+    }
+
+    Permit();
+
+    LEAVE();
+}
+
+/****************************************************************************/
+
+/* Find the clock ID for the CPU time of the given task, provided it is
+   being counted. */
+BOOL
+__get_cpu_clock_id(struct Task *task, clockid_t *clock_id_ptr) {
+    struct cpu_clock *cc;
+    BOOL result = FALSE;
+
+    Forbid();
+
+    cc = find_clock(task);
+    if (cc != NULL) {
+        (*clock_id_ptr) = CPU_CLOCK_ID(cc - clocks, cc->cc_Serial);
+        result = TRUE;
+    }
+
+    Permit();
+
+    return (result);
+}
+
+/****************************************************************************/
+
+/* Read CLOCK_PROCESS_CPUTIME_ID, CLOCK_THREAD_CPUTIME_ID or the clock of a
+   particular thread. Returns FALSE if there is no such clock. */
+BOOL
+__get_cpu_time(clockid_t clock_id, struct timespec *ts) {
+    struct cpu_clock *cc;
+    uint64 ticks, now, launch;
+    ULONG count;
+    BOOL result = FALSE;
+
+    if (clock_id == CLOCK_PROCESS_CPUTIME_ID) {
+        /* Without the numbers, the time the program has been running for
+           will have to do. */
+        if (main_task == NULL) {
+            __get_elapsed_time(ts);
+            return (TRUE);
+        }
+
+        /* If the calling task is one of those we count for, it is the
+           one running right now. */
+        do {
+            count = switch_count;
+
+            ticks = process_ticks;
+            cc = running;
+            launch = launch_ticks;
+            now = rdtsc();
+        } while (count != switch_count);
+
+        if (cc != NULL)
+            ticks += now - launch;
+
+        result = TRUE;
+    } else if (clock_id == CLOCK_THREAD_CPUTIME_ID) {
+        /* Only the calling task can add or remove its own entry. */
+        cc = find_clock(FindTask(NULL));
+        if (cc != NULL) {
+            do {
+                count = switch_count;
+
+                ticks = cc->cc_Ticks;
+                launch = launch_ticks;
+                now = rdtsc();
+            } while (count != switch_count);
+
+            ticks += now - launch;
+
+            result = TRUE;
+        }
+    } else if ((clock_id & CPU_CLOCK_ID_FLAG) != 0 && CPU_CLOCK_ID_INDEX(clock_id) < CPU_CLOCK_MAX_TASKS) {
+        cc = &clocks[CPU_CLOCK_ID_INDEX(clock_id)];
+
+        Forbid();
+
+        if (cc->cc_Task != NULL && cc->cc_Task != CPU_CLOCK_TOMBSTONE && cc->cc_Serial == CPU_CLOCK_ID_SERIAL(clock_id)) {
+            ticks = cc->cc_Ticks;
+
+            if (running == cc)
+                ticks += rdtsc() - launch_ticks;
+
+            result = TRUE;
+        }
+
+        Permit();
+    }
+
+    if (result)
+        __convert_time_base(ticks, ts);
+
+    return (result);
+}
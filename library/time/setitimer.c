@@ -48,6 +48,9 @@ setitimer(int which, const struct itimerval *new_value, struct itimerval *old_va
             else if (__global_clib2->tmr_real_task == NULL) {
                 /* Create timer tasks */
                 if ((new_value->it_value.tv_sec != 0 || new_value->it_value.tv_usec != 0)) {
+                    /* SIGALRM handlers will run on the timer process. */
+                    __enable_locking();
+
                     __global_clib2->tmr_real_task = CreateNewProcTags(
                             NP_Name, "CLIB2_ITIMER_REAL_TASK",
                             NP_Entry, itimer_real_task,
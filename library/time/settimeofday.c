@@ -1,5 +1,5 @@
 /*
- * $Id: time_settimeofday.c,v 1.0 2022-02-24 18:31:57 clib2devs Exp $
+ * $Id: time_settimeofday.c,v 1.1 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _TIME_HEADERS_H
@@ -46,6 +46,8 @@ settimeofday(const struct timeval *t, const struct timezone *tz) {
     DoIO((struct IORequest *) __timer_request);
     GetMsg(__timer_port);
 
+    __invalidate_clock();
+
     result = 0;
     __set_errno(0);
 
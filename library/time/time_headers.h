@@ -1,5 +1,5 @@
 /*
- * $Id: time_headers.h,v 1.12 2006-01-08 12:04:27 clib2devs Exp $
+ * $Id: time_headers.h,v 1.14 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _TIME_HEADERS_H
@@ -117,4 +117,27 @@ extern int __calculate_days_per_date(int year,int month,int day);
 
 /****************************************************************************/
 
+/* The clocks read from the time base, in timebase_clock.c */
+extern void __init_clock(void);
+extern void __invalidate_clock(void);
+extern void __get_monotonic_time(struct timespec * ts);
+extern void __get_real_time(struct timespec * ts,LONG * minutes_west_ptr);
+extern void __get_elapsed_time(struct timespec * ts);
+extern ULONG __get_clock_resolution(void);
+extern uint64 __get_time_base_frequency(void);
+extern void __convert_time_base(uint64 ticks,struct timespec * ts);
+
+/****************************************************************************/
+
+/* CPU time used by the tasks of this program, in cpu_clock.c. Clock IDs
+   with this bit set stand for one particular thread. */
+#define CPU_CLOCK_ID_FLAG 0x80000000UL
+
+extern void __start_cpu_clock(void);
+extern void __stop_cpu_clock(void);
+extern BOOL __get_cpu_clock_id(struct Task * task,clockid_t * clock_id_ptr);
+extern BOOL __get_cpu_time(clockid_t clock_id,struct timespec * ts);
+
+/****************************************************************************/
+
 #endif /* _TIME_HEADERS_H */
@@ -0,0 +1,415 @@
+/*
+ * $Id: time_timebase_clock.c,v 1.1 2026-10-17 12:00:00 clib2devs Exp $
+*/
+
+#ifndef _TIME_HEADERS_H
+#include "time_headers.h"
+#endif /* _TIME_HEADERS_H */
+
+#ifndef _LOCALE_HEADERS_H
+#include "locale_headers.h"
+#endif /* _LOCALE_HEADERS_H */
+
+#ifndef _UNISTD_HEADERS_H
+#include "unistd_headers.h"
+#endif /* _UNISTD_HEADERS_H */
+
+/* clock_gettime(), gettimeofday(), time() and clock() read the PowerPC time
+ * base and turn the count into nanoseconds, without calling timer.device or
+ * taking a lock. What the conversion needs is kept in one of two slots: the
+ * count at which the slot starts, the monotonic and the real time at that
+ * point, and the time zone offset. About once a second, or when the system
+ * time or the locale was changed, whoever reads the clock next compares it
+ * with the system time, fills in the other slot and switches over to it.
+ * Readers never wait: should the slot they are copying change under them,
+ * they start over with the one in use now, which nobody writes to.
+ *
+ * Without a time base frequency to go by, GetUpTime() stands in for the
+ * time base, counting microseconds.
+ */
+
+/* How often the real time is compared with the system time. */
+#define RESYNC_INTERVAL 1
+
+/* GetSysTime() only counts microseconds, and the time it takes to call it
+   varies. Smaller differences are not corrected, so that the real time
+   does not jitter back and forth. */
+#define RESYNC_THRESHOLD 50000
+
+#define MEMORY_BARRIER() __asm__ __volatile__ ("lwsync" : : : "memory")
+
+struct clock_slot {
+    volatile ULONG cs_Sequence;     /* Odd while the slot is being filled in */
+    uint64 cs_Ticks;                /* Time base count the slot starts at */
+    ULONG cs_Fraction;              /* Monotonic time below a nanosecond, in 1/2^32 */
+    time_t cs_MonotonicSeconds;     /* Monotonic time at cs_Ticks */
+    ULONG cs_MonotonicNanos;
+    time_t cs_RealSeconds;          /* Real time (UTC) at cs_Ticks */
+    ULONG cs_RealNanos;
+    int64 cs_RealOffset;            /* Real time minus monotonic time, in nanoseconds */
+    LONG cs_MinutesWest;            /* Time zone offset from the locale */
+    uint64 cs_ResyncTicks;          /* When to compare with the system time again */
+    ULONG cs_Generation;            /* Value of clock_generation the slot was set up for */
+};
+
+static struct clock_slot slots[2];
+static volatile LONG current_slot = -1;
+static volatile ULONG clock_generation;
+static volatile int resync_busy;
+
+static BOOL use_time_base;
+static uint64 frequency;
+static uint64 multiplier;           /* Nanoseconds per tick, in 1/2^32 */
+static uint64 start_ticks;          /* When the clock was set up */
+static uint64 start_nanos;
+static ULONG resolution;
+
+/****************************************************************************/
+
+static uint64
+read_ticks(void) {
+    struct TimerIFace *ITimer = __ITimer;
+    struct TimeVal tv;
+
+    if (use_time_base)
+        return rdtsc();
+
+    GetUpTime(&tv);
+
+    return (uint64) tv.Seconds * 1000000 + tv.Microseconds;
+}
+
+/****************************************************************************/
+
+/* Convert time base ticks to nanoseconds, plus a fraction of a nanosecond
+   carried over. This is a 64 by 64 bit multiplication which keeps the
+   middle 64 bits of the result, made of 32 bit multiplications. */
+static uint64
+scale_ticks(uint64 ticks, ULONG fraction, ULONG *fraction_ptr) {
+    ULONG ticks_high = (ULONG) (ticks >> 32), ticks_low = (ULONG) ticks;
+    ULONG multiplier_high = (ULONG) (multiplier >> 32), multiplier_low = (ULONG) multiplier;
+    uint64 low;
+    uint64 result;
+
+    /* This cannot overflow: (2^32-1)^2 + 2^32-1 < 2^64 */
+    low = (uint64) ticks_low * multiplier_low + fraction;
+
+    result = (low >> 32) +
+             (uint64) ticks_low * multiplier_high +
+             (uint64) ticks_high * multiplier_low +
+             (((uint64) ticks_high * multiplier_high) << 32);
+
+    if (fraction_ptr != NULL)
+        (*fraction_ptr) = (ULONG) low;
+
+    return (result);
+}
+
+/****************************************************************************/
+
+static void
+split_nanos(int64 nanos, time_t *seconds_ptr, ULONG *nanos_ptr) {
+    time_t seconds;
+
+    seconds = nanos / (int64) NSEC_PER_SEC;
+    nanos -= seconds * (int64) NSEC_PER_SEC;
+
+    if (nanos < 0) {
+        nanos += NSEC_PER_SEC;
+        seconds--;
+    }
+
+    (*seconds_ptr) = seconds;
+    (*nanos_ptr) = (ULONG) nanos;
+}
+
+/****************************************************************************/
+
+/* Nanoseconds since a slot started are usually less than 2^32, which saves
+   a 64 bit division. */
+static void
+add_nanos(struct timespec *ts, time_t seconds, ULONG nanos, uint64 delta) {
+    if (delta < 0x100000000ULL) {
+        ULONG n = (ULONG) delta;
+
+        seconds += n / 1000000000UL;
+        nanos += n % 1000000000UL;
+    } else {
+        seconds += (time_t) (delta / NSEC_PER_SEC);
+        nanos += (ULONG) (delta % NSEC_PER_SEC);
+    }
+
+    if (nanos >= 1000000000UL) {
+        nanos -= 1000000000UL;
+        seconds++;
+    }
+
+    ts->tv_sec = seconds;
+    ts->tv_nsec = (long) nanos;
+}
+
+/****************************************************************************/
+
+/* Compare with the system time and switch over to a new slot. Only one
+   caller gets to do this at a time; the others carry on with the slot in
+   use. */
+static void
+resync(void) {
+    struct TimerIFace *ITimer = __ITimer;
+    struct clock_slot *cs;
+    struct TimeVal tv;
+    ULONG generation;
+    LONG minutes_west;
+    uint64 ticks;
+    int64 mono_nanos;
+    int64 real_offset;
+    ULONG fraction;
+    LONG index;
+
+    if (ITimer == NULL)
+        return;
+
+    if (NOT __sync_bool_compare_and_swap(&resync_busy, 0, 1))
+        return;
+
+    /* A change made while this is in progress makes for another round. */
+    generation = clock_generation;
+
+    __locale_lock();
+
+    minutes_west = (__default_locale != NULL) ? __default_locale->loc_GMTOffset : 0;
+
+    __locale_unlock();
+
+    GetSysTime(&tv);
+    ticks = read_ticks();
+
+    mono_nanos = (int64) (start_nanos + scale_ticks(ticks - start_ticks, 0, &fraction));
+
+    /* The system time is local time, counted from 1978. */
+    real_offset = ((int64) tv.Seconds + UNIX_TIME_OFFSET + 60 * minutes_west) * (int64) NSEC_PER_SEC +
+                  (int64) tv.Microseconds * 1000 - mono_nanos;
+
+    index = current_slot;
+    if (index >= 0) {
+        int64 difference = real_offset - slots[index].cs_RealOffset;
+
+        if (minutes_west == slots[index].cs_MinutesWest && difference > -RESYNC_THRESHOLD && difference < RESYNC_THRESHOLD)
+            real_offset = slots[index].cs_RealOffset;
+
+        index = 1 - index;
+    } else {
+        index = 0;
+    }
+
+    cs = &slots[index];
+
+    cs->cs_Sequence++;
+
+    MEMORY_BARRIER();
+
+    cs->cs_Ticks = ticks;
+    cs->cs_Fraction = fraction;
+    split_nanos(mono_nanos, &cs->cs_MonotonicSeconds, &cs->cs_MonotonicNanos);
+    split_nanos(mono_nanos + real_offset, &cs->cs_RealSeconds, &cs->cs_RealNanos);
+    cs->cs_RealOffset = real_offset;
+    cs->cs_MinutesWest = minutes_west;
+    cs->cs_ResyncTicks = ticks + RESYNC_INTERVAL * frequency;
+    cs->cs_Generation = generation;
+
+    MEMORY_BARRIER();
+
+    cs->cs_Sequence++;
+
+    MEMORY_BARRIER();
+
+    current_slot = index;
+
+    __sync_lock_release(&resync_busy);
+}
+
+/****************************************************************************/
+
+/* Copy the slot in use and find out how many nanoseconds have passed since
+   it started. Returns FALSE if the clock cannot be read yet, or any more. */
+static BOOL
+read_clock(struct clock_slot *cs, uint64 *nanos_ptr) {
+    BOOL resynced = FALSE;
+    ULONG sequence;
+    uint64 ticks;
+    LONG index;
+
+    while (TRUE) {
+        index = current_slot;
+        if (index < 0 || (NOT use_time_base && __ITimer == NULL))
+            return (FALSE);
+
+        MEMORY_BARRIER();
+
+        sequence = slots[index].cs_Sequence;
+
+        MEMORY_BARRIER();
+
+        (*cs) = slots[index];
+
+        MEMORY_BARRIER();
+
+        /* The slot was reused while we were copying it. */
+        if ((sequence & 1) != 0 || slots[index].cs_Sequence != sequence)
+            continue;
+
+        ticks = read_ticks();
+
+        if (NOT resynced && (ticks >= cs->cs_ResyncTicks || cs->cs_Generation != clock_generation)) {
+            resync();
+
+            resynced = TRUE;
+            continue;
+        }
+
+        break;
+    }
+
+    (*nanos_ptr) = scale_ticks(ticks - cs->cs_Ticks, cs->cs_Fraction, NULL);
+
+    return (TRUE);
+}
+
+/****************************************************************************/
+
+/* Before the timer is set up, or after it was shut down, there is only
+   the DOS clock. */
+static void
+read_date_stamp(struct timespec *ts) {
+    struct DateStamp ds;
+
+    DateStamp(&ds);
+
+    ts->tv_sec = __convert_datestamp_to_time(&ds);
+    ts->tv_nsec = (ds.ds_Tick % TICKS_PER_SECOND) * (1000000000 / TICKS_PER_SECOND);
+}
+
+/****************************************************************************/
+
+void
+__get_monotonic_time(struct timespec *ts) {
+    struct clock_slot cs;
+    uint64 nanos;
+
+    if (read_clock(&cs, &nanos))
+        add_nanos(ts, cs.cs_MonotonicSeconds, cs.cs_MonotonicNanos, nanos);
+    else
+        read_date_stamp(ts);
+}
+
+/****************************************************************************/
+
+void
+__get_real_time(struct timespec *ts, LONG *minutes_west_ptr) {
+    struct clock_slot cs;
+    uint64 nanos;
+
+    if (read_clock(&cs, &nanos)) {
+        add_nanos(ts, cs.cs_RealSeconds, cs.cs_RealNanos, nanos);
+
+        if (minutes_west_ptr != NULL)
+            (*minutes_west_ptr) = cs.cs_MinutesWest;
+    } else {
+        read_date_stamp(ts);
+
+        if (minutes_west_ptr != NULL) {
+            __locale_lock();
+
+            (*minutes_west_ptr) = (__default_locale != NULL) ? __default_locale->loc_GMTOffset : 0;
+
+            __locale_unlock();
+        }
+    }
+}
+
+/****************************************************************************/
+
+/* How long ago the clock was set up, which is shortly after the program
+   was started. */
+void
+__get_elapsed_time(struct timespec *ts) {
+    struct clock_slot cs;
+    uint64 nanos;
+
+    if (read_clock(&cs, &nanos)) {
+        nanos += (uint64) cs.cs_MonotonicSeconds * NSEC_PER_SEC + cs.cs_MonotonicNanos - start_nanos;
+
+        add_nanos(ts, 0, 0, nanos);
+    } else {
+        ts->tv_sec = 0;
+        ts->tv_nsec = 0;
+    }
+}
+
+/****************************************************************************/
+
+/* In nanoseconds. */
+ULONG
+__get_clock_resolution(void) {
+    if (current_slot < 0)
+        return (1000000000UL / TICKS_PER_SECOND);
+
+    return (resolution);
+}
+
+/****************************************************************************/
+
+/* Zero if there is no time base to go by. */
+uint64
+__get_time_base_frequency(void) {
+    return (use_time_base ? frequency : 0);
+}
+
+/****************************************************************************/
+
+/* Turn a number of time base ticks into seconds and nanoseconds. */
+void
+__convert_time_base(uint64 ticks, struct timespec *ts) {
+    add_nanos(ts, 0, 0, scale_ticks(ticks, 0, NULL));
+}
+
+/****************************************************************************/
+
+/* The system time or the time zone changed; compare again before the clock
+   is read next. */
+void
+__invalidate_clock(void) {
+    __sync_fetch_and_add(&clock_generation, 1);
+}
+
+/****************************************************************************/
+
+/* Called once timer.device is open, before any threads are started. */
+void
+__init_clock(void) {
+    struct TimerIFace *ITimer = __ITimer;
+    struct TimeVal tv;
+
+    ENTER();
+
+    frequency = 0;
+    GetCPUInfoTags(GCIT_TimeBaseSpeed, &frequency, TAG_DONE);
+
+    SHOWVALUE(frequency);
+
+    use_time_base = (BOOL) (frequency > 0);
+    if (NOT use_time_base)
+        frequency = 1000000;
+
+    multiplier = (NSEC_PER_SEC << 32) / frequency;
+    resolution = (ULONG) ((NSEC_PER_SEC + frequency - 1) / frequency);
+
+    /* The monotonic clock counts from when the system was started. */
+    GetUpTime(&tv);
+    start_ticks = read_ticks();
+    start_nanos = (uint64) tv.Seconds * NSEC_PER_SEC + (uint64) tv.Microseconds * 1000;
+
+    resync();
+
+    LEAVE();
+}
@@ -1,5 +1,5 @@
 /*
- * $Id: fcntl_lock.c,v 1.4 2006-01-08 12:04:22 clib2devs Exp $
+ * $Id: fcntl_lock.c,v 1.6 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _STDIO_HEADERS_H
@@ -10,12 +10,41 @@ void
 __fd_lock(struct fd *fd)
 {
 	if (NULL != fd && NULL != fd->fd_Lock)
-		ObtainSemaphore(fd->fd_Lock);
+		__OBTAIN_SEMAPHORE_AT(fd->fd_Lock, __CLIB2_LOCK_FD);
 }
 
 void 
 __fd_unlock(struct fd *fd)
 {
     if (NULL != fd && NULL != fd->fd_Lock)
-		ReleaseSemaphore(fd->fd_Lock);
+		__release_semaphore(fd->fd_Lock);
+}
+
+/* Let go of the descriptor as often as the calling task holds it, so that
+   it can go to sleep without keeping others from the descriptor. Returns
+   how often it was held, to be handed to __fd_relock(). */
+LONG
+__fd_unlock_all(struct fd *fd)
+{
+	LONG count = 0;
+	LONG i;
+
+	if (NULL != fd && NULL != fd->fd_Lock && fd->fd_Lock->ss_Owner == FindTask(NULL))
+	{
+		count = fd->fd_Lock->ss_NestCount;
+
+		for (i = 0; i < count; i++)
+			__release_semaphore(fd->fd_Lock);
+	}
+
+	return (count);
+}
+
+/* The descriptor may have been closed in the meantime, in which case there
+   is no lock left to obtain. */
+void
+__fd_relock(struct fd *fd, LONG count)
+{
+	while (count-- > 0)
+		__fd_lock(fd);
 }
@@ -1,22 +1,33 @@
 /*
- * $Id: unistd_pipe.c,v 1.0 2020-01-14 12:35:27 clib2devs Exp $
+ * $Id: unistd_pipe.c,v 1.1 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _UNISTD_HEADERS_H
 #include "unistd_headers.h"
 #endif /* _UNISTD_HEADERS_H */
 
+/* Set this to TRUE to have pipe() and pipe2() open PIPE: files instead,
+   whose file handles can be handed to other programs. */
+BOOL NOCOMMON __use_dos_pipes;
+
 static int pipenum = 0;
 
-int pipe(int fd[2]) {
-    ENTER();
-    DECLARE_UTILITYBASE();
+/* A pipe through the PIPE: handler, or a temporary file. */
+int
+__open_dos_pipe(int fd[2], int flags) {
     char pipe_name[1024] = {0};
 
+    ENTER();
+
 #ifdef USE_TEMPFILES
     snprintf(pipe_name, sizeof(pipe_name), "T:%x.%08x", pipenum++, ((struct Process *)FindTask(NULL))->pr_ProcessID);
 #else
-    snprintf(pipe_name, sizeof(pipe_name), "PIPE:%x%lu/32768/0", pipenum++, ((struct Process *) FindTask(NULL))->pr_ProcessID);
+    if (flags & O_NONBLOCK)
+        snprintf(pipe_name, sizeof(pipe_name), "PIPE:%x%lu/32768/0/NOBLOCK", pipenum++,
+                 ((struct Process *) FindTask(NULL))->pr_ProcessID);
+    else
+        snprintf(pipe_name, sizeof(pipe_name), "PIPE:%x%lu/32768/0", pipenum++,
+                 ((struct Process *) FindTask(NULL))->pr_ProcessID);
 #endif // USE_TEMPFILES
 
     fd[1] = open(pipe_name, O_WRONLY | O_CREAT);
@@ -36,3 +47,17 @@ int pipe(int fd[2]) {
     RETURN(0);
     return 0;
 }
+
+int pipe(int fd[2]) {
+    int result;
+
+    ENTER();
+
+    if (__use_dos_pipes)
+        result = __open_dos_pipe(fd, 0);
+    else
+        result = __create_ring_pipe(fd, FALSE, FALSE);
+
+    RETURN(result);
+    return result;
+}
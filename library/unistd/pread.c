@@ -1,5 +1,5 @@
 /*
- * $Id: unistd_pread.c,v 1.0 2021-02-21 23:05:27 clib2devs Exp $
+ * $Id: unistd_pread.c,v 1.1 2026-10-17 20:14:07 clib2devs Exp $
 */
 
 /****************************************************************************/
@@ -9,21 +9,86 @@
 #endif /* _UNISTD_HEADERS_H */
 
 ssize_t
-pread(int fd, void *buf, size_t n, off_t off)
-{
-    off_t cur_pos;
-    ssize_t num_read;
+pread(int file_descriptor, void *buffer, size_t num_bytes, off_t offset) {
+    ssize_t num_bytes_read;
+    struct fd *fd = NULL;
+    ssize_t result = EOF;
 
-    if ((cur_pos = lseek(fd, 0, SEEK_CUR)) == (off_t)-1)
-        return -1;
+    ENTER();
 
-    if (lseek(fd, off, SEEK_SET) == (off_t)-1)
-        return -1;
+    SHOWVALUE(file_descriptor);
+    SHOWPOINTER(buffer);
+    SHOWVALUE(num_bytes);
+    SHOWVALUE(offset);
 
-    num_read = read(fd, buf, n);
+    assert(buffer != NULL);
+    assert((int) num_bytes >= 0);
 
-    if (lseek(fd, cur_pos, SEEK_SET) == (off_t)-1)
-        return -1;
+    __check_abort();
 
-    return (ssize_t)num_read;
+    if (buffer == NULL) {
+        SHOWMSG("invalid buffer");
+
+        __set_errno(EFAULT);
+        goto out;
+    }
+
+    if (offset < 0) {
+        SHOWMSG("invalid offset");
+
+        __set_errno(EINVAL);
+        goto out;
+    }
+
+    /* The descriptor lock is all it takes; the file position is moved
+       and restored by the hook while it holds on to it. */
+    __stdio_lock();
+
+    fd = __get_file_descriptor(file_descriptor);
+    if (fd != NULL)
+        __fd_lock(fd);
+
+    __stdio_unlock();
+
+    if (fd == NULL) {
+        __set_errno(EBADF);
+        goto out;
+    }
+
+    if (FLAG_IS_CLEAR(fd->fd_Flags, FDF_READ)) {
+        SHOWMSG("this descriptor is not read-enabled");
+
+        __set_errno(EBADF);
+        goto out;
+    }
+
+    if (num_bytes > 0) {
+        struct file_action_message fam;
+
+        SHOWMSG("calling the hook");
+
+        fam.fam_Action = file_action_pread;
+        fam.fam_Data = buffer;
+        fam.fam_Size = num_bytes;
+        fam.fam_Offset = offset;
+
+        assert(fd->fd_Action != NULL);
+
+        num_bytes_read = (*fd->fd_Action)(fd, &fam);
+        if (num_bytes_read == EOF) {
+            __set_errno(fam.fam_Error);
+            goto out;
+        }
+    } else {
+        num_bytes_read = 0;
+    }
+
+    result = num_bytes_read;
+
+out:
+
+    __fd_unlock(fd);
+
+    RETURN(result);
+    return (result);
 }
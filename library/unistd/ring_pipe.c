@@ -0,0 +1,1014 @@
+/*
+ * $Id: unistd_ring_pipe.c,v 1.3 2026-10-17 12:00:00 clib2devs Exp $
+*/
+
+#ifndef _UNISTD_HEADERS_H
+#include "unistd_headers.h"
+#endif /* _UNISTD_HEADERS_H */
+
+#include <sys/socket.h>
+#include <sys/filio.h>
+#include <stddef.h>
+#include <poll.h>
+
+/* Pipes and socket pairs used by the threads of one program do not need
+ * a handler process or the TCP/IP stack: the data goes into a ring buffer,
+ * and whoever is waiting for it is woken up by a signal. Tasks blocked in
+ * read(), write(), send() and recv(), and those waiting in select() and
+ * poll(), are all on the same list, and all of them are woken up whenever
+ * anything about the pipe changes.
+ */
+
+/* Writes up to this size are never interleaved with other writes. */
+#define ATOMIC_WRITE_SIZE _POSIX_PIPE_BUF
+
+/****************************************************************************/
+
+static void
+delete_ring_pipe(struct ring_pipe *rp) {
+    int i;
+
+    if (rp == NULL)
+        return;
+
+    for (i = 0; i < 2; i++) {
+        if (rp->rp_Buffer[i].rb_Data != NULL)
+            FreeVec(rp->rp_Buffer[i].rb_Data);
+    }
+
+    __delete_semaphore(rp->rp_Lock);
+
+    FreeVec(rp);
+}
+
+/****************************************************************************/
+
+/* Has to be called with the pipe locked. */
+static void
+wake_waiters(struct ring_pipe *rp) {
+    struct ring_waiter *rw;
+
+    for (rw = (struct ring_waiter *) rp->rp_Waiters.mlh_Head;
+         rw->rw_Node.mln_Succ != NULL;
+         rw = (struct ring_waiter *) rw->rw_Node.mln_Succ) {
+        Signal(rw->rw_Task, rw->rw_Signals);
+    }
+}
+
+/****************************************************************************/
+
+/* Go to sleep until something about the pipe changes, letting go of the
+   pipe, the file descriptor and the stdio lock in the meantime, so that
+   other tasks can poll or close the descriptor. Has to be called with the
+   pipe locked, and returns with the pipe locked again. */
+static int
+wait_for_change(struct ring_pipe *rp, struct fd *fd) {
+    struct ring_waiter rw;
+    ULONG break_mask = 0;
+    ULONG signals;
+    LONG stdio_count;
+    LONG fd_count;
+    int signal_bit;
+
+    signal_bit = AllocSignal(-1);
+    if (signal_bit < 0) {
+        SHOWMSG("no signal to wait for");
+
+        __set_errno(EAGAIN);
+        return (ERROR);
+    }
+
+    rw.rw_Task = FindTask(NULL);
+    rw.rw_Signals = (1UL << signal_bit);
+
+    SetSignal(0, rw.rw_Signals);
+
+    AddTail((struct List *) &rp->rp_Waiters, (struct Node *) &rw.rw_Node);
+
+    __release_semaphore(rp->rp_Lock);
+
+    fd_count = __fd_unlock_all(fd);
+    stdio_count = __stdio_unlock_all();
+
+    if (__check_abort_enabled)
+        break_mask = __break_signal_mask;
+
+    signals = Wait(rw.rw_Signals | break_mask);
+
+    /* Same order as everywhere else: the stdio lock comes first. */
+    __stdio_relock(stdio_count);
+    __fd_relock(fd, fd_count);
+
+    __obtain_semaphore(rp->rp_Lock);
+
+    Remove((struct Node *) &rw.rw_Node);
+
+    FreeSignal(signal_bit);
+
+    /* Stop if a break signal arrives; __check_abort() will pick it up. */
+    if ((signals & break_mask) != 0) {
+        SetSignal(break_mask, break_mask);
+
+        __set_errno(EINTR);
+        return (ERROR);
+    }
+
+    return (OK);
+}
+
+/****************************************************************************/
+
+/* Look up the end of the pipe attached to a file descriptor, and make sure
+   that the pipe stays around until release_ring_end() is called. */
+static struct ring_end *
+obtain_ring_end(struct fd *fd) {
+    struct ring_end *re = NULL;
+
+    __fd_lock(fd);
+
+    if (FLAG_IS_SET(fd->fd_Flags, FDF_IS_RING_PIPE))
+        re = fd->fd_Aux;
+
+    if (re != NULL) {
+        __obtain_semaphore(re->re_Pipe->rp_Lock);
+
+        re->re_Pipe->rp_NumUsers++;
+
+        __release_semaphore(re->re_Pipe->rp_Lock);
+    }
+
+    __fd_unlock(fd);
+
+    if (re == NULL)
+        __set_errno(EBADF);
+
+    return (re);
+}
+
+/****************************************************************************/
+
+static void
+release_ring_end(struct ring_end *re) {
+    struct ring_pipe *rp = re->re_Pipe;
+    BOOL last_user;
+
+    __obtain_semaphore(rp->rp_Lock);
+
+    rp->rp_NumUsers--;
+
+    last_user = (BOOL) (rp->rp_NumUsers == 0 && rp->rp_NumOpenEnds == 0);
+
+    __release_semaphore(rp->rp_Lock);
+
+    /* Both ends were closed in the meantime. */
+    if (last_user)
+        delete_ring_pipe(rp);
+}
+
+/****************************************************************************/
+
+int
+__create_ring_pipe(int fd[2], BOOL is_socket_pair, BOOL non_blocking) {
+    struct SignalSemaphore *locks[2] = {NULL, NULL};
+    struct ring_pipe *rp;
+    int slots[2] = {-1, -1};
+    int result = ERROR;
+    ULONG flags;
+    int i;
+
+    ENTER();
+
+    SHOWVALUE(is_socket_pair);
+    SHOWVALUE(non_blocking);
+
+    rp = AllocVecTags(sizeof(*rp), AVT_Type, MEMF_SHARED, AVT_ClearWithValue, 0, TAG_DONE);
+    if (rp == NULL) {
+        __set_errno(ENOMEM);
+        goto out;
+    }
+
+    NewList((struct List *) &rp->rp_Waiters);
+
+    rp->rp_Lock = __create_semaphore();
+    if (rp->rp_Lock == NULL) {
+        __set_errno(ENOMEM);
+        goto out;
+    }
+
+    for (i = 0; i < (is_socket_pair ? 2 : 1); i++) {
+        rp->rp_Buffer[i].rb_Data = AllocVecTags(RING_PIPE_SIZE, AVT_Type, MEMF_SHARED, TAG_DONE);
+        if (rp->rp_Buffer[i].rb_Data == NULL) {
+            __set_errno(ENOMEM);
+            goto out;
+        }
+    }
+
+    for (i = 0; i < 2; i++) {
+        locks[i] = __create_semaphore();
+        if (locks[i] == NULL) {
+            __set_errno(ENOMEM);
+            goto out;
+        }
+
+        rp->rp_End[i].re_Pipe = rp;
+    }
+
+    /* The first end of a pipe is for reading, the second one for writing.
+       Either end of a socket pair reads what the other one writes. */
+    if (is_socket_pair) {
+        rp->rp_End[0].re_Read = &rp->rp_Buffer[0];
+        rp->rp_End[0].re_Write = &rp->rp_Buffer[1];
+        rp->rp_End[1].re_Read = &rp->rp_Buffer[1];
+        rp->rp_End[1].re_Write = &rp->rp_Buffer[0];
+    } else {
+        rp->rp_End[0].re_Read = &rp->rp_Buffer[0];
+        rp->rp_End[1].re_Write = &rp->rp_Buffer[0];
+
+        /* Nobody reads what is written into the unused buffer. */
+        rp->rp_Buffer[1].rb_ReaderGone = rp->rp_Buffer[1].rb_WriterGone = TRUE;
+    }
+
+    rp->rp_NumOpenEnds = 2;
+
+    __stdio_lock();
+
+    for (i = 0; i < 2; i++) {
+        slots[i] = __find_vacant_fd_entry();
+        if (slots[i] < 0) {
+            if (__grow_fd_table(0) < 0) {
+                SHOWMSG("couldn't find a vacant fd slot and no memory to create one");
+
+                if (i > 0)
+                    memset(__fd[slots[0]], 0, sizeof(*__fd[slots[0]]));
+
+                __stdio_unlock();
+                goto out;
+            }
+
+            slots[i] = __find_vacant_fd_entry();
+            assert(slots[i] >= 0);
+        }
+
+        flags = FDF_IN_USE | FDF_IS_RING_PIPE;
+
+        if (rp->rp_End[i].re_Read != NULL)
+            SET_FLAG(flags, FDF_READ);
+
+        if (rp->rp_End[i].re_Write != NULL)
+            SET_FLAG(flags, FDF_WRITE);
+
+        if (non_blocking)
+            SET_FLAG(flags, FDF_NON_BLOCKING);
+
+        /* Marks the slot as being in use, so that the next search will
+           find a different one. */
+        __initialize_fd(__fd[slots[i]], __ring_pipe_hook_entry, ZERO, flags, locks[i]);
+
+        __fd[slots[i]]->fd_Aux = &rp->rp_End[i];
+    }
+
+    __stdio_unlock();
+
+    fd[0] = slots[0];
+    fd[1] = slots[1];
+
+    rp = NULL;
+    locks[0] = locks[1] = NULL;
+
+    result = OK;
+
+out:
+
+    delete_ring_pipe(rp);
+
+    __delete_semaphore(locks[0]);
+    __delete_semaphore(locks[1]);
+
+    RETURN(result);
+    return (result);
+}
+
+/****************************************************************************/
+
+/* MSG_PEEK leaves the data in the pipe, and MSG_DONTWAIT does not wait for
+   it; other flags are ignored. */
+ssize_t
+__ring_pipe_read(struct fd *fd, void *buffer, size_t num_bytes, int flags) {
+    struct ring_buffer *rb;
+    struct ring_pipe *rp;
+    struct ring_end *re;
+    ssize_t result = ERROR;
+    size_t num_bytes_read;
+    size_t n;
+
+    ENTER();
+
+    SHOWPOINTER(fd);
+    SHOWPOINTER(buffer);
+    SHOWVALUE(num_bytes);
+    SHOWVALUE(flags);
+
+    re = obtain_ring_end(fd);
+    if (re == NULL)
+        goto out;
+
+    rp = re->re_Pipe;
+    rb = re->re_Read;
+
+    __obtain_semaphore(rp->rp_Lock);
+
+    while (TRUE) {
+        if (re->re_Closed || rb == NULL) {
+            __set_errno(EBADF);
+            goto unlock;
+        }
+
+        if (rb->rb_Count > 0)
+            break;
+
+        /* Nothing is going to arrive any more. */
+        if (rb->rb_WriterGone || rb->rb_ReaderGone) {
+            result = 0;
+            goto unlock;
+        }
+
+        if (FLAG_IS_SET(flags, MSG_DONTWAIT) || FLAG_IS_SET(fd->fd_Flags, FDF_NON_BLOCKING)) {
+            __fd_count_blocked(fd, fd_NumEmptyReads);
+
+            __set_errno(EAGAIN);
+            goto unlock;
+        }
+
+        if (wait_for_change(rp, fd) < 0)
+            goto unlock;
+    }
+
+    num_bytes_read = (num_bytes < rb->rb_Count) ? num_bytes : rb->rb_Count;
+
+    /* The data may wrap around the end of the buffer. */
+    n = RING_PIPE_SIZE - rb->rb_Head;
+    if (n > num_bytes_read)
+        n = num_bytes_read;
+
+    memcpy(buffer, &rb->rb_Data[rb->rb_Head], n);
+
+    if (n < num_bytes_read)
+        memcpy((UBYTE *) buffer + n, rb->rb_Data, num_bytes_read - n);
+
+    if (FLAG_IS_CLEAR(flags, MSG_PEEK)) {
+        rb->rb_Count -= num_bytes_read;
+
+        if (rb->rb_Count == 0)
+            rb->rb_Head = 0;
+        else
+            rb->rb_Head = (rb->rb_Head + num_bytes_read) % RING_PIPE_SIZE;
+
+        /* There is room to write now. */
+        wake_waiters(rp);
+    }
+
+    result = (ssize_t) num_bytes_read;
+
+unlock:
+
+    __release_semaphore(rp->rp_Lock);
+
+    release_ring_end(re);
+
+out:
+
+    RETURN(result);
+    return (result);
+}
+
+/****************************************************************************/
+
+/* A write which fits into ATOMIC_WRITE_SIZE goes in as a whole; a longer
+   one waits for room as often as it takes, unless MSG_DONTWAIT is set or
+   the descriptor is in non-blocking mode. */
+ssize_t
+__ring_pipe_write(struct fd *fd, const void *buffer, size_t num_bytes, int flags) {
+    struct ring_buffer *rb;
+    struct ring_pipe *rp;
+    struct ring_end *re;
+    size_t num_bytes_written = 0;
+    size_t room, needed, tail;
+    ssize_t result = ERROR;
+    BOOL non_blocking;
+    size_t n;
+
+    ENTER();
+
+    SHOWPOINTER(fd);
+    SHOWPOINTER(buffer);
+    SHOWVALUE(num_bytes);
+    SHOWVALUE(flags);
+
+    re = obtain_ring_end(fd);
+    if (re == NULL)
+        goto out;
+
+    rp = re->re_Pipe;
+    rb = re->re_Write;
+
+    non_blocking = (BOOL) (FLAG_IS_SET(flags, MSG_DONTWAIT) || FLAG_IS_SET(fd->fd_Flags, FDF_NON_BLOCKING));
+
+    __obtain_semaphore(rp->rp_Lock);
+
+    while (num_bytes_written < num_bytes) {
+        if (re->re_Closed || rb == NULL) {
+            __set_errno(EBADF);
+            break;
+        }
+
+        /* Nobody is going to read this, or writing was shut down. Note
+           that there is no SIGPIPE, just like for the PIPE: handler. */
+        if (rb->rb_ReaderGone || rb->rb_WriterGone) {
+            __set_errno(EPIPE);
+            break;
+        }
+
+        room = RING_PIPE_SIZE - rb->rb_Count;
+
+        needed = num_bytes - num_bytes_written;
+        if (needed > ATOMIC_WRITE_SIZE)
+            needed = 1;
+
+        if (room < needed) {
+            if (non_blocking) {
+                __fd_count_blocked(fd, fd_NumFullWrites);
+
+                __set_errno(EAGAIN);
+                break;
+            }
+
+            if (wait_for_change(rp, fd) < 0)
+                break;
+
+            continue;
+        }
+
+        n = num_bytes - num_bytes_written;
+        if (n > room)
+            n = room;
+
+        /* The free space may wrap around the end of the buffer. */
+        tail = (rb->rb_Head + rb->rb_Count) % RING_PIPE_SIZE;
+
+        room = RING_PIPE_SIZE - tail;
+        if (room > n)
+            room = n;
+
+        memcpy(&rb->rb_Data[tail], (const UBYTE *) buffer + num_bytes_written, room);
+
+        if (room < n)
+            memcpy(rb->rb_Data, (const UBYTE *) buffer + num_bytes_written + room, n - room);
+
+        rb->rb_Count += n;
+        num_bytes_written += n;
+
+        /* There is something to read now. */
+        wake_waiters(rp);
+    }
+
+    __release_semaphore(rp->rp_Lock);
+
+    release_ring_end(re);
+
+    /* Whatever was written so far still counts. */
+    if (num_bytes_written > 0 || num_bytes == 0)
+        result = (ssize_t) num_bytes_written;
+
+out:
+
+    RETURN(result);
+    return (result);
+}
+
+/****************************************************************************/
+
+int
+__ring_pipe_shutdown(struct fd *fd, int how) {
+    struct ring_pipe *rp;
+    struct ring_end *re;
+    int result = ERROR;
+
+    ENTER();
+
+    SHOWPOINTER(fd);
+    SHOWVALUE(how);
+
+    if (how != SHUT_RD && how != SHUT_WR && how != SHUT_RDWR) {
+        __set_errno(EINVAL);
+        goto out;
+    }
+
+    re = obtain_ring_end(fd);
+    if (re == NULL)
+        goto out;
+
+    rp = re->re_Pipe;
+
+    __obtain_semaphore(rp->rp_Lock);
+
+    /* Whatever was not read yet is discarded. */
+    if ((how == SHUT_RD || how == SHUT_RDWR) && re->re_Read != NULL) {
+        re->re_Read->rb_ReaderGone = TRUE;
+        re->re_Read->rb_Count = re->re_Read->rb_Head = 0;
+    }
+
+    if ((how == SHUT_WR || how == SHUT_RDWR) && re->re_Write != NULL)
+        re->re_Write->rb_WriterGone = TRUE;
+
+    wake_waiters(rp);
+
+    __release_semaphore(rp->rp_Lock);
+
+    release_ring_end(re);
+
+    result = OK;
+
+out:
+
+    RETURN(result);
+    return (result);
+}
+
+/****************************************************************************/
+
+/* FIONBIO and FIONREAD work as they would for a socket. */
+int
+__ring_pipe_ioctl(struct fd *fd, int request, char *param) {
+    struct ring_end *re;
+    int result = ERROR;
+
+    ENTER();
+
+    SHOWPOINTER(fd);
+    SHOWVALUE(request);
+    SHOWPOINTER(param);
+
+    if (param == NULL) {
+        __set_errno(EFAULT);
+        goto out;
+    }
+
+    re = obtain_ring_end(fd);
+    if (re == NULL)
+        goto out;
+
+    switch (request) {
+        case FIONBIO:
+
+            __fd_lock(fd);
+
+            if ((*(const int *) param) != 0)
+                SET_FLAG(fd->fd_Flags, FDF_NON_BLOCKING);
+            else
+                CLEAR_FLAG(fd->fd_Flags, FDF_NON_BLOCKING);
+
+            __fd_unlock(fd);
+
+            result = OK;
+            break;
+
+        case FIONREAD:
+
+            __obtain_semaphore(re->re_Pipe->rp_Lock);
+
+            (*(int *) param) = (re->re_Read != NULL) ? (int) re->re_Read->rb_Count : 0;
+
+            __release_semaphore(re->re_Pipe->rp_Lock);
+
+            result = OK;
+            break;
+
+        default:
+
+            __set_errno(ENOTTY);
+            break;
+    }
+
+    release_ring_end(re);
+
+out:
+
+    RETURN(result);
+    return (result);
+}
+
+/****************************************************************************/
+
+/* Reads into one buffer after the other, as long as they are filled; only
+   the first read may wait. With MSG_PEEK, only the first buffer is used,
+   since reading on would find the same data again. There is no address and
+   no ancillary data. */
+ssize_t
+__ring_pipe_recvmsg(struct fd *fd, struct msghdr *msg, int flags) {
+    ssize_t result = ERROR;
+    ssize_t total = 0;
+    ssize_t n;
+    size_t i;
+
+    ENTER();
+
+    SHOWPOINTER(fd);
+    SHOWPOINTER(msg);
+    SHOWVALUE(flags);
+
+    if (msg->msg_iov == NULL && msg->msg_iovlen > 0) {
+        __set_errno(EFAULT);
+        goto out;
+    }
+
+    for (i = 0; i < msg->msg_iovlen; i++) {
+        if (msg->msg_iov[i].iov_len == 0)
+            continue;
+
+        n = __ring_pipe_read(fd, msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len, flags);
+        if (n < 0) {
+            if (total == 0)
+                goto out;
+
+            break;
+        }
+
+        total += n;
+
+        if ((size_t) n < msg->msg_iov[i].iov_len || FLAG_IS_SET(flags, MSG_PEEK))
+            break;
+
+        SET_FLAG(flags, MSG_DONTWAIT);
+    }
+
+    msg->msg_namelen = 0;
+    msg->msg_controllen = 0;
+    msg->msg_flags = 0;
+
+    result = total;
+
+out:
+
+    RETURN(result);
+    return (result);
+}
+
+/****************************************************************************/
+
+/* Writes one buffer after the other. If one cannot be written completely
+   without waiting, the ones which follow are not written. */
+ssize_t
+__ring_pipe_sendmsg(struct fd *fd, const struct msghdr *msg, int flags) {
+    ssize_t result = ERROR;
+    ssize_t total = 0;
+    ssize_t n;
+    size_t i;
+
+    ENTER();
+
+    SHOWPOINTER(fd);
+    SHOWPOINTER(msg);
+    SHOWVALUE(flags);
+
+    if (msg->msg_iov == NULL && msg->msg_iovlen > 0) {
+        __set_errno(EFAULT);
+        goto out;
+    }
+
+    for (i = 0; i < msg->msg_iovlen; i++) {
+        if (msg->msg_iov[i].iov_len == 0)
+            continue;
+
+        n = __ring_pipe_write(fd, msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len, flags);
+        if (n < 0) {
+            if (total == 0)
+                goto out;
+
+            break;
+        }
+
+        total += n;
+
+        if ((size_t) n < msg->msg_iov[i].iov_len)
+            break;
+    }
+
+    result = total;
+
+out:
+
+    RETURN(result);
+    return (result);
+}
+
+/****************************************************************************/
+
+/* The socket options which make sense for a socket pair. The buffer size
+   is fixed, and the only level is SOL_SOCKET. */
+int
+__ring_pipe_getsockopt(struct fd *fd, int level, int optname, void *optval, socklen_t *optlen) {
+    struct ring_end *re;
+    int result = ERROR;
+    int value;
+
+    ENTER();
+
+    SHOWPOINTER(fd);
+    SHOWVALUE(level);
+    SHOWVALUE(optname);
+
+    re = obtain_ring_end(fd);
+    if (re == NULL)
+        goto out;
+
+    release_ring_end(re);
+
+    if (level != SOL_SOCKET) {
+        __set_errno(EOPNOTSUPP);
+        goto out;
+    }
+
+    switch (optname) {
+        case SO_TYPE:
+
+            value = SOCK_STREAM;
+            break;
+
+        case SO_ERROR:
+
+            value = 0;
+            break;
+
+        case SO_SNDBUF:
+        case SO_RCVBUF:
+
+            value = RING_PIPE_SIZE;
+            break;
+
+        default:
+
+            __set_errno(ENOPROTOOPT);
+            goto out;
+    }
+
+    if ((*optlen) < sizeof(value)) {
+        __set_errno(EINVAL);
+        goto out;
+    }
+
+    memcpy(optval, &value, sizeof(value));
+    (*optlen) = sizeof(value);
+
+    result = OK;
+
+out:
+
+    RETURN(result);
+    return (result);
+}
+
+/****************************************************************************/
+
+/* The buffer sizes can be set, but stay what they are. */
+int
+__ring_pipe_setsockopt(struct fd *fd, int level, int optname, const void *optval, socklen_t optlen) {
+    struct ring_end *re;
+    int result = ERROR;
+
+    ENTER();
+
+    SHOWPOINTER(fd);
+    SHOWVALUE(level);
+    SHOWVALUE(optname);
+
+    (void) optval;
+
+    re = obtain_ring_end(fd);
+    if (re == NULL)
+        goto out;
+
+    release_ring_end(re);
+
+    if (level != SOL_SOCKET) {
+        __set_errno(EOPNOTSUPP);
+        goto out;
+    }
+
+    if (optname != SO_SNDBUF && optname != SO_RCVBUF) {
+        __set_errno(ENOPROTOOPT);
+        goto out;
+    }
+
+    if (optlen < sizeof(int)) {
+        __set_errno(EINVAL);
+        goto out;
+    }
+
+    result = OK;
+
+out:
+
+    RETURN(result);
+    return (result);
+}
+
+/****************************************************************************/
+
+/* Neither end of a socket pair has an address; both are unnamed local
+   sockets. */
+int
+__ring_pipe_getname(struct fd *fd, struct sockaddr *name, socklen_t *namelen) {
+    struct sockaddr sa;
+    struct ring_end *re;
+    int result = ERROR;
+    socklen_t len;
+
+    ENTER();
+
+    SHOWPOINTER(fd);
+
+    re = obtain_ring_end(fd);
+    if (re == NULL)
+        goto out;
+
+    release_ring_end(re);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_len = offsetof(struct sockaddr, sa_data);
+    sa.sa_family = AF_LOCAL;
+
+    len = (*namelen);
+    if (len > sa.sa_len)
+        len = sa.sa_len;
+
+    memcpy(name, &sa, len);
+    (*namelen) = sa.sa_len;
+
+    result = OK;
+
+out:
+
+    RETURN(result);
+    return (result);
+}
+
+/****************************************************************************/
+
+/* Called when the file descriptor is closed, with it locked. */
+void
+__close_ring_end(struct ring_end *re) {
+    struct ring_pipe *rp = re->re_Pipe;
+    BOOL last_user;
+
+    ENTER();
+
+    SHOWPOINTER(re);
+
+    __obtain_semaphore(rp->rp_Lock);
+
+    assert(NOT re->re_Closed);
+
+    if (re->re_Read != NULL) {
+        re->re_Read->rb_ReaderGone = TRUE;
+        re->re_Read->rb_Count = re->re_Read->rb_Head = 0;
+    }
+
+    if (re->re_Write != NULL)
+        re->re_Write->rb_WriterGone = TRUE;
+
+    if (re->re_PollWaiterArmed) {
+        Remove((struct Node *) &re->re_PollWaiter.rw_Node);
+        re->re_PollWaiterArmed = FALSE;
+    }
+
+    re->re_Closed = TRUE;
+
+    rp->rp_NumOpenEnds--;
+
+    /* Whoever waits for the other end learns about it now. */
+    wake_waiters(rp);
+
+    last_user = (BOOL) (rp->rp_NumOpenEnds == 0 && rp->rp_NumUsers == 0);
+
+    __release_semaphore(rp->rp_Lock);
+
+    if (last_user)
+        delete_ring_pipe(rp);
+
+    LEAVE();
+}
+
+/****************************************************************************/
+
+/* Has to be called with the pipe locked. */
+static int
+get_ring_events(const struct ring_end *re, int events) {
+    const struct ring_buffer *rb;
+    int revents = 0;
+
+    rb = re->re_Read;
+    if (rb != NULL && FLAG_IS_SET(events, POLLIN)) {
+        if (rb->rb_Count > 0 || rb->rb_WriterGone)
+            revents |= POLLIN;
+
+        if (rb->rb_WriterGone)
+            revents |= POLLHUP;
+    }
+
+    rb = re->re_Write;
+    if (rb != NULL && FLAG_IS_SET(events, POLLOUT)) {
+        if (RING_PIPE_SIZE - rb->rb_Count >= ATOMIC_WRITE_SIZE || rb->rb_ReaderGone)
+            revents |= POLLOUT;
+
+        if (rb->rb_ReaderGone)
+            revents |= POLLERR;
+    }
+
+    return (revents);
+}
+
+/****************************************************************************/
+
+/* Check without waiting which of the requested events the pipe can deliver
+   now. Has to be called with the file descriptor locked. */
+int
+__check_ring_pipe(struct fd *fd, int events) {
+    struct ring_end *re = fd->fd_Aux;
+    int revents;
+
+    /* There is no pipe behind this descriptor (any more). */
+    if (re == NULL)
+        return (POLLNVAL);
+
+    __obtain_semaphore(re->re_Pipe->rp_Lock);
+
+    revents = get_ring_events(re, events);
+
+    __release_semaphore(re->re_Pipe->rp_Lock);
+
+    return (revents);
+}
+
+/****************************************************************************/
+
+/* Have the task woken up through the given signal as soon as anything
+   about the pipe changes, or right away if one of the events has come
+   about since the pipe was last checked. Returns ERROR if another task is
+   waiting for the same end already. Has to be called with the file
+   descriptor locked. */
+int
+__arm_ring_pipe_waiter(struct fd *fd, int events, struct Task *task, int signal_bit) {
+    struct ring_end *re = fd->fd_Aux;
+    int result = ERROR;
+
+    assert(task != NULL && signal_bit >= 0);
+
+    if (re == NULL)
+        return (ERROR);
+
+    __obtain_semaphore(re->re_Pipe->rp_Lock);
+
+    if (re->re_PollWaiterArmed && re->re_PollWaiter.rw_Task != task) {
+        SHOWMSG("somebody else is waiting");
+        goto out;
+    }
+
+    re->re_PollWaiter.rw_Task = task;
+    re->re_PollWaiter.rw_Signals = (1UL << signal_bit);
+
+    if (NOT re->re_PollWaiterArmed) {
+        AddTail((struct List *) &re->re_Pipe->rp_Waiters, (struct Node *) &re->re_PollWaiter.rw_Node);
+        re->re_PollWaiterArmed = TRUE;
+    }
+
+    if (get_ring_events(re, events) != 0)
+        Signal(task, re->re_PollWaiter.rw_Signals);
+
+    result = OK;
+
+out:
+
+    __release_semaphore(re->re_Pipe->rp_Lock);
+
+    return (result);
+}
+
+/****************************************************************************/
+
+/* Has to be called with the file descriptor locked. */
+void
+__disarm_ring_pipe_waiter(struct fd *fd, struct Task *task) {
+    struct ring_end *re = fd->fd_Aux;
+
+    if (re == NULL)
+        return;
+
+    __obtain_semaphore(re->re_Pipe->rp_Lock);
+
+    if (re->re_PollWaiterArmed && re->re_PollWaiter.rw_Task == task) {
+        Remove((struct Node *) &re->re_PollWaiter.rw_Node);
+        re->re_PollWaiterArmed = FALSE;
+    }
+
+    __release_semaphore(re->re_Pipe->rp_Lock);
+}
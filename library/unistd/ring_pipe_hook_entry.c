@@ -0,0 +1,136 @@
+/*
+ * $Id: unistd_ring_pipe_hook_entry.c,v 1.0 2026-10-17 12:00:00 clib2devs Exp $
+*/
+
+#ifndef _UNISTD_HEADERS_H
+#include "unistd_headers.h"
+#endif /* _UNISTD_HEADERS_H */
+
+int64_t
+__ring_pipe_hook_entry(struct fd *fd, struct file_action_message *fam) {
+    struct ring_end *re;
+    struct ring_buffer *rb;
+    struct ExamineData *fib;
+    BOOL is_aliased;
+    int64_t result;
+
+    assert(fam != NULL && fd != NULL);
+
+    /* Careful: file_action_close has to monkey with the file descriptor
+                table and therefore needs to obtain the stdio lock before
+                it locks this particular descriptor entry. */
+    if (fam->fam_Action == file_action_close)
+        __stdio_lock();
+
+    __fd_lock(fd);
+
+    switch (fam->fam_Action) {
+        case file_action_read:
+            SHOWMSG("file_action_read");
+
+            assert(fam->fam_Data != NULL);
+            assert(fam->fam_Size > 0);
+
+            result = __ring_pipe_read(fd, fam->fam_Data, (size_t) fam->fam_Size, 0);
+            if (result < 0)
+                fam->fam_Error = __get_errno();
+
+            break;
+
+        case file_action_write:
+            SHOWMSG("file_action_write");
+
+            assert(fam->fam_Data != NULL);
+            assert(fam->fam_Size > 0);
+
+            result = __ring_pipe_write(fd, fam->fam_Data, (size_t) fam->fam_Size, 0);
+            if (result < 0)
+                fam->fam_Error = __get_errno();
+
+            break;
+
+        case file_action_close:
+            SHOWMSG("file_action_close");
+            result = OK;
+
+            /* If this is an alias, just remove it. */
+            is_aliased = __fd_is_aliased(fd);
+            if (is_aliased)
+                __remove_fd_alias(fd);
+            else
+                __close_ring_end(fd->fd_Aux);
+
+            __fd_unlock(fd);
+
+            /* Free the lock semaphore now. */
+            if (NOT is_aliased)
+                __delete_semaphore(fd->fd_Lock);
+
+            /* And that's the last for this file descriptor. */
+            memset(fd, 0, sizeof(*fd));
+            fd = NULL;
+            break;
+
+        case file_action_seek:
+        case file_action_pread:
+        case file_action_pwrite:
+            SHOWMSG("file_action_seek/file_action_pread/file_action_pwrite");
+            result = ERROR;
+            fam->fam_Error = ESPIPE;
+            break;
+
+        case file_action_set_blocking:
+            SHOWMSG("file_action_set_blocking");
+
+            /* Only the FDF_NON_BLOCKING flag matters. */
+            result = OK;
+            break;
+
+        case file_action_examine:
+            SHOWMSG("file_action_examine");
+
+            /* fstat() frees what it gets back. */
+            fib = AllocDosObjectTags(DOS_EXAMINEDATA, TAG_DONE);
+            if (fib == NULL) {
+                result = ERROR;
+                fam->fam_Error = ENOMEM;
+                break;
+            }
+
+            re = fd->fd_Aux;
+
+            /* A socket pair can be read from and written to at both ends. */
+            fib->Type = (re->re_Read != NULL && re->re_Write != NULL) ? ST_SOCKET : ST_PIPEFILE;
+
+            /* How much there is to read. */
+            rb = re->re_Read;
+            if (rb != NULL) {
+                __obtain_semaphore(re->re_Pipe->rp_Lock);
+
+                fib->FileSize = rb->rb_Count;
+
+                __release_semaphore(re->re_Pipe->rp_Lock);
+            }
+
+            DateStamp(&fib->Date);
+
+            fam->fam_FileInfo = fib;
+
+            result = OK;
+            break;
+
+        default:
+            SHOWVALUE(fam->fam_Action);
+            result = ERROR;
+            fam->fam_Error = EBADF;
+            break;
+    }
+
+    __fd_unlock(fd);
+
+    if (fam->fam_Action == file_action_close)
+        __stdio_unlock();
+
+    RETURN(result);
+    return (result);
+}
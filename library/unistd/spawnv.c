@@ -162,6 +162,10 @@ spawnv(int mode, const char *file, const char **argv) {
     char finalpath[PATH_MAX] = {0};
     snprintf(finalpath, PATH_MAX - 1, "%s %s", file, arg_string);
 
+    /* A program started in the background runs alongside this one. */
+    if (mode == P_NOWAIT)
+        __enable_locking();
+
     struct Process *me = (struct Process *) FindTask(NULL);
     BPTR in  = mode == P_WAIT ? me->pr_COS : 0;
 
@@ -1,5 +1,5 @@
 /*
- * $Id: unistd_timer.c,v 1.11 2021-02-01 16:35:56 clib2devs Exp $
+ * $Id: unistd_timer.c,v 1.13 2026-10-17 12:00:00 clib2devs Exp $
 */
 
 #ifndef _UNISTD_HEADERS_H
@@ -73,6 +73,10 @@ CLIB_CONSTRUCTOR(timer_init)
     /* Set system time for rusage */
     struct TimerIFace *ITimer = __ITimer;
     GetSysTime(&__global_clib2->clock);
+    /* Calibrate the time base clock */
+    __init_clock();
+    /* Count the CPU time used by the main program */
+    __start_cpu_clock();
     /* Generate random seed */
     __global_clib2->__random_seed = time(NULL);
 
@@ -96,6 +100,9 @@ CLIB_DESTRUCTOR(timer_exit)
 {
 	ENTER();
 
+	/* exec must not call into this program after it is gone */
+	__stop_cpu_clock();
+
 	if (__ITimer != NULL)
 		DropInterface((struct Interface *)__ITimer);
 
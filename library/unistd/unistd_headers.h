@@ -17,6 +17,12 @@
 #include "stdlib_headers.h"
 #endif /* _STDLIB_HEADERS_H */
 
+/****************************************************************************/
+
+#ifndef _SYS_SOCKET_H
+#include <sys/socket.h>
+#endif /* _SYS_SOCKET_H */
+
 extern char NOCOMMON __current_path_name[MAXPATHLEN];
 
 /****************************************************************************/
@@ -74,4 +80,73 @@ extern int itimer_real_task(void);
 
 extern BOOL NOCOMMON __unix_path_semantics;
 
+/****************************************************************************/
+
+/* How much an in-process pipe holds. */
+#define RING_PIPE_SIZE 65536
+
+/* Somebody waiting for something to happen to an in-process pipe. */
+struct ring_waiter
+{
+	struct MinNode		rw_Node;
+	struct Task *		rw_Task;
+	ULONG				rw_Signals;
+};
+
+/* The data flowing in one direction. */
+struct ring_buffer
+{
+	UBYTE *				rb_Data;
+	size_t				rb_Head;			/* Where the next byte is read from */
+	size_t				rb_Count;			/* How many bytes are waiting to be read */
+	BOOL				rb_ReaderGone;		/* Nobody is going to read any more */
+	BOOL				rb_WriterGone;		/* Nobody is going to write any more */
+};
+
+/* One end of the pipe, attached to its file descriptor through fd_Aux. */
+struct ring_end
+{
+	struct ring_pipe *	re_Pipe;
+	struct ring_buffer *re_Read;			/* NULL if this end cannot read */
+	struct ring_buffer *re_Write;			/* NULL if this end cannot write */
+	struct ring_waiter	re_PollWaiter;		/* For select() and poll(); has only
+											   one owner at a time */
+	BOOL				re_PollWaiterArmed;
+	BOOL				re_Closed;
+};
+
+/* A pipe has one buffer and two ends, one to read from and one to write
+   to; a socket pair has two buffers, and both ends can read and write. The
+   pipe is shared by both ends and goes away when both have been closed,
+   and no send() or recv() is still waiting on it. */
+struct ring_pipe
+{
+	struct SignalSemaphore *	rp_Lock;
+	struct MinList				rp_Waiters;		/* Woken up whenever anything changes */
+	struct ring_buffer			rp_Buffer[2];
+	struct ring_end				rp_End[2];
+	int							rp_NumOpenEnds;
+	int							rp_NumUsers;	/* Calls waiting without the descriptor locked */
+};
+
+extern BOOL NOCOMMON __use_dos_pipes;
+
+extern int __open_dos_pipe(int fd[2],int flags);
+
+extern int64_t __ring_pipe_hook_entry(struct fd * fd,struct file_action_message * fam);
+extern int __create_ring_pipe(int fd[2],BOOL is_socket_pair,BOOL non_blocking);
+extern ssize_t __ring_pipe_read(struct fd * fd,void * buffer,size_t num_bytes,int flags);
+extern ssize_t __ring_pipe_write(struct fd * fd,const void * buffer,size_t num_bytes,int flags);
+extern int __ring_pipe_shutdown(struct fd * fd,int how);
+extern int __ring_pipe_ioctl(struct fd * fd,int request,char * param);
+extern ssize_t __ring_pipe_recvmsg(struct fd * fd,struct msghdr * msg,int flags);
+extern ssize_t __ring_pipe_sendmsg(struct fd * fd,const struct msghdr * msg,int flags);
+extern int __ring_pipe_getsockopt(struct fd * fd,int level,int optname,void * optval,socklen_t * optlen);
+extern int __ring_pipe_setsockopt(struct fd * fd,int level,int optname,const void * optval,socklen_t optlen);
+extern int __ring_pipe_getname(struct fd * fd,struct sockaddr * name,socklen_t * namelen);
+extern void __close_ring_end(struct ring_end * re);
+extern int __check_ring_pipe(struct fd * fd,int events);
+extern int __arm_ring_pipe_waiter(struct fd * fd,int events,struct Task * task,int signal_bit);
+extern void __disarm_ring_pipe_waiter(struct fd * fd,struct Task * task);
+
 #endif /* _UNISTD_HEADERS_H */
@@ -105,6 +105,8 @@ typedef struct
     char   *buffer;
     size_t  buffer_pos;
     size_t  buffer_size;
+    int     grow;       /* The buffer may be reallocated when it is full */
+    int     failed;     /* Growing the buffer did not work */
 } Out;
 
 #define S(x) [(x)-'A']
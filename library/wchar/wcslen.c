@@ -6,17 +6,26 @@
 #include "wchar_headers.h"
 #endif /* _WCHAR_HEADERS_H */
 
+#ifndef _STRING_HEADERS_H
+#include "string_headers.h"
+#endif /* _STRING_HEADERS_H */
+
 size_t
-wcslen(const wchar_t *s) {
+__wcslen_generic(const wchar_t *s) {
     const wchar_t *p;
 
-    ENTER();
-
     p = s;
     while (*p)
         p++;
 
-    size_t result = p - s;
+    return p - s;
+}
+
+size_t
+wcslen(const wchar_t *s) {
+    ENTER();
+
+    size_t result = __string_functions.sf_wcslen(s);
 
     RETURN(result);
     return result;
@@ -6,74 +6,36 @@
 #include "wchar_headers.h"
 #endif /* _WCHAR_HEADERS_H */
 
+#ifndef _STRING_TWOWAY_H
+#include "string_twoway.h"
+#endif /* _STRING_TWOWAY_H */
+
 wchar_t *
 wcsstr(const wchar_t *big, const wchar_t *little) {
-#if 1
-    unsigned int i;
-    wchar_t *p = (wchar_t *) big;
+    wchar_t *result;
 
     ENTER();
 
-    if (!p)
+    if (big == NULL) {
+        LEAVE();
         return NULL;
+    }
 
     // Always find the empty string
-    if ((!little) || (!little[0]))
+    if (little == NULL || little[0] == L'\0') {
+        LEAVE();
         return (wchar_t *) big;
-
-    size_t flen = wcslen(little);
-
-    for (i = 0; i < flen; i++) {
-        if ((p = wcschr(p, little[i])) == NULL) {
-            LEAVE();
-            return NULL;
-        }
-
-        if (!wmemcmp(p, little, flen)) {
-            LEAVE();
-            return p;
-        }
-
-        big = p + 1;
     }
 
-    LEAVE();
-    return NULL;
-#else
-    const wchar_t *p;
-    const wchar_t *q;
-    const wchar_t *r;
-
-    ENTER();
-
-    if (!*little)
-    {
-        /* LINTED interface specification */
-        return (wchar_t *)big;
+    // Skip straight to the first possible match
+    big = wcschr(big, little[0]);
+    if (big == NULL || little[1] == L'\0') {
+        LEAVE();
+        return (wchar_t *) big;
     }
-    if (wcslen(big) < wcslen(little))
-        return NULL;
 
-    p = big;
-    q = little;
-    while (*p)
-    {
-        q = little;
-        r = p;
-        while (*q)
-        {
-            if (*r != *q)
-                break;
-            q++;
-            r++;
-        }
-        if (!*q)
-        {
-            /* LINTED interface specification */
-            return (wchar_t *)p;
-        }
-        p++;
-    }
-    return NULL;
-#endif
+    result = __twoway_wcsstr(big, little);
+
+    LEAVE();
+    return result;
 }
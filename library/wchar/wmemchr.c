@@ -6,14 +6,14 @@
 #include "wchar_headers.h"
 #endif /* _WCHAR_HEADERS_H */
 
+#ifndef _STRING_HEADERS_H
+#include "string_headers.h"
+#endif /* _STRING_HEADERS_H */
+
 wchar_t *
-wmemchr(const wchar_t *ptr, wchar_t val, size_t len) {
+__wmemchr_generic(const wchar_t *ptr, wchar_t val, size_t len) {
     size_t i;
 
-    if (ptr == NULL) {
-        return NULL;
-    }
-
     for (i = 0; i < len; i++) {
         if (*ptr == val) {
             /* LINTED const castaway */
@@ -23,3 +23,12 @@ wmemchr(const wchar_t *ptr, wchar_t val, size_t len) {
     }
     return NULL;
 }
+
+wchar_t *
+wmemchr(const wchar_t *ptr, wchar_t val, size_t len) {
+    if (ptr == NULL) {
+        return NULL;
+    }
+
+    return __string_functions.sf_wmemchr(ptr, val, len);
+}
@@ -6,8 +6,12 @@
 #include "wchar_headers.h"
 #endif /* _WCHAR_HEADERS_H */
 
+#ifndef _STRING_HEADERS_H
+#include "string_headers.h"
+#endif /* _STRING_HEADERS_H */
+
 wchar_t *
-wmemset(wchar_t *ptr, int val, size_t len) {
+__wmemset_generic(wchar_t *ptr, wchar_t val, size_t len) {
     size_t i;
     wchar_t *p;
 
@@ -19,3 +23,8 @@ wmemset(wchar_t *ptr, int val, size_t len) {
 
     return ptr;
 }
+
+wchar_t *
+wmemset(wchar_t *ptr, int val, size_t len) {
+    return __string_functions.sf_wmemset(ptr, val, len);
+}
@@ -0,0 +1,184 @@
+/*
+ * Compares line reading throughput: getline() and fgets() against a
+ * getdelim() which fetches one character at a time through fgetc(), the
+ * way the library used to do it. Both short (log style) and long lines
+ * are tried.
+ *
+ * Usage: getline_benchmark [megabytes]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/types.h>
+
+#define FILE_PATH ("getline_test.txt")
+
+static ssize_t
+old_getdelim(char **lineptr, size_t *n, int delimiter, FILE *stream) {
+    char *ptr = *lineptr;
+    size_t size = (ptr != NULL) ? *n : 0;
+    size_t len = 0;
+
+    for (;;) {
+        if ((size - len) <= 2) {
+            size = size ? (size * 2) : 256;
+            ptr = realloc(*lineptr, size);
+            if (ptr == NULL)
+                return -1;
+            *lineptr = ptr;
+            *n = size;
+        }
+
+        int c = fgetc(stream);
+        if (c == -1) {
+            if (len == 0 || ferror(stream))
+                return -1;
+            break;
+        }
+        ptr[len++] = c;
+        if (c == delimiter)
+            break;
+    }
+
+    ptr[len] = '\0';
+    return len;
+}
+
+static int
+write_test_file(size_t total, size_t line_length) {
+    FILE *file = fopen(FILE_PATH, "w");
+    size_t written = 0;
+    char *line;
+    size_t i;
+
+    if (file == NULL) {
+        printf("can't create test file %s (%s)\n", FILE_PATH, strerror(errno));
+        return -1;
+    }
+
+    line = malloc(line_length + 1);
+    if (line == NULL) {
+        fclose(file);
+        return -1;
+    }
+
+    for (i = 0; i < line_length - 1; i++)
+        line[i] = 'a' + (i % 26);
+
+    line[line_length - 1] = '\n';
+    line[line_length] = '\0';
+
+    while (written < total) {
+        /* Vary the length a little, like real log lines do */
+        size_t len = line_length - (written / line_length) % (line_length / 4 + 1);
+
+        fwrite(line + line_length - len, 1, len, file);
+        written += len;
+    }
+
+    free(line);
+    fclose(file);
+
+    return 0;
+}
+
+static double
+elapsed(clock_t begin) {
+    return (double) (clock() - begin) / CLOCKS_PER_SEC;
+}
+
+static void
+report(const char *name, unsigned long lines, size_t bytes, double seconds) {
+    if (seconds <= 0.0)
+        seconds = 1.0 / CLOCKS_PER_SEC;
+
+    printf("  %-14s %9lu lines  %10.0f lines/s  %8.2f MB/s\n", name, lines, lines / seconds,
+           bytes / seconds / (1024.0 * 1024.0));
+}
+
+static void
+run(size_t line_length) {
+    char *line = NULL;
+    size_t size = 0;
+    char buffer[256];
+    unsigned long lines;
+    size_t bytes;
+    ssize_t len;
+    clock_t begin;
+    FILE *file;
+
+    printf("Lines of up to %lu bytes:\n", (unsigned long) line_length);
+
+    /* Old: one fgetc() per character */
+    file = fopen(FILE_PATH, "r");
+    if (file == NULL)
+        return;
+
+    lines = 0;
+    bytes = 0;
+    begin = clock();
+    while ((len = old_getdelim(&line, &size, '\n', file)) > 0) {
+        lines++;
+        bytes += len;
+    }
+    report("fgetc loop", lines, bytes, elapsed(begin));
+    fclose(file);
+
+    /* New: getline() */
+    file = fopen(FILE_PATH, "r");
+    if (file == NULL)
+        return;
+
+    lines = 0;
+    bytes = 0;
+    begin = clock();
+    while ((len = getline(&line, &size, file)) > 0) {
+        lines++;
+        bytes += len;
+    }
+    report("getline", lines, bytes, elapsed(begin));
+    fclose(file);
+
+    /* fgets(), which may split long lines */
+    file = fopen(FILE_PATH, "r");
+    if (file == NULL)
+        return;
+
+    lines = 0;
+    bytes = 0;
+    begin = clock();
+    while (fgets(buffer, sizeof(buffer), file) != NULL) {
+        len = strlen(buffer);
+        if (len > 0 && buffer[len - 1] == '\n')
+            lines++;
+        bytes += len;
+    }
+    report("fgets", lines, bytes, elapsed(begin));
+    fclose(file);
+
+    free(line);
+}
+
+int
+main(int argc, char **argv) {
+    size_t megabytes = 16;
+    static const size_t line_lengths[] = { 40, 120, 4000 };
+    size_t i;
+
+    if (argc > 1)
+        megabytes = strtoul(argv[1], NULL, 10);
+
+    for (i = 0; i < sizeof(line_lengths) / sizeof(line_lengths[0]); i++) {
+        if (write_test_file(megabytes * 1024 * 1024, line_lengths[i]) < 0)
+            return EXIT_FAILURE;
+
+        run(line_lengths[i]);
+    }
+
+    remove(FILE_PATH);
+
+    return EXIT_SUCCESS;
+}
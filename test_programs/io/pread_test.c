@@ -0,0 +1,234 @@
+/*
+ * Checks pread(), pwrite(), preadv() and pwritev(): the data has to come from
+ * and go to the given offset, and the file position must stay where it was.
+ * Then several threads read random 4 KB blocks from one shared descriptor
+ * while the main thread keeps reading it sequentially, which only works if
+ * pread() never disturbs the file position. The time this takes is shown.
+ *
+ * Usage: pread_test [threads] [reads per thread]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/uio.h>
+
+#define FILE_PATH ("pread_test.dat")
+#define BLOCK_SIZE 4096
+#define NUM_BLOCKS 256
+
+static int fd = -1;
+static long reads_per_thread = 2000;
+static int failures;
+
+/* Every byte of the file tells where it is. */
+static unsigned char
+pattern(long offset) {
+    return (unsigned char) ((offset * 7 + offset / 251) & 255);
+}
+
+static int
+check_block(const unsigned char *data, long offset, long length) {
+    long i;
+
+    for (i = 0; i < length; i++) {
+        if (data[i] != pattern(offset + i))
+            return -1;
+    }
+
+    return 0;
+}
+
+static void
+fail(const char *what) {
+    printf("FAIL: %s (%s)\n", what, strerror(errno));
+    failures++;
+}
+
+static void *
+reader(void *arg) {
+    unsigned long state = (unsigned long) arg * 2654435761UL + 1;
+    unsigned char block[BLOCK_SIZE];
+    long i;
+
+    for (i = 0; i < reads_per_thread; i++) {
+        long offset;
+
+        state = state * 1103515245UL + 12345UL;
+        offset = (long) ((state >> 8) % NUM_BLOCKS) * BLOCK_SIZE;
+
+        if (pread(fd, block, sizeof(block), offset) != sizeof(block) ||
+            check_block(block, offset, sizeof(block)) != 0) {
+            fail("pread() from several threads");
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+static void
+check_basics(void) {
+    unsigned char data[BLOCK_SIZE], more[100];
+    struct iovec iov[3];
+    off_t position;
+    long i;
+
+    /* Reading from the middle leaves the position alone. */
+    if (lseek(fd, 1000, SEEK_SET) != 1000)
+        fail("lseek()");
+
+    if (pread(fd, data, 500, 20000) != 500 || check_block(data, 20000, 500) != 0)
+        fail("pread()");
+
+    if (lseek(fd, 0, SEEK_CUR) != 1000)
+        fail("pread() moved the file position");
+
+    /* Reading at the current position needs no seek at all, but must not
+       move the position either. */
+    if (pread(fd, data, 500, 1000) != 500 || check_block(data, 1000, 500) != 0)
+        fail("pread() at the current position");
+
+    if (read(fd, data, 10) != 10 || check_block(data, 1000, 10) != 0)
+        fail("read() after pread()");
+
+    /* Reading across the end of the file is cut short, past it gives 0. */
+    if (pread(fd, data, 200, (long) NUM_BLOCKS * BLOCK_SIZE - 100) != 100)
+        fail("pread() across the end of the file");
+
+    if (pread(fd, data, 200, (long) NUM_BLOCKS * BLOCK_SIZE + 5000) != 0)
+        fail("pread() past the end of the file");
+
+    /* Scattered reading */
+    iov[0].iov_base = data;
+    iov[0].iov_len = 10;
+    iov[1].iov_base = data + 10;
+    iov[1].iov_len = 0;
+    iov[2].iov_base = more;
+    iov[2].iov_len = sizeof(more);
+
+    if (preadv(fd, iov, 3, 30000) != 10 + sizeof(more) || check_block(data, 30000, 10) != 0 ||
+        check_block(more, 30010, sizeof(more)) != 0)
+        fail("preadv()");
+
+    /* Writing at an offset, then gathered writing */
+    position = lseek(fd, 0, SEEK_CUR);
+
+    for (i = 0; i < (long) sizeof(more); i++)
+        more[i] = (unsigned char) i;
+
+    if (pwrite(fd, more, sizeof(more), 50000) != sizeof(more))
+        fail("pwrite()");
+
+    if (pread(fd, data, sizeof(more), 50000) != sizeof(more) || memcmp(data, more, sizeof(more)) != 0)
+        fail("reading back what pwrite() wrote");
+
+    for (i = 0; i < (long) sizeof(more); i++)
+        data[i] = pattern(50000 + i);
+
+    if (pwrite(fd, data, sizeof(more), 50000) != sizeof(more))
+        fail("pwrite()");
+
+    iov[0].iov_base = more;
+    iov[0].iov_len = 40;
+    iov[1].iov_base = more + 40;
+    iov[1].iov_len = 60;
+
+    if (pwritev(fd, iov, 2, 60000) != 100)
+        fail("pwritev()");
+
+    if (pread(fd, data, 100, 60000) != 100 || memcmp(data, more, 100) != 0)
+        fail("reading back what pwritev() wrote");
+
+    for (i = 0; i < 100; i++)
+        more[i] = pattern(60000 + i);
+
+    if (pwrite(fd, more, 100, 60000) != 100)
+        fail("pwrite()");
+
+    if (lseek(fd, 0, SEEK_CUR) != position)
+        fail("pwrite() moved the file position");
+
+    if (pread(-1, data, 10, 0) != -1 || errno != EBADF)
+        fail("pread() on an invalid descriptor");
+
+    if (pread(fd, data, 10, -1) != -1 || errno != EINVAL)
+        fail("pread() at a negative offset");
+}
+
+int
+main(int argc, char **argv) {
+    int num_threads = 4;
+    pthread_t threads[64];
+    unsigned char block[BLOCK_SIZE];
+    clock_t begin;
+    double seconds;
+    long offset;
+    int i;
+
+    if (argc > 1)
+        num_threads = atoi(argv[1]);
+    if (argc > 2)
+        reads_per_thread = atol(argv[2]);
+
+    if (num_threads < 1)
+        num_threads = 1;
+    else if (num_threads > 64)
+        num_threads = 64;
+
+    fd = open(FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        printf("can't create %s (%s)\n", FILE_PATH, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    for (offset = 0; offset < (long) NUM_BLOCKS * BLOCK_SIZE; offset += BLOCK_SIZE) {
+        for (i = 0; i < BLOCK_SIZE; i++)
+            block[i] = pattern(offset + i);
+
+        if (write(fd, block, BLOCK_SIZE) != BLOCK_SIZE) {
+            printf("can't write %s (%s)\n", FILE_PATH, strerror(errno));
+            close(fd);
+            return EXIT_FAILURE;
+        }
+    }
+
+    check_basics();
+
+    /* Random reads from all threads, and one sequential reader */
+    lseek(fd, 0, SEEK_SET);
+
+    begin = clock();
+
+    for (i = 0; i < num_threads; i++)
+        pthread_create(&threads[i], NULL, reader, (void *) (long) i);
+
+    for (offset = 0; offset < (long) NUM_BLOCKS * BLOCK_SIZE; offset += BLOCK_SIZE) {
+        if (read(fd, block, BLOCK_SIZE) != BLOCK_SIZE || check_block(block, offset, BLOCK_SIZE) != 0) {
+            fail("read() while other threads use pread()");
+            break;
+        }
+    }
+
+    for (i = 0; i < num_threads; i++)
+        pthread_join(threads[i], NULL);
+
+    seconds = (double) (clock() - begin) / CLOCKS_PER_SEC;
+    if (seconds <= 0.0)
+        seconds = 1.0 / CLOCKS_PER_SEC;
+
+    printf("%d threads, %ld random 4 KB pread() calls: %.3f s, %.0f calls/s\n",
+           num_threads, num_threads * reads_per_thread, seconds, num_threads * reads_per_thread / seconds);
+
+    close(fd);
+    remove(FILE_PATH);
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+/*
+ * Writes a file with writev() from vectors that mix large and tiny buffers,
+ * reads it back with readv() using the same layout and checks the contents.
+ * The same is then done over a socket pair. The time taken is shown, so that
+ * vectors of many small pieces can be compared with vectors of a few large
+ * ones.
+ *
+ * Usage: readv_writev_test [rounds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+
+#define FILE_PATH ("readv_writev_test.dat")
+#define DATA_SIZE 65536
+#define MAX_VECTORS 64
+
+static unsigned char data[DATA_SIZE];
+static unsigned char copy[DATA_SIZE];
+
+/* Cuts the data into 'count' pieces; 'small' makes them all tiny. */
+static size_t
+make_vector(struct iovec *iov, unsigned char *base, int count, int small, unsigned long *state) {
+    size_t offset = 0;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        size_t length;
+
+        *state = (*state) * 1103515245UL + 12345UL;
+
+        if (small)
+            length = ((*state) >> 8) % 33;
+        else
+            length = ((*state) >> 8) % 4000;
+
+        if (offset + length > DATA_SIZE)
+            length = DATA_SIZE - offset;
+
+        iov[i].iov_base = base + offset;
+        iov[i].iov_len = length;
+        offset += length;
+    }
+
+    return offset;
+}
+
+static double
+run(const char *name, int write_fd, int read_fd, int small, long rounds) {
+    struct iovec out[MAX_VECTORS], in[MAX_VECTORS];
+    unsigned long state = 1;
+    clock_t begin = clock();
+    double seconds;
+    long r;
+
+    for (r = 0; r < rounds; r++) {
+        int count = 1 + (int) (r % MAX_VECTORS);
+        unsigned long saved_state = state;
+        size_t total = make_vector(out, data, count, small, &state);
+        ssize_t result;
+
+        state = saved_state;
+        make_vector(in, copy, count, small, &state);
+
+        if (read_fd == write_fd)
+            lseek(write_fd, 0, SEEK_SET);
+
+        result = writev(write_fd, out, count);
+        if (result != (ssize_t) total) {
+            printf("FAIL: %s writev() returned %ld instead of %lu (%s)\n", name, (long) result, (unsigned long) total, strerror(errno));
+            return -1;
+        }
+
+        if (read_fd == write_fd)
+            lseek(read_fd, 0, SEEK_SET);
+
+        memset(copy, 0, total);
+
+        result = readv(read_fd, in, count);
+        if (result != (ssize_t) total || memcmp(data, copy, total) != 0) {
+            printf("FAIL: %s readv() returned %ld instead of %lu (%s)\n", name, (long) result, (unsigned long) total, strerror(errno));
+            return -1;
+        }
+    }
+
+    seconds = (double) (clock() - begin) / CLOCKS_PER_SEC;
+
+    printf("  %-28s %8ld rounds  %.3f s\n", name, rounds, seconds);
+
+    return seconds;
+}
+
+int
+main(int argc, char **argv) {
+    long rounds = 20000;
+    int sockets[2];
+    int failures = 0;
+    int fd;
+    int i;
+
+    if (argc > 1)
+        rounds = atol(argv[1]);
+
+    for (i = 0; i < DATA_SIZE; i++)
+        data[i] = (unsigned char) (i * 31 + i / 256);
+
+    fd = open(FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        printf("can't create %s (%s)\n", FILE_PATH, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    printf("File:\n");
+    failures += (run("large pieces", fd, fd, 0, rounds) < 0);
+    failures += (run("tiny pieces", fd, fd, 1, rounds) < 0);
+
+    close(fd);
+    remove(FILE_PATH);
+
+    /* Small vectors only, so that the socket buffer cannot fill up. */
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0) {
+        printf("Socket pair:\n");
+        failures += (run("tiny pieces", sockets[0], sockets[1], 1, rounds) < 0);
+
+        close(sockets[0]);
+        close(sockets[1]);
+    } else {
+        printf("no socket pair (%s), skipped\n", strerror(errno));
+    }
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,143 @@
+/*
+ * Checks that select() and poll() wait for a pipe until its time is up, and
+ * that they wake up soon after data arrives. The wake-up latency should be
+ * well below a tick, which is how often the pipe used to be polled. A
+ * descriptor which is not open makes select() fail with EBADF.
+ *
+ * > select_wait
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/select.h>
+#include <sys/time.h>
+
+static int pipe_fds[2];
+static double write_time;
+
+static double
+now(void) {
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void *
+writer(void *arg) {
+    (void) arg;
+
+    usleep(200000);
+
+    write_time = now();
+    write(pipe_fds[1], "x", 1);
+
+    return NULL;
+}
+
+int
+main(void) {
+    struct pollfd pfd[2];
+    struct timeval tv;
+    pthread_t thread;
+    double start, elapsed;
+    fd_set read_fds;
+    char c;
+    int failures = 0;
+    int closed_fd;
+    int n;
+
+    if (pipe(pipe_fds) != 0) {
+        perror("pipe");
+        return EXIT_FAILURE;
+    }
+
+    /* Nothing to read: select() has to time out after 500 ms. */
+    FD_ZERO(&read_fds);
+    FD_SET(pipe_fds[0], &read_fds);
+
+    tv.tv_sec = 0;
+    tv.tv_usec = 500000;
+
+    start = now();
+
+    n = select(pipe_fds[0] + 1, &read_fds, NULL, NULL, &tv);
+
+    elapsed = now() - start;
+
+    printf("select() timeout:  returned %d after %.0f ms\n", n, elapsed * 1000.0);
+
+    if (n != 0 || FD_ISSET(pipe_fds[0], &read_fds) || elapsed < 0.45) {
+        printf("FAIL: select() did not time out properly\n");
+        failures++;
+    }
+
+    /* Data arrives while poll() waits without a timeout. */
+    if (pthread_create(&thread, NULL, writer, NULL) != 0) {
+        printf("FAIL: could not create a thread\n");
+        return EXIT_FAILURE;
+    }
+
+    pfd[0].fd = pipe_fds[0];
+    pfd[0].events = POLLIN;
+    pfd[1].fd = 1000;
+    pfd[1].events = POLLIN;
+
+    /* The invalid descriptor would make poll() return at once; leave it
+       out while waiting. */
+    n = poll(pfd, 1, -1);
+
+    elapsed = now() - write_time;
+
+    pthread_join(thread, NULL);
+
+    printf("poll() wake-up:    returned %d after %.1f ms\n", n, elapsed * 1000.0);
+
+    if (n != 1 || (pfd[0].revents & POLLIN) == 0) {
+        printf("FAIL: poll() did not see the data\n");
+        failures++;
+    }
+
+    if (read(pipe_fds[0], &c, 1) != 1 || c != 'x') {
+        printf("FAIL: could not read the data\n");
+        failures++;
+    }
+
+    /* Now with the invalid descriptor. */
+    n = poll(pfd, 2, 0);
+    if (n != 1 || pfd[0].revents != 0 || pfd[1].revents != POLLNVAL) {
+        printf("FAIL: poll() did not flag the invalid descriptor\n");
+        failures++;
+    }
+
+    /* select() cannot report it and has to fail instead. */
+    closed_fd = dup(pipe_fds[0]);
+    close(closed_fd);
+
+    FD_ZERO(&read_fds);
+    FD_SET(pipe_fds[0], &read_fds);
+    FD_SET(closed_fd, &read_fds);
+
+    tv.tv_sec = 0;
+    tv.tv_usec = 100000;
+
+    errno = 0;
+    n = select((closed_fd > pipe_fds[0] ? closed_fd : pipe_fds[0]) + 1, &read_fds, NULL, NULL, &tv);
+    if (n != -1 || errno != EBADF || !FD_ISSET(pipe_fds[0], &read_fds)) {
+        printf("FAIL: select() accepted a closed descriptor\n");
+        failures++;
+    }
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,173 @@
+/*
+ * Measures sequential read and write speed in MB/s through stdio, once with
+ * the default buffering and once in streaming mode (the 'S' mode letter of
+ * fopen()), in which a helper process reads ahead and writes behind. Each
+ * block is run through a checksum, so that there is some work for the I/O
+ * to overlap with. The data read back has to match what was written.
+ *
+ * Usage: stream_benchmark [megabytes] [block size]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#define FILE_PATH ("stream_benchmark.dat")
+
+static unsigned long
+checksum(const unsigned char *data, size_t length, unsigned long sum) {
+    size_t i;
+
+    for (i = 0; i < length; i++)
+        sum = (sum << 5) + sum + data[i];
+
+    return sum;
+}
+
+static double
+elapsed(clock_t begin) {
+    double seconds = (double) (clock() - begin) / CLOCKS_PER_SEC;
+
+    if (seconds <= 0.0)
+        seconds = 1.0 / CLOCKS_PER_SEC;
+
+    return seconds;
+}
+
+static int
+write_file(const char *mode, unsigned char *block, size_t block_size, long num_blocks, unsigned long *sum) {
+    clock_t begin;
+    FILE *out;
+    long i;
+    size_t j;
+
+    out = fopen(FILE_PATH, mode);
+    if (out == NULL) {
+        printf("can't create %s (%s)\n", FILE_PATH, strerror(errno));
+        return -1;
+    }
+
+    begin = clock();
+
+    (*sum) = 0;
+
+    for (i = 0; i < num_blocks; i++) {
+        for (j = 0; j < block_size; j++)
+            block[j] = (unsigned char) (i + j * 13);
+
+        (*sum) = checksum(block, block_size, *sum);
+
+        if (fwrite(block, block_size, 1, out) != 1) {
+            printf("FAIL: fwrite() in mode \"%s\" (%s)\n", mode, strerror(errno));
+            fclose(out);
+            return -1;
+        }
+    }
+
+    if (fclose(out) != 0) {
+        printf("FAIL: fclose() in mode \"%s\" (%s)\n", mode, strerror(errno));
+        return -1;
+    }
+
+    printf("  write, mode \"%s\": %8.2f MB/s\n", mode,
+           (double) block_size * num_blocks / (1024.0 * 1024.0) / elapsed(begin));
+
+    return 0;
+}
+
+static int
+read_file(const char *mode, unsigned char *block, size_t block_size, long num_blocks, unsigned long expected_sum) {
+    unsigned long sum = 0;
+    clock_t begin;
+    FILE *in;
+    long i;
+
+    in = fopen(FILE_PATH, mode);
+    if (in == NULL) {
+        printf("can't open %s (%s)\n", FILE_PATH, strerror(errno));
+        return -1;
+    }
+
+    begin = clock();
+
+    for (i = 0; i < num_blocks; i++) {
+        if (fread(block, block_size, 1, in) != 1) {
+            printf("FAIL: fread() in mode \"%s\" (%s)\n", mode, strerror(errno));
+            fclose(in);
+            return -1;
+        }
+
+        sum = checksum(block, block_size, sum);
+
+        /* ftell() must not get in the way of reading ahead. */
+        if ((i % 64) == 0 && ftell(in) != (long) ((i + 1) * block_size)) {
+            printf("FAIL: ftell() in mode \"%s\" returned %ld\n", mode, ftell(in));
+            fclose(in);
+            return -1;
+        }
+    }
+
+    if (getc(in) != EOF || !feof(in)) {
+        printf("FAIL: no end of file in mode \"%s\"\n", mode);
+        fclose(in);
+        return -1;
+    }
+
+    fclose(in);
+
+    if (sum != expected_sum) {
+        printf("FAIL: data read in mode \"%s\" does not match\n", mode);
+        return -1;
+    }
+
+    printf("  read,  mode \"%s\": %8.2f MB/s\n", mode,
+           (double) block_size * num_blocks / (1024.0 * 1024.0) / elapsed(begin));
+
+    return 0;
+}
+
+int
+main(int argc, char **argv) {
+    size_t block_size = 4096;
+    long megabytes = 32;
+    unsigned char *block;
+    unsigned long sum;
+    long num_blocks;
+    int failures = 0;
+
+    if (argc > 1)
+        megabytes = atol(argv[1]);
+    if (argc > 2)
+        block_size = (size_t) atol(argv[2]);
+
+    if (megabytes < 1)
+        megabytes = 1;
+    if (block_size < 1)
+        block_size = 1;
+
+    num_blocks = (long) (megabytes * 1024 * 1024 / block_size);
+
+    block = malloc(block_size);
+    if (block == NULL) {
+        printf("out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%ld MB in blocks of %lu bytes:\n", megabytes, (unsigned long) block_size);
+
+    failures += (write_file("wb", block, block_size, num_blocks, &sum) < 0);
+    failures += (read_file("rb", block, block_size, num_blocks, sum) < 0);
+
+    failures += (write_file("wbS", block, block_size, num_blocks, &sum) < 0);
+    failures += (read_file("rbS", block, block_size, num_blocks, sum) < 0);
+
+    remove(FILE_PATH);
+
+    free(block);
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
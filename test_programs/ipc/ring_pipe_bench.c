@@ -0,0 +1,317 @@
+/*
+ * Checks pipe() and socketpair(AF_UNIX, SOCK_STREAM, ...) between threads,
+ * then measures how many bytes per second go through each of them, and how
+ * long a one byte ping-pong round trip over a socket pair takes.
+ *
+ * > ring_pipe_bench [megabytes] [round trips]
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+
+#define CHUNK_SIZE 16384
+
+static long num_megabytes = 64;
+static long num_round_trips = 20000;
+static int failures;
+
+#define CHECK(c) do { if (!(c)) { printf("FAIL line %d: %s\n", __LINE__, #c); failures++; } } while (0)
+
+static double
+now(void) {
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void *
+blocked_reader(void *arg) {
+    char c;
+
+    return (void *) (long) read(*(int *) arg, &c, 1);
+}
+
+static void
+check_semantics(void) {
+    struct pollfd pfd[2];
+    struct iovec iov[2];
+    struct msghdr msg;
+    struct sockaddr sa;
+    socklen_t len;
+    pthread_t thread;
+    void *thread_result;
+    char buf[600];
+    int fds[2];
+    int dup_fds[2];
+    int value;
+    int n;
+
+    /* Data arrives in order, and EOF follows the writer closing. */
+    CHECK(pipe(fds) == 0);
+    CHECK(write(fds[1], "hello", 5) == 5);
+    CHECK(write(fds[1], " world", 6) == 6);
+    CHECK(read(fds[0], buf, sizeof(buf)) == 11 && memcmp(buf, "hello world", 11) == 0);
+
+    pfd[0].fd = fds[0];
+    pfd[0].events = POLLIN;
+    pfd[1].fd = fds[1];
+    pfd[1].events = POLLOUT;
+    CHECK(poll(pfd, 2, 0) == 1 && pfd[0].revents == 0 && (pfd[1].revents & POLLOUT) != 0);
+
+    CHECK(write(fds[1], "x", 1) == 1);
+    CHECK(poll(pfd, 1, 100) == 1 && (pfd[0].revents & POLLIN) != 0);
+    CHECK(read(fds[0], buf, 1) == 1);
+
+    CHECK(close(fds[1]) == 0);
+    CHECK(poll(pfd, 1, 100) == 1 && (pfd[0].revents & (POLLIN | POLLHUP)) != 0);
+    CHECK(read(fds[0], buf, sizeof(buf)) == 0);
+    CHECK(close(fds[0]) == 0);
+
+    /* Nobody is left to read. */
+    CHECK(pipe(fds) == 0);
+    CHECK(close(fds[0]) == 0);
+    CHECK(write(fds[1], "x", 1) == -1 && errno == EPIPE);
+    CHECK(close(fds[1]) == 0);
+
+    /* Non-blocking ends. */
+    CHECK(pipe2(fds, O_NONBLOCK) == 0);
+    CHECK(read(fds[0], buf, sizeof(buf)) == -1 && errno == EAGAIN);
+
+    memset(buf, 'x', sizeof(buf));
+    while ((n = write(fds[1], buf, sizeof(buf))) > 0)
+        continue;
+
+    CHECK(n == -1 && errno == EAGAIN);
+    CHECK(close(fds[0]) == 0 && close(fds[1]) == 0);
+
+    /* Both ends of a socket pair can be written to. */
+    CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    CHECK(send(fds[0], "ping", 4, 0) == 4);
+    CHECK(recv(fds[1], buf, sizeof(buf), MSG_PEEK) == 4);
+    CHECK(recv(fds[1], buf, sizeof(buf), 0) == 4 && memcmp(buf, "ping", 4) == 0);
+    CHECK(recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT) == -1 && errno == EAGAIN);
+    CHECK(write(fds[1], "pong", 4) == 4);
+    CHECK(read(fds[0], buf, sizeof(buf)) == 4 && memcmp(buf, "pong", 4) == 0);
+
+    CHECK(shutdown(fds[1], SHUT_WR) == 0);
+    CHECK(recv(fds[0], buf, sizeof(buf), 0) == 0);
+    CHECK(send(fds[0], "x", 1, 0) == 1);
+    CHECK(recv(fds[1], buf, sizeof(buf), 0) == 1);
+    CHECK(close(fds[0]) == 0 && close(fds[1]) == 0);
+
+    /* The other socket calls work on a socket pair, too. */
+    CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    CHECK(sendto(fds[0], "abc", 3, 0, NULL, 0) == 3);
+    len = sizeof(sa);
+    CHECK(recvfrom(fds[1], buf, sizeof(buf), 0, &sa, &len) == 3 && len == 0);
+
+    memset(&msg, 0, sizeof(msg));
+    iov[0].iov_base = (void *) "he";
+    iov[0].iov_len = 2;
+    iov[1].iov_base = (void *) "llo";
+    iov[1].iov_len = 3;
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+    CHECK(sendmsg(fds[1], &msg, 0) == 5);
+
+    memset(buf, 0, sizeof(buf));
+    iov[0].iov_base = buf;
+    iov[0].iov_len = 1;
+    iov[1].iov_base = buf + 1;
+    iov[1].iov_len = 10;
+    CHECK(recvmsg(fds[0], &msg, 0) == 5 && memcmp(buf, "hello", 5) == 0);
+
+    len = sizeof(value);
+    CHECK(getsockopt(fds[0], SOL_SOCKET, SO_TYPE, &value, &len) == 0 && value == SOCK_STREAM);
+    value = 4096;
+    CHECK(setsockopt(fds[0], SOL_SOCKET, SO_RCVBUF, &value, sizeof(value)) == 0);
+    CHECK(getsockopt(fds[0], IPPROTO_TCP, 1, &value, &len) == -1 && errno == EOPNOTSUPP);
+
+    len = sizeof(sa);
+    CHECK(getsockname(fds[0], &sa, &len) == 0 && sa.sa_family == AF_LOCAL);
+    len = sizeof(sa);
+    CHECK(getpeername(fds[1], &sa, &len) == 0 && sa.sa_family == AF_LOCAL);
+    CHECK(close(fds[0]) == 0 && close(fds[1]) == 0);
+
+    /* Duplicated ends refer to the same pipe, also once the originals are closed. */
+    CHECK(pipe(fds) == 0);
+    dup_fds[0] = dup(fds[0]);
+    dup_fds[1] = dup(fds[1]);
+    CHECK(dup_fds[0] >= 0 && dup_fds[1] >= 0);
+    CHECK(write(dup_fds[1], "dup", 3) == 3);
+
+    pfd[0].fd = dup_fds[0];
+    pfd[0].events = POLLIN;
+    CHECK(poll(pfd, 1, 100) == 1 && (pfd[0].revents & POLLIN) != 0);
+    CHECK(read(dup_fds[0], buf, sizeof(buf)) == 3 && memcmp(buf, "dup", 3) == 0);
+
+    CHECK(close(fds[0]) == 0 && close(fds[1]) == 0);
+    CHECK(write(dup_fds[1], "x", 1) == 1);
+    CHECK(read(dup_fds[0], buf, sizeof(buf)) == 1);
+
+    /* A reader blocked on the descriptor must not keep others from polling it. */
+    CHECK(pthread_create(&thread, NULL, blocked_reader, &dup_fds[0]) == 0);
+    usleep(100000);
+
+    pfd[0].fd = dup_fds[0];
+    pfd[0].events = POLLIN;
+    CHECK(poll(pfd, 1, 0) == 0);
+
+    CHECK(write(dup_fds[1], "x", 1) == 1);
+    pthread_join(thread, &thread_result);
+    CHECK(thread_result == (void *) 1L);
+
+    CHECK(close(dup_fds[0]) == 0 && close(dup_fds[1]) == 0);
+}
+
+/****************************************************************************/
+
+struct transfer {
+    int fd;
+    long num_bytes;
+    long num_done;
+};
+
+static void *
+writer(void *arg) {
+    struct transfer *t = arg;
+    static char buf[CHUNK_SIZE];
+    long left = t->num_bytes;
+    int n;
+
+    memset(buf, 0x5a, sizeof(buf));
+
+    while (left > 0) {
+        n = write(t->fd, buf, (left < CHUNK_SIZE) ? left : CHUNK_SIZE);
+        if (n <= 0)
+            break;
+
+        left -= n;
+    }
+
+    t->num_done = t->num_bytes - left;
+
+    return NULL;
+}
+
+static void
+measure_throughput(const char *name, int fds[2]) {
+    struct transfer t;
+    static char buf[CHUNK_SIZE];
+    pthread_t thread;
+    double start, elapsed;
+    long total = 0;
+    int n;
+
+    t.fd = fds[1];
+    t.num_bytes = num_megabytes * 1024 * 1024;
+    t.num_done = 0;
+
+    start = now();
+
+    CHECK(pthread_create(&thread, NULL, writer, &t) == 0);
+
+    while (total < t.num_bytes) {
+        n = read(fds[0], buf, sizeof(buf));
+        if (n <= 0)
+            break;
+
+        total += n;
+    }
+
+    pthread_join(thread, NULL);
+
+    elapsed = now() - start;
+
+    CHECK(total == t.num_bytes && t.num_done == t.num_bytes);
+
+    printf("%-11s %ld MB in %.2f s, %.1f MB/s\n", name, total / (1024 * 1024), elapsed, total / elapsed / (1024 * 1024));
+}
+
+/****************************************************************************/
+
+static void *
+echo(void *arg) {
+    int fd = *(int *) arg;
+    char c;
+
+    while (recv(fd, &c, 1, 0) == 1) {
+        if (send(fd, &c, 1, 0) != 1)
+            break;
+    }
+
+    return NULL;
+}
+
+static void
+measure_latency(void) {
+    pthread_t thread;
+    double start, elapsed;
+    int fds[2];
+    long i;
+    char c = 'x';
+
+    CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    CHECK(pthread_create(&thread, NULL, echo, &fds[1]) == 0);
+
+    start = now();
+
+    for (i = 0; i < num_round_trips; i++) {
+        if (send(fds[0], &c, 1, 0) != 1 || recv(fds[0], &c, 1, 0) != 1)
+            break;
+    }
+
+    elapsed = now() - start;
+
+    CHECK(i == num_round_trips);
+
+    /* The echo thread sees the end of the stream. */
+    close(fds[0]);
+    pthread_join(thread, NULL);
+    close(fds[1]);
+
+    printf("ping-pong:  %ld round trips in %.2f s, %.1f us each\n", i, elapsed, elapsed * 1000000.0 / i);
+}
+
+/****************************************************************************/
+
+int
+main(int argc, char **argv) {
+    int fds[2];
+
+    if (argc > 1)
+        num_megabytes = atol(argv[1]);
+
+    if (argc > 2)
+        num_round_trips = atol(argv[2]);
+
+    check_semantics();
+
+    CHECK(pipe(fds) == 0);
+    measure_throughput("pipe:", fds);
+    close(fds[0]);
+    close(fds[1]);
+
+    CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    measure_throughput("socketpair:", fds);
+    close(fds[0]);
+    close(fds[1]);
+
+    measure_latency();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+/*
+ * Multi-threaded malloc()/free() throughput benchmark.
+ *
+ * Every thread runs a tight loop of small allocation/free pairs, keeping a
+ * small window of live blocks so that the allocator cannot just hand back
+ * the same pointer over and over. The total number of operations per second
+ * is printed for an increasing number of threads.
+ *
+ * > malloc_threads_benchmark [MAX_THREADS] [ITERATIONS]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#define WINDOW 64
+
+static int MAX_THREADS = 16;
+static int ITERATIONS = 1000000;
+
+static void *
+worker(void *arg) {
+    uintptr_t seed = (uintptr_t) arg * 2654435761UL + 1;
+    void *window[WINDOW];
+    int i;
+
+    memset(window, 0, sizeof(window));
+
+    for (i = 0; i < ITERATIONS; i++) {
+        int slot;
+        size_t size;
+
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+
+        slot = seed % WINDOW;
+        size = 8 + (seed >> 8) % 248;
+
+        free(window[slot]);
+        window[slot] = malloc(size);
+        if (window[slot] != NULL)
+            *(char *) window[slot] = (char) i;
+    }
+
+    for (i = 0; i < WINDOW; i++)
+        free(window[i]);
+
+    return NULL;
+}
+
+static double
+run(int nthreads) {
+    pthread_t threads[nthreads];
+    struct timeval start, end;
+    double elapsed;
+    int i;
+
+    gettimeofday(&start, NULL);
+
+    for (i = 0; i < nthreads; i++)
+        pthread_create(&threads[i], NULL, worker, (void *) (uintptr_t) (i + 1));
+
+    for (i = 0; i < nthreads; i++)
+        pthread_join(threads[i], NULL);
+
+    gettimeofday(&end, NULL);
+
+    elapsed = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1000000.0;
+
+    return elapsed;
+}
+
+int
+main(int argc, char **argv) {
+    int nthreads;
+
+    if (argc >= 2) {
+        int n = atoi(argv[1]);
+        if (n > 0) MAX_THREADS = n;
+    }
+    if (argc >= 3) {
+        int n = atoi(argv[2]);
+        if (n > 0) ITERATIONS = n;
+    }
+
+    printf("%8s %12s %16s\n", "threads", "seconds", "ops/sec");
+
+    for (nthreads = 1; nthreads <= MAX_THREADS; nthreads *= 2) {
+        double elapsed = run(nthreads);
+        double ops = 2.0 * nthreads * ITERATIONS;
+
+        printf("%8d %12.3f %16.0f\n", nthreads, elapsed, elapsed > 0 ? ops / elapsed : 0);
+    }
+
+    return 0;
+}
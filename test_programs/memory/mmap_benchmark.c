@@ -0,0 +1,147 @@
+/*
+ * mmap() benchmark: time to first byte and memory cost of a large mapping.
+ *
+ * A scratch file of the requested size is created first. It is then mapped
+ * read-only and the time until mmap() returns (and the first byte can be
+ * read) is compared against a plain malloc()+read() of the same data. The
+ * amount of free system memory is sampled before and while the mapping is
+ * alive to show its peak cost.
+ *
+ * > mmap_benchmark [SIZE_IN_MB] [FILE]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+
+#ifdef __amigaos4__
+#include <proto/exec.h>
+#endif
+
+static double
+now(void) {
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static unsigned long
+free_memory(void) {
+#ifdef __amigaos4__
+    return AvailMem(MEMF_ANY);
+#else
+    return 0;
+#endif
+}
+
+static int
+create_file(const char *name, size_t size) {
+    static char buffer[64 * 1024];
+    size_t written = 0;
+    size_t i;
+    int fd;
+
+    fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return -1;
+
+    for (i = 0; i < sizeof(buffer); i++)
+        buffer[i] = (char) (i * 31 + 7);
+
+    while (written < size) {
+        size_t n = size - written;
+
+        if (n > sizeof(buffer))
+            n = sizeof(buffer);
+
+        if (write(fd, buffer, n) != (ssize_t) n) {
+            close(fd);
+            return -1;
+        }
+
+        written += n;
+    }
+
+    return close(fd);
+}
+
+int
+main(int argc, char **argv) {
+    const char *name = "T:mmap_benchmark.tmp";
+    size_t size = 64 * 1024 * 1024;
+    unsigned long before, during;
+    double start, first_byte;
+    volatile char c;
+    char *data;
+    int fd;
+
+    if (argc >= 2 && atoi(argv[1]) > 0)
+        size = (size_t) atoi(argv[1]) * 1024 * 1024;
+    if (argc >= 3)
+        name = argv[2];
+
+    printf("Creating %lu MB test file %s\n", (unsigned long) (size >> 20), name);
+
+    if (create_file(name, size) < 0) {
+        perror("create_file");
+        return 1;
+    }
+
+    fd = open(name, O_RDONLY);
+    if (fd < 0) {
+        perror("open");
+        return 1;
+    }
+
+    /* mmap() */
+    before = free_memory();
+    start = now();
+
+    data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    c = data[0];
+    first_byte = now() - start;
+    during = free_memory();
+
+    printf("%-16s time to first byte %8.3f s, peak memory %8lu KB\n", "mmap()", first_byte, (before - during) >> 10);
+
+    start = now();
+    munmap(data, size);
+    printf("%-16s %8.3f s\n", "munmap()", now() - start);
+
+    /* malloc() + read() */
+    lseek(fd, 0, SEEK_SET);
+
+    before = free_memory();
+    start = now();
+
+    data = calloc(1, size);
+    if (data == NULL || read(fd, data, size) != (ssize_t) size) {
+        perror("read");
+        return 1;
+    }
+
+    c = data[0];
+    first_byte = now() - start;
+    during = free_memory();
+
+    printf("%-16s time to first byte %8.3f s, peak memory %8lu KB\n", "calloc()+read()", first_byte, (before - during) >> 10);
+
+    free(data);
+    close(fd);
+    unlink(name);
+
+    (void) c;
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * MAP_SHARED write-back test.
+ *
+ * Maps a file at a page aligned offset, modifies it through the mapping and
+ * checks that msync() and munmap() write every change back, that data past
+ * the end of the file reads as zero and that invalid arguments are rejected.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#define FILE_NAME "T:mmap_shared.tmp"
+
+static int failures;
+
+#define CHECK(cond) \
+    do { if (!(cond)) { printf("FAILED: %s (line %d)\n", #cond, __LINE__); failures++; } } while (0)
+
+int
+main(void) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    size_t file_size = 3 * page_size + 100;
+    char *buffer, *map;
+    size_t i;
+    int fd;
+
+    buffer = malloc(file_size);
+    for (i = 0; i < file_size; i++)
+        buffer[i] = (char) ('a' + i % 26);
+
+    /* A truncated existing file would be locked exclusively */
+    unlink(FILE_NAME);
+
+    fd = open(FILE_NAME, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || write(fd, buffer, file_size) != (ssize_t) file_size) {
+        perror(FILE_NAME);
+        return 1;
+    }
+
+    /* Invalid arguments */
+    errno = 0;
+    CHECK(mmap(NULL, page_size, PROT_READ, MAP_SHARED, fd, 1) == MAP_FAILED && errno == EINVAL);
+    errno = 0;
+    CHECK(mmap(NULL, 0, PROT_READ, MAP_SHARED, fd, 0) == MAP_FAILED && errno == EINVAL);
+    errno = 0;
+    CHECK(mmap(NULL, page_size, PROT_READ, 0, fd, 0) == MAP_FAILED && errno == EINVAL);
+    errno = 0;
+    CHECK(mmap(NULL, page_size, PROT_READ, MAP_SHARED, -1, 0) == MAP_FAILED && errno == EBADF);
+
+    /* Map everything but the first page; the mapping runs past the end of the file */
+    map = mmap(NULL, 3 * page_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, page_size);
+    CHECK(map != MAP_FAILED);
+    if (map == MAP_FAILED)
+        return 1;
+
+    CHECK(memcmp(map, buffer + page_size, file_size - page_size) == 0);
+    for (i = file_size - page_size; i < 3 * (size_t) page_size; i++) {
+        if (map[i] != 0) {
+            CHECK(map[i] == 0);
+            break;
+        }
+    }
+
+    /* The descriptor's file position must not move */
+    CHECK(lseek(fd, 0, SEEK_CUR) == (off_t) file_size);
+
+    /* Change the second mapped page and sync it */
+    memset(map + page_size, 'X', 16);
+    memcpy(buffer + 2 * page_size, map + page_size, 16);
+    CHECK(msync(map, 3 * page_size, MS_SYNC) == 0);
+
+    /* Edits which cancel out in any sum must be written back, too */
+    {
+        unsigned int *word = (unsigned int *) (map + 2 * page_size);
+
+        word[0] += 1;
+        word[1] -= 2;
+        word[2] += 1;
+        memcpy(buffer + 3 * page_size, word, 3 * sizeof(*word));
+    }
+    CHECK(msync(map, 3 * page_size, MS_SYNC) == 0);
+
+    /* Change the first mapped page and the tail, then unmap */
+    map[0] = 'Y';
+    buffer[page_size] = 'Y';
+    map[file_size - page_size] = 'Z'; /* beyond end of file: must not be written */
+
+    close(fd);
+
+    CHECK(munmap(map, 3 * page_size) == 0);
+
+    fd = open(FILE_NAME, O_RDONLY);
+    {
+        char *check = malloc(file_size + 1);
+        ssize_t n = read(fd, check, file_size + 1);
+
+        CHECK(n == (ssize_t) file_size);
+        CHECK(memcmp(check, buffer, file_size) == 0);
+
+        free(check);
+    }
+    close(fd);
+
+    /* Anonymous mappings are zero filled */
+    map = mmap(NULL, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    CHECK(map != MAP_FAILED && map[0] == 0 && map[page_size - 1] == 0);
+    CHECK(munmap(map, page_size) == 0);
+
+    unlink(FILE_NAME);
+    free(buffer);
+
+    printf("%s\n", failures == 0 ? "All tests passed" : "Some tests FAILED");
+
+    return failures != 0;
+}
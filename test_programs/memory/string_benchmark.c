@@ -26,12 +26,18 @@ the Free Software Foundation, 59 Temple Place - Suite 330,
 Boston, MA 02111-1307, USA.  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stddef.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
 
+#ifdef __amigaos4__
+#include <proto/exec.h>
+#endif
+
 void bench_string();
+void bench_sizes();
 
 #define MAX_LENGTH 64
 #define TIMES 10000000
@@ -68,9 +74,108 @@ bench_string() {
     printf("%lf secs\n", time_spent);
 }
 
+/* Per-call cost of the single string functions for sizes from 1 byte up to
+   64 KB. Each measurement touches roughly the same amount of memory. */
+#define MIN_SIZE 1
+#define MAX_SIZE (64 * 1024)
+#define BYTES_PER_RUN (32 * 1024 * 1024)
+
+enum { F_MEMSET, F_MEMCPY, F_MEMCMP, F_MEMCHR, F_STRLEN, F_STRCHR, F_STRRCHR, F_STRCMP, F_STRNCMP, F_STRCPY, F_COUNT };
+
+static const char *function_names[F_COUNT] = {
+    "memset", "memcpy", "memcmp", "memchr", "strlen", "strchr", "strrchr", "strcmp", "strncmp", "strcpy"
+};
+
+static double cpu_hz;
+
+static volatile size_t sink;
+
+static double
+run_function(int function, char *a, char *b, size_t size, long calls) {
+    clock_t begin, end;
+    long i;
+
+    /* Strings of "size" characters, terminated right after */
+    memset(a, 'x', size);
+    memset(b, 'x', size);
+    a[size] = b[size] = '\0';
+
+    begin = clock();
+
+    for (i = 0; i < calls; i++) {
+        switch (function) {
+            case F_MEMSET:  memset(a, 'x', size); break;
+            case F_MEMCPY:  memcpy(b, a, size); break;
+            case F_MEMCMP:  sink += memcmp(a, b, size); break;
+            case F_MEMCHR:  sink += (size_t) memchr(a, 'y', size); break;
+            case F_STRLEN:  sink += strlen(a); break;
+            case F_STRCHR:  sink += (size_t) strchr(a, 'y'); break;
+            case F_STRRCHR: sink += (size_t) strrchr(a, 'y'); break;
+            case F_STRCMP:  sink += strcmp(a, b); break;
+            case F_STRNCMP: sink += strncmp(a, b, size + 1); break;
+            case F_STRCPY:  strcpy(b, a); break;
+        }
+    }
+
+    end = clock();
+
+    return (double) (end - begin) / CLOCKS_PER_SEC / calls;
+}
+
+void
+bench_sizes() {
+    char *a = malloc(MAX_SIZE + 1);
+    char *b = malloc(MAX_SIZE + 1);
+    size_t size;
+    int f;
+
+    if (a == NULL || b == NULL) {
+        printf("Not enough memory\n");
+        goto out;
+    }
+
+    printf("%8s", "size");
+    for (f = 0; f < F_COUNT; f++)
+        printf(" %9s", function_names[f]);
+    printf("\n");
+
+    for (size = MIN_SIZE; size <= MAX_SIZE; size *= 2) {
+        long calls = BYTES_PER_RUN / size;
+
+        if (calls > 1000000)
+            calls = 1000000;
+
+        printf("%8lu", (unsigned long) size);
+
+        for (f = 0; f < F_COUNT; f++) {
+            double seconds = run_function(f, a, b, size, calls);
+
+            /* Cycles if the CPU speed is known, nanoseconds otherwise */
+            if (cpu_hz > 0)
+                printf(" %9.1f", seconds * cpu_hz);
+            else
+                printf(" %9.1f", seconds * 1e9);
+        }
+
+        printf("\n");
+    }
+
+out:
+
+    free(a);
+    free(b);
+}
+
 /* Main, run the benchmarks.  */
 int
 main() {
+#ifdef __amigaos4__
+    uint64 speed = 0;
+
+    GetCPUInfoTags(GCIT_ProcessorSpeed, &speed, TAG_DONE);
+    cpu_hz = (double) speed;
+#endif
+
 #ifndef NEWLIB
     disableOptimizedFunctions();
 #endif
@@ -84,5 +189,17 @@ main() {
     bench_string();
 #endif
 
+    printf("\n%s per call:\n", cpu_hz > 0 ? "Cycles" : "Nanoseconds");
+
+#ifndef NEWLIB
+    disableOptimizedFunctions();
+    printf("\nWithout optimized functions\n");
+    bench_sizes();
+
+    enableOptimizedFunctions();
+    printf("\nWith optimized functions\n");
+#endif
+    bench_sizes();
+
     return 0;
 }
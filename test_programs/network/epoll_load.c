@@ -0,0 +1,270 @@
+/*
+ * Puts many socket pairs on an epoll interest list, checks level-triggered,
+ * edge-triggered and one-shot reporting, and then measures how many events
+ * per second epoll_wait() delivers, compared with poll() on the same set.
+ *
+ * > epoll_load [pairs] [rounds]
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+static int num_pairs = 200;
+static int num_rounds = 20000;
+static int (*pairs)[2];
+static int failures;
+
+#define CHECK(c) do { if (!(c)) { printf("FAIL line %d: %s\n", __LINE__, #c); failures++; } } while (0)
+
+static double
+now(void) {
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void
+drain(int i) {
+    char buf[256];
+
+    while (recv(pairs[i][0], buf, sizeof(buf), MSG_DONTWAIT) > 0)
+        continue;
+}
+
+static int
+has_event(const struct epoll_event *events, int n, int i) {
+    while (n-- > 0) {
+        if (events[n].data.u32 == (uint32_t) i)
+            return 1;
+    }
+
+    return 0;
+}
+
+int
+main(int argc, char **argv) {
+    struct epoll_event ev, events[64];
+    struct pollfd *pfds;
+    double start, elapsed;
+    long num_events;
+    char buf[64];
+    int ep, i, n, r, k;
+
+    if (argc > 1)
+        num_pairs = atoi(argv[1]);
+
+    if (argc > 2)
+        num_rounds = atoi(argv[2]);
+
+    if (num_pairs < 40) {
+        printf("need at least 40 pairs\n");
+        return EXIT_FAILURE;
+    }
+
+    pairs = calloc(num_pairs, sizeof(*pairs));
+    pfds = calloc(num_pairs, sizeof(*pfds));
+    if (pairs == NULL || pfds == NULL) {
+        printf("out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < num_pairs; i++) {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pairs[i]) != 0) {
+            perror("socketpair");
+            return EXIT_FAILURE;
+        }
+    }
+
+    CHECK(epoll_create(0) == -1 && errno == EINVAL);
+
+    ep = epoll_create1(0);
+    if (ep < 0) {
+        perror("epoll_create1");
+        return EXIT_FAILURE;
+    }
+
+    /* Pairs 0-9 are edge-triggered, 10-19 one-shot. */
+    for (i = 0; i < num_pairs; i++) {
+        ev.events = EPOLLIN;
+        if (i < 10)
+            ev.events |= EPOLLET;
+        else if (i < 20)
+            ev.events |= EPOLLONESHOT;
+
+        ev.data.u32 = i;
+
+        CHECK(epoll_ctl(ep, EPOLL_CTL_ADD, pairs[i][0], &ev) == 0);
+    }
+
+    CHECK(epoll_ctl(ep, EPOLL_CTL_ADD, pairs[0][0], &ev) == -1 && errno == EEXIST);
+    CHECK(epoll_ctl(ep, EPOLL_CTL_ADD, ep, &ev) == -1 && errno == EINVAL);
+    CHECK(epoll_wait(ep, events, 64, 0) == 0);
+
+    /* Level-triggered: reported until the data is read. */
+    send(pairs[30][1], "x", 1, 0);
+    send(pairs[num_pairs - 1][1], "x", 1, 0);
+
+    n = epoll_wait(ep, events, 64, 100);
+    CHECK(n == 2 && has_event(events, n, 30) && has_event(events, n, num_pairs - 1));
+    CHECK(epoll_wait(ep, events, 64, 0) == 2);
+
+    drain(30);
+    drain(num_pairs - 1);
+
+    CHECK(epoll_wait(ep, events, 64, 0) == 0);
+
+    /* Edge-triggered: reported once, again when more data arrives, and
+       again when data arrives after everything was read, even before the
+       next call. */
+    send(pairs[5][1], "x", 1, 0);
+
+    n = epoll_wait(ep, events, 64, 0);
+    CHECK(n == 1 && events[0].data.u32 == 5);
+    CHECK(epoll_wait(ep, events, 64, 0) == 0);
+
+    send(pairs[5][1], "x", 1, 0);
+
+    n = epoll_wait(ep, events, 64, 0);
+    CHECK(n == 1 && events[0].data.u32 == 5);
+    CHECK(epoll_wait(ep, events, 64, 0) == 0);
+
+    drain(5);
+    send(pairs[5][1], "x", 1, 0);
+
+    n = epoll_wait(ep, events, 64, 0);
+    CHECK(n == 1 && events[0].data.u32 == 5);
+
+    drain(5);
+    CHECK(epoll_wait(ep, events, 64, 0) == 0);
+
+    send(pairs[5][1], "x", 1, 0);
+
+    n = epoll_wait(ep, events, 64, 0);
+    CHECK(n == 1 && events[0].data.u32 == 5);
+
+    drain(5);
+
+    /* Edge-triggered output: a writable socket is reported once. */
+    ev.events = EPOLLOUT | EPOLLET;
+    ev.data.u32 = 6;
+    CHECK(epoll_ctl(ep, EPOLL_CTL_MOD, pairs[6][0], &ev) == 0);
+
+    n = epoll_wait(ep, events, 64, 0);
+    CHECK(n == 1 && events[0].data.u32 == 6 && events[0].events == EPOLLOUT);
+    CHECK(epoll_wait(ep, events, 64, 0) == 0);
+
+    ev.events = EPOLLIN | EPOLLET;
+    CHECK(epoll_ctl(ep, EPOLL_CTL_MOD, pairs[6][0], &ev) == 0);
+
+    /* One-shot: reported once, until EPOLL_CTL_MOD. */
+    send(pairs[15][1], "x", 1, 0);
+
+    n = epoll_wait(ep, events, 64, 0);
+    CHECK(n == 1 && events[0].data.u32 == 15);
+    CHECK(epoll_wait(ep, events, 64, 0) == 0);
+
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.u32 = 15;
+    CHECK(epoll_ctl(ep, EPOLL_CTL_MOD, pairs[15][0], &ev) == 0);
+
+    n = epoll_wait(ep, events, 64, 0);
+    CHECK(n == 1 && events[0].data.u32 == 15);
+
+    drain(15);
+
+    /* Removed from the list. */
+    send(pairs[25][1], "x", 1, 0);
+
+    CHECK(epoll_ctl(ep, EPOLL_CTL_DEL, pairs[25][0], NULL) == 0);
+    CHECK(epoll_ctl(ep, EPOLL_CTL_DEL, pairs[25][0], NULL) == -1 && errno == ENOENT);
+    CHECK(epoll_wait(ep, events, 64, 0) == 0);
+
+    drain(25);
+
+    ev.events = EPOLLIN;
+    ev.data.u32 = 25;
+    CHECK(epoll_ctl(ep, EPOLL_CTL_ADD, pairs[25][0], &ev) == 0);
+
+    /* A closed socket drops off the list by itself. */
+    close(pairs[num_pairs - 1][0]);
+    close(pairs[num_pairs - 1][1]);
+
+    CHECK(epoll_wait(ep, events, 64, 0) == 0);
+
+    send(pairs[num_pairs - 2][1], "x", 1, 0);
+
+    n = epoll_wait(ep, events, 64, 0);
+    CHECK(n == 1 && events[0].data.u32 == (uint32_t) (num_pairs - 2));
+
+    drain(num_pairs - 2);
+
+    num_pairs--;
+
+    /* Load: one level-triggered pair after another becomes readable. */
+    num_events = 0;
+    start = now();
+
+    for (r = 0; r < num_rounds; r++) {
+        send(pairs[20 + (r * 37) % (num_pairs - 20)][1], "x", 1, 0);
+
+        n = epoll_wait(ep, events, 64, -1);
+
+        for (k = 0; k < n; k++) {
+            recv(pairs[events[k].data.u32][0], buf, sizeof(buf), 0);
+            num_events++;
+        }
+    }
+
+    elapsed = now() - start;
+
+    printf("epoll_wait(): %d pairs, %ld events in %.2f s, %.0f events/s\n", num_pairs, num_events, elapsed, num_events / elapsed);
+
+    CHECK(num_events == num_rounds);
+
+    /* The same with poll(), which has to look at every descriptor. */
+    for (i = 0; i < num_pairs; i++) {
+        pfds[i].fd = pairs[i][0];
+        pfds[i].events = POLLIN;
+    }
+
+    num_events = 0;
+    start = now();
+
+    for (r = 0; r < num_rounds; r++) {
+        send(pairs[20 + (r * 37) % (num_pairs - 20)][1], "x", 1, 0);
+
+        n = poll(pfds, num_pairs, -1);
+
+        for (i = 0; i < num_pairs && n > 0; i++) {
+            if (pfds[i].revents & POLLIN) {
+                recv(pfds[i].fd, buf, sizeof(buf), 0);
+                num_events++;
+                n--;
+            }
+        }
+    }
+
+    elapsed = now() - start;
+
+    printf("poll():       %d pairs, %ld events in %.2f s, %.0f events/s\n", num_pairs, num_events, elapsed, num_events / elapsed);
+
+    CHECK(close(ep) == 0);
+
+    for (i = 0; i < num_pairs; i++) {
+        close(pairs[i][0]);
+        close(pairs[i][1]);
+    }
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
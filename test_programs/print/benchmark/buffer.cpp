@@ -0,0 +1,50 @@
+#include <buffer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sstream>
+#include <chrono>
+
+// A short message formatted into a large buffer. snprintf() used to clear
+// the whole buffer first, so this measured the size of the buffer rather
+// than the length of the message.
+static const int bufferSize = 64 * 1024;
+
+Buffer::Buffer(int a)
+    : Test::Test{a}
+{
+    testCout();
+    testPrintf();
+    print();
+}
+
+void Buffer::testCout()
+{
+    clearScreen();
+
+    for (int i = 0; i != amount; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int j = 0; j != 10000; ++j) {
+            std::ostringstream stream;
+            stream << "line " << j << ": " << "abcdef";
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        resultsCout.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(end-start).count());
+    }
+}
+
+void Buffer::testPrintf()
+{
+    char *buffer = static_cast<char *>(malloc(bufferSize));
+
+    clearScreen();
+
+    for (int i = 0; i != amount; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int j = 0; j != 10000; ++j)
+            snprintf(buffer, bufferSize, "line %d: %s", j, "abcdef");
+        auto end = std::chrono::high_resolution_clock::now();
+        resultsPrintf.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(end-start).count());
+    }
+
+    free(buffer);
+}
@@ -0,0 +1,14 @@
+#ifndef BUFFER_H
+#define BUFFER_H
+
+#include <vector>
+#include <test.h>
+
+class Buffer : public Test {
+public:
+    explicit Buffer(int);
+    void testCout();
+    void testPrintf();
+};
+
+#endif // BUFFER_H
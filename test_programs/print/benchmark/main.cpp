@@ -2,6 +2,7 @@
 #include <integer.h>
 #include <string.h>
 #include <float.h>
+#include <buffer.h>
 
 int main()
 {
@@ -11,7 +12,8 @@ int main()
     std::cout << "Select mode:\n"
                  "1. Integer\n"
                  "2. Float\n"
-                 "3. String\n";
+                 "3. String\n"
+                 "4. Buffer (snprintf into 64 KB)\n";
     int mode;
     std::cin >> mode;
 
@@ -28,6 +30,10 @@ int main()
         String test {tests};
         break;
     }
+    case 4: {
+        Buffer test {tests};
+        break;
+    }
     }
     std::cin.ignore();
     getchar();
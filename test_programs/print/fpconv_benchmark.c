@@ -0,0 +1,118 @@
+/*
+ * Measures how fast floating point numbers are converted to text with
+ * snprintf() and back again with strtod() and strtof(). Short numbers, as
+ * they are typed in, and numbers covering the whole range of a double are
+ * tried separately.
+ *
+ * Usage: fpconv_benchmark [count]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <stdint.h>
+
+static uint64_t state = 88172645463325252ULL;
+
+static uint64_t
+next_random(void) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+static double
+elapsed(clock_t begin) {
+    double seconds = (double) (clock() - begin) / CLOCKS_PER_SEC;
+
+    if (seconds <= 0.0)
+        seconds = 1.0 / CLOCKS_PER_SEC;
+
+    return seconds;
+}
+
+static void
+report(const char *name, long count, double seconds) {
+    printf("  %-22s %10.0f conversions/s  %8.1f ns each\n", name, count / seconds, seconds * 1e9 / count);
+}
+
+static void
+run(const char *title, const double *values, long count) {
+    static const char *formats[] = { "%g", "%e", "%f", "%.3f", "%.17g" };
+    static char text[80];
+    char *strings;
+    char name[32];
+    volatile double dsum = 0;
+    volatile float fsum = 0;
+    clock_t begin;
+    size_t f;
+    long i;
+
+    printf("%s:\n", title);
+
+    for (f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+        begin = clock();
+        for (i = 0; i < count; i++)
+            snprintf(text, sizeof(text), formats[f], values[i]);
+
+        snprintf(name, sizeof(name), "snprintf(\"%s\")", formats[f]);
+        report(name, count, elapsed(begin));
+    }
+
+    strings = malloc((size_t) count * 32);
+    if (strings == NULL)
+        return;
+
+    for (i = 0; i < count; i++)
+        snprintf(&strings[i * 32], 32, "%.17g", values[i]);
+
+    begin = clock();
+    for (i = 0; i < count; i++)
+        dsum += strtod(&strings[i * 32], NULL);
+    report("strtod", count, elapsed(begin));
+
+    begin = clock();
+    for (i = 0; i < count; i++)
+        fsum += strtof(&strings[i * 32], NULL);
+    report("strtof", count, elapsed(begin));
+
+    free(strings);
+}
+
+int
+main(int argc, char **argv) {
+    long count = 200000;
+    double *values;
+    long i;
+
+    if (argc > 1)
+        count = atol(argv[1]);
+
+    values = malloc(sizeof(*values) * count);
+    if (values == NULL)
+        return EXIT_FAILURE;
+
+    /* Prices, measurements and the like */
+    for (i = 0; i < count; i++)
+        values[i] = (double) (next_random() % 10000000) / 100.0;
+
+    run("Numbers with few digits", values, count);
+
+    /* Any finite double at all */
+    for (i = 0; i < count; i++) {
+        uint64_t bits = next_random();
+
+        memcpy(&values[i], &bits, sizeof(values[i]));
+        if (!isfinite(values[i]))
+            values[i] = 1.5;
+    }
+
+    run("Numbers of any size", values, count);
+
+    free(values);
+
+    return EXIT_SUCCESS;
+}
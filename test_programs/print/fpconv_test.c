@@ -0,0 +1,142 @@
+/*
+ * Checks that floating point numbers survive the trip through printf() and
+ * strtod()/strtof() unchanged, for random bit patterns and for a number of
+ * well known hard cases. It also checks a few conversions whose correctly
+ * rounded result is known, where the digits printf() starts from are not
+ * enough and the exact conversion has to step in.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+
+static uint64_t state = 88172645463325252ULL;
+
+static uint64_t
+next_random(void) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+static int failures;
+
+static void
+check_double(double value) {
+    char buffer[64];
+    double result;
+    char *end;
+
+    snprintf(buffer, sizeof(buffer), "%.17g", value);
+    result = strtod(buffer, &end);
+
+    if ((*end) != '\0' || memcmp(&result, &value, sizeof(value)) != 0) {
+        if (failures++ < 20)
+            printf("FAIL: %s reads back as %.17g\n", buffer, result);
+    }
+}
+
+static void
+check_float(float value) {
+    char buffer[64];
+    float result;
+    char *end;
+
+    snprintf(buffer, sizeof(buffer), "%.9g", value);
+    result = strtof(buffer, &end);
+
+    if ((*end) != '\0' || memcmp(&result, &value, sizeof(value)) != 0) {
+        if (failures++ < 20)
+            printf("FAIL: %s reads back as %.9g (float)\n", buffer, result);
+    }
+}
+
+/* An 'expected_errno' of -1 means that it does not matter; a result which is
+   too small to be a normal number may or may not set ERANGE. */
+static void
+check_string(const char *str, double expected, int expected_errno) {
+    double result;
+    char *end;
+
+    errno = 0;
+    result = strtod(str, &end);
+
+    if ((*end) != '\0' || memcmp(&result, &expected, sizeof(expected)) != 0 || (expected_errno >= 0 && errno != expected_errno)) {
+        if (failures++ < 20)
+            printf("FAIL: \"%s\" reads as %.17g (errno %d), expected %.17g (errno %d)\n",
+                   str, result, errno, expected, expected_errno);
+    }
+}
+
+static void
+check_format(const char *format, double value, const char *expected) {
+    char buffer[512];
+
+    snprintf(buffer, sizeof(buffer), format, value);
+
+    if (strcmp(buffer, expected) != 0) {
+        if (failures++ < 20)
+            printf("FAIL: \"%s\" gives \"%s\", expected \"%s\"\n", format, buffer, expected);
+    }
+}
+
+int
+main(int argc, char **argv) {
+    long count = 1000000;
+    long i;
+
+    if (argc > 1)
+        count = atol(argv[1]);
+
+    for (i = 0; i < count; i++) {
+        uint64_t bits = next_random();
+        uint32_t bits32 = (uint32_t) (bits >> 32);
+        double d;
+        float f;
+
+        memcpy(&d, &bits, sizeof(d));
+        memcpy(&f, &bits32, sizeof(f));
+
+        if (isfinite(d))
+            check_double(d);
+        if (isfinite(f))
+            check_float(f);
+    }
+
+    /* Halfway cases, long inputs, subnormal numbers and the limits */
+    check_string("9007199254740993", 9007199254740992.0, 0);
+    check_string("9007199254740993.0000000000000000000000000001", 9007199254740994.0, 0);
+    check_string("2.2250738585072011e-308", 2.225073858507201e-308, -1);
+    check_string("2.2250738585072012e-308", 2.2250738585072014e-308, -1);
+    check_string("4.9406564584124654e-324", 4.9406564584124654e-324, -1);
+    check_string("2.4703282292062328e-324", 4.9406564584124654e-324, -1);
+    check_string("2.4703282292062327e-324", 0.0, ERANGE);
+    check_string("1.7976931348623157e308", 1.7976931348623157e308, 0);
+    check_string("1.7976931348623159e308", HUGE_VAL, ERANGE);
+    check_string("0.1", 0.1, 0);
+    check_string("123456789012345678901234567890e-10", 12345678901234567890.0, 0);
+    check_string("0x1.8p1", 3.0, 0);
+
+    /* Digits which end in a tie, and precisions beyond 17 digits */
+    check_format("%.1f", 0.25, "0.2");
+    check_format("%.1f", 0.35, "0.3");
+    check_format("%.2f", 1.005, "1.00");
+    check_format("%.0f", 2.5, "2");
+    check_format("%.20f", 0.1, "0.10000000000000000555");
+    check_format("%.3e", 1e23, "1.000e+23");
+    check_format("%.17g", 1e23, "9.9999999999999992e+22");
+    check_format("%g", 100000.0, "100000");
+    check_format("%g", 1000000.0, "1e+06");
+    check_format("%g", 0.0001, "0.0001");
+    check_format("%#g", 1.0, "1.00000");
+    check_format("%f", 1e15, "1000000000000000.000000");
+    check_format("%.0f", 9007199254740993.0, "9007199254740992");
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
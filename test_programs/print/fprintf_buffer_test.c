@@ -0,0 +1,85 @@
+/*
+ * Writes the same formatted text through fprintf() into files with different
+ * buffer modes and sizes, and checks that the files end up holding exactly
+ * what snprintf() produces for it. Long paddings, long strings and line feeds
+ * in all places make sure that the write buffer both overflows and has to be
+ * flushed in the middle of a conversion.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FILE_PATH ("fprintf_buffer_test.txt")
+
+static char expected[1024 * 1024];
+static char actual[1024 * 1024];
+
+static size_t
+format_all(FILE *file, char *buffer, size_t size) {
+    static const char *words[] = { "", "x", "line\n", "\n\n", "a longer string without a line feed" };
+    size_t len = 0;
+    int i;
+
+    for (i = 0; i < 200; i++) {
+        const char *w = words[i % 5];
+        int width = (i * 37) % 700;
+
+        if (file != NULL) {
+            fprintf(file, "%d:%*d|%-*s|%s\n", i, width, -i, width / 3, w, w);
+            fprintf(file, "%#*x %0*ld %.*f %g%c", width, i, width / 2, (long) i * 1000003L, i % 20, i / 7.0, 1e10 * i, (i % 3) ? ' ' : '\n');
+        } else {
+            len += snprintf(buffer + len, size - len, "%d:%*d|%-*s|%s\n", i, width, -i, width / 3, w, w);
+            len += snprintf(buffer + len, size - len, "%#*x %0*ld %.*f %g%c", width, i, width / 2, (long) i * 1000003L, i % 20, i / 7.0, 1e10 * i, (i % 3) ? ' ' : '\n');
+        }
+    }
+
+    return len;
+}
+
+int
+main(void) {
+    static const int modes[] = { _IOFBF, _IOLBF, _IONBF };
+    static const char *mode_names[] = { "full", "line", "none" };
+    static const size_t sizes[] = { 1, 7, 64, 256, 8192 };
+    size_t expected_len = format_all(NULL, expected, sizeof(expected));
+    int failures = 0;
+    size_t m, s;
+
+    for (m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            FILE *file = fopen(FILE_PATH, "w");
+            size_t len;
+
+            if (file == NULL) {
+                printf("can't create %s\n", FILE_PATH);
+                return EXIT_FAILURE;
+            }
+
+            setvbuf(file, NULL, modes[m], sizes[s]);
+            format_all(file, NULL, 0);
+            fclose(file);
+
+            file = fopen(FILE_PATH, "r");
+            if (file == NULL) {
+                printf("can't open %s\n", FILE_PATH);
+                return EXIT_FAILURE;
+            }
+
+            len = fread(actual, 1, sizeof(actual), file);
+            fclose(file);
+
+            if (len != expected_len || memcmp(actual, expected, len) != 0) {
+                printf("FAIL: buffer mode %s, size %lu (%lu bytes written, %lu expected)\n",
+                       mode_names[m], (unsigned long) sizes[s], (unsigned long) len, (unsigned long) expected_len);
+                failures++;
+            }
+        }
+    }
+
+    remove(FILE_PATH);
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
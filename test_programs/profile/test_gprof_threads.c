@@ -0,0 +1,73 @@
+/*
+ * Calls a few functions from several threads at once, a known number of
+ * times each. Build it with -pg and run it, then check the call counts with
+ *
+ * > gprof -b test_gprof_threads gmon.out
+ *
+ * work_a() must show 4000000 calls, work_b() 2000000 and work_c() 400000,
+ * all of them from worker(). gmon.out.1, gmon.out.2 etc. hold the flat
+ * profile of each thread on its own; gmon.threads tells which is which.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_THREADS 4
+#define NUM_CALLS 1000000
+
+static volatile unsigned long sink;
+
+void work_a(int i) {
+    sink += i;
+}
+
+void work_b(int i) {
+    sink ^= i;
+}
+
+void work_c(int i) {
+    int j;
+
+    for (j = 0; j < 100; j++)
+        sink += i * j;
+}
+
+static void *
+worker(void *arg) {
+    int i;
+
+    (void) arg;
+
+    for (i = 0; i < NUM_CALLS; i++) {
+        work_a(i);
+
+        if ((i & 1) == 0)
+            work_b(i);
+
+        if ((i % 10) == 0)
+            work_c(i);
+    }
+
+    return NULL;
+}
+
+int main(void) {
+    pthread_t thread[NUM_THREADS];
+    int i;
+
+    for (i = 0; i < NUM_THREADS; i++) {
+        if (pthread_create(&thread[i], NULL, worker, NULL) != 0) {
+            printf("could not start thread %d\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (i = 0; i < NUM_THREADS; i++)
+        pthread_join(thread[i], NULL);
+
+    printf("expected calls: work_a() %d, work_b() %d, work_c() %d\n",
+           NUM_THREADS * NUM_CALLS, NUM_THREADS * NUM_CALLS / 2, NUM_THREADS * NUM_CALLS / 10);
+
+    return EXIT_SUCCESS;
+}
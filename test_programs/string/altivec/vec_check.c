@@ -0,0 +1,241 @@
+/*
+ * Checks the AltiVec string kernels in library/cpu/altivec against simple
+ * scalar reference implementations, on random data at every alignment.
+ *
+ * Built with -maltivec this tests the vector code on the machine it runs
+ * on. Built for any other host the kernels fall back to their portable C
+ * versions, which are then checked instead (see the Makefile).
+ *
+ * Usage: vec_check [iterations [seed]]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "vec_string.h"
+
+#define AREA_SIZE 4096
+#define MAX_LEN   600
+
+/* 16 byte aligned, so that every alignment of the data is tried out. */
+static unsigned char area1[AREA_SIZE] __attribute__((aligned(16)));
+static unsigned char area2[AREA_SIZE] __attribute__((aligned(16)));
+static wchar_t warea1[AREA_SIZE] __attribute__((aligned(16)));
+static wchar_t warea2[AREA_SIZE] __attribute__((aligned(16)));
+
+static unsigned long rng_state;
+static unsigned long failures;
+static unsigned long checks;
+
+static unsigned long
+rnd(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= (rng_state >> 17) & 0x7fff;
+    rng_state ^= rng_state << 5;
+    return rng_state & 0xffffffffUL;
+}
+
+static size_t
+rnd_range(size_t n) {
+    return n > 0 ? rnd() % n : 0;
+}
+
+/* Mostly a few distinct bytes, so that there are plenty of matches. */
+static void
+fill(unsigned char *p, size_t len) {
+    static const unsigned char alphabet[8] = { 'a', 'b', 'c', 0x80, 0xff, 'a', 'b', 'a' };
+    size_t i;
+
+    for (i = 0; i < len; i++)
+        p[i] = rnd_range(16) == 0 ? (unsigned char) (rnd() | 1) : alphabet[rnd_range(8)];
+}
+
+static int
+sign(int x) {
+    return x < 0 ? -1 : (x > 0 ? 1 : 0);
+}
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        checks++;                                           \
+        if (!(cond)) {                                      \
+            failures++;                                     \
+            if (failures <= 20) {                           \
+                printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+                printf(__VA_ARGS__);                        \
+                printf("\n");                               \
+            }                                               \
+        }                                                   \
+    } while (0)
+
+/****************************************************************************/
+
+static const void *
+ref_memchr(const void *p, int c, size_t n) {
+    const unsigned char *m = p;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (m[i] == (unsigned char) c)
+            return m + i;
+    }
+
+    return NULL;
+}
+
+static const void *
+ref_memrchr(const void *p, int c, size_t n) {
+    const unsigned char *m = p;
+
+    while (n-- > 0) {
+        if (m[n] == (unsigned char) c)
+            return m + n;
+    }
+
+    return NULL;
+}
+
+static int
+ref_strncmp(const char *a, const char *b, size_t n) {
+    const unsigned char *l = (const unsigned char *) a, *r = (const unsigned char *) b;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (l[i] != r[i] || l[i] == '\0')
+            return l[i] - r[i];
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
+static void
+test_bytes(void) {
+    size_t off = rnd_range(48), len = rnd_range(MAX_LEN);
+    char *s = (char *) area1 + off;
+    int c;
+
+    fill(area1, AREA_SIZE);
+
+    c = rnd_range(4) == 0 ? (int) rnd_range(256) : (unsigned char) s[rnd_range(len + 1)];
+
+    CHECK(vec_memchr(s, c, len) == ref_memchr(s, c, len), "memchr off=%lu len=%lu c=%d", (unsigned long) off,
+          (unsigned long) len, c);
+    CHECK(vec_memrchr(s, c, len) == ref_memrchr(s, c, len), "memrchr off=%lu len=%lu c=%d", (unsigned long) off,
+          (unsigned long) len, c);
+
+    s[len] = '\0';
+
+    CHECK(vec_strlen(s) == len, "strlen off=%lu len=%lu", (unsigned long) off, (unsigned long) len);
+    CHECK(vec_strchr(s, c) == ref_memchr(s, c, len + 1), "strchr off=%lu len=%lu c=%d", (unsigned long) off,
+          (unsigned long) len, c);
+    CHECK(vec_strrchr(s, c) == ref_memrchr(s, c, len + 1), "strrchr off=%lu len=%lu c=%d", (unsigned long) off,
+          (unsigned long) len, c);
+}
+
+static void
+test_compare(void) {
+    size_t off1 = rnd_range(48), off2 = rnd_range(48), len = rnd_range(MAX_LEN);
+    char *a = (char *) area1 + off1;
+    char *b = (char *) area2 + off2;
+    size_t n = rnd_range(MAX_LEN + 20);
+
+    fill(area1, AREA_SIZE);
+    memcpy(b, a, len + 1);
+
+    switch (rnd_range(4)) {
+        case 0:
+            break;
+        case 1:
+            b[rnd_range(len + 1)] ^= 1 << rnd_range(8);
+            break;
+        case 2:
+            b[rnd_range(len + 1)] = '\0';
+            break;
+        default:
+            a[rnd_range(len + 1)] = (char) rnd();
+            break;
+    }
+
+    a[len] = '\0';
+    b[len] = '\0';
+
+    CHECK(sign(vec_strcmp(a, b)) == sign(ref_strncmp(a, b, (size_t) -1)), "strcmp off=%lu/%lu len=%lu",
+          (unsigned long) off1, (unsigned long) off2, (unsigned long) len);
+    CHECK(sign(vec_strncmp(a, b, n)) == sign(ref_strncmp(a, b, n)), "strncmp off=%lu/%lu len=%lu n=%lu",
+          (unsigned long) off1, (unsigned long) off2, (unsigned long) len, (unsigned long) n);
+}
+
+static void
+test_wide(void) {
+    size_t off = rnd_range(12), len = rnd_range(MAX_LEN / 2);
+    wchar_t *s = warea1 + off;
+    wchar_t c;
+    size_t i;
+
+    for (i = 0; i < AREA_SIZE; i++)
+        warea1[i] = (wchar_t) (1 + rnd_range(6)) * 0x10001;
+
+    c = rnd_range(4) == 0 ? (wchar_t) rnd() : s[rnd_range(len + 1)];
+
+    {
+        const wchar_t *expected = NULL;
+
+        for (i = 0; i < len; i++) {
+            if (s[i] == c) {
+                expected = s + i;
+                break;
+            }
+        }
+
+        CHECK(vec_wmemchr(s, c, len) == expected, "wmemchr off=%lu len=%lu", (unsigned long) off,
+              (unsigned long) len);
+    }
+
+    s[len] = L'\0';
+    CHECK(vec_wcslen(s) == len, "wcslen off=%lu len=%lu", (unsigned long) off, (unsigned long) len);
+
+    /* wmemset() must neither write too little nor too much */
+    memcpy(warea2, warea1, sizeof(warea1));
+    for (i = 0; i < len; i++)
+        warea2[off + i] = c;
+
+    CHECK(vec_wmemset(s, c, len) == s, "wmemset result");
+    CHECK(memcmp(warea1, warea2, sizeof(warea1)) == 0, "wmemset off=%lu len=%lu", (unsigned long) off,
+          (unsigned long) len);
+}
+
+/****************************************************************************/
+
+int
+main(int argc, char **argv) {
+    unsigned long iterations = 100000;
+    unsigned long i;
+
+    rng_state = 88172645UL;
+
+    if (argc > 1)
+        iterations = strtoul(argv[1], NULL, 0);
+
+    if (argc > 2)
+        rng_state = strtoul(argv[2], NULL, 0) | 1;
+
+#ifdef __ALTIVEC__
+    printf("Checking the AltiVec kernels, %lu iterations\n", iterations);
+#else
+    printf("Checking the portable kernels, %lu iterations\n", iterations);
+#endif /* __ALTIVEC__ */
+
+    for (i = 0; i < iterations; i++) {
+        test_bytes();
+        test_compare();
+        test_wide();
+    }
+
+    printf("%lu checks, %lu failures\n", checks, failures);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,429 @@
+/*
+ * Differential fuzz test for the portable word-at-a-time string kernels and
+ * the Two-Way substring search used by the library (string_swar.h and
+ * string_twoway.h). Every kernel is checked against a trivial byte by byte
+ * reference implementation on random data, at random alignments.
+ *
+ * The kernels only depend upon the compiler, which is why this program can
+ * be built for the Amiga as well as on an ordinary Linux host (see the
+ * Makefile).
+ *
+ * Usage: string_fuzz [iterations [seed]]
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "../../../library/string/string_swar.h"
+#include "../../../library/string/string_twoway.h"
+
+#define AREA_SIZE 4096
+#define MAX_LEN   700
+
+/* All strings live in here, so that the kernels may safely read whole
+   words beyond the end of a string. */
+static unsigned char area1[AREA_SIZE];
+static unsigned char area2[AREA_SIZE];
+static unsigned char area3[AREA_SIZE];
+static wchar_t warea1[AREA_SIZE];
+static wchar_t warea2[AREA_SIZE];
+
+static unsigned long rng_state;
+static unsigned long failures;
+static unsigned long checks;
+
+static unsigned long
+rnd(void) {
+    /* xorshift, so that the results are the same on every host */
+    rng_state ^= rng_state << 13;
+    rng_state ^= (rng_state >> 17) & 0x7fff;
+    rng_state ^= rng_state << 5;
+    return rng_state & 0xffffffffUL;
+}
+
+static size_t
+rnd_range(size_t n) {
+    return n > 0 ? rnd() % n : 0;
+}
+
+/* Random bytes from a small alphabet, which makes matches (and partial
+   matches) frequent. Sometimes bytes with the high bit set are used, too. */
+static void
+fill(unsigned char *p, size_t len) {
+    static const unsigned char alphabets[][8] = {
+        { 'a', 'b', 'a', 'b', 'a', 'b', 'a', 'b' },
+        { 'a', 'b', 'c', 'A', 'B', 'C', 'a', 'a' },
+        { 'x', 0x80, 0xff, 0x7f, 'X', 0xfe, 0x01, 'x' },
+        { 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'b' },
+    };
+    const unsigned char *alphabet = alphabets[rnd_range(4)];
+    size_t i;
+
+    for (i = 0; i < len; i++)
+        p[i] = (rnd_range(16) == 0) ? (unsigned char) (rnd() | 1) : alphabet[rnd_range(8)];
+}
+
+static int
+sign(int x) {
+    return x < 0 ? -1 : (x > 0 ? 1 : 0);
+}
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        checks++;                                           \
+        if (!(cond)) {                                      \
+            failures++;                                     \
+            if (failures <= 20) {                           \
+                printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+                printf(__VA_ARGS__);                        \
+                printf("\n");                               \
+            }                                               \
+        }                                                   \
+    } while (0)
+
+/****************************************************************************/
+
+/* Reference implementations */
+
+static size_t
+ref_strlen(const char *s) {
+    size_t n = 0;
+
+    while (s[n] != '\0')
+        n++;
+
+    return n;
+}
+
+static const void *
+ref_memchr(const void *p, int c, size_t n) {
+    const unsigned char *m = p;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (m[i] == (unsigned char) c)
+            return m + i;
+    }
+
+    return NULL;
+}
+
+static const void *
+ref_memrchr(const void *p, int c, size_t n) {
+    const unsigned char *m = p;
+
+    while (n-- > 0) {
+        if (m[n] == (unsigned char) c)
+            return m + n;
+    }
+
+    return NULL;
+}
+
+static const char *
+ref_strchr(const char *s, int c) {
+    return ref_memchr(s, c, ref_strlen(s) + 1);
+}
+
+static const char *
+ref_strrchr(const char *s, int c) {
+    return ref_memrchr(s, c, ref_strlen(s) + 1);
+}
+
+static int
+ref_memcmp(const void *a, const void *b, size_t n) {
+    const unsigned char *l = a, *r = b;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (l[i] != r[i])
+            return l[i] - r[i];
+    }
+
+    return 0;
+}
+
+static int
+ref_strncmp(const char *a, const char *b, size_t n) {
+    const unsigned char *l = (const unsigned char *) a, *r = (const unsigned char *) b;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (l[i] != r[i] || l[i] == '\0')
+            return l[i] - r[i];
+    }
+
+    return 0;
+}
+
+static const unsigned char *
+ref_search(const unsigned char *h, size_t hl, const unsigned char *n, size_t nl, const unsigned char *fold) {
+    size_t i, j;
+
+    for (i = 0; i + nl <= hl; i++) {
+        for (j = 0; j < nl; j++) {
+            unsigned char a = h[i + j], b = n[j];
+
+            if (fold != NULL) {
+                a = fold[a];
+                b = fold[b];
+            }
+
+            if (a != b)
+                break;
+        }
+
+        if (j == nl)
+            return h + i;
+    }
+
+    return NULL;
+}
+
+static const wchar_t *
+ref_wcsstr(const wchar_t *h, const wchar_t *n) {
+    size_t i, j;
+
+    for (i = 0; h[i] != L'\0'; i++) {
+        for (j = 0; n[j] != L'\0' && h[i + j] == n[j]; j++)
+            ;
+
+        if (n[j] == L'\0')
+            return h + i;
+    }
+
+    return NULL;
+}
+
+/****************************************************************************/
+
+static void
+test_scan(void) {
+    size_t off = rnd_range(64), len = rnd_range(MAX_LEN);
+    char *s = (char *) area1 + off;
+    int c;
+
+    fill(area1, AREA_SIZE);
+    s[len] = '\0';
+
+    /* Look for bytes which are in the string, beyond it, or nowhere. */
+    c = rnd_range(4) == 0 ? (int) rnd_range(256) : s[rnd_range(len + 1)];
+    if (rnd_range(8) == 0)
+        c += 256; /* only the low byte counts */
+
+    CHECK(__swar_strlen(s) == len, "strlen off=%lu len=%lu", (unsigned long) off, (unsigned long) len);
+
+    {
+        size_t maxlen = rnd_range(MAX_LEN + 10);
+        size_t expected = len < maxlen ? len : maxlen;
+
+        CHECK(__swar_strnlen(s, maxlen) == expected, "strnlen off=%lu len=%lu max=%lu",
+              (unsigned long) off, (unsigned long) len, (unsigned long) maxlen);
+    }
+
+    CHECK(__swar_strchr(s, c) == ref_strchr(s, c), "strchr off=%lu len=%lu c=%d", (unsigned long) off,
+          (unsigned long) len, c);
+    CHECK(__swar_strrchr(s, c) == ref_strrchr(s, c), "strrchr off=%lu len=%lu c=%d", (unsigned long) off,
+          (unsigned long) len, c);
+    CHECK(__swar_strchrnul(s, c) == (ref_strchr(s, c) ? ref_strchr(s, c) : s + len), "strchrnul off=%lu c=%d",
+          (unsigned long) off, c);
+
+    /* memchr() and memrchr() do not stop at a NUL byte */
+    fill(area1, AREA_SIZE);
+    CHECK(__swar_memchr(s, c, len) == ref_memchr(s, c, len), "memchr off=%lu len=%lu c=%d", (unsigned long) off,
+          (unsigned long) len, c);
+    CHECK(__swar_memrchr(s, c, len) == ref_memrchr(s, c, len), "memrchr off=%lu len=%lu c=%d",
+          (unsigned long) off, (unsigned long) len, c);
+}
+
+static void
+test_compare(void) {
+    size_t off1 = rnd_range(64), off2 = rnd_range(64), len = rnd_range(MAX_LEN);
+    char *a = (char *) area1 + off1;
+    char *b = (char *) area2 + off2;
+    size_t n;
+
+    /* Same alignment is the interesting case for the word loops */
+    if (rnd_range(2))
+        off2 = off1, b = (char *) area2 + off2;
+
+    fill(area1, AREA_SIZE);
+    memcpy(b, a, len + 1);
+
+    /* Either equal, or different at some position, possibly beyond the
+       end of the shorter string. */
+    switch (rnd_range(4)) {
+        case 0:
+            break;
+        case 1:
+            b[rnd_range(len + 1)] ^= 1 << rnd_range(8);
+            break;
+        case 2:
+            b[rnd_range(len + 1)] = '\0';
+            break;
+        default:
+            a[rnd_range(len + 1)] = (char) rnd();
+            break;
+    }
+
+    a[len] = '\0';
+    b[len] = '\0';
+
+    n = rnd_range(MAX_LEN + 10);
+
+    CHECK(sign(__swar_strcmp(a, b)) == sign(ref_strncmp(a, b, (size_t) -1)), "strcmp off=%lu/%lu len=%lu",
+          (unsigned long) off1, (unsigned long) off2, (unsigned long) len);
+    CHECK(sign(__swar_strncmp(a, b, n)) == sign(ref_strncmp(a, b, n)), "strncmp off=%lu/%lu len=%lu n=%lu",
+          (unsigned long) off1, (unsigned long) off2, (unsigned long) len, (unsigned long) n);
+    CHECK(sign(__swar_memcmp(a, b, len)) == sign(ref_memcmp(a, b, len)), "memcmp off=%lu/%lu len=%lu",
+          (unsigned long) off1, (unsigned long) off2, (unsigned long) len);
+}
+
+static void
+test_copy(void) {
+    size_t off1 = rnd_range(64), off2 = rnd_range(64), len = rnd_range(MAX_LEN);
+    char *src = (char *) area1 + off1;
+    char *dst;
+    char *end;
+    int c = (int) rnd_range(512);
+
+    if (rnd_range(2))
+        off2 = off1;
+
+    dst = (char *) area2 + off2;
+
+    fill(area1, AREA_SIZE);
+    src[len] = '\0';
+
+    memset(area2, 0x55, AREA_SIZE);
+    memset(area3, 0x55, AREA_SIZE);
+    memcpy(area3 + off2, src, len + 1);
+
+    end = __swar_stpcpy(dst, src);
+
+    CHECK(end == dst + len, "stpcpy result off=%lu/%lu len=%lu", (unsigned long) off1, (unsigned long) off2,
+          (unsigned long) len);
+    CHECK(memcmp(area2, area3, AREA_SIZE) == 0, "stpcpy data off=%lu/%lu len=%lu", (unsigned long) off1,
+          (unsigned long) off2, (unsigned long) len);
+
+    /* memset() must neither write too little nor too much */
+    memset(area3 + off2, c, len);
+
+    CHECK(__swar_memset(dst, c, len) == dst, "memset result");
+    CHECK(memcmp(area2, area3, AREA_SIZE) == 0, "memset data off=%lu len=%lu c=%d", (unsigned long) off2,
+          (unsigned long) len, c);
+}
+
+static void
+test_search(void) {
+    static unsigned char fold[256];
+    size_t hoff = rnd_range(64), hlen = rnd_range(MAX_LEN), nlen = 1 + rnd_range(rnd_range(2) ? 8 : 64);
+    unsigned char *h = area1 + hoff;
+    unsigned char *n = area2 + rnd_range(64);
+    const unsigned char *expected;
+    char *found;
+    size_t i;
+
+    for (i = 0; i < 256; i++)
+        fold[i] = toupper(i);
+
+    fill(area1, AREA_SIZE);
+
+    /* The needle either comes from the haystack, or is made up of a
+       repeated pattern, which is the hard case for a periodic needle. */
+    switch (rnd_range(3)) {
+        case 0:
+            if (hlen >= nlen) {
+                memcpy(n, h + rnd_range(hlen - nlen + 1), nlen);
+                break;
+            }
+
+            /* fall through */
+        case 1:
+            fill(n, nlen);
+            break;
+        default: {
+            size_t period = 1 + rnd_range(4);
+
+            fill(n, period);
+            for (i = period; i < nlen; i++)
+                n[i] = n[i - period];
+
+            for (i = 0; i < hlen; i++)
+                h[i] = rnd_range(32) ? n[i % period] : n[0] ^ 1;
+
+            break;
+        }
+    }
+
+    /* Neither may contain a NUL byte for the string versions */
+    for (i = 0; i < hlen; i++) {
+        if (h[i] == '\0')
+            h[i] = 'z';
+    }
+
+    for (i = 0; i < nlen; i++) {
+        if (n[i] == '\0')
+            n[i] = 'z';
+    }
+
+    h[hlen] = '\0';
+    n[nlen] = '\0';
+
+    /* memmem() and strnstr() */
+    expected = ref_search(h, hlen, n, nlen, NULL);
+    found = __twoway_search(h, h + hlen, 0, n, nlen, NULL);
+    CHECK(found == (const char *) expected, "memmem hlen=%lu nlen=%lu", (unsigned long) hlen, (unsigned long) nlen);
+
+    /* strstr(), which only finds the end of the haystack as it goes */
+    found = __twoway_search(h, h, 1, n, nlen, NULL);
+    CHECK(found == (const char *) expected, "strstr hlen=%lu nlen=%lu", (unsigned long) hlen, (unsigned long) nlen);
+
+    /* strcasestr() */
+    expected = ref_search(h, hlen, n, nlen, fold);
+    found = __twoway_search(h, h, 1, n, nlen, fold);
+    CHECK(found == (const char *) expected, "strcasestr hlen=%lu nlen=%lu", (unsigned long) hlen,
+          (unsigned long) nlen);
+
+    /* wcsstr(), with characters which do not fit into a byte */
+    for (i = 0; i <= hlen; i++)
+        warea1[i] = h[i] != 0 ? (wchar_t) (h[i] * 0x10001) : L'\0';
+
+    for (i = 0; i <= nlen; i++)
+        warea2[i] = n[i] != 0 ? (wchar_t) (n[i] * 0x10001) : L'\0';
+
+    CHECK(__twoway_wcsstr(warea1, warea2) == ref_wcsstr(warea1, warea2), "wcsstr hlen=%lu nlen=%lu",
+          (unsigned long) hlen, (unsigned long) nlen);
+}
+
+/****************************************************************************/
+
+int
+main(int argc, char **argv) {
+    unsigned long iterations = 100000;
+    unsigned long i;
+
+    rng_state = 2463534242UL;
+
+    if (argc > 1)
+        iterations = strtoul(argv[1], NULL, 0);
+
+    if (argc > 2)
+        rng_state = strtoul(argv[2], NULL, 0) | 1;
+
+    printf("Running %lu iterations, word size %lu bytes\n", iterations, (unsigned long) SWAR_SIZE);
+
+    for (i = 0; i < iterations; i++) {
+        test_scan();
+        test_compare();
+        test_copy();
+        test_search();
+    }
+
+    printf("%lu checks, %lu failures\n", checks, failures);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
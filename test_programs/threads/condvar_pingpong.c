@@ -0,0 +1,95 @@
+/*
+ * Condition variable ping-pong benchmark.
+ *
+ * A producer and a consumer hand a single token back and forth through a
+ * mutex and two condition variables, so every round trip costs two waits
+ * and two signals. The cost of signalling a condition variable nobody waits
+ * on is measured as well.
+ *
+ * > condvar_pingpong [ROUNDS]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+static int ROUNDS = 100000;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ping = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pong = PTHREAD_COND_INITIALIZER;
+static int turn; /* 0 = producer, 1 = consumer */
+
+static double
+now(void) {
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void *
+consumer(void *arg) {
+    int i;
+
+    (void) arg;
+
+    for (i = 0; i < ROUNDS; i++) {
+        pthread_mutex_lock(&lock);
+        while (turn != 1)
+            pthread_cond_wait(&ping, &lock);
+        turn = 0;
+        pthread_cond_signal(&pong);
+        pthread_mutex_unlock(&lock);
+    }
+
+    return NULL;
+}
+
+int
+main(int argc, char **argv) {
+    pthread_cond_t idle = PTHREAD_COND_INITIALIZER;
+    pthread_t thread;
+    double start, elapsed;
+    int i;
+
+    if (argc >= 2 && atoi(argv[1]) > 0)
+        ROUNDS = atoi(argv[1]);
+
+    start = now();
+    for (i = 0; i < ROUNDS * 10; i++)
+        pthread_cond_signal(&idle);
+    elapsed = now() - start;
+
+    printf("%-28s %10.1f ns per call\n", "signal without waiters", elapsed * 1e9 / (ROUNDS * 10));
+
+    start = now();
+    for (i = 0; i < ROUNDS * 10; i++)
+        pthread_cond_broadcast(&idle);
+    elapsed = now() - start;
+
+    printf("%-28s %10.1f ns per call\n", "broadcast without waiters", elapsed * 1e9 / (ROUNDS * 10));
+
+    pthread_create(&thread, NULL, consumer, NULL);
+
+    start = now();
+
+    for (i = 0; i < ROUNDS; i++) {
+        pthread_mutex_lock(&lock);
+        turn = 1;
+        pthread_cond_signal(&ping);
+        while (turn != 0)
+            pthread_cond_wait(&pong, &lock);
+        pthread_mutex_unlock(&lock);
+    }
+
+    elapsed = now() - start;
+
+    pthread_join(thread, NULL);
+
+    printf("%-28s %10.1f us per round trip (%d rounds)\n", "ping-pong", elapsed * 1e6 / ROUNDS, ROUNDS);
+
+    return 0;
+}
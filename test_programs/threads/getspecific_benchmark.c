@@ -0,0 +1,123 @@
+/*
+ * pthread_getspecific() latency with an increasing number of live threads.
+ *
+ * For every thread count the given number of idle threads is started and
+ * parked on a condition variable. The main thread and one extra worker then
+ * time a tight pthread_getspecific() loop, so the lookup cost can be compared
+ * between 1, 100 and 1000 live threads.
+ *
+ * > getspecific_benchmark [ITERATIONS]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+static int ITERATIONS = 1000000;
+
+static pthread_key_t key;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static int done;
+
+static double
+now(void) {
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void *
+idle(void *arg) {
+    pthread_setspecific(key, arg);
+
+    pthread_mutex_lock(&lock);
+    while (!done)
+        pthread_cond_wait(&cond, &lock);
+    pthread_mutex_unlock(&lock);
+
+    return NULL;
+}
+
+/* Returns the average latency of one call in nanoseconds */
+static double
+measure(void) {
+    volatile uintptr_t sum = 0;
+    double start;
+    int i;
+
+    pthread_setspecific(key, (void *) 1);
+
+    start = now();
+
+    for (i = 0; i < ITERATIONS; i++)
+        sum += (uintptr_t) pthread_getspecific(key);
+
+    return (now() - start) * 1e9 / ITERATIONS;
+}
+
+static void *
+worker(void *arg) {
+    *(double *) arg = measure();
+
+    return NULL;
+}
+
+int
+main(int argc, char **argv) {
+    static const int counts[] = { 1, 100, 1000 };
+    pthread_t *threads;
+    unsigned int c;
+    int i;
+
+    if (argc >= 2 && atoi(argv[1]) > 0)
+        ITERATIONS = atoi(argv[1]);
+
+    pthread_key_create(&key, NULL);
+
+    threads = malloc(sizeof(*threads) * counts[sizeof(counts) / sizeof(counts[0]) - 1]);
+    if (threads == NULL)
+        return 1;
+
+    printf("%8s %16s %16s\n", "threads", "main ns/call", "thread ns/call");
+
+    for (c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        int started = 0;
+        double in_main, in_thread = 0;
+        pthread_t measurer;
+
+        done = 0;
+
+        /* The main thread counts as the first live thread */
+        for (i = 1; i < counts[c]; i++) {
+            if (pthread_create(&threads[started], NULL, idle, (void *) (uintptr_t) i) != 0)
+                break;
+
+            started++;
+        }
+
+        in_main = measure();
+
+        if (pthread_create(&measurer, NULL, worker, &in_thread) == 0)
+            pthread_join(measurer, NULL);
+
+        printf("%8d %16.1f %16.1f\n", started + 1, in_main, in_thread);
+
+        pthread_mutex_lock(&lock);
+        done = 1;
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&lock);
+
+        for (i = 0; i < started; i++)
+            pthread_join(threads[i], NULL);
+    }
+
+    free(threads);
+    pthread_key_delete(key);
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * Lock elision benchmark.
+ *
+ * Times getc(), putc() and malloc()/free() pairs while the program has only
+ * one thread, in which case the library skips its locks, and again after a
+ * thread has been started, which switches locking on for good.
+ *
+ * The switch happens while the main thread holds a stream lock taken with
+ * flockfile(): the new thread must not get to write to that stream before
+ * the main thread has let go of it.
+ *
+ * > lock_elision_benchmark [ITERATIONS]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#define FILE_PATH ("lock_elision_benchmark.dat")
+
+static int ITERATIONS = 1000000;
+
+static FILE *shared_stream;
+
+static double
+now(void) {
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void
+run(const char *label) {
+    void *pointers[16];
+    double start, elapsed;
+    FILE *file;
+    int i, j;
+
+    printf("%s:\n", label);
+
+    file = fopen(FILE_PATH, "w+");
+    if (file == NULL) {
+        perror(FILE_PATH);
+        exit(EXIT_FAILURE);
+    }
+
+    start = now();
+    for (i = 0; i < ITERATIONS; i++)
+        putc('a' + (i % 26), file);
+    elapsed = now() - start;
+
+    printf("  putc()            %8.1f ns/call\n", elapsed * 1e9 / ITERATIONS);
+
+    rewind(file);
+
+    start = now();
+    for (i = 0; i < ITERATIONS; i++) {
+        if (getc(file) != 'a' + (i % 26)) {
+            printf("FAIL: getc() returned the wrong data\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    elapsed = now() - start;
+
+    printf("  getc()            %8.1f ns/call\n", elapsed * 1e9 / ITERATIONS);
+
+    fclose(file);
+    remove(FILE_PATH);
+
+    start = now();
+    for (i = 0; i < ITERATIONS / 16; i++) {
+        for (j = 0; j < 16; j++)
+            pointers[j] = malloc(32);
+        for (j = 0; j < 16; j++)
+            free(pointers[j]);
+    }
+    elapsed = now() - start;
+
+    printf("  malloc(32)/free() %8.1f ns/pair\n", elapsed * 1e9 / (ITERATIONS / 16 * 16));
+
+    start = now();
+    for (i = 0; i < ITERATIONS / 16; i++) {
+        for (j = 0; j < 16; j++)
+            pointers[j] = malloc(8192);
+        for (j = 0; j < 16; j++)
+            free(pointers[j]);
+    }
+    elapsed = now() - start;
+
+    printf("  malloc(8K)/free() %8.1f ns/pair\n", elapsed * 1e9 / (ITERATIONS / 16 * 16));
+}
+
+static void *
+writer(void *arg) {
+    (void) arg;
+
+    fputs("thread\n", shared_stream);
+
+    return NULL;
+}
+
+int
+main(int argc, char **argv) {
+    char line[64];
+    pthread_t thread;
+
+    if (argc > 1)
+        ITERATIONS = atoi(argv[1]);
+
+    if (ITERATIONS < 16)
+        ITERATIONS = 16;
+
+    run("one thread, locks skipped");
+
+    shared_stream = tmpfile();
+    if (shared_stream == NULL) {
+        perror("tmpfile");
+        return EXIT_FAILURE;
+    }
+
+    /* The stream is locked before there is a second thread to lock
+       it against; the thread has to wait for the main thread anyway. */
+    flockfile(shared_stream);
+
+    if (pthread_create(&thread, NULL, writer, NULL) != 0) {
+        printf("FAIL: could not create a thread\n");
+        return EXIT_FAILURE;
+    }
+
+    fputs("main\n", shared_stream);
+
+    funlockfile(shared_stream);
+
+    pthread_join(thread, NULL);
+
+    rewind(shared_stream);
+
+    if (fgets(line, sizeof(line), shared_stream) == NULL || strcmp(line, "main\n") != 0) {
+        printf("FAIL: the thread got hold of a locked stream\n");
+        return EXIT_FAILURE;
+    }
+
+    fclose(shared_stream);
+
+    run("after pthread_create(), locks taken");
+
+    printf("OK\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,138 @@
+/*
+ * Lock and call statistics.
+ *
+ * Has several threads allocate memory, write to the same stream and take
+ * the same mutex, then checks what __clib2_stats_snapshot() reports. Only
+ * the library built with STATS=yes keeps these numbers; with any other the
+ * test just says so.
+ *
+ * > lock_stats [ITERATIONS]
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/clib2_stats.h>
+
+#define NUM_THREADS 4
+#define FILE_PATH ("lock_stats.dat")
+
+static int ITERATIONS = 20000;
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static FILE *shared_stream;
+static long shared_count;
+static int failures;
+
+#define CHECK(c) do { if (!(c)) { printf("FAIL line %d: %s\n", __LINE__, #c); failures++; } } while (0)
+
+static const char *lock_names[__CLIB2_NUM_LOCK_SITES] = {
+    "memory", "stdio", "fd", "iob", "locale", "pthread mutex"
+};
+
+static void *
+worker(void *arg) {
+    void *p;
+    int i;
+
+    (void) arg;
+
+    for (i = 0; i < ITERATIONS; i++) {
+        /* Too large for the per-thread caches */
+        p = malloc(8192);
+        free(p);
+
+        flockfile(shared_stream);
+        putc_unlocked('x', shared_stream);
+        funlockfile(shared_stream);
+
+        pthread_mutex_lock(&mutex);
+        shared_count++;
+        pthread_mutex_unlock(&mutex);
+    }
+
+    return NULL;
+}
+
+int
+main(int argc, char **argv) {
+    struct __clib2_stats before, after;
+    pthread_t threads[NUM_THREADS];
+    char buffer[100];
+    int fd, i;
+
+    memset(buffer, 0x5a, sizeof(buffer));
+
+    if (argc > 1)
+        ITERATIONS = atoi(argv[1]);
+
+    if (__clib2_stats_snapshot(&before) != 0) {
+        CHECK(errno == ENOSYS);
+        printf("library not built with STATS=yes\n");
+        printf("%s\n", failures ? "FAILED" : "OK");
+        return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    CHECK(__clib2_stats_snapshot(NULL) != 0 && errno == EFAULT);
+
+    /* read() and write() count calls and bytes. */
+    CHECK(__clib2_stats_reset() == 0);
+
+    fd = open(FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    CHECK(fd >= 0);
+    CHECK(write(fd, buffer, sizeof(buffer)) == sizeof(buffer));
+    CHECK(lseek(fd, 0, SEEK_SET) == 0);
+    CHECK(read(fd, buffer, sizeof(buffer)) == sizeof(buffer));
+    close(fd);
+
+    CHECK(__clib2_stats_snapshot(&before) == 0);
+    CHECK(before.s_Calls[__CLIB2_CALL_WRITE].cs_Calls == 1 && before.s_Calls[__CLIB2_CALL_WRITE].cs_Bytes == sizeof(buffer));
+    CHECK(before.s_Calls[__CLIB2_CALL_READ].cs_Calls == 1 && before.s_Calls[__CLIB2_CALL_READ].cs_Bytes == sizeof(buffer));
+    CHECK(before.s_Locks[__CLIB2_LOCK_FD].ls_Acquisitions >= 2);
+
+    /* Now the threads compete for the locks. */
+    shared_stream = fopen(FILE_PATH, "w");
+    CHECK(shared_stream != NULL);
+
+    for (i = 0; i < NUM_THREADS; i++)
+        CHECK(pthread_create(&threads[i], NULL, worker, NULL) == 0);
+
+    for (i = 0; i < NUM_THREADS; i++)
+        pthread_join(threads[i], NULL);
+
+    fclose(shared_stream);
+    remove(FILE_PATH);
+
+    CHECK(__clib2_stats_snapshot(&after) == 0);
+    CHECK(shared_count == (long) NUM_THREADS * ITERATIONS);
+
+    CHECK(after.s_Calls[__CLIB2_CALL_MALLOC].cs_Calls - before.s_Calls[__CLIB2_CALL_MALLOC].cs_Calls >= (uint64_t) NUM_THREADS * ITERATIONS);
+    CHECK(after.s_Calls[__CLIB2_CALL_MALLOC].cs_Bytes - before.s_Calls[__CLIB2_CALL_MALLOC].cs_Bytes >= (uint64_t) NUM_THREADS * ITERATIONS * 8192);
+    CHECK(after.s_Calls[__CLIB2_CALL_FREE].cs_Calls - before.s_Calls[__CLIB2_CALL_FREE].cs_Calls >= (uint64_t) NUM_THREADS * ITERATIONS);
+
+    CHECK(after.s_Locks[__CLIB2_LOCK_MEMORY].ls_Acquisitions - before.s_Locks[__CLIB2_LOCK_MEMORY].ls_Acquisitions >= (uint64_t) 2 * NUM_THREADS * ITERATIONS);
+    CHECK(after.s_Locks[__CLIB2_LOCK_IOB].ls_Acquisitions - before.s_Locks[__CLIB2_LOCK_IOB].ls_Acquisitions >= (uint64_t) NUM_THREADS * ITERATIONS);
+    CHECK(after.s_Locks[__CLIB2_LOCK_PTHREAD_MUTEX].ls_Acquisitions - before.s_Locks[__CLIB2_LOCK_PTHREAD_MUTEX].ls_Acquisitions >= (uint64_t) NUM_THREADS * ITERATIONS);
+
+    printf("%-14s %12s %12s %16s %14s\n", "lock", "acquired", "contended", "wait ns", "max wait ns");
+
+    for (i = 0; i < __CLIB2_NUM_LOCK_SITES; i++) {
+        const struct __clib2_lock_stats *ls = &after.s_Locks[i];
+
+        CHECK(ls->ls_Contended <= ls->ls_Acquisitions);
+        CHECK(ls->ls_WaitMax <= ls->ls_WaitTotal);
+        CHECK(ls->ls_Contended > 0 || ls->ls_WaitTotal == 0);
+
+        printf("%-14s %12llu %12llu %16llu %14llu\n", lock_names[i],
+               (unsigned long long) ls->ls_Acquisitions, (unsigned long long) ls->ls_Contended,
+               (unsigned long long) ls->ls_WaitTotal, (unsigned long long) ls->ls_WaitMax);
+    }
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
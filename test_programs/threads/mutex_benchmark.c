@@ -0,0 +1,116 @@
+/*
+ * pthread mutex benchmark.
+ *
+ * Times lock/unlock pairs on an uncontended mutex (one thread), on a
+ * recursive mutex, and on a single mutex shared by an increasing number of
+ * threads which all hammer the same counter.
+ *
+ * > mutex_benchmark [MAX_THREADS] [ITERATIONS]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+static int MAX_THREADS = 8;
+static int ITERATIONS = 1000000;
+
+static pthread_mutex_t shared_mutex = PTHREAD_MUTEX_INITIALIZER;
+static volatile long counter;
+
+static double
+now(void) {
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void *
+contender(void *arg) {
+    int i;
+
+    (void) arg;
+
+    for (i = 0; i < ITERATIONS; i++) {
+        pthread_mutex_lock(&shared_mutex);
+        counter++;
+        pthread_mutex_unlock(&shared_mutex);
+    }
+
+    return NULL;
+}
+
+static void
+uncontended(const char *name, pthread_mutex_t *mutex) {
+    double start, elapsed;
+    int i;
+
+    start = now();
+
+    for (i = 0; i < ITERATIONS; i++) {
+        pthread_mutex_lock(mutex);
+        pthread_mutex_unlock(mutex);
+    }
+
+    elapsed = now() - start;
+
+    printf("%-24s %10.1f ns per lock/unlock\n", name, elapsed * 1e9 / ITERATIONS);
+}
+
+int
+main(int argc, char **argv) {
+    pthread_mutexattr_t attr;
+    pthread_mutex_t normal, recursive;
+    pthread_t *threads;
+    int nthreads, i;
+
+    if (argc >= 2 && atoi(argv[1]) > 0)
+        MAX_THREADS = atoi(argv[1]);
+    if (argc >= 3 && atoi(argv[2]) > 0)
+        ITERATIONS = atoi(argv[2]);
+
+    pthread_mutex_init(&normal, NULL);
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&recursive, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    uncontended("uncontended normal", &normal);
+    uncontended("uncontended recursive", &recursive);
+
+    pthread_mutex_destroy(&normal);
+    pthread_mutex_destroy(&recursive);
+
+    threads = malloc(sizeof(*threads) * MAX_THREADS);
+    if (threads == NULL)
+        return 1;
+
+    printf("\n%8s %12s %16s %8s\n", "threads", "seconds", "locks/sec", "check");
+
+    for (nthreads = 1; nthreads <= MAX_THREADS; nthreads *= 2) {
+        double start, elapsed;
+
+        counter = 0;
+        start = now();
+
+        for (i = 0; i < nthreads; i++)
+            pthread_create(&threads[i], NULL, contender, NULL);
+
+        for (i = 0; i < nthreads; i++)
+            pthread_join(threads[i], NULL);
+
+        elapsed = now() - start;
+
+        printf("%8d %12.3f %16.0f %8s\n", nthreads, elapsed,
+               elapsed > 0 ? (double) nthreads * ITERATIONS / elapsed : 0,
+               counter == (long) nthreads * ITERATIONS ? "ok" : "FAILED");
+    }
+
+    free(threads);
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * Overhead of timed pthread waits.
+ *
+ * pthread_cond_timedwait() and pthread_mutex_timedlock() are called in a loop
+ * with a deadline which has already passed and with a deadline 1 ms in the
+ * future. For the latter the time spent beyond the 1 ms is the overhead.
+ *
+ * > timedwait_benchmark [ITERATIONS]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+static int ITERATIONS = 1000;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t held = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t gate = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gate_cond = PTHREAD_COND_INITIALIZER;
+static int holding, release;
+
+static double
+now(void) {
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void
+deadline(struct timespec *ts, long usec) {
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    tv.tv_usec += usec;
+    while (tv.tv_usec < 0) {
+        tv.tv_usec += 1000000;
+        tv.tv_sec--;
+    }
+    while (tv.tv_usec >= 1000000) {
+        tv.tv_usec -= 1000000;
+        tv.tv_sec++;
+    }
+
+    ts->tv_sec = tv.tv_sec;
+    ts->tv_nsec = tv.tv_usec * 1000;
+}
+
+/* Keeps the "held" mutex locked until told to let go */
+static void *
+holder(void *arg) {
+    (void) arg;
+
+    pthread_mutex_lock(&held);
+
+    pthread_mutex_lock(&gate);
+    holding = 1;
+    pthread_cond_signal(&gate_cond);
+    while (!release)
+        pthread_cond_wait(&gate_cond, &gate);
+    pthread_mutex_unlock(&gate);
+
+    pthread_mutex_unlock(&held);
+
+    return NULL;
+}
+
+static void
+report(const char *name, double elapsed, long usec) {
+    double per_call = elapsed * 1e6 / ITERATIONS;
+
+    printf("%-36s %10.1f us per call %10.1f us overhead\n", name, per_call, per_call - usec);
+}
+
+static void
+cond_wait(const char *name, long usec) {
+    struct timespec ts;
+    double start;
+    int i, timeouts = 0;
+
+    start = now();
+
+    pthread_mutex_lock(&lock);
+    for (i = 0; i < ITERATIONS; i++) {
+        deadline(&ts, usec);
+        if (pthread_cond_timedwait(&cond, &lock, &ts) == ETIMEDOUT)
+            timeouts++;
+    }
+    pthread_mutex_unlock(&lock);
+
+    report(name, now() - start, usec > 0 ? usec : 0);
+
+    if (timeouts != ITERATIONS)
+        printf("  only %d of %d waits timed out\n", timeouts, ITERATIONS);
+}
+
+static void
+mutex_wait(const char *name, long usec) {
+    struct timespec ts;
+    double start;
+    int i, timeouts = 0;
+
+    start = now();
+
+    for (i = 0; i < ITERATIONS; i++) {
+        deadline(&ts, usec);
+        if (pthread_mutex_timedlock(&held, &ts) == ETIMEDOUT)
+            timeouts++;
+    }
+
+    report(name, now() - start, usec > 0 ? usec : 0);
+
+    if (timeouts != ITERATIONS)
+        printf("  only %d of %d waits timed out\n", timeouts, ITERATIONS);
+}
+
+int
+main(int argc, char **argv) {
+    pthread_t thread;
+
+    if (argc >= 2 && atoi(argv[1]) > 0)
+        ITERATIONS = atoi(argv[1]);
+
+    cond_wait("cond_timedwait, expired deadline", -1000);
+    cond_wait("cond_timedwait, 1 ms deadline", 1000);
+
+    pthread_create(&thread, NULL, holder, NULL);
+
+    pthread_mutex_lock(&gate);
+    while (!holding)
+        pthread_cond_wait(&gate_cond, &gate);
+    pthread_mutex_unlock(&gate);
+
+    mutex_wait("mutex_timedlock, expired deadline", -1000);
+    mutex_wait("mutex_timedlock, 1 ms deadline", 1000);
+
+    pthread_mutex_lock(&gate);
+    release = 1;
+    pthread_cond_signal(&gate_cond);
+    pthread_mutex_unlock(&gate);
+
+    pthread_join(thread, NULL);
+
+    return 0;
+}
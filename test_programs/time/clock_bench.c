@@ -0,0 +1,126 @@
+/*
+ * Measures how many times per second clock_gettime(), gettimeofday(), time()
+ * and clock() can be called, by one thread and by several at once.
+ *
+ * > clock_bench [calls] [threads]
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/time.h>
+
+#define MAX_THREADS 16
+
+static long num_calls = 1000000;
+static int num_threads = 4;
+
+enum {
+    CALL_MONOTONIC,
+    CALL_REALTIME,
+    CALL_GETTIMEOFDAY,
+    CALL_TIME,
+    CALL_CLOCK,
+    NUM_CALLS
+};
+
+static const char *call_names[NUM_CALLS] = {
+    "clock_gettime(CLOCK_MONOTONIC)",
+    "clock_gettime(CLOCK_REALTIME)",
+    "gettimeofday()",
+    "time()",
+    "clock()"
+};
+
+static double
+now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+static void *
+run(void *arg) {
+    int which = (int) (long) arg;
+    struct timespec ts;
+    struct timeval tv;
+    long i;
+
+    for (i = 0; i < num_calls; i++) {
+        switch (which) {
+            case CALL_MONOTONIC:
+                clock_gettime(CLOCK_MONOTONIC, &ts);
+                break;
+
+            case CALL_REALTIME:
+                clock_gettime(CLOCK_REALTIME, &ts);
+                break;
+
+            case CALL_GETTIMEOFDAY:
+                gettimeofday(&tv, NULL);
+                break;
+
+            case CALL_TIME:
+                time(NULL);
+                break;
+
+            case CALL_CLOCK:
+                clock();
+                break;
+        }
+    }
+
+    return NULL;
+}
+
+static void
+measure(int which, int threads) {
+    pthread_t thread[MAX_THREADS];
+    double start, elapsed;
+    int i;
+
+    start = now();
+
+    if (threads == 1) {
+        run((void *) (long) which);
+    } else {
+        for (i = 0; i < threads; i++)
+            pthread_create(&thread[i], NULL, run, (void *) (long) which);
+
+        for (i = 0; i < threads; i++)
+            pthread_join(thread[i], NULL);
+    }
+
+    elapsed = now() - start;
+
+    printf("%-31s %2d thread%s %12.0f calls/s %8.1f ns/call\n", call_names[which], threads, (threads == 1) ? " " : "s",
+           num_calls * threads / elapsed, elapsed * 1000000000.0 / num_calls / threads);
+}
+
+int
+main(int argc, char **argv) {
+    struct timespec res;
+    int which;
+
+    if (argc > 1)
+        num_calls = atol(argv[1]);
+
+    if (argc > 2)
+        num_threads = atoi(argv[2]);
+
+    if (num_threads < 1 || num_threads > MAX_THREADS)
+        num_threads = 4;
+
+    if (clock_getres(CLOCK_MONOTONIC, &res) == 0)
+        printf("resolution: %ld ns\n", res.tv_nsec);
+
+    for (which = 0; which < NUM_CALLS; which++) {
+        measure(which, 1);
+        measure(which, num_threads);
+    }
+
+    return EXIT_SUCCESS;
+}
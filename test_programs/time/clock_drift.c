@@ -0,0 +1,126 @@
+/*
+ * Checks that CLOCK_MONOTONIC never goes backwards, also not when several
+ * threads read it, that time(), gettimeofday() and CLOCK_REALTIME agree, and
+ * how far CLOCK_MONOTONIC drifts against CLOCK_REALTIME.
+ *
+ * > clock_drift [seconds]
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#define NUM_THREADS 4
+
+static int num_seconds = 10;
+static volatile int stop;
+static int failures;
+
+#define CHECK(c) do { if (!(c)) { printf("FAIL line %d: %s\n", __LINE__, #c); failures++; } } while (0)
+
+static long long
+nanos(const struct timespec *ts) {
+    return ts->tv_sec * 1000000000LL + ts->tv_nsec;
+}
+
+/* Each thread compares what it reads with what it and the others read
+   before. */
+static volatile long long latest;
+
+static void *
+watch(void *arg) {
+    struct timespec ts;
+    long long previous = 0, seen, t;
+    long *num_backwards = arg;
+
+    while (!stop) {
+        seen = latest;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        t = nanos(&ts);
+
+        if (t < previous || t < seen || ts.tv_nsec < 0 || ts.tv_nsec >= 1000000000)
+            (*num_backwards)++;
+
+        previous = t;
+
+        if (t > seen)
+            __sync_bool_compare_and_swap(&latest, seen, t);
+    }
+
+    return NULL;
+}
+
+static void
+check_agreement(void) {
+    struct timespec ts;
+    struct timeval tv;
+    time_t t;
+    int i;
+
+    for (i = 0; i < 1000; i++) {
+        t = time(NULL);
+        gettimeofday(&tv, NULL);
+        clock_gettime(CLOCK_REALTIME, &ts);
+
+        CHECK(tv.tv_sec == t || tv.tv_sec == t + 1);
+        CHECK(ts.tv_sec * 1000000LL + ts.tv_nsec / 1000 >= tv.tv_sec * 1000000LL + tv.tv_usec);
+        CHECK(ts.tv_sec * 1000000LL + ts.tv_nsec / 1000 - (tv.tv_sec * 1000000LL + tv.tv_usec) < 10000);
+    }
+}
+
+int
+main(int argc, char **argv) {
+    struct timespec mono_start, mono_end, real_start, real_end, res;
+    long num_backwards[NUM_THREADS] = { 0 };
+    pthread_t thread[NUM_THREADS];
+    long long mono, real;
+    double ppm;
+    int i;
+
+    if (argc > 1)
+        num_seconds = atoi(argv[1]);
+
+    CHECK(clock_getres(CLOCK_MONOTONIC, &res) == 0 && res.tv_sec == 0 && res.tv_nsec > 0);
+
+    check_agreement();
+
+    clock_gettime(CLOCK_MONOTONIC, &mono_start);
+    clock_gettime(CLOCK_REALTIME, &real_start);
+
+    for (i = 0; i < NUM_THREADS; i++)
+        CHECK(pthread_create(&thread[i], NULL, watch, &num_backwards[i]) == 0);
+
+    sleep(num_seconds);
+
+    stop = 1;
+
+    for (i = 0; i < NUM_THREADS; i++) {
+        pthread_join(thread[i], NULL);
+
+        CHECK(num_backwards[i] == 0);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &mono_end);
+    clock_gettime(CLOCK_REALTIME, &real_end);
+
+    check_agreement();
+
+    mono = nanos(&mono_end) - nanos(&mono_start);
+    real = nanos(&real_end) - nanos(&real_start);
+    ppm = (mono - real) * 1000000.0 / real;
+
+    printf("monotonic %.6f s, realtime %.6f s, drift %.1f ppm\n", mono / 1e9, real / 1e9, ppm);
+
+    /* The real time follows the system time, which the monotonic clock is
+       only compared with; they should not be far apart. */
+    CHECK(mono >= num_seconds * 1000000000LL);
+    CHECK(ppm > -1000.0 && ppm < 1000.0);
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
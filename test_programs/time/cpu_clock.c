@@ -0,0 +1,147 @@
+/*
+ * Starts a few threads which keep the CPU busy for different amounts of
+ * time and one which only sleeps, and checks that CLOCK_THREAD_CPUTIME_ID,
+ * pthread_getcpuclockid(), CLOCK_PROCESS_CPUTIME_ID, clock() and getrusage()
+ * tell them apart.
+ *
+ * > cpu_clock [milliseconds]
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#define NUM_BUSY_THREADS 3
+
+static long busy_ms = 200;
+static int failures;
+
+#define CHECK(c) do { if (!(c)) { printf("FAIL line %d: %s\n", __LINE__, #c); failures++; } } while (0)
+
+static double
+seconds(clockid_t clock_id) {
+    struct timespec ts;
+
+    if (clock_gettime(clock_id, &ts) != 0)
+        return -1.0;
+
+    return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+/* Use up the given amount of CPU time. */
+static void
+burn(double amount) {
+    double end = seconds(CLOCK_THREAD_CPUTIME_ID) + amount;
+    volatile unsigned long n = 0;
+
+    while (seconds(CLOCK_THREAD_CPUTIME_ID) < end)
+        n++;
+}
+
+struct work {
+    double amount;
+    double used;
+    volatile int done;
+};
+
+static void *
+busy(void *arg) {
+    struct work *w = arg;
+
+    burn(w->amount);
+
+    w->used = seconds(CLOCK_THREAD_CPUTIME_ID);
+    w->done = 1;
+
+    /* Wait for the main thread to look at our clock from the outside. */
+    while (w->done != 2)
+        usleep(1000);
+
+    return NULL;
+}
+
+static void *
+sleeper(void *arg) {
+    struct work *w = arg;
+
+    usleep(busy_ms * 1000);
+
+    w->used = seconds(CLOCK_THREAD_CPUTIME_ID);
+    w->done = 1;
+
+    while (w->done != 2)
+        usleep(1000);
+
+    return NULL;
+}
+
+int
+main(int argc, char **argv) {
+    struct work work[NUM_BUSY_THREADS + 1];
+    pthread_t thread[NUM_BUSY_THREADS + 1];
+    clockid_t clock_id[NUM_BUSY_THREADS + 1];
+    double process_start, process_used, total = 0.0, amount;
+    struct rusage ru;
+    clock_t clock_start;
+    int i;
+
+    if (argc > 1)
+        busy_ms = atol(argv[1]);
+
+    amount = busy_ms / 1000.0;
+
+    CHECK(seconds(CLOCK_THREAD_CPUTIME_ID) >= 0.0);
+
+    process_start = seconds(CLOCK_PROCESS_CPUTIME_ID);
+    clock_start = clock();
+
+    for (i = 0; i <= NUM_BUSY_THREADS; i++) {
+        work[i].amount = amount * (i + 1);
+        work[i].done = 0;
+
+        CHECK(pthread_create(&thread[i], NULL, (i < NUM_BUSY_THREADS) ? busy : sleeper, &work[i]) == 0);
+    }
+
+    for (i = 0; i <= NUM_BUSY_THREADS; i++) {
+        while (!work[i].done)
+            usleep(1000);
+
+        CHECK(pthread_getcpuclockid(thread[i], &clock_id[i]) == 0);
+
+        printf("thread %d: %.3f s of CPU time, %.3f s seen from outside\n", i, work[i].used, seconds(clock_id[i]));
+
+        /* The threads are idle now, so the clock should not move. */
+        CHECK(seconds(clock_id[i]) >= work[i].used && seconds(clock_id[i]) < work[i].used + 0.01);
+
+        if (i < NUM_BUSY_THREADS) {
+            CHECK(work[i].used >= work[i].amount && work[i].used < work[i].amount + 0.05);
+            total += work[i].used;
+        } else {
+            CHECK(work[i].used < 0.05);
+        }
+    }
+
+    process_used = seconds(CLOCK_PROCESS_CPUTIME_ID) - process_start;
+
+    printf("process: %.3f s of CPU time, the busy threads used %.3f s\n", process_used, total);
+    printf("clock(): %.3f s\n", (double) (clock() - clock_start) / CLOCKS_PER_SEC);
+
+    CHECK(process_used >= total && process_used < total + 0.2);
+    CHECK((double) (clock() - clock_start) / CLOCKS_PER_SEC >= total - 2.0 / CLOCKS_PER_SEC);
+
+    CHECK(getrusage(RUSAGE_SELF, &ru) == 0);
+    CHECK(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1000000.0 >= total - 0.05);
+
+    for (i = 0; i <= NUM_BUSY_THREADS; i++) {
+        work[i].done = 2;
+        pthread_join(thread[i], NULL);
+    }
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}